@@ -1,3 +1,9 @@
+#include <array>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 #include "math/Loggers.hpp"
 
 #include "util/macros.hpp"
@@ -16,6 +22,39 @@
 #include "pole_position/core.hpp"
 #include "pole_position/Loggers.hpp"
 #include "pole_position/Boilerplate.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+
+/**
+ * @brief The runtime levels of our own loggers. These must not ask for a level below a logger's compile-time floor,
+ * because those calls no longer exist
+ */
+constexpr std::array<std::pair<std::string_view, util::Logger::Level>, 13> demoAppLoggerLevels = {{
+    {"GENERAL", util::Logger::Level::info},
+    {"PLAYER", util::Logger::Level::info},
+    {"HEADLESS", util::Logger::Level::info},
+    {"INPUT_RECORDING", util::Logger::Level::info},
+    {"PROFILER", util::Logger::Level::info},
+    {"ASSET_LOADING", util::Logger::Level::info},
+    {"SCENE_FILE", util::Logger::Level::info},
+    {"JOBS", util::Logger::Level::info},
+    {"MEMORY", util::Logger::Level::info},
+    {"TERRAIN", util::Logger::Level::info},
+    {"VEHICLE", util::Logger::Level::info},
+    {"GHOST", util::Logger::Level::info},
+    {"SNAPSHOT", util::Logger::Level::info},
+}};
+
+constexpr bool
+areLoggerLevelsCompiledIn() {
+    for (const std::pair<std::string_view, util::Logger::Level>& loggerLevel : demoAppLoggerLevels) {
+        if (static_cast<int>(loggerLevel.second) < static_cast<int>(getLogLevelFloor(loggerLevel.first))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(areLoggerLevelsCompiledIn(), "A runtime logger level is below that logger's POLE_POSITION_LOG_LEVEL_FLOOR");
 
 int
 DoBoilerplateStuff(
@@ -35,11 +74,8 @@ DoBoilerplateStuff(
     REGISTER_LOGGER_GROUP(QUARTZ_SCENE);
     REGISTER_LOGGER_GROUP(DEMO_APP);
 
-    util::Logger::setLevels({
-        // demo app
-        {"GENERAL", util::Logger::Level::info},
-        {"PLAYER", util::Logger::Level::info},
-
+    std::vector<std::pair<std::string, util::Logger::Level>> loggerLevels(demoAppLoggerLevels.begin(), demoAppLoggerLevels.end());
+    loggerLevels.insert(loggerLevels.end(), {
         // math
         {"TRANSFORM", util::Logger::Level::info},
 
@@ -92,6 +128,8 @@ DoBoilerplateStuff(
         {"SCENE", util::Logger::Level::info},
         {"SKYBOX", util::Logger::Level::info},
     });
+    util::Logger::setLevels({loggerLevels.begin(), loggerLevels.end()});
+    AsyncLogger::setLevels(loggerLevels);
 
     if (shouldLogPreamble) {
         LOG_INFO(GENERAL, "Quartz version   : {}.{}.{}", QUARTZ_MAJOR_VERSION, QUARTZ_MINOR_VERSION, QUARTZ_PATCH_VERSION);
@@ -131,6 +169,11 @@ DoBoilerplateStuff(
 #endif
     }
 
+    return 0;
+}
+
+int
+DoWindowingBoilerplateStuff() {
     if (!glfwInit()) {
         LOG_CRITICAL(GENERAL, "Failed to initialize GLFW");
         return EXIT_FAILURE;
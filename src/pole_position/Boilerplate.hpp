@@ -14,3 +14,15 @@ int DoBoilerplateStuff(const bool shouldLogPreamble);
     }                                                                                   \
     REQUIRE_SEMICOLON
 
+
+int DoWindowingBoilerplateStuff();
+
+#define DO_WINDOWING_BOILERPLATE()                                                                         \
+    {                                                                                                      \
+        const int windowingBoilerplateStatus = DoWindowingBoilerplateStuff();                              \
+        if (windowingBoilerplateStatus) {                                                                  \
+            LOG_ERROR(GENERAL, "Required windowing boilerplate returned {}", windowingBoilerplateStatus);  \
+            return windowingBoilerplateStatus;                                                             \
+        }                                                                                                  \
+    }                                                                                                      \
+    REQUIRE_SEMICOLON
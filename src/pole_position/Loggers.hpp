@@ -1,19 +1,130 @@
 #pragma once
 
+#include <string_view>
+
 #include "util/logger/Logger.hpp"
 
-DECLARE_LOGGER(GENERAL, trace);
-DECLARE_LOGGER(PLAYER, trace);
-DECLARE_LOGGER(BIGBOY, trace);
-DECLARE_LOGGER(ALAMANCY, trace);
-DECLARE_LOGGER(GENERAL2, trace);
+/**
+ * @brief The compile-time level floor of each of our loggers. Log calls below a logger's floor compile to nothing.
+ * The floors are set with the POLE_POSITION_LOG_LEVEL_FLOOR and POLE_POSITION_LOG_LEVEL_FLOOR_<LOGGER> cmake
+ * options and default to trace, which keeps every call
+ */
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_GENERAL
+#define POLE_POSITION_LOG_LEVEL_FLOOR_GENERAL trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_PLAYER
+#define POLE_POSITION_LOG_LEVEL_FLOOR_PLAYER trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_BIGBOY
+#define POLE_POSITION_LOG_LEVEL_FLOOR_BIGBOY trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_ALAMANCY
+#define POLE_POSITION_LOG_LEVEL_FLOOR_ALAMANCY trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_GENERAL2
+#define POLE_POSITION_LOG_LEVEL_FLOOR_GENERAL2 trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_HEADLESS
+#define POLE_POSITION_LOG_LEVEL_FLOOR_HEADLESS trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_INPUT_RECORDING
+#define POLE_POSITION_LOG_LEVEL_FLOOR_INPUT_RECORDING trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_PROFILER
+#define POLE_POSITION_LOG_LEVEL_FLOOR_PROFILER trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_ASSET_LOADING
+#define POLE_POSITION_LOG_LEVEL_FLOOR_ASSET_LOADING trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_SCENE_FILE
+#define POLE_POSITION_LOG_LEVEL_FLOOR_SCENE_FILE trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_JOBS
+#define POLE_POSITION_LOG_LEVEL_FLOOR_JOBS trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_MEMORY
+#define POLE_POSITION_LOG_LEVEL_FLOOR_MEMORY trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_TERRAIN
+#define POLE_POSITION_LOG_LEVEL_FLOOR_TERRAIN trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_VEHICLE
+#define POLE_POSITION_LOG_LEVEL_FLOOR_VEHICLE trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_GHOST
+#define POLE_POSITION_LOG_LEVEL_FLOOR_GHOST trace
+#endif
+#ifndef POLE_POSITION_LOG_LEVEL_FLOOR_SNAPSHOT
+#define POLE_POSITION_LOG_LEVEL_FLOOR_SNAPSHOT trace
+#endif
+
+/**
+ * @brief Declares the logger with its floor as the compile-time level, along with a NAME_LOG_LEVEL_FLOOR constant
+ * that the ASYNC_LOG_* macros and the runtime level check in DoBoilerplateStuff use
+ */
+#define DECLARE_POLE_POSITION_LOGGER(NAME)                                                                  \
+    DECLARE_LOGGER(NAME, POLE_POSITION_LOG_LEVEL_FLOOR_##NAME);                                             \
+    constexpr util::Logger::Level NAME##_LOG_LEVEL_FLOOR = util::Logger::Level::POLE_POSITION_LOG_LEVEL_FLOOR_##NAME
+
+DECLARE_POLE_POSITION_LOGGER(GENERAL);
+DECLARE_POLE_POSITION_LOGGER(PLAYER);
+DECLARE_POLE_POSITION_LOGGER(BIGBOY);
+DECLARE_POLE_POSITION_LOGGER(ALAMANCY);
+DECLARE_POLE_POSITION_LOGGER(GENERAL2);
+DECLARE_POLE_POSITION_LOGGER(HEADLESS);
+DECLARE_POLE_POSITION_LOGGER(INPUT_RECORDING);
+DECLARE_POLE_POSITION_LOGGER(PROFILER);
+DECLARE_POLE_POSITION_LOGGER(ASSET_LOADING);
+DECLARE_POLE_POSITION_LOGGER(SCENE_FILE);
+DECLARE_POLE_POSITION_LOGGER(JOBS);
+DECLARE_POLE_POSITION_LOGGER(MEMORY);
+DECLARE_POLE_POSITION_LOGGER(TERRAIN);
+DECLARE_POLE_POSITION_LOGGER(VEHICLE);
+DECLARE_POLE_POSITION_LOGGER(GHOST);
+DECLARE_POLE_POSITION_LOGGER(SNAPSHOT);
 
 DECLARE_LOGGER_GROUP(
     DEMO_APP,
-    5,
+    16,
     GENERAL,
     PLAYER,
     BIGBOY,
     ALAMANCY,
-    GENERAL2
+    GENERAL2,
+    HEADLESS,
+    INPUT_RECORDING,
+    PROFILER,
+    ASSET_LOADING,
+    SCENE_FILE,
+    JOBS,
+    MEMORY,
+    TERRAIN,
+    VEHICLE,
+    GHOST,
+    SNAPSHOT
 );
+
+constexpr util::Logger::Level
+getLogLevelFloor(
+    const std::string_view loggerName
+) {
+    if (loggerName == "GENERAL") { return GENERAL_LOG_LEVEL_FLOOR; }
+    if (loggerName == "PLAYER") { return PLAYER_LOG_LEVEL_FLOOR; }
+    if (loggerName == "BIGBOY") { return BIGBOY_LOG_LEVEL_FLOOR; }
+    if (loggerName == "ALAMANCY") { return ALAMANCY_LOG_LEVEL_FLOOR; }
+    if (loggerName == "GENERAL2") { return GENERAL2_LOG_LEVEL_FLOOR; }
+    if (loggerName == "HEADLESS") { return HEADLESS_LOG_LEVEL_FLOOR; }
+    if (loggerName == "INPUT_RECORDING") { return INPUT_RECORDING_LOG_LEVEL_FLOOR; }
+    if (loggerName == "PROFILER") { return PROFILER_LOG_LEVEL_FLOOR; }
+    if (loggerName == "ASSET_LOADING") { return ASSET_LOADING_LOG_LEVEL_FLOOR; }
+    if (loggerName == "SCENE_FILE") { return SCENE_FILE_LOG_LEVEL_FLOOR; }
+    if (loggerName == "JOBS") { return JOBS_LOG_LEVEL_FLOOR; }
+    if (loggerName == "MEMORY") { return MEMORY_LOG_LEVEL_FLOOR; }
+    if (loggerName == "TERRAIN") { return TERRAIN_LOG_LEVEL_FLOOR; }
+    if (loggerName == "VEHICLE") { return VEHICLE_LOG_LEVEL_FLOOR; }
+    if (loggerName == "GHOST") { return GHOST_LOG_LEVEL_FLOOR; }
+    if (loggerName == "SNAPSHOT") { return SNAPSHOT_LOG_LEVEL_FLOOR; }
+
+    // Not one of ours, so nothing is compiled out as far as we know
+    return util::Logger::Level::trace;
+}
@@ -0,0 +1,420 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/asset_loading/AssetCache.hpp"
+#include "pole_position/asset_loading/AssetCacheFormat.hpp"
+#include "pole_position/asset_loading/Gltf.hpp"
+#include "pole_position/asset_loading/MappedFile.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+
+namespace {
+
+constexpr uint64_t fnvOffsetBasis = 0xcbf29ce484222325;
+constexpr uint64_t fnvPrime = 0x100000001b3;
+
+uint64_t
+hashFnv1a(
+    const std::string_view bytes,
+    uint64_t hash = fnvOffsetBasis
+) {
+    for (const char byte : bytes) {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= fnvPrime;
+    }
+    return hash;
+}
+
+template <typename T>
+T
+readPod(
+    const std::string_view contents,
+    const uint64_t offset
+) {
+    T value;
+    std::memcpy(&value, contents.data() + offset, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+AssetCache::CachedAsset::CachedAsset(
+    MappedFile&& mappedFile,
+    const asset_cache_format::Header& header,
+    std::vector<Section>&& sections
+) :
+    m_mappedFile(std::move(mappedFile)),
+    m_header(header),
+    m_sections(std::move(sections))
+{}
+
+const AssetCache::Section*
+AssetCache::CachedAsset::findSection(
+    const asset_cache_format::SectionKind kind,
+    const std::string_view name
+) const {
+    for (const Section& section : m_sections) {
+        if (section.kind == kind && (name.empty() || section.name == name)) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<asset_cache_format::FileStamp>
+AssetCache::getFileStamp(
+    const std::string& filepath
+) {
+    std::error_code errorCode;
+    const uintmax_t byteCount = std::filesystem::file_size(filepath, errorCode);
+    if (errorCode) {
+        return std::nullopt;
+    }
+    const std::filesystem::file_time_type modificationTime = std::filesystem::last_write_time(filepath, errorCode);
+    if (errorCode) {
+        return std::nullopt;
+    }
+
+    return asset_cache_format::FileStamp {
+        static_cast<uint64_t>(byteCount),
+        static_cast<int64_t>(modificationTime.time_since_epoch().count())
+    };
+}
+
+std::optional<AssetCache::SourceFile>
+AssetCache::readSourceFile(
+    const std::string& filepath
+) {
+    const std::optional<asset_cache_format::FileStamp> o_stamp = AssetCache::getFileStamp(filepath);
+    if (!o_stamp) {
+        return std::nullopt;
+    }
+
+    std::ifstream inputStream(filepath, std::ios::binary);
+    std::vector<char> contents(o_stamp->byteCount);
+    if (!inputStream || !inputStream.read(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+        return std::nullopt;
+    }
+
+    return SourceFile {filepath, *o_stamp, std::move(contents)};
+}
+
+std::optional<AssetCache::Sources>
+AssetCache::readSources(
+    const std::string& sourceFilepath
+) {
+    std::optional<SourceFile> o_sourceFile = AssetCache::readSourceFile(sourceFilepath);
+    if (!o_sourceFile) {
+        return std::nullopt;
+    }
+
+    Sources sources {{}, fnvOffsetBasis};
+    sources.files.push_back(std::move(*o_sourceFile));
+
+    const std::string_view contents(sources.files[0].contents.data(), sources.files[0].contents.size());
+    const std::string extension = std::filesystem::path(sourceFilepath).extension().string();
+    std::vector<std::string> externalFilepaths;
+    if (extension == ".gltf") {
+        externalFilepaths = getGltfExternalFilepaths(sourceFilepath, contents);
+    } else if (extension == ".glb") {
+        if (const std::optional<GlbChunks> o_glbChunks = splitGlb(contents)) {
+            externalFilepaths = getGltfExternalFilepaths(sourceFilepath, o_glbChunks->json);
+        }
+    }
+
+    for (const std::string& externalFilepath : externalFilepaths) {
+        std::optional<SourceFile> o_externalFile = AssetCache::readSourceFile(externalFilepath);
+        if (!o_externalFile) {
+            LOG_WARNING(ASSET_LOADING, "{} references {}, which cannot be read", sourceFilepath, externalFilepath);
+            return std::nullopt;
+        }
+        sources.files.push_back(std::move(*o_externalFile));
+    }
+
+    // The filepaths are part of the hash so a reference moving to another file counts as a change
+    for (const SourceFile& sourceFile : sources.files) {
+        sources.contentHash = hashFnv1a(sourceFile.filepath, sources.contentHash);
+        sources.contentHash = hashFnv1a({sourceFile.contents.data(), sourceFile.contents.size()}, sources.contentHash);
+    }
+
+    return sources;
+}
+
+std::shared_ptr<const AssetCache::CachedAsset>
+AssetCache::parseCookedAsset(
+    MappedFile&& mappedFile,
+    const std::string& sourceFilepath
+) {
+    const std::string_view contents = mappedFile.getContents();
+    if (contents.size() < sizeof(asset_cache_format::Header)) {
+        return nullptr;
+    }
+
+    const asset_cache_format::Header header = readPod<asset_cache_format::Header>(contents, 0);
+    if (header.magic != asset_cache_format::magic || header.version != asset_cache_format::version) {
+        return nullptr;
+    }
+
+    // Two sources could hash to the same cooked filepath, so make sure this is the one we want
+    const uint64_t sourceFilepathOffset = sizeof(asset_cache_format::Header);
+    const uint64_t sectionTableOffset = asset_cache_format::alignUp(sourceFilepathOffset + header.sourceFilepathByteCount);
+    const uint64_t sectionTableEnd = sectionTableOffset + static_cast<uint64_t>(header.sectionCount) * sizeof(asset_cache_format::SectionEntry);
+    if (sectionTableEnd > contents.size() || contents.substr(sourceFilepathOffset, header.sourceFilepathByteCount) != sourceFilepath) {
+        return nullptr;
+    }
+
+    std::vector<Section> sections;
+    sections.reserve(header.sectionCount);
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        const asset_cache_format::SectionEntry sectionEntry = readPod<asset_cache_format::SectionEntry>(contents, sectionTableOffset + i * sizeof(asset_cache_format::SectionEntry));
+        if (sectionEntry.nameOffset + sectionEntry.nameByteCount > contents.size() || sectionEntry.dataOffset + sectionEntry.dataByteCount > contents.size()) {
+            return nullptr;
+        }
+        sections.push_back({
+            sectionEntry.kind,
+            contents.substr(sectionEntry.nameOffset, sectionEntry.nameByteCount),
+            sectionEntry.sourceStamp,
+            contents.substr(sectionEntry.dataOffset, sectionEntry.dataByteCount)
+        });
+    }
+
+    return std::make_shared<const CachedAsset>(std::move(mappedFile), header, std::move(sections));
+}
+
+bool
+AssetCache::isStampFresh(
+    const CachedAsset& cachedAsset,
+    const std::string& sourceFilepath
+) {
+    if (AssetCache::getFileStamp(sourceFilepath) != std::optional(cachedAsset.getSourceStamp())) {
+        return false;
+    }
+
+    for (const Section& section : cachedAsset.getSections()) {
+        if (section.kind == asset_cache_format::SectionKind::externalResource && AssetCache::getFileStamp(std::string(section.name)) != std::optional(section.sourceStamp)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+AssetCache::AssetCache(
+    const std::string& directory
+) :
+    m_directory(directory),
+    m_freshCount(0),
+    m_cookCount(0),
+    m_staleCount(0),
+    m_failureCount(0),
+    m_residentAssets()
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(m_directory, errorCode);
+    if (errorCode) {
+        throw std::runtime_error("Failed to create asset cache directory " + m_directory + ": " + errorCode.message());
+    }
+
+    LOG_INFOthis("Caching cooked assets in {}", m_directory);
+}
+
+std::string
+AssetCache::getCookedFilepath(
+    const std::string& sourceFilepath
+) const {
+    // The file name is only there to make the directory readable, the hash is what keeps them unique
+    const std::string fileName = std::filesystem::path(sourceFilepath).filename().string();
+    return (std::filesystem::path(m_directory) / fmt::format("{:016x}_{}.ppac", hashFnv1a(sourceFilepath), fileName)).string();
+}
+
+AssetCache::Statistics
+AssetCache::getStatistics() const {
+    return {
+        m_freshCount.load(std::memory_order_relaxed),
+        m_cookCount.load(std::memory_order_relaxed),
+        m_staleCount.load(std::memory_order_relaxed),
+        m_failureCount.load(std::memory_order_relaxed)
+    };
+}
+
+std::shared_ptr<const AssetCache::CachedAsset>
+AssetCache::load(
+    const std::string& sourceFilepath
+) {
+    return m_residentAssets.acquire(
+        sourceFilepath,
+        [this] (const std::string& resolvedSourceFilepath, uint64_t& byteCount) {
+            std::shared_ptr<const CachedAsset> p_cachedAsset = this->loadUncached(resolvedSourceFilepath);
+            byteCount = p_cachedAsset ? p_cachedAsset->getByteCount() : 0;
+            return p_cachedAsset;
+        }
+    );
+}
+
+std::shared_ptr<const AssetCache::CachedAsset>
+AssetCache::loadUncached(
+    const std::string& sourceFilepath
+) {
+    PROFILE_SCOPE("Asset cache load");
+
+    const std::string cookedFilepath = this->getCookedFilepath(sourceFilepath);
+
+    std::optional<Sources> o_sources;
+    std::error_code errorCode;
+    if (std::filesystem::exists(cookedFilepath, errorCode)) {
+        try {
+            std::shared_ptr<const CachedAsset> p_cachedAsset = AssetCache::parseCookedAsset(MappedFile(cookedFilepath), sourceFilepath);
+            if (p_cachedAsset && AssetCache::isStampFresh(*p_cachedAsset, sourceFilepath)) {
+                m_freshCount.fetch_add(1, std::memory_order_relaxed);
+                return p_cachedAsset;
+            }
+
+            // Touching a file or checking it out again changes its stamp but not its contents. Cooking it again
+            // is only a write at that point, and it keeps us from hashing the sources on every launch after this
+            if (p_cachedAsset) {
+                o_sources = AssetCache::readSources(sourceFilepath);
+                if (o_sources && o_sources->contentHash == p_cachedAsset->getContentHash()) {
+                    LOG_TRACEthis("{} was touched but its contents did not change", sourceFilepath);
+                } else {
+                    LOG_INFOthis("{} is stale, cooking it again", cookedFilepath);
+                    m_staleCount.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        } catch (const std::exception& e) {
+            LOG_WARNINGthis("{}", e.what());
+        }
+    }
+
+    if (!o_sources) {
+        o_sources = AssetCache::readSources(sourceFilepath);
+    }
+    if (!o_sources || !this->cook(*o_sources, cookedFilepath)) {
+        LOG_WARNINGthis("Failed to cook {}", sourceFilepath);
+        m_failureCount.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    m_cookCount.fetch_add(1, std::memory_order_relaxed);
+
+    try {
+        return AssetCache::parseCookedAsset(MappedFile(cookedFilepath), sourceFilepath);
+    } catch (const std::exception& e) {
+        LOG_WARNINGthis("{}", e.what());
+        m_failureCount.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+}
+
+bool
+AssetCache::cook(
+    const Sources& sources,
+    const std::string& cookedFilepath
+) {
+    PROFILE_SCOPE("Asset cache cook");
+
+    struct CookedSection {
+        asset_cache_format::SectionKind kind;
+        std::string_view name;
+        asset_cache_format::FileStamp sourceStamp;
+        std::string_view data;
+    };
+
+    const SourceFile& sourceFile = sources.files[0];
+    const std::string_view sourceContents(sourceFile.contents.data(), sourceFile.contents.size());
+    const std::string extension = std::filesystem::path(sourceFile.filepath).extension().string();
+
+    std::vector<CookedSection> cookedSections;
+    if (extension == ".gltf") {
+        cookedSections.push_back({asset_cache_format::SectionKind::gltfJson, {}, sourceFile.stamp, sourceContents});
+    } else if (const std::optional<GlbChunks> o_glbChunks = extension == ".glb" ? splitGlb(sourceContents) : std::nullopt) {
+        cookedSections.push_back({asset_cache_format::SectionKind::gltfJson, {}, sourceFile.stamp, o_glbChunks->json});
+        cookedSections.push_back({asset_cache_format::SectionKind::gltfBinaryChunk, {}, sourceFile.stamp, o_glbChunks->binary});
+    } else {
+        cookedSections.push_back({asset_cache_format::SectionKind::sourceFile, {}, sourceFile.stamp, sourceContents});
+    }
+    for (std::size_t i = 1; i < sources.files.size(); ++i) {
+        const SourceFile& externalFile = sources.files[i];
+        cookedSections.push_back({asset_cache_format::SectionKind::externalResource, externalFile.filepath, externalFile.stamp, {externalFile.contents.data(), externalFile.contents.size()}});
+    }
+
+    const asset_cache_format::Header header {
+        asset_cache_format::magic,
+        asset_cache_format::version,
+        0,
+        static_cast<uint32_t>(cookedSections.size()),
+        static_cast<uint32_t>(sourceFile.filepath.size()),
+        sourceFile.stamp,
+        sources.contentHash
+    };
+
+    // Lay everything out before writing so the section table can be written in one go
+    const uint64_t sectionTableOffset = asset_cache_format::alignUp(sizeof(asset_cache_format::Header) + sourceFile.filepath.size());
+    uint64_t offset = sectionTableOffset + cookedSections.size() * sizeof(asset_cache_format::SectionEntry);
+    std::vector<asset_cache_format::SectionEntry> sectionEntries;
+    sectionEntries.reserve(cookedSections.size());
+    for (const CookedSection& cookedSection : cookedSections) {
+        const uint64_t nameOffset = asset_cache_format::alignUp(offset);
+        const uint64_t dataOffset = asset_cache_format::alignUp(nameOffset + cookedSection.name.size());
+        sectionEntries.push_back({
+            cookedSection.kind,
+            static_cast<uint32_t>(cookedSection.name.size()),
+            cookedSection.sourceStamp,
+            nameOffset,
+            dataOffset,
+            cookedSection.data.size()
+        });
+        offset = dataOffset + cookedSection.data.size();
+    }
+
+    // Write to a temporary file and move it into place so a crash or a concurrent launch never sees half of it
+    const std::string temporaryFilepath = fmt::format("{}.{:x}.tmp", cookedFilepath, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream outputStream(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        uint64_t writtenByteCount = 0;
+        const auto writeAt = [&] (const uint64_t writeOffset, const void* p_bytes, const uint64_t byteCount) {
+            static constexpr std::array<char, asset_cache_format::alignment> padding {};
+            outputStream.write(padding.data(), static_cast<std::streamsize>(writeOffset - writtenByteCount));
+            outputStream.write(static_cast<const char*>(p_bytes), static_cast<std::streamsize>(byteCount));
+            writtenByteCount = writeOffset + byteCount;
+        };
+
+        writeAt(0, &header, sizeof(header));
+        writeAt(sizeof(header), sourceFile.filepath.data(), sourceFile.filepath.size());
+        writeAt(sectionTableOffset, sectionEntries.data(), sectionEntries.size() * sizeof(asset_cache_format::SectionEntry));
+        for (std::size_t i = 0; i < cookedSections.size(); ++i) {
+            writeAt(sectionEntries[i].nameOffset, cookedSections[i].name.data(), cookedSections[i].name.size());
+            writeAt(sectionEntries[i].dataOffset, cookedSections[i].data.data(), cookedSections[i].data.size());
+        }
+
+        if (!outputStream) {
+            std::error_code errorCode;
+            std::filesystem::remove(temporaryFilepath, errorCode);
+            return false;
+        }
+    }
+
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryFilepath, cookedFilepath, errorCode);
+    if (errorCode) {
+        LOG_WARNINGthis("Failed to move {} into place: {}", cookedFilepath, errorCode.message());
+        std::filesystem::remove(temporaryFilepath, errorCode);
+        return false;
+    }
+
+    LOG_TRACEthis("Cooked {} into {} sections ( {} bytes )", sourceFile.filepath, cookedSections.size(), offset);
+    return true;
+}
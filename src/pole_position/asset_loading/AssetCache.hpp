@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/asset_loading/AssetCacheFormat.hpp"
+#include "pole_position/asset_loading/MappedFile.hpp"
+#include "pole_position/asset_loading/ResourceCache.hpp"
+
+/**
+ * @brief Cooks source assets into single binary blobs on first use and maps those blobs on every use after that.
+ * A .glb is split into its json and binary chunks, and a .gltf is stored together with every buffer and image it
+ * references, so loading an asset is one mapping no matter how many files it came from. Cooked assets are keyed
+ * by their source filepath and recooked automatically when their sources' contents change
+ */
+class AssetCache {
+public: // classes and enums
+    struct Section {
+        asset_cache_format::SectionKind kind;
+        std::string_view name;
+        asset_cache_format::FileStamp sourceStamp;
+        std::string_view data;
+    };
+
+    /**
+     * @brief A mapped cooked asset. The sections view straight into the mapping, so they live as long as this does
+     */
+    class CachedAsset {
+    public: // member functions
+        CachedAsset(MappedFile&& mappedFile, const asset_cache_format::Header& header, std::vector<Section>&& sections);
+        CachedAsset(const CachedAsset& other) = delete;
+        CachedAsset& operator=(const CachedAsset& other) = delete;
+
+        uint64_t getContentHash() const { return m_header.contentHash; }
+        const asset_cache_format::FileStamp& getSourceStamp() const { return m_header.sourceStamp; }
+        uint64_t getByteCount() const { return m_mappedFile.getByteCount(); }
+        const std::vector<Section>& getSections() const { return m_sections; }
+        const Section* findSection(const asset_cache_format::SectionKind kind, const std::string_view name = {}) const;
+
+        void prefetch() const { m_mappedFile.prefetch(); }
+
+    private: // member variables
+        MappedFile m_mappedFile;
+        asset_cache_format::Header m_header;
+        std::vector<Section> m_sections;
+    };
+
+    struct Statistics {
+        uint64_t freshCount;
+        uint64_t cookCount;
+        uint64_t staleCount;
+        uint64_t failureCount;
+    };
+
+public: // member functions
+    explicit AssetCache(const std::string& directory);
+    AssetCache(const AssetCache& other) = delete;
+    AssetCache& operator=(const AssetCache& other) = delete;
+
+    /**
+     * @brief Map the cooked form of the asset, cooking it first if it has never been cooked or its sources
+     * changed. Everything loading the same asset shares one mapping for as long as any of them holds on to it.
+     * Safe to call from several threads at once. Null if the asset cannot be read
+     */
+    std::shared_ptr<const CachedAsset> load(const std::string& sourceFilepath);
+
+    std::string getCookedFilepath(const std::string& sourceFilepath) const;
+    Statistics getStatistics() const;
+    ResourceCache<CachedAsset>::Statistics getResidentStatistics() const { return m_residentAssets.getStatistics(); }
+
+    USE_LOGGER(ASSET_LOADING);
+
+private: // classes and enums
+    struct SourceFile {
+        std::string filepath;
+        asset_cache_format::FileStamp stamp;
+        std::vector<char> contents;
+    };
+
+    /**
+     * @brief Everything an asset is cooked from: the source itself followed by every file it references
+     */
+    struct Sources {
+        std::vector<SourceFile> files;
+        uint64_t contentHash;
+    };
+
+private: // helpers
+    static std::optional<asset_cache_format::FileStamp> getFileStamp(const std::string& filepath);
+    static std::optional<SourceFile> readSourceFile(const std::string& filepath);
+    static std::optional<Sources> readSources(const std::string& sourceFilepath);
+
+    /**
+     * @brief The header and sections of a mapped cooked asset, or nothing if it is corrupt or for another source
+     */
+    static std::shared_ptr<const CachedAsset> parseCookedAsset(MappedFile&& mappedFile, const std::string& sourceFilepath);
+
+    static bool isStampFresh(const CachedAsset& cachedAsset, const std::string& sourceFilepath);
+
+private: // member functions
+    std::shared_ptr<const CachedAsset> loadUncached(const std::string& sourceFilepath);
+    bool cook(const Sources& sources, const std::string& cookedFilepath);
+
+private: // member variables
+    std::string m_directory;
+    std::atomic<uint64_t> m_freshCount;
+    std::atomic<uint64_t> m_cookCount;
+    std::atomic<uint64_t> m_staleCount;
+    std::atomic<uint64_t> m_failureCount;
+    ResourceCache<CachedAsset> m_residentAssets;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief The layout of a cooked asset in the asset cache.
+ *
+ * A cooked asset is a header, the source filepath, a table of sections and then each section's name and data.
+ * The section table, the names and the data all start on an alignment boundary so they can be used straight
+ * out of the mapping:
+ *
+ *   Header | source filepath | SectionEntry[sectionCount] | name 0 | data 0 | name 1 | data 1 | ...
+ *
+ * The header and every section remember the size and modification time of the file they were cooked from, which
+ * is enough to tell that a cooked asset is still fresh without reading its sources. When a stamp does not match
+ * the sources are hashed and compared against the content hash before deciding to cook again
+ */
+namespace asset_cache_format {
+
+constexpr std::array<char, 4> magic = {'P', 'P', 'A', 'C'};
+constexpr uint16_t version = 1;
+
+constexpr uint64_t alignment = 16;
+
+enum class SectionKind : uint32_t {
+    sourceFile = 0,         // the bytes of a source we do not know how to split up
+    gltfJson = 1,           // the json document of a .gltf, or the json chunk of a .glb
+    gltfBinaryChunk = 2,    // the binary chunk of a .glb
+    externalResource = 3    // a buffer or image referenced by the json, named by its absolute filepath
+};
+
+struct FileStamp {
+    uint64_t byteCount;
+    int64_t modificationTime;
+
+    bool operator==(const FileStamp& other) const { return byteCount == other.byteCount && modificationTime == other.modificationTime; }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+struct Header {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t sectionCount;
+    uint32_t sourceFilepathByteCount;
+    FileStamp sourceStamp;
+    uint64_t contentHash;
+};
+static_assert(sizeof(Header) == 40);
+
+struct SectionEntry {
+    SectionKind kind;
+    uint32_t nameByteCount;
+    FileStamp sourceStamp;
+    uint64_t nameOffset;
+    uint64_t dataOffset;
+    uint64_t dataByteCount;
+};
+static_assert(sizeof(SectionEntry) == 48);
+
+constexpr uint64_t
+alignUp(
+    const uint64_t offset
+) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace asset_cache_format
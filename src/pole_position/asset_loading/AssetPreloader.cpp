@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/scene/doodad/Doodad.hpp"
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/asset_loading/AssetCache.hpp"
+#include "pole_position/asset_loading/AssetCacheFormat.hpp"
+#include "pole_position/asset_loading/AssetPreloader.hpp"
+#include "pole_position/asset_loading/Gltf.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+
+std::vector<std::string>
+AssetPreloader::getSceneAssetFilepaths(
+    const quartz::scene::Scene::Parameters& sceneParameters
+) {
+    std::vector<std::string> filepaths;
+    filepaths.reserve(sceneParameters.doodadParameters.size() + sceneParameters.skyBoxInformation.size());
+
+    for (const quartz::scene::Doodad::Parameters& doodadParameters : sceneParameters.doodadParameters) {
+        filepaths.push_back(doodadParameters.objectFilepath);
+    }
+    for (const std::string& skyBoxFilepath : sceneParameters.skyBoxInformation) {
+        filepaths.push_back(skyBoxFilepath);
+    }
+
+    return filepaths;
+}
+
+AssetPreloader::AssetPreloader(
+    const uint32_t workerCount
+) :
+    mp_assetCache(nullptr),
+    m_mutex(),
+    m_jobAvailableCondition(),
+    m_idleCondition(),
+    m_jobs(),
+    m_seenFilepaths(),
+    m_inFlightJobCount(0),
+    m_isStopping(false),
+    m_hasLoggedTimings(false),
+    m_firstEnqueueTime(),
+    m_assetTimings(),
+    m_cachedAssets(),
+    m_workers()
+{
+    LOG_FUNCTION_SCOPE_TRACEthis("{} workers", workerCount);
+
+    m_workers.reserve(std::max(workerCount, 1u));
+    for (uint32_t i = 0; i < std::max(workerCount, 1u); ++i) {
+        m_workers.emplace_back(&AssetPreloader::workerLoop, this);
+    }
+}
+
+AssetPreloader::~AssetPreloader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_jobAvailableCondition.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void
+AssetPreloader::enqueue(
+    const std::string& filepath
+) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        this->enqueueLocked(filepath);
+    }
+    m_jobAvailableCondition.notify_one();
+}
+
+void
+AssetPreloader::enqueueScene(
+    const quartz::scene::Scene::Parameters& sceneParameters
+) {
+    const std::vector<std::string> filepaths = AssetPreloader::getSceneAssetFilepaths(sceneParameters);
+    LOG_TRACEthis("Enqueueing {} assets of scene {}", filepaths.size(), sceneParameters.name);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const std::string& filepath : filepaths) {
+            this->enqueueLocked(filepath);
+        }
+    }
+    m_jobAvailableCondition.notify_all();
+}
+
+std::vector<AssetPreloader::AssetTiming>
+AssetPreloader::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return m_jobs.empty() && m_inFlightJobCount == 0; });
+    return m_assetTimings;
+}
+
+bool
+AssetPreloader::waitFor(
+    const std::chrono::milliseconds timeout
+) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_idleCondition.wait_for(lock, timeout, [this] { return m_jobs.empty() && m_inFlightJobCount == 0; });
+}
+
+AssetPreloader::Progress
+AssetPreloader::getProgress() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return {m_assetTimings.size(), m_seenFilepaths.size()};
+}
+
+std::shared_ptr<const AssetCache::CachedAsset>
+AssetPreloader::getCachedAsset(
+    const std::string& filepath
+) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto cachedAssetIterator = m_cachedAssets.find(filepath);
+    return cachedAssetIterator != m_cachedAssets.end() ? cachedAssetIterator->second : nullptr;
+}
+
+void
+AssetPreloader::enqueueLocked(
+    const std::string& filepath
+) {
+    // Doodads share models, so only the first reference to a file gets read
+    if (!m_seenFilepaths.insert(filepath).second) {
+        return;
+    }
+
+    const Clock::time_point now = Clock::now();
+    if (m_seenFilepaths.size() == 1) {
+        m_firstEnqueueTime = now;
+    }
+
+    m_jobs.push_back({filepath, now});
+    m_hasLoggedTimings = false;
+}
+
+void
+AssetPreloader::workerLoop() {
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Assets);
+
+    std::vector<char> readBuffer;
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailableCondition.wait(lock, [this] { return m_isStopping || !m_jobs.empty(); });
+            if (m_isStopping) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            ++m_inFlightJobCount;
+        }
+
+        AssetTiming assetTiming = mp_assetCache ? this->loadCachedAsset(job) : this->loadAsset(job, readBuffer);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_assetTimings.push_back(std::move(assetTiming));
+        --m_inFlightJobCount;
+
+        if (m_jobs.empty() && m_inFlightJobCount == 0) {
+            if (!m_hasLoggedTimings) {
+                this->logTimings();
+                m_hasLoggedTimings = true;
+            }
+            m_idleCondition.notify_all();
+        }
+    }
+}
+
+AssetPreloader::AssetTiming
+AssetPreloader::loadAsset(
+    const Job& job,
+    std::vector<char>& readBuffer
+) {
+    PROFILE_SCOPE("Asset preload");
+
+    const Clock::time_point readStartTime = Clock::now();
+    AssetTiming assetTiming {
+        job.filepath,
+        0,
+        0,
+        std::chrono::duration<double, std::milli>(readStartTime - job.enqueueTime).count(),
+        0.0,
+        0.0
+    };
+
+    std::ifstream inputStream(job.filepath, std::ios::binary | std::ios::ate);
+    if (!inputStream) {
+        LOG_WARNINGthis("Failed to open {}", job.filepath);
+        return assetTiming;
+    }
+
+    const std::streamsize byteCount = inputStream.tellg();
+    inputStream.seekg(0);
+    readBuffer.resize(static_cast<std::size_t>(std::max<std::streamsize>(byteCount, 0)));
+    if (!inputStream.read(readBuffer.data(), byteCount)) {
+        LOG_WARNINGthis("Failed to read {}", job.filepath);
+        return assetTiming;
+    }
+
+    const Clock::time_point readEndTime = Clock::now();
+    assetTiming.byteCount = static_cast<uint64_t>(byteCount);
+    assetTiming.readMilliseconds = std::chrono::duration<double, std::milli>(readEndTime - readStartTime).count();
+
+    if (std::filesystem::path(job.filepath).extension() == ".gltf") {
+        const std::vector<std::string> dependencyFilepaths = getGltfExternalFilepaths(job.filepath, std::string_view(readBuffer.data(), readBuffer.size()));
+        assetTiming.dependencyCount = static_cast<uint32_t>(dependencyFilepaths.size());
+        assetTiming.parseMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - readEndTime).count();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const std::string& dependencyFilepath : dependencyFilepaths) {
+                this->enqueueLocked(dependencyFilepath);
+            }
+        }
+        m_jobAvailableCondition.notify_all();
+    }
+
+    return assetTiming;
+}
+
+AssetPreloader::AssetTiming
+AssetPreloader::loadCachedAsset(
+    const Job& job
+) {
+    PROFILE_SCOPE("Asset preload from cache");
+
+    const Clock::time_point loadStartTime = Clock::now();
+    AssetTiming assetTiming {
+        job.filepath,
+        0,
+        0,
+        std::chrono::duration<double, std::milli>(loadStartTime - job.enqueueTime).count(),
+        0.0,
+        0.0
+    };
+
+    // Everything the asset references was cooked into it, so there is nothing else to enqueue
+    std::shared_ptr<const AssetCache::CachedAsset> p_cachedAsset = mp_assetCache->load(job.filepath);
+    if (!p_cachedAsset) {
+        return assetTiming;
+    }
+    p_cachedAsset->prefetch();
+
+    assetTiming.byteCount = p_cachedAsset->getByteCount();
+    assetTiming.dependencyCount = static_cast<uint32_t>(std::count_if(
+        p_cachedAsset->getSections().begin(),
+        p_cachedAsset->getSections().end(),
+        [] (const AssetCache::Section& section) { return section.kind == asset_cache_format::SectionKind::externalResource; }
+    ));
+    assetTiming.readMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - loadStartTime).count();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cachedAssets.emplace(job.filepath, std::move(p_cachedAsset));
+
+    return assetTiming;
+}
+
+void
+AssetPreloader::logTimings() const {
+    std::vector<const AssetTiming*> sortedAssetTimings;
+    sortedAssetTimings.reserve(m_assetTimings.size());
+    uint64_t totalByteCount = 0;
+    double totalWorkMilliseconds = 0.0;
+    for (const AssetTiming& assetTiming : m_assetTimings) {
+        sortedAssetTimings.push_back(&assetTiming);
+        totalByteCount += assetTiming.byteCount;
+        totalWorkMilliseconds += assetTiming.readMilliseconds + assetTiming.parseMilliseconds;
+    }
+    std::sort(sortedAssetTimings.begin(), sortedAssetTimings.end(), [] (const AssetTiming* p_a, const AssetTiming* p_b) { return p_a->readMilliseconds + p_a->parseMilliseconds > p_b->readMilliseconds + p_b->parseMilliseconds; });
+
+    const double wallMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - m_firstEnqueueTime).count();
+    LOG_INFOthis("Preloaded {} assets ( {:.2f} MiB ) in {:.2f} ms with {} workers, {:.2f} ms of work in total", m_assetTimings.size(), totalByteCount / (1024.0 * 1024.0), wallMilliseconds, m_workers.size(), totalWorkMilliseconds);
+    if (mp_assetCache) {
+        const AssetCache::Statistics statistics = mp_assetCache->getStatistics();
+        const ResourceCache<AssetCache::CachedAsset>::Statistics residentStatistics = mp_assetCache->getResidentStatistics();
+        LOG_INFOthis("Asset cache: {} fresh, {} cooked ( {} of them stale ), {} failed", statistics.freshCount, statistics.cookCount, statistics.staleCount, statistics.failureCount);
+        LOG_INFOthis("Asset cache: {} loads, {} assets resident ( {:.2f} MiB )", residentStatistics.loadCount, residentStatistics.residentCount, residentStatistics.residentByteCount / (1024.0 * 1024.0));
+    }
+    for (const AssetTiming* p_assetTiming : sortedAssetTimings) {
+        LOG_INFOthis("  {:>10} bytes  queued {:>8.2f} ms  read {:>8.2f} ms  parse {:>6.2f} ms  {} dependencies  {}", p_assetTiming->byteCount, p_assetTiming->queuedMilliseconds, p_assetTiming->readMilliseconds, p_assetTiming->parseMilliseconds, p_assetTiming->dependencyCount, p_assetTiming->filepath);
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/asset_loading/AssetCache.hpp"
+
+/**
+ * @brief Reads a scene's assets from disk across a pool of worker threads while the application is still
+ * creating its window and device, so quartz decodes them from the page cache instead of waiting on the disk one
+ * file at a time. glTF files are parsed for the external buffers and images they reference, which are read too.
+ * Logs how long each asset took once everything has been read.
+ *
+ * Given an AssetCache, assets are mapped from the cache instead, cooking the ones that are missing or stale
+ */
+class AssetPreloader {
+public: // classes and enums
+    struct AssetTiming {
+        std::string filepath;
+        uint64_t byteCount;
+        uint32_t dependencyCount;
+        double queuedMilliseconds;
+        double readMilliseconds;
+        double parseMilliseconds;
+    };
+
+    /**
+     * @brief Counts over everything ever enqueued, including the files assets reference, which are only enqueued
+     * once the asset referencing them has been read
+     */
+    struct Progress {
+        std::size_t loadedCount;
+        std::size_t enqueuedCount;
+    };
+
+public: // member functions
+    static std::vector<std::string> getSceneAssetFilepaths(const quartz::scene::Scene::Parameters& sceneParameters);
+
+    explicit AssetPreloader(const uint32_t workerCount);
+    AssetPreloader(const AssetPreloader& other) = delete;
+    AssetPreloader& operator=(const AssetPreloader& other) = delete;
+    ~AssetPreloader();
+
+    /**
+     * @brief Must be set before anything is enqueued
+     */
+    void setAssetCache(AssetCache* const p_assetCache) { mp_assetCache = p_assetCache; }
+
+    void enqueue(const std::string& filepath);
+    void enqueueScene(const quartz::scene::Scene::Parameters& sceneParameters);
+
+    /**
+     * @brief Block until every enqueued asset, and everything they reference, has been read
+     */
+    std::vector<AssetTiming> wait();
+
+    /**
+     * @brief Like wait, but gives up after the timeout. Returns whether everything has been read
+     */
+    bool waitFor(const std::chrono::milliseconds timeout);
+
+    Progress getProgress();
+
+    /**
+     * @brief The cached form of an asset once it has been loaded through the AssetCache, null otherwise
+     */
+    std::shared_ptr<const AssetCache::CachedAsset> getCachedAsset(const std::string& filepath);
+
+    USE_LOGGER(ASSET_LOADING);
+
+private: // classes and enums
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        std::string filepath;
+        Clock::time_point enqueueTime;
+    };
+
+private: // member functions
+    void enqueueLocked(const std::string& filepath);
+    void workerLoop();
+    AssetTiming loadAsset(const Job& job, std::vector<char>& readBuffer);
+    AssetTiming loadCachedAsset(const Job& job);
+    void logTimings() const;
+
+private: // member variables
+    AssetCache* mp_assetCache;
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailableCondition;
+    std::condition_variable m_idleCondition;
+    std::deque<Job> m_jobs;
+    std::unordered_set<std::string> m_seenFilepaths;
+    uint32_t m_inFlightJobCount;
+    bool m_isStopping;
+    bool m_hasLoggedTimings;
+    Clock::time_point m_firstEnqueueTime;
+    std::vector<AssetTiming> m_assetTimings;
+    std::unordered_map<std::string, std::shared_ptr<const AssetCache::CachedAsset>> m_cachedAssets;
+    std::vector<std::thread> m_workers;
+};
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pole_position/asset_loading/Gltf.hpp"
+
+namespace {
+
+constexpr uint32_t glbMagic = 0x46546C67; // "glTF"
+constexpr uint32_t glbJsonChunkType = 0x4E4F534A; // "JSON"
+constexpr uint32_t glbBinaryChunkType = 0x004E4942; // "BIN\0"
+constexpr std::size_t glbHeaderSize = 12;
+constexpr std::size_t glbChunkHeaderSize = 8;
+
+uint32_t
+readLittleEndianUint32(
+    const std::string_view contents,
+    const std::size_t offset
+) {
+    const auto* p_bytes = reinterpret_cast<const unsigned char*>(contents.data() + offset);
+    return static_cast<uint32_t>(p_bytes[0]) | (static_cast<uint32_t>(p_bytes[1]) << 8) | (static_cast<uint32_t>(p_bytes[2]) << 16) | (static_cast<uint32_t>(p_bytes[3]) << 24);
+}
+
+int
+getHexDigitValue(
+    const char character
+) {
+    if (character >= '0' && character <= '9') { return character - '0'; }
+    if (character >= 'a' && character <= 'f') { return character - 'a' + 10; }
+    if (character >= 'A' && character <= 'F') { return character - 'A' + 10; }
+    return -1;
+}
+
+/**
+ * @brief glTF uris are percent encoded, so "Cube%20Texture.png" is a file with a space in its name
+ */
+std::string
+decodeUri(
+    const std::string_view uri
+) {
+    std::string decoded;
+    decoded.reserve(uri.size());
+    for (std::size_t i = 0; i < uri.size(); ++i) {
+        if (uri[i] == '%' && i + 2 < uri.size()) {
+            const int high = getHexDigitValue(uri[i + 1]);
+            const int low = getHexDigitValue(uri[i + 2]);
+            if (high >= 0 && low >= 0) {
+                decoded.push_back(static_cast<char>(high * 16 + low));
+                i += 2;
+                continue;
+            }
+        }
+        decoded.push_back(uri[i]);
+    }
+    return decoded;
+}
+
+/**
+ * @brief The array of exactly three numbers that follows a key's colon, if that is what follows it
+ */
+std::optional<std::array<double, 3>>
+readVec3Array(
+    const std::string_view json,
+    std::size_t position
+) {
+    position = json.find_first_not_of(" \t\r\n", position);
+    if (position == std::string_view::npos || json[position] != ':') {
+        return std::nullopt;
+    }
+    position = json.find_first_not_of(" \t\r\n", position + 1);
+    if (position == std::string_view::npos || json[position] != '[') {
+        return std::nullopt;
+    }
+
+    std::array<double, 3> values {};
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        position = json.find_first_not_of(" \t\r\n", position + 1);
+        if (position == std::string_view::npos) {
+            return std::nullopt;
+        }
+
+        const std::from_chars_result result = std::from_chars(json.data() + position, json.data() + json.size(), values[i]);
+        if (result.ec != std::errc()) {
+            return std::nullopt;
+        }
+        position = json.find_first_not_of(" \t\r\n", static_cast<std::size_t>(result.ptr - json.data()));
+        if (position == std::string_view::npos || json[position] != (i + 1 < values.size() ? ',' : ']')) {
+            return std::nullopt;
+        }
+    }
+
+    return values;
+}
+
+} // namespace
+
+std::optional<GlbChunks>
+splitGlb(
+    const std::string_view contents
+) {
+    if (contents.size() < glbHeaderSize || readLittleEndianUint32(contents, 0) != glbMagic) {
+        return std::nullopt;
+    }
+
+    GlbChunks glbChunks {};
+    std::size_t offset = glbHeaderSize;
+    while (offset + glbChunkHeaderSize <= contents.size()) {
+        const uint32_t chunkByteCount = readLittleEndianUint32(contents, offset);
+        const uint32_t chunkType = readLittleEndianUint32(contents, offset + 4);
+        offset += glbChunkHeaderSize;
+        if (offset + chunkByteCount > contents.size()) {
+            return std::nullopt;
+        }
+
+        if (chunkType == glbJsonChunkType) {
+            glbChunks.json = contents.substr(offset, chunkByteCount);
+        } else if (chunkType == glbBinaryChunkType) {
+            glbChunks.binary = contents.substr(offset, chunkByteCount);
+        }
+
+        offset += chunkByteCount;
+    }
+
+    if (glbChunks.json.empty()) {
+        return std::nullopt;
+    }
+
+    return glbChunks;
+}
+
+std::vector<std::string>
+getGltfExternalFilepaths(
+    const std::string& gltfFilepath,
+    const std::string_view json
+) {
+    // Every external buffer and image in a glTF is referenced through a "uri" string, which is all we need, so
+    // scan for those instead of parsing the whole document
+    const std::filesystem::path directory = std::filesystem::path(gltfFilepath).parent_path();
+    constexpr std::string_view uriKey = "\"uri\"";
+
+    std::vector<std::string> externalFilepaths;
+    for (std::size_t keyPosition = json.find(uriKey); keyPosition != std::string_view::npos; keyPosition = json.find(uriKey, keyPosition + uriKey.size())) {
+        const std::size_t colonPosition = json.find_first_not_of(" \t\r\n", keyPosition + uriKey.size());
+        if (colonPosition == std::string_view::npos || json[colonPosition] != ':') {
+            continue;
+        }
+        const std::size_t openingQuotePosition = json.find_first_not_of(" \t\r\n", colonPosition + 1);
+        if (openingQuotePosition == std::string_view::npos || json[openingQuotePosition] != '"') {
+            continue;
+        }
+        const std::size_t closingQuotePosition = json.find('"', openingQuotePosition + 1);
+        if (closingQuotePosition == std::string_view::npos) {
+            break;
+        }
+
+        const std::string_view uri = json.substr(openingQuotePosition + 1, closingQuotePosition - openingQuotePosition - 1);
+        if (uri.empty() || uri.substr(0, 5) == "data:") {
+            continue;
+        }
+
+        externalFilepaths.push_back((directory / decodeUri(uri)).lexically_normal().string());
+    }
+
+    return externalFilepaths;
+}
+
+std::optional<GltfBounds>
+getGltfBounds(
+    const std::string_view json
+) {
+    // glTF requires min and max on every position accessor, so like the uris they can be scanned for. Other three
+    // component accessors with bounds are normals and colors, which sit inside of [-1, 1] and only ever make the
+    // box a little bigger than it has to be
+    constexpr std::string_view minKey = "\"min\"";
+    constexpr std::string_view maxKey = "\"max\"";
+
+    std::optional<GltfBounds> o_bounds;
+    const auto mergeBounds = [&o_bounds] (const std::array<double, 3>& point) {
+        if (!o_bounds) {
+            o_bounds = GltfBounds {point, point};
+            return;
+        }
+        for (std::size_t i = 0; i < point.size(); ++i) {
+            o_bounds->min[i] = std::min(o_bounds->min[i], point[i]);
+            o_bounds->max[i] = std::max(o_bounds->max[i], point[i]);
+        }
+    };
+
+    for (const std::string_view key : {minKey, maxKey}) {
+        for (std::size_t keyPosition = json.find(key); keyPosition != std::string_view::npos; keyPosition = json.find(key, keyPosition + key.size())) {
+            if (const std::optional<std::array<double, 3>> o_point = readVec3Array(json, keyPosition + key.size())) {
+                mergeBounds(*o_point);
+            }
+        }
+    }
+
+    return o_bounds;
+}
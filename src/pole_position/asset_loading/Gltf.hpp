@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The JSON and binary chunks of a .glb container. Both view into the container's bytes
+ */
+struct GlbChunks {
+    std::string_view json;
+    std::string_view binary;
+};
+
+std::optional<GlbChunks> splitGlb(const std::string_view contents);
+
+/**
+ * @brief The absolute filepaths of the buffers and images a glTF document references through uris. Embedded
+ * base64 data uris are skipped because there is nothing on disk to read for them
+ */
+std::vector<std::string> getGltfExternalFilepaths(const std::string& gltfFilepath, const std::string_view json);
+
+/**
+ * @brief The box around every vertex of a glTF document, in the model's own space
+ */
+struct GltfBounds {
+    std::array<double, 3> min;
+    std::array<double, 3> max;
+};
+
+/**
+ * @brief Empty if the document has no three component accessor bounds. Node transforms are not applied, so this is
+ * only right for models authored around their origin, which is how every model we ship is
+ */
+std::optional<GltfBounds> getGltfBounds(const std::string_view json);
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pole_position/asset_loading/MappedFile.hpp"
+
+MappedFile::MappedFile(
+    const std::string& filepath
+) :
+    mp_data(nullptr),
+    m_byteCount(0)
+{
+    const int fileDescriptor = open(filepath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Failed to open " + filepath + ": " + std::strerror(errno));
+    }
+
+    struct stat fileStatus {};
+    if (fstat(fileDescriptor, &fileStatus) != 0) {
+        const std::string error = std::strerror(errno);
+        close(fileDescriptor);
+        throw std::runtime_error("Failed to stat " + filepath + ": " + error);
+    }
+    m_byteCount = static_cast<std::size_t>(fileStatus.st_size);
+
+    // mmap refuses empty mappings, and there is nothing to map anyways
+    if (m_byteCount > 0) {
+        void* const p_data = mmap(nullptr, m_byteCount, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (p_data == MAP_FAILED) {
+            const std::string error = std::strerror(errno);
+            close(fileDescriptor);
+            throw std::runtime_error("Failed to map " + filepath + ": " + error);
+        }
+        mp_data = p_data;
+    }
+
+    // The mapping keeps its own reference to the file
+    close(fileDescriptor);
+}
+
+MappedFile::MappedFile(
+    MappedFile&& other
+) noexcept :
+    mp_data(std::exchange(other.mp_data, nullptr)),
+    m_byteCount(std::exchange(other.m_byteCount, 0))
+{}
+
+MappedFile&
+MappedFile::operator=(
+    MappedFile&& other
+) noexcept {
+    if (this != &other) {
+        this->unmap();
+        mp_data = std::exchange(other.mp_data, nullptr);
+        m_byteCount = std::exchange(other.m_byteCount, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    this->unmap();
+}
+
+void
+MappedFile::prefetch() const {
+    if (mp_data) {
+        madvise(mp_data, m_byteCount, MADV_WILLNEED);
+    }
+}
+
+void
+MappedFile::prefetch(
+    const std::size_t offset,
+    const std::size_t byteCount
+) const {
+    if (!mp_data || offset >= m_byteCount) {
+        return;
+    }
+
+    const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t firstByte = offset / pageSize * pageSize;
+    const std::size_t endByte = std::min(offset + byteCount, m_byteCount);
+    madvise(static_cast<char*>(mp_data) + firstByte, endByte - firstByte, MADV_WILLNEED);
+}
+
+void
+MappedFile::evict(
+    const std::size_t offset,
+    const std::size_t byteCount
+) const {
+    if (!mp_data) {
+        return;
+    }
+
+    // The last page of the file may be partial, so the range may end at the end of the file instead of a page
+    const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t firstByte = (offset + pageSize - 1) / pageSize * pageSize;
+    const std::size_t endByte = offset + byteCount >= m_byteCount ? m_byteCount : (offset + byteCount) / pageSize * pageSize;
+    if (firstByte >= endByte) {
+        return;
+    }
+
+    madvise(static_cast<char*>(mp_data) + firstByte, endByte - firstByte, MADV_DONTNEED);
+}
+
+void
+MappedFile::unmap() {
+    if (mp_data) {
+        munmap(mp_data, m_byteCount);
+        mp_data = nullptr;
+        m_byteCount = 0;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief A read only memory mapping of a whole file, unmapped when destroyed
+ */
+class MappedFile {
+public: // member functions
+    /**
+     * @brief Throws if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& filepath);
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    std::string_view getContents() const { return {static_cast<const char*>(mp_data), m_byteCount}; }
+    std::size_t getByteCount() const { return m_byteCount; }
+
+    /**
+     * @brief Ask the kernel to start paging the whole file in, so the first reads do not fault one page at a time
+     */
+    void prefetch() const;
+
+    /**
+     * @brief The same for a range of the file, widened to whole pages
+     */
+    void prefetch(const std::size_t offset, const std::size_t byteCount) const;
+
+    /**
+     * @brief Let the kernel drop the pages of a range of the file, narrowed to the pages that lie entirely inside
+     * of it so that nothing around it is dropped. They are read from the file again when they are next touched
+     */
+    void evict(const std::size_t offset, const std::size_t byteCount) const;
+
+private: // member functions
+    void unmap();
+
+private: // member variables
+    void* mp_data;
+    std::size_t m_byteCount;
+};
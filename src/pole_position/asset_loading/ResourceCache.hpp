@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+
+#include "util/macros.hpp"
+
+#include "pole_position/memory/MemoryTracker.hpp"
+
+/**
+ * @brief Shares loaded resources between everything that asks for the same file. Resources are keyed by their
+ * resolved filepath, so "a/../b.glb" and "b.glb" are one resource, and live for as long as anything holds on to
+ * them. Safe to use from several threads; when two threads miss on the same resource at once, one loads it and
+ * the other waits for it. If the load throws, the waiting threads get the same exception and the next acquire tries
+ * again. The bytes each resource keeps resident are accounted to it in the MemoryTracker
+ */
+template <typename Resource>
+class ResourceCache {
+public: // classes and enums
+    struct Statistics {
+        uint64_t loadCount;
+        uint64_t residentCount;
+        uint64_t residentByteCount;
+    };
+
+    /**
+     * @brief Loads the resource at the given filepath and reports how many bytes it keeps resident, or returns
+     * null if it cannot be loaded
+     */
+    using Loader = std::function<std::shared_ptr<const Resource>(const std::string& filepath, uint64_t& byteCount)>;
+
+public: // member functions
+    ResourceCache() : mp_state(std::make_shared<State>()) {}
+    ResourceCache(const ResourceCache& other) = delete;
+    ResourceCache& operator=(const ResourceCache& other) = delete;
+
+    static std::string resolveFilepath(const std::string& filepath);
+
+    std::shared_ptr<const Resource> acquire(const std::string& filepath, const Loader& loader);
+    Statistics getStatistics() const;
+
+private: // classes and enums
+    struct Entry {
+        std::weak_ptr<const Resource> p_resource;
+        std::shared_future<std::shared_ptr<const Resource>> o_loading;
+    };
+
+    /**
+     * @brief Shared with the deleters of the handed out resources, which may outlive the cache
+     */
+    struct State {
+        std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        Statistics statistics {};
+    };
+
+private: // member variables
+    std::shared_ptr<State> mp_state;
+};
+
+template <typename Resource>
+std::string
+ResourceCache<Resource>::resolveFilepath(
+    const std::string& filepath
+) {
+    std::error_code errorCode;
+    const std::filesystem::path resolvedFilepath = std::filesystem::weakly_canonical(filepath, errorCode);
+    return errorCode ? std::filesystem::path(filepath).lexically_normal().string() : resolvedFilepath.string();
+}
+
+template <typename Resource>
+std::shared_ptr<const Resource>
+ResourceCache<Resource>::acquire(
+    const std::string& filepath,
+    const Loader& loader
+) {
+    const std::string resolvedFilepath = ResourceCache::resolveFilepath(filepath);
+
+    std::promise<std::shared_ptr<const Resource>> loadingPromise;
+    {
+        std::unique_lock<std::mutex> lock(mp_state->mutex);
+        Entry& entry = mp_state->entries[resolvedFilepath];
+
+        if (std::shared_ptr<const Resource> p_resource = entry.p_resource.lock()) {
+            return p_resource;
+        }
+
+        if (entry.o_loading.valid()) {
+            const std::shared_future<std::shared_ptr<const Resource>> loading = entry.o_loading;
+            lock.unlock();
+            return loading.get();
+        }
+
+        ++mp_state->statistics.loadCount;
+        entry.o_loading = loadingPromise.get_future().share();
+    }
+
+    uint64_t byteCount = 0;
+    std::shared_ptr<const Resource> p_loadedResource;
+    try {
+        p_loadedResource = loader(resolvedFilepath, byteCount);
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mp_state->mutex);
+            mp_state->entries.erase(resolvedFilepath);
+        }
+        loadingPromise.set_exception(std::current_exception());
+        throw;
+    }
+
+    // Wrap the resource so the cache finds out when the last holder lets go of it
+    std::shared_ptr<const Resource> p_resource;
+    if (p_loadedResource) {
+        p_resource = std::shared_ptr<const Resource>(
+            p_loadedResource.get(),
+            [p_state = mp_state, p_loadedResource, resolvedFilepath, byteCount] (UNUSED const Resource* p_released) mutable {
+                MemoryTracker::recordAssetRelease(resolvedFilepath, byteCount);
+
+                std::lock_guard<std::mutex> lock(p_state->mutex);
+                --p_state->statistics.residentCount;
+                p_state->statistics.residentByteCount -= byteCount;
+
+                const auto entryIterator = p_state->entries.find(resolvedFilepath);
+                if (entryIterator != p_state->entries.end() && entryIterator->second.p_resource.expired() && !entryIterator->second.o_loading.valid()) {
+                    p_state->entries.erase(entryIterator);
+                }
+                p_loadedResource.reset();
+            }
+        );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mp_state->mutex);
+        Entry& entry = mp_state->entries[resolvedFilepath];
+        entry.p_resource = p_resource;
+        entry.o_loading = {};
+        if (p_resource) {
+            ++mp_state->statistics.residentCount;
+            mp_state->statistics.residentByteCount += byteCount;
+        } else {
+            mp_state->entries.erase(resolvedFilepath);
+        }
+    }
+    if (p_resource) {
+        MemoryTracker::recordAssetAllocation(resolvedFilepath, byteCount);
+    }
+    loadingPromise.set_value(p_resource);
+
+    return p_resource;
+}
+
+template <typename Resource>
+typename ResourceCache<Resource>::Statistics
+ResourceCache<Resource>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mp_state->mutex);
+    return mp_state->statistics;
+}
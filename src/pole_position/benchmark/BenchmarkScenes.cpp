@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "quartz/physics/field/Field.hpp"
+#include "quartz/physics/rigid_body/RigidBody.hpp"
+#include "quartz/scene/doodad/Doodad.hpp"
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/benchmark/BenchmarkScenes.hpp"
+#include "pole_position/scene/SceneParameters.hpp"
+#include "pole_position/vehicle/VehicleAiSystem.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+quartz::scene::Scene::Parameters
+createBenchmarkSceneParameters(
+    const std::size_t rigidBodyCount
+) {
+    constexpr double gridSpacing = 4.0;
+    constexpr double staticHeight = 1.0;
+    constexpr double dynamicDropHeight = 6.0;
+
+    const std::vector<quartz::scene::Doodad::Parameters> objectTemplates = createObjectsDoodadParameter();
+    std::vector<quartz::scene::Doodad::Parameters> terrainDoodadParameters = createTerrainDoodadParameter();
+
+    const std::size_t gridSideLength = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(rigidBodyCount))));
+    const double gridHalfWidth = gridSideLength * gridSpacing * 0.5;
+
+    std::vector<quartz::scene::Doodad::Parameters> doodadParameters;
+    doodadParameters.reserve(rigidBodyCount + terrainDoodadParameters.size());
+
+    for (std::size_t i = 0; i < rigidBodyCount; ++i) {
+        const std::size_t row = i / gridSideLength;
+        const std::size_t column = i % gridSideLength;
+        const bool isDynamic = row % 2 == 1;
+
+        quartz::scene::Doodad::Parameters parameters = objectTemplates[i % objectTemplates.size()];
+        parameters.transform.position = math::Vec3(
+            column * gridSpacing - gridHalfWidth,
+            isDynamic ? dynamicDropHeight : staticHeight,
+            row * gridSpacing - gridHalfWidth
+        );
+        parameters.transform.scale = math::Vec3(1.0, 1.0, 1.0);
+        parameters.o_rigidBodyParameters->bodyType = isDynamic ?
+            quartz::physics::RigidBody::BodyType::Dynamic :
+            quartz::physics::RigidBody::BodyType::Static;
+        parameters.o_rigidBodyParameters->enableGravity = true;
+        parameters.o_rigidBodyParameters->colliderParameters.isTrigger = false;
+
+        doodadParameters.push_back(std::move(parameters));
+    }
+
+    // Stretch the ground so that every body lands on it
+    const double terrainHalfWidth = std::max(gridHalfWidth + gridSpacing, 200.0);
+    for (quartz::scene::Doodad::Parameters& parameters : terrainDoodadParameters) {
+        parameters.transform.scale = math::Vec3(terrainHalfWidth, 1.0, terrainHalfWidth);
+        std::get<quartz::physics::BoxShape::Parameters>(parameters.o_rigidBodyParameters->colliderParameters.shapeParameters).halfExtents_m = math::Vec3(terrainHalfWidth, 1.0, terrainHalfWidth);
+        doodadParameters.push_back(std::move(parameters));
+    }
+
+    return createDemoEnvironmentSceneParameters("benchmark_scene_" + std::to_string(rigidBodyCount), std::move(doodadParameters));
+}
+
+quartz::scene::Scene::Parameters
+createVehicleBenchmarkSceneParameters(
+    const std::size_t vehicleCount,
+    const VehicleParameters& vehicleParameters,
+    const VehicleAiSystem::Parameters& trackParameters
+) {
+    constexpr double groundTop = 0.5;
+    constexpr double dropHeight = 0.5;
+
+    std::vector<quartz::scene::Doodad::Parameters> terrainDoodadParameters = createTerrainDoodadParameter();
+
+    std::vector<quartz::scene::Doodad::Parameters> doodadParameters;
+    doodadParameters.reserve(vehicleCount + terrainDoodadParameters.size());
+
+    // Dealt out to the lanes in turn, each lane's share evenly spaced around it and staggered against its neighbours
+    const std::size_t laneVehicleCount = (vehicleCount + trackParameters.laneCount - 1) / trackParameters.laneCount;
+    for (std::size_t i = 0; i < vehicleCount; ++i) {
+        const std::size_t laneIndex = i % trackParameters.laneCount;
+        const std::size_t slotIndex = i / trackParameters.laneCount;
+        const double laneRadius_m = trackParameters.innermostLaneRadius_m + laneIndex * trackParameters.laneWidth_m;
+        const double angle_rad = 2.0 * std::numbers::pi * (slotIndex + 0.5 * (laneIndex % 2)) / laneVehicleCount;
+
+        const math::Vec3 position = trackParameters.trackCenter + math::Vec3(
+            std::sin(angle_rad) * laneRadius_m,
+            groundTop - vehicleParameters.wheelParameters.front().attachmentPosition_m.y + vehicleParameters.suspensionRestLength_m + vehicleParameters.wheelRadius_m + dropHeight,
+            std::cos(angle_rad) * laneRadius_m
+        );
+
+        // Square to the radius, which is along the lane
+        doodadParameters.push_back(createVehicleDoodadParameters(vehicleParameters, position, angle_rad + 0.5 * std::numbers::pi));
+    }
+
+    const double outermostLaneRadius_m = trackParameters.innermostLaneRadius_m + (trackParameters.laneCount - 1) * trackParameters.laneWidth_m;
+    const double terrainHalfWidth = outermostLaneRadius_m + 50.0;
+    for (quartz::scene::Doodad::Parameters& parameters : terrainDoodadParameters) {
+        parameters.transform.position = trackParameters.trackCenter + math::Vec3(0.0, groundTop - 1.0, 0.0);
+        parameters.transform.scale = math::Vec3(terrainHalfWidth, 1.0, terrainHalfWidth);
+        std::get<quartz::physics::BoxShape::Parameters>(parameters.o_rigidBodyParameters->colliderParameters.shapeParameters).halfExtents_m = math::Vec3(terrainHalfWidth, 1.0, terrainHalfWidth);
+        doodadParameters.push_back(std::move(parameters));
+    }
+
+    quartz::scene::Scene::Parameters sceneParameters = createDemoEnvironmentSceneParameters("vehicle_benchmark_scene_" + std::to_string(vehicleCount), std::move(doodadParameters));
+    sceneParameters.o_fieldParameters.emplace(math::Vec3(0.0, -9.81, 0.0));
+
+    return sceneParameters;
+}
+
+quartz::scene::Scene::Parameters
+createGhostBenchmarkSceneParameters(
+    const std::size_t ghostCount,
+    const math::Vec3& halfExtents_m
+) {
+    std::vector<quartz::scene::Doodad::Parameters> doodadParameters;
+    doodadParameters.reserve(ghostCount);
+    for (std::size_t i = 0; i < ghostCount; ++i) {
+        doodadParameters.push_back(createGhostDoodadParameters(halfExtents_m));
+    }
+
+    return createDemoEnvironmentSceneParameters("ghost_benchmark_scene_" + std::to_string(ghostCount), std::move(doodadParameters));
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+#include "math/transform/Vec3.hpp"
+
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/vehicle/VehicleAiSystem.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+/**
+ * @brief A scene with rigidBodyCount bodies copied from the demo level's object templates on a grid whose rows
+ * alternate between static bodies resting just above the ground and dynamic bodies dropped onto the ground from
+ * higher up, on top of a copy of the demo terrain that is resized to fit
+ */
+quartz::scene::Scene::Parameters
+createBenchmarkSceneParameters(
+    const std::size_t rigidBodyCount
+);
+
+/**
+ * @brief vehicleCount vehicles spread evenly around the track's lanes, facing along them, on ground that is resized
+ * to fit the track, under Earth's gravity rather than the demo level's. The vehicles are the scene's first doodads
+ */
+quartz::scene::Scene::Parameters
+createVehicleBenchmarkSceneParameters(
+    const std::size_t vehicleCount,
+    const VehicleParameters& vehicleParameters,
+    const VehicleAiSystem::Parameters& trackParameters
+);
+
+/**
+ * @brief ghostCount ghosts of the given size and nothing else, since ghosts neither collide nor fall. The ghosts
+ * are the scene's doodads, in order
+ */
+quartz::scene::Scene::Parameters
+createGhostBenchmarkSceneParameters(
+    const std::size_t ghostCount,
+    const math::Vec3& halfExtents_m
+);
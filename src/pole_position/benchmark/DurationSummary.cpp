@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+DurationSummary
+DurationSummary::fromSamples(
+    std::vector<double> samples
+) {
+    if (samples.empty()) {
+        return { 0.0, 0.0, 0.0, 0.0 };
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    const auto percentile = [&samples] (const double fraction) {
+        const std::size_t index = static_cast<std::size_t>(std::ceil(fraction * samples.size())) - 1;
+        return samples[std::min(index, samples.size() - 1)];
+    };
+
+    return {
+        std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size(),
+        percentile(0.50),
+        percentile(0.99),
+        samples.back()
+    };
+}
+
+void
+DurationSummary::write(
+    JsonWriter& jsonWriter,
+    const std::string_view key
+) const {
+    jsonWriter.beginObject(key)
+        .write("mean", mean)
+        .write("p50", p50)
+        .write("p99", p99)
+        .write("max", max)
+        .endObject();
+}
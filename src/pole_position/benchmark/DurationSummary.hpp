@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief Order statistics over a set of measured durations
+ */
+struct DurationSummary {
+public: // member functions
+    static DurationSummary fromSamples(std::vector<double> samples);
+
+    void write(JsonWriter& jsonWriter, const std::string_view key) const;
+
+public: // member variables
+    double mean;
+    double p50;
+    double p99;
+    double max;
+};
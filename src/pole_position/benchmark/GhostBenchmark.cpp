@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/benchmark/BenchmarkScenes.hpp"
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/GhostBenchmark.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/ghost/GhostPlayback.hpp"
+#include "pole_position/ghost/TrajectoryCodec.hpp"
+#include "pole_position/ghost/TrajectoryFile.hpp"
+#include "pole_position/ghost/TrajectoryRecorder.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/scene/SceneParameters.hpp"
+#include "pole_position/vehicle/VehicleAiSystem.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+namespace {
+
+struct RecordedTrajectory {
+    std::string filepath;
+    std::vector<math::Vec3> positions;
+    std::vector<math::Quaternion> rotations;
+};
+
+/**
+ * @brief Drives the cars and records each of them to its own file, keeping the exact transforms it recorded so the
+ * files can be checked against them
+ */
+std::vector<RecordedTrajectory>
+recordTrajectories(
+    const std::size_t vehicleCount,
+    const double ticksPerSecond,
+    const uint64_t warmupTickCount,
+    const uint64_t recordedTickCount
+) {
+    const InputState idleInputState = InputState::idle();
+
+    const VehicleAiSystem::Parameters trackParameters {
+        math::Vec3(0.0, 0.0, 0.0),
+        60.0,
+        5.0,
+        vehicleCount,
+        20.0,
+        15.0
+    };
+    const VehicleParameters vehicleParameters = createRaceCarVehicleParameters();
+
+    HeadlessSimulation simulation(createVehicleBenchmarkSceneParameters(vehicleCount, vehicleParameters, trackParameters), ticksPerSecond);
+    simulation.setPhysicsSubstepCount(4);
+
+    std::vector<std::size_t> vehicleDoodadIndices(vehicleCount);
+    for (std::size_t i = 0; i < vehicleCount; ++i) {
+        vehicleDoodadIndices[i] = i;
+    }
+    simulation.addVehicles(vehicleDoodadIndices, vehicleParameters);
+    simulation.addSystem(std::make_unique<VehicleAiSystem>(trackParameters), vehicleDoodadIndices);
+
+    // Recorded from after the cars have dropped onto the track and pulled away
+    for (uint64_t i = 0; i < warmupTickCount; ++i) {
+        simulation.tick(idleInputState);
+    }
+
+    std::vector<RecordedTrajectory> recordedTrajectories(vehicleCount);
+    std::vector<std::unique_ptr<TrajectoryRecorder>> trajectoryRecorders;
+    trajectoryRecorders.reserve(vehicleCount);
+    for (std::size_t i = 0; i < vehicleCount; ++i) {
+        RecordedTrajectory& recordedTrajectory = recordedTrajectories[i];
+        recordedTrajectory.filepath = (std::filesystem::temp_directory_path() / ("pole_position_ghost_benchmark_" + std::to_string(i) + ".ppgt")).string();
+        recordedTrajectory.positions.reserve(recordedTickCount);
+        recordedTrajectory.rotations.reserve(recordedTickCount);
+
+        trajectoryRecorders.push_back(std::make_unique<TrajectoryRecorder>(recordedTrajectory.filepath, ticksPerSecond));
+        simulation.addTrajectoryRecorder(*trajectoryRecorders.back(), vehicleDoodadIndices[i]);
+    }
+
+    const DoodadStore& doodadStore = simulation.getDoodadStore();
+    for (uint64_t i = 0; i < recordedTickCount; ++i) {
+        simulation.tick(idleInputState);
+
+        for (std::size_t j = 0; j < vehicleCount; ++j) {
+            recordedTrajectories[j].positions.push_back(doodadStore.positions[vehicleDoodadIndices[j]]);
+            recordedTrajectories[j].rotations.push_back(doodadStore.rotations[vehicleDoodadIndices[j]]);
+        }
+    }
+
+    return recordedTrajectories;
+}
+
+/**
+ * @brief Decodes every frame of the file and compares it against what was recorded, raising the maximum errors
+ */
+void
+measureTrajectoryError(
+    const TrajectoryFile& trajectoryFile,
+    const RecordedTrajectory& recordedTrajectory,
+    double& maxPositionError_m,
+    double& maxRotationError_rad
+) {
+    TrajectoryCodec codec;
+    TrajectoryCodec::QuantizedFrame frame;
+
+    for (uint32_t blockIndex = 0; blockIndex < trajectoryFile.getBlockCount(); ++blockIndex) {
+        const std::span<const uint8_t> blockBytes = trajectoryFile.getBlockBytes(blockIndex);
+        const uint8_t* p_cursor = blockBytes.data();
+        const uint8_t* const p_blockEnd = blockBytes.data() + blockBytes.size();
+        codec.reset();
+
+        const uint32_t firstFrameIndex = blockIndex * trajectoryFile.getFramesPerBlock();
+        const uint32_t endFrameIndex = std::min(firstFrameIndex + trajectoryFile.getFramesPerBlock(), trajectoryFile.getFrameCount());
+        for (uint32_t frameIndex = firstFrameIndex; frameIndex < endFrameIndex; ++frameIndex) {
+            if (!codec.decode(p_cursor, p_blockEnd, frame)) {
+                throw std::runtime_error("Failed to decode frame " + std::to_string(frameIndex) + " of " + trajectoryFile.getFilepath());
+            }
+
+            const math::Vec3 position = TrajectoryCodec::dequantizePosition(frame, trajectoryFile.getPositionQuantum());
+            maxPositionError_m = std::max(maxPositionError_m, (position - recordedTrajectory.positions[frameIndex]).magnitude());
+
+            // q and -q are the same rotation
+            const math::Quaternion rotation = TrajectoryCodec::dequantizeRotation(frame);
+            const math::Quaternion& recordedRotation = recordedTrajectory.rotations[frameIndex];
+            const double dot = std::abs(rotation.w * recordedRotation.w + rotation.x * recordedRotation.x + rotation.y * recordedRotation.y + rotation.z * recordedRotation.z);
+            maxRotationError_rad = std::max(maxRotationError_rad, 2.0 * std::acos(std::min(dot, 1.0)));
+        }
+    }
+}
+
+GhostPlaybackBenchmarkResult
+runGhostPlaybackBenchmark(
+    const std::size_t ghostCount,
+    const std::vector<std::unique_ptr<TrajectoryFile>>& trajectoryFiles,
+    const double ticksPerSecond,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+) {
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} ghosts", ghostCount);
+
+    const InputState idleInputState = InputState::idle();
+
+    HeadlessSimulation simulation(createGhostBenchmarkSceneParameters(ghostCount, createRaceCarVehicleParameters().chassisHalfExtents_m), ticksPerSecond);
+
+    // Each trajectory's ghosts are spread evenly along it and loop, so they keep decoding from all over the file
+    const std::size_t ghostsPerTrajectory = (ghostCount + trajectoryFiles.size() - 1) / trajectoryFiles.size();
+    for (std::size_t i = 0; i < ghostCount; ++i) {
+        const TrajectoryFile& trajectoryFile = *trajectoryFiles[i % trajectoryFiles.size()];
+        const GhostPlayback::GhostParameters ghostParameters {
+            -static_cast<double>(i / trajectoryFiles.size()) * trajectoryFile.getDurationSeconds() / ghostsPerTrajectory,
+            true
+        };
+        simulation.addGhost(i, trajectoryFile, ghostParameters);
+    }
+
+    for (uint64_t i = 0; i < warmupTickCount; ++i) {
+        simulation.tick(idleInputState);
+    }
+
+    std::vector<double> decodeSamples;
+    std::vector<double> interpolateSamples;
+    decodeSamples.reserve(tickCount);
+    interpolateSamples.reserve(tickCount);
+    uint64_t totalActiveGhostCount = 0;
+
+    for (uint64_t i = 0; i < tickCount; ++i) {
+        simulation.tick(idleInputState);
+
+        const HeadlessSimulation::TickTimings& tickTimings = simulation.getLastTickTimings();
+        decodeSamples.push_back(tickTimings.ghostDecodeMicroseconds);
+        interpolateSamples.push_back(tickTimings.ghostInterpolateMicroseconds);
+        totalActiveGhostCount += tickTimings.activeGhostCount;
+    }
+
+    double totalMicroseconds = 0.0;
+    for (std::size_t i = 0; i < decodeSamples.size(); ++i) {
+        totalMicroseconds += decodeSamples[i] + interpolateSamples[i];
+    }
+
+    const GhostPlayback::Statistics statistics = simulation.getGhostPlayback().getStatistics();
+    const GhostPlaybackBenchmarkResult result {
+        ghostCount,
+        tickCount,
+        DurationSummary::fromSamples(std::move(decodeSamples)),
+        DurationSummary::fromSamples(std::move(interpolateSamples)),
+        totalActiveGhostCount > 0 ? totalMicroseconds * 1000.0 / totalActiveGhostCount : 0.0,
+        statistics.meanDecodedFramesPerUpdate,
+        static_cast<uint64_t>(statistics.stateBytesPerGhost),
+        statistics.trajectoryBytesPerGhost
+    };
+
+    LOG_INFO(GENERAL, "{} ghosts: decode mean {:.1f} us p99 {:.1f} us, interpolate mean {:.1f} us p99 {:.1f} us, {:.1f} ns per ghost",
+        ghostCount,
+        result.decodeMicroseconds.mean,
+        result.decodeMicroseconds.p99,
+        result.interpolateMicroseconds.mean,
+        result.interpolateMicroseconds.p99,
+        result.meanNanosecondsPerGhost
+    );
+    LOG_INFO(GENERAL, "{} ghosts: {:.1f} frames decoded per tick, {} bytes of state and {:.0f} trajectory bytes per ghost", ghostCount, result.meanDecodedFramesPerTick, result.stateBytesPerGhost, result.trajectoryBytesPerGhost);
+
+    return result;
+}
+
+} // namespace
+
+void
+GhostPlaybackBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject()
+        .write("ghostCount", static_cast<uint64_t>(ghostCount))
+        .write("tickCount", tickCount);
+    decodeMicroseconds.write(jsonWriter, "decodeMicroseconds");
+    interpolateMicroseconds.write(jsonWriter, "interpolateMicroseconds");
+    jsonWriter
+        .write("meanNanosecondsPerGhost", meanNanosecondsPerGhost)
+        .write("meanDecodedFramesPerTick", meanDecodedFramesPerTick)
+        .write("stateBytesPerGhost", stateBytesPerGhost)
+        .write("trajectoryBytesPerGhost", trajectoryBytesPerGhost)
+        .endObject();
+}
+
+void
+GhostBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject("ghosts")
+        .write("trajectoryCount", static_cast<uint64_t>(trajectoryCount))
+        .write("framesPerTrajectory", static_cast<uint64_t>(framesPerTrajectory))
+        .write("framesPerSecond", framesPerSecond)
+        .write("bytesPerFrame", bytesPerFrame)
+        .write("compressionRatio", compressionRatio)
+        .write("maxPositionError_m", maxPositionError_m)
+        .write("maxRotationError_rad", maxRotationError_rad)
+        .beginArray("playbacks");
+    for (const GhostPlaybackBenchmarkResult& playbackResult : playbackResults) {
+        playbackResult.write(jsonWriter);
+    }
+    jsonWriter
+        .endArray()
+        .endObject();
+}
+
+GhostBenchmarkResult
+runGhostBenchmark(
+    const std::vector<std::size_t>& ghostCounts,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+) {
+    constexpr std::size_t trajectoryCount = 4;
+    constexpr double ticksPerSecond = 60.0;
+    constexpr uint64_t recordedTickCount = 30 * 60;
+
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} trajectories", trajectoryCount);
+
+    const std::vector<RecordedTrajectory> recordedTrajectories = recordTrajectories(trajectoryCount, ticksPerSecond, std::max<uint64_t>(warmupTickCount, 120), recordedTickCount);
+
+    GhostBenchmarkResult result {
+        trajectoryCount,
+        0,
+        ticksPerSecond,
+        0.0,
+        0.0,
+        0.0,
+        0.0,
+        {}
+    };
+
+    // The files are removed however the benchmark ends
+    try {
+        std::vector<std::unique_ptr<TrajectoryFile>> trajectoryFiles;
+        trajectoryFiles.reserve(trajectoryCount);
+        std::size_t totalByteCount = 0;
+        for (const RecordedTrajectory& recordedTrajectory : recordedTrajectories) {
+            trajectoryFiles.push_back(std::make_unique<TrajectoryFile>(recordedTrajectory.filepath));
+            measureTrajectoryError(*trajectoryFiles.back(), recordedTrajectory, result.maxPositionError_m, result.maxRotationError_rad);
+            totalByteCount += trajectoryFiles.back()->getByteCount();
+        }
+
+        result.framesPerTrajectory = trajectoryFiles.front()->getFrameCount();
+        result.bytesPerFrame = static_cast<double>(totalByteCount) / (trajectoryCount * result.framesPerTrajectory);
+        result.compressionRatio = 7.0 * sizeof(double) / result.bytesPerFrame;
+
+        LOG_INFO(GENERAL, "{} trajectories of {} frames: {:.2f} bytes per frame ( {:.1f}x smaller than raw ), max position error {:.3f} mm, max rotation error {:.4f} degrees",
+            trajectoryCount,
+            result.framesPerTrajectory,
+            result.bytesPerFrame,
+            result.compressionRatio,
+            result.maxPositionError_m * 1000.0,
+            result.maxRotationError_rad * 180.0 / std::numbers::pi
+        );
+
+        for (const std::size_t ghostCount : ghostCounts) {
+            result.playbackResults.push_back(runGhostPlaybackBenchmark(ghostCount, trajectoryFiles, ticksPerSecond, warmupTickCount, tickCount));
+        }
+    } catch (...) {
+        for (const RecordedTrajectory& recordedTrajectory : recordedTrajectories) {
+            std::filesystem::remove(recordedTrajectory.filepath);
+        }
+        throw;
+    }
+
+    for (const RecordedTrajectory& recordedTrajectory : recordedTrajectories) {
+        std::filesystem::remove(recordedTrajectory.filepath);
+    }
+
+    return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief Ghosts playing the recorded trajectories back, each trajectory shared by a quarter of them. The decode
+ * and interpolate passes are timed per tick. All durations are in microseconds
+ */
+struct GhostPlaybackBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    std::size_t ghostCount;
+    uint64_t tickCount;
+    DurationSummary decodeMicroseconds;
+    DurationSummary interpolateMicroseconds;
+    double meanNanosecondsPerGhost;
+    double meanDecodedFramesPerTick;
+
+    /**
+     * @brief What the playback holds in memory per ghost, and the trajectory files' sizes shared out over the
+     * ghosts that play them
+     */
+    uint64_t stateBytesPerGhost;
+    double trajectoryBytesPerGhost;
+};
+
+/**
+ * @brief AI driven race cars recorded for half a minute at 60 ticks per second, how small and how accurate their
+ * trajectory files are, and then the same trajectories played back on every ghost count. The compression ratio is
+ * against storing each frame's position and rotation as seven doubles
+ */
+struct GhostBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    std::size_t trajectoryCount;
+    uint32_t framesPerTrajectory;
+    double framesPerSecond;
+    double bytesPerFrame;
+    double compressionRatio;
+    double maxPositionError_m;
+    double maxRotationError_rad;
+    std::vector<GhostPlaybackBenchmarkResult> playbackResults;
+};
+
+GhostBenchmarkResult
+runGhostBenchmark(
+    const std::vector<std::size_t>& ghostCounts,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+);
@@ -0,0 +1,199 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/macros.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/benchmark/BenchmarkScenes.hpp"
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JobScalingBenchmark.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/jobs/JobSystem.hpp"
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+
+namespace {
+
+/**
+ * @brief Pushes every dynamic body around with a gust field sampled at its position, standing in for the per
+ * doodad gameplay logic of a real scene. Each doodad costs a handful of transcendental calls, which is about what a
+ * small behaviour costs
+ */
+class GustSystem : public DoodadSystem {
+public: // member functions
+    GustSystem() : m_time_s(0.0) {}
+
+    const char* getName() const override { return "Gust system"; }
+
+    void prepareFixedUpdate(
+        UNUSED const InputState& inputState,
+        const double ticksPerSecond
+    ) override {
+        m_time_s += 1.0 / ticksPerSecond;
+    }
+
+    void fixedUpdate(
+        const SystemContext& context,
+        CommandBuffer& commandBuffer
+    ) const override {
+        for (const std::size_t doodadIndex : context.doodadIndices) {
+            const math::Vec3& position = context.doodadStore.positions[doodadIndex];
+
+            double gust_x = 0.0;
+            double gust_z = 0.0;
+            double amplitude = 1.0;
+            double frequency = 0.05;
+            for (uint32_t octave = 0; octave < 4; ++octave) {
+                gust_x += amplitude * std::sin(position.z * frequency + m_time_s * (1.0 + octave));
+                gust_z += amplitude * std::cos(position.x * frequency - m_time_s * (0.5 + octave));
+                amplitude *= 0.5;
+                frequency *= 2.0;
+            }
+
+            commandBuffer.applyForce(doodadIndex, math::Vec3(gust_x, 0.0, gust_z) * 2.0);
+        }
+    }
+
+private: // member variables
+    double m_time_s;
+};
+
+uint64_t
+hashDoodadTransforms(
+    const DoodadStore& doodadStore
+) {
+    // FNV-1a over the raw bytes, any difference at all between two runs shows up
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const auto hashBytes = [&hash] (const void* p_data, const std::size_t byteCount) {
+        const unsigned char* p_bytes = static_cast<const unsigned char*>(p_data);
+        for (std::size_t i = 0; i < byteCount; ++i) {
+            hash = (hash ^ p_bytes[i]) * 0x100000001b3ull;
+        }
+    };
+
+    for (std::size_t i = 0; i < doodadStore.size(); ++i) {
+        const double values[7] = {
+            doodadStore.positions[i].x, doodadStore.positions[i].y, doodadStore.positions[i].z,
+            doodadStore.rotations[i].w, doodadStore.rotations[i].x, doodadStore.rotations[i].y, doodadStore.rotations[i].z
+        };
+        hashBytes(values, sizeof(values));
+    }
+
+    return hash;
+}
+
+} // namespace
+
+void
+JobScalingBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject()
+        .write("rigidBodyCount", static_cast<uint64_t>(rigidBodyCount))
+        .write("workerCount", static_cast<uint64_t>(workerCount))
+        .write("tickCount", tickCount);
+    systemsFixedUpdateMicroseconds.write(jsonWriter, "systemsFixedUpdateMicroseconds");
+    fixedUpdateMicroseconds.write(jsonWriter, "fixedUpdateMicroseconds");
+    jsonWriter
+        .write("systemsFixedUpdateSpeedup", systemsFixedUpdateSpeedup)
+        .write("matchesSerial", matchesSerial)
+        .endObject();
+}
+
+std::vector<JobScalingBenchmarkResult>
+runJobScalingBenchmark(
+    const std::size_t rigidBodyCount,
+    const std::vector<std::size_t>& workerCounts,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+) {
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} rigid bodies", rigidBodyCount);
+
+    const InputState idleInputState = InputState::idle();
+
+    // The serial run is what every other run is checked against, so it always goes first
+    std::vector<std::size_t> runWorkerCounts = {0};
+    for (const std::size_t workerCount : workerCounts) {
+        if (workerCount > 0) {
+            runWorkerCounts.push_back(workerCount);
+        }
+    }
+
+    std::vector<JobScalingBenchmarkResult> results;
+    std::optional<uint64_t> o_serialHash;
+    double serialMeanMicroseconds = 0.0;
+
+    for (const std::size_t workerCount : runWorkerCounts) {
+        std::optional<JobSystem> o_jobSystem;
+        if (workerCount > 0) {
+            o_jobSystem.emplace(static_cast<uint32_t>(workerCount));
+        }
+
+        HeadlessSimulation simulation(createBenchmarkSceneParameters(rigidBodyCount), 60.0);
+        simulation.setJobSystem(o_jobSystem ? &*o_jobSystem : nullptr);
+        simulation.addSystem(std::make_unique<GustSystem>(), simulation.getDoodadStore().movableDoodadIndices);
+
+        for (uint64_t i = 0; i < warmupTickCount; ++i) {
+            simulation.tick(idleInputState);
+        }
+
+        std::vector<double> systemsFixedUpdateSamples;
+        std::vector<double> fixedUpdateSamples;
+        systemsFixedUpdateSamples.reserve(tickCount);
+        fixedUpdateSamples.reserve(tickCount);
+
+        for (uint64_t i = 0; i < tickCount; ++i) {
+            simulation.tick(idleInputState);
+
+            const HeadlessSimulation::TickTimings& tickTimings = simulation.getLastTickTimings();
+            systemsFixedUpdateSamples.push_back(tickTimings.systemsFixedUpdateMicroseconds);
+            fixedUpdateSamples.push_back(tickTimings.fixedUpdateMicroseconds);
+        }
+
+        const uint64_t hash = hashDoodadTransforms(simulation.getDoodadStore());
+        if (!o_serialHash) {
+            o_serialHash = hash;
+        }
+
+        JobScalingBenchmarkResult result {
+            rigidBodyCount,
+            static_cast<uint32_t>(workerCount),
+            tickCount,
+            DurationSummary::fromSamples(std::move(systemsFixedUpdateSamples)),
+            DurationSummary::fromSamples(std::move(fixedUpdateSamples)),
+            1.0,
+            hash == *o_serialHash
+        };
+        if (workerCount == 0) {
+            serialMeanMicroseconds = result.systemsFixedUpdateMicroseconds.mean;
+        } else if (result.systemsFixedUpdateMicroseconds.mean > 0.0) {
+            result.systemsFixedUpdateSpeedup = serialMeanMicroseconds / result.systemsFixedUpdateMicroseconds.mean;
+        }
+
+        LOG_INFO(GENERAL, "{} rigid bodies, {} workers: systems fixed update mean {:.1f} us ( {:.2f}x ), fixed update mean {:.1f} us",
+            rigidBodyCount,
+            workerCount,
+            result.systemsFixedUpdateMicroseconds.mean,
+            result.systemsFixedUpdateSpeedup,
+            result.fixedUpdateMicroseconds.mean
+        );
+        if (!result.matchesSerial) {
+            LOG_ERROR(GENERAL, "{} rigid bodies, {} workers: the doodads' transforms differ from the serial run", rigidBodyCount, workerCount);
+        }
+
+        results.push_back(result);
+    }
+
+    return results;
+}
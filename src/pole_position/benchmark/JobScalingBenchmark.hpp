@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief The systems' fixed update of a benchmark scene, run serially and then on a job system with each of a
+ * list of worker counts. A worker count of 0 is the serial run the others are compared against. All durations are
+ * in microseconds
+ */
+struct JobScalingBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    std::size_t rigidBodyCount;
+    uint32_t workerCount;
+    uint64_t tickCount;
+    DurationSummary systemsFixedUpdateMicroseconds;
+    DurationSummary fixedUpdateMicroseconds;
+    double systemsFixedUpdateSpeedup;
+
+    /**
+     * @brief Whether every doodad ended up with exactly the same transform as in the serial run
+     */
+    bool matchesSerial;
+};
+
+std::vector<JobScalingBenchmarkResult>
+runJobScalingBenchmark(
+    const std::size_t rigidBodyCount,
+    const std::vector<std::size_t>& workerCounts,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+);
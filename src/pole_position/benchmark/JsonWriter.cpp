@@ -0,0 +1,182 @@
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+JsonWriter::JsonWriter(
+    std::ostream& outputStream
+) :
+    m_outputStream(outputStream),
+    m_scopeHasValues()
+{}
+
+void
+JsonWriter::writeIndentation() {
+    for (std::size_t i = 0; i < m_scopeHasValues.size(); ++i) {
+        m_outputStream << "  ";
+    }
+}
+
+void
+JsonWriter::writeSeparator() {
+    if (m_scopeHasValues.empty()) {
+        return;
+    }
+
+    if (m_scopeHasValues.back()) {
+        m_outputStream << ",";
+    }
+    m_outputStream << "\n";
+    m_scopeHasValues.back() = true;
+    this->writeIndentation();
+}
+
+void
+JsonWriter::writeString(
+    const std::string_view string
+) {
+    m_outputStream << '"';
+    for (const char character : string) {
+        switch (character) {
+            case '"':
+                m_outputStream << "\\\"";
+                break;
+            case '\\':
+                m_outputStream << "\\\\";
+                break;
+            case '\n':
+                m_outputStream << "\\n";
+                break;
+            default:
+                m_outputStream << character;
+                break;
+        }
+    }
+    m_outputStream << '"';
+}
+
+void
+JsonWriter::writeKey(
+    const std::string_view key
+) {
+    this->writeSeparator();
+    this->writeString(key);
+    m_outputStream << ": ";
+}
+
+JsonWriter&
+JsonWriter::beginObject() {
+    this->writeSeparator();
+    m_outputStream << "{";
+    m_scopeHasValues.push_back(false);
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::beginObject(
+    const std::string_view key
+) {
+    this->writeKey(key);
+    m_outputStream << "{";
+    m_scopeHasValues.push_back(false);
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::endObject() {
+    const bool hadValues = m_scopeHasValues.back();
+    m_scopeHasValues.pop_back();
+    if (hadValues) {
+        m_outputStream << "\n";
+        this->writeIndentation();
+    }
+    m_outputStream << "}";
+    if (m_scopeHasValues.empty()) {
+        m_outputStream << "\n";
+    }
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::beginArray() {
+    this->writeSeparator();
+    m_outputStream << "[";
+    m_scopeHasValues.push_back(false);
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::beginArray(
+    const std::string_view key
+) {
+    this->writeKey(key);
+    m_outputStream << "[";
+    m_scopeHasValues.push_back(false);
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::endArray() {
+    const bool hadValues = m_scopeHasValues.back();
+    m_scopeHasValues.pop_back();
+    if (hadValues) {
+        m_outputStream << "\n";
+        this->writeIndentation();
+    }
+    m_outputStream << "]";
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::write(
+    const std::string_view key,
+    const std::string_view value
+) {
+    this->writeKey(key);
+    this->writeString(value);
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::write(
+    const std::string_view key,
+    const char* const value
+) {
+    return this->write(key, std::string_view(value));
+}
+
+JsonWriter&
+JsonWriter::write(
+    const std::string_view key,
+    const double value
+) {
+    this->writeKey(key);
+    if (std::isfinite(value)) {
+        m_outputStream << value;
+    } else {
+        m_outputStream << "null";
+    }
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::write(
+    const std::string_view key,
+    const uint64_t value
+) {
+    this->writeKey(key);
+    m_outputStream << value;
+    return *this;
+}
+
+JsonWriter&
+JsonWriter::write(
+    const std::string_view key,
+    const bool value
+) {
+    this->writeKey(key);
+    m_outputStream << (value ? "true" : "false");
+    return *this;
+}
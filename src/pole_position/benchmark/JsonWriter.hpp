@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A minimal streaming JSON writer for benchmark reports. Keys and values are written in the order they are
+ * given, and the writer keeps track of where commas go
+ */
+class JsonWriter {
+public: // member functions
+    explicit JsonWriter(std::ostream& outputStream);
+
+    JsonWriter& beginObject();
+    JsonWriter& beginObject(const std::string_view key);
+    JsonWriter& endObject();
+
+    JsonWriter& beginArray();
+    JsonWriter& beginArray(const std::string_view key);
+    JsonWriter& endArray();
+
+    JsonWriter& write(const std::string_view key, const std::string_view value);
+    JsonWriter& write(const std::string_view key, const char* const value);
+    JsonWriter& write(const std::string_view key, const double value);
+    JsonWriter& write(const std::string_view key, const uint64_t value);
+    JsonWriter& write(const std::string_view key, const bool value);
+
+private: // member functions
+    void writeSeparator();
+    void writeKey(const std::string_view key);
+    void writeString(const std::string_view string);
+    void writeIndentation();
+
+private: // member variables
+    std::ostream& m_outputStream;
+    std::vector<bool> m_scopeHasValues;
+};
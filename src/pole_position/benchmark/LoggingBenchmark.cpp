@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/benchmark/LoggingBenchmark.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+
+void
+LoggingBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject("logging")
+        .write("callCount", callCount)
+        .write("disabledCallNanoseconds", disabledCallNanoseconds)
+        .write("enabledCallNanoseconds", enabledCallNanoseconds)
+        .write("droppedRecordCount", droppedRecordCount)
+        .endObject();
+}
+
+LoggingBenchmarkResult
+runLoggingBenchmark(
+    const uint64_t callCount
+) {
+    using Clock = std::chrono::steady_clock;
+
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} calls", callCount);
+
+    // BIGBOY is not used anywhere else, so we can change its level freely
+    const AsyncLogger::ScopedSession asyncLoggerSession("/dev/null");
+    const uint64_t initialDroppedRecordCount = AsyncLogger::getDroppedRecordCount();
+
+    AsyncLogger::setLevels({{"BIGBOY", util::Logger::Level::off}});
+    const Clock::time_point disabledStartTime = Clock::now();
+    for (uint64_t i = 0; i < callCount; ++i) {
+        ASYNC_LOG_TRACE(BIGBOY, "Disabled call {} of {}", i, callCount);
+    }
+    const double disabledCallNanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - disabledStartTime).count() / callCount;
+
+    // Only time the calls themselves, and give the writer thread time to drain between bursts that fit into
+    // the ring buffer so that we measure enqueueing rather than dropping
+    AsyncLogger::setLevels({{"BIGBOY", util::Logger::Level::trace}});
+    constexpr uint64_t burstSize = AsyncLogger::RingBuffer::capacity / 2;
+    double enabledTotalNanoseconds = 0.0;
+    for (uint64_t burstStart = 0; burstStart < callCount; burstStart += burstSize) {
+        const uint64_t burstEnd = std::min(burstStart + burstSize, callCount);
+
+        const Clock::time_point burstStartTime = Clock::now();
+        for (uint64_t i = burstStart; i < burstEnd; ++i) {
+            ASYNC_LOG_TRACE(BIGBOY, "Enabled call {} of {} ( {:.3f} )", i, callCount, i * 0.5);
+        }
+        enabledTotalNanoseconds += std::chrono::duration<double, std::nano>(Clock::now() - burstStartTime).count();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    const double enabledCallNanoseconds = enabledTotalNanoseconds / callCount;
+
+    const LoggingBenchmarkResult result {
+        callCount,
+        disabledCallNanoseconds,
+        enabledCallNanoseconds,
+        AsyncLogger::getDroppedRecordCount() - initialDroppedRecordCount
+    };
+
+    LOG_INFO(GENERAL, "Async logging: {:.2f} ns per disabled call, {:.2f} ns per enabled call, {} dropped", result.disabledCallNanoseconds, result.enabledCallNanoseconds, result.droppedRecordCount);
+
+    return result;
+}
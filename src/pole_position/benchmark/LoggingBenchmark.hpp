@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief The cost on the calling thread of an ASYNC_LOG_* call, in nanoseconds per call
+ */
+struct LoggingBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    uint64_t callCount;
+    double disabledCallNanoseconds;
+    double enabledCallNanoseconds;
+    uint64_t droppedRecordCount;
+};
+
+LoggingBenchmarkResult
+runLoggingBenchmark(
+    const uint64_t callCount
+);
@@ -0,0 +1,23 @@
+#include <cstdint>
+
+#include <sys/resource.h>
+
+#include "util/platform.hpp"
+
+#include "pole_position/benchmark/ProcessMemory.hpp"
+
+uint64_t
+getPeakResidentBytes() {
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+
+#ifdef ON_MAC
+    // ru_maxrss is reported in bytes on mac
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    // ru_maxrss is reported in kilobytes on linux
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief The high-water mark of the process' resident memory. This never goes down, so benchmarks that want a
+ * per-case peak should run their cases from smallest to largest
+ */
+uint64_t getPeakResidentBytes();
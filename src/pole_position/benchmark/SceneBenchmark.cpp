@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/benchmark/BenchmarkScenes.hpp"
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/benchmark/ProcessMemory.hpp"
+#include "pole_position/benchmark/SceneBenchmark.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/memory/AllocationCounter.hpp"
+#include "pole_position/physics/ContactEventBuffer.hpp"
+#include "pole_position/scene/SceneParameters.hpp"
+
+void
+SceneBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject()
+        .write("rigidBodyCount", static_cast<uint64_t>(rigidBodyCount))
+        .write("doodadCount", static_cast<uint64_t>(doodadCount))
+        .write("sceneConstructionMilliseconds", sceneConstructionMilliseconds)
+        .write("tickCount", tickCount);
+    fixedUpdateMicroseconds.write(jsonWriter, "fixedUpdateMicroseconds");
+    physicsStepMicroseconds.write(jsonWriter, "physicsStepMicroseconds");
+    collisionCallbackMicroseconds.write(jsonWriter, "collisionCallbackMicroseconds");
+    contactDispatchMicroseconds.write(jsonWriter, "contactDispatchMicroseconds");
+    transformSyncMicroseconds.write(jsonWriter, "transformSyncMicroseconds");
+    jsonWriter
+        .write("meanContactEventsPerTick", meanContactEventsPerTick)
+        .write("meanSubscribedContactEventsPerTick", meanSubscribedContactEventsPerTick)
+        .write("meanActiveDoodadCount", meanActiveDoodadCount)
+        .write("meanSleepingDoodadCount", meanSleepingDoodadCount)
+        .write("allocationCountingEnabled", allocationCountingEnabled)
+        .write("meanAllocationsPerTick", meanAllocationsPerTick)
+        .write("maxAllocationsPerTick", maxAllocationsPerTick)
+        .write("processPeakResidentBytes", processPeakResidentBytes)
+        .endObject();
+}
+
+SceneBenchmarkResult
+runSceneBenchmark(
+    const std::size_t rigidBodyCount,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+) {
+    using Clock = std::chrono::steady_clock;
+
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} rigid bodies", rigidBodyCount);
+
+    const InputState idleInputState = InputState::idle();
+
+    const Clock::time_point constructionStartTime = Clock::now();
+    HeadlessSimulation simulation(createBenchmarkSceneParameters(rigidBodyCount), 60.0);
+    const double sceneConstructionMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - constructionStartTime).count();
+
+    // Stands in for gameplay that reacts to things hitting the objects, reading every event once
+    uint64_t subscribedContactPointCount = 0;
+    simulation.getContactEventBuffer().subscribe(
+        static_cast<uint16_t>(CollisionCategories::Interactable),
+        0xFFFF,
+        [&subscribedContactPointCount] (std::span<const ContactEventBuffer::ContactEvent> events) {
+            for (const ContactEventBuffer::ContactEvent& event : events) {
+                subscribedContactPointCount += event.contactPointCount;
+            }
+        }
+    );
+
+    for (uint64_t i = 0; i < warmupTickCount; ++i) {
+        simulation.tick(idleInputState);
+    }
+
+    std::vector<double> fixedUpdateSamples;
+    std::vector<double> physicsStepSamples;
+    std::vector<double> collisionCallbackSamples;
+    std::vector<double> contactDispatchSamples;
+    std::vector<double> transformSyncSamples;
+    fixedUpdateSamples.reserve(tickCount);
+    physicsStepSamples.reserve(tickCount);
+    collisionCallbackSamples.reserve(tickCount);
+    contactDispatchSamples.reserve(tickCount);
+    transformSyncSamples.reserve(tickCount);
+    uint64_t contactEventCount = 0;
+    uint64_t subscribedContactEventCount = 0;
+    uint64_t activeDoodadCount = 0;
+    uint64_t sleepingDoodadCount = 0;
+    uint64_t allocationCount = 0;
+    uint64_t maxAllocationCount = 0;
+
+    for (uint64_t i = 0; i < tickCount; ++i) {
+        simulation.tick(idleInputState);
+
+        const HeadlessSimulation::TickTimings& tickTimings = simulation.getLastTickTimings();
+        fixedUpdateSamples.push_back(tickTimings.fixedUpdateMicroseconds);
+        physicsStepSamples.push_back(tickTimings.physicsStepMicroseconds);
+        collisionCallbackSamples.push_back(tickTimings.collisionCallbackMicroseconds);
+        contactDispatchSamples.push_back(tickTimings.contactDispatchMicroseconds);
+        transformSyncSamples.push_back(tickTimings.transformSyncMicroseconds);
+        contactEventCount += tickTimings.contactStartCount + tickTimings.contactStayCount + tickTimings.contactEndCount;
+        subscribedContactEventCount += tickTimings.contactEventCount;
+        activeDoodadCount += tickTimings.activeDoodadCount;
+        sleepingDoodadCount += tickTimings.sleepingDoodadCount;
+        allocationCount += tickTimings.allocationCount;
+        maxAllocationCount = std::max(maxAllocationCount, tickTimings.allocationCount);
+    }
+
+    const SceneBenchmarkResult result {
+        rigidBodyCount,
+        simulation.getDoodadCount(),
+        sceneConstructionMilliseconds,
+        tickCount,
+        DurationSummary::fromSamples(std::move(fixedUpdateSamples)),
+        DurationSummary::fromSamples(std::move(physicsStepSamples)),
+        DurationSummary::fromSamples(std::move(collisionCallbackSamples)),
+        DurationSummary::fromSamples(std::move(contactDispatchSamples)),
+        DurationSummary::fromSamples(std::move(transformSyncSamples)),
+        tickCount > 0 ? static_cast<double>(contactEventCount) / tickCount : 0.0,
+        tickCount > 0 ? static_cast<double>(subscribedContactEventCount) / tickCount : 0.0,
+        tickCount > 0 ? static_cast<double>(activeDoodadCount) / tickCount : 0.0,
+        tickCount > 0 ? static_cast<double>(sleepingDoodadCount) / tickCount : 0.0,
+        AllocationCounter::isEnabled(),
+        tickCount > 0 ? static_cast<double>(allocationCount) / tickCount : 0.0,
+        maxAllocationCount,
+        getPeakResidentBytes()
+    };
+
+    LOG_INFO(GENERAL, "{} rigid bodies: constructed in {:.1f} ms, fixed update mean {:.1f} us p99 {:.1f} us, collision callbacks mean {:.1f} us, contact dispatch mean {:.1f} us",
+        rigidBodyCount,
+        result.sceneConstructionMilliseconds,
+        result.fixedUpdateMicroseconds.mean,
+        result.fixedUpdateMicroseconds.p99,
+        result.collisionCallbackMicroseconds.mean,
+        result.contactDispatchMicroseconds.mean
+    );
+    LOG_INFO(GENERAL, "{} rigid bodies: mean {:.1f} active and {:.1f} sleeping, transform sync mean {:.1f} us",
+        rigidBodyCount,
+        result.meanActiveDoodadCount,
+        result.meanSleepingDoodadCount,
+        result.transformSyncMicroseconds.mean
+    );
+    if (result.allocationCountingEnabled) {
+        LOG_INFO(GENERAL, "{} rigid bodies: mean {:.1f} allocations per tick, max {}", rigidBodyCount, result.meanAllocationsPerTick, result.maxAllocationsPerTick);
+    }
+    LOG_TRACE(GENERAL, "{} rigid bodies: the subscriber saw {} contact points", rigidBodyCount, subscribedContactPointCount);
+
+    return result;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief Builds a benchmark scene with a given number of rigid bodies and steps it headlessly, with one contact
+ * subscriber reading the interactable objects' contacts. All durations are in microseconds, except for the scene
+ * construction which is in milliseconds
+ */
+struct SceneBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    std::size_t rigidBodyCount;
+    std::size_t doodadCount;
+    double sceneConstructionMilliseconds;
+    uint64_t tickCount;
+    DurationSummary fixedUpdateMicroseconds;
+    DurationSummary physicsStepMicroseconds;
+    DurationSummary collisionCallbackMicroseconds;
+    DurationSummary contactDispatchMicroseconds;
+    DurationSummary transformSyncMicroseconds;
+    double meanContactEventsPerTick;
+    double meanSubscribedContactEventsPerTick;
+    double meanActiveDoodadCount;
+    double meanSleepingDoodadCount;
+
+    /**
+     * @brief Only measured when built with POLE_POSITION_ENABLE_ALLOCATION_COUNTING
+     */
+    bool allocationCountingEnabled;
+    double meanAllocationsPerTick;
+    uint64_t maxAllocationsPerTick;
+
+    /**
+     * @brief The high-water mark of the whole process' resident memory when this case finished, which includes every
+     * case that ran before it
+     */
+    uint64_t processPeakResidentBytes;
+};
+
+SceneBenchmarkResult
+runSceneBenchmark(
+    const std::size_t rigidBodyCount,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+);
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/benchmark/BenchmarkScenes.hpp"
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/benchmark/SnapshotBenchmark.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/snapshot/WorldSnapshot.hpp"
+#include "pole_position/snapshot/WorldSnapshotFormat.hpp"
+#include "pole_position/snapshot/WorldSnapshotRing.hpp"
+
+namespace {
+
+/**
+ * @brief The furthest any doodad is from where it is in the other snapshot
+ */
+double
+computeMaxPositionDifference(
+    const WorldSnapshot& snapshot,
+    const WorldSnapshot& otherSnapshot
+) {
+    const std::size_t doodadCount = snapshot.getHeader().doodadCount;
+    const std::span<const world_snapshot_format::DoodadTransform> doodadTransforms = snapshot.getSection<world_snapshot_format::DoodadTransform>(snapshot.getLayout().doodadTransformsOffset, doodadCount);
+    const std::span<const world_snapshot_format::DoodadTransform> otherDoodadTransforms = otherSnapshot.getSection<world_snapshot_format::DoodadTransform>(otherSnapshot.getLayout().doodadTransformsOffset, doodadCount);
+
+    double maxDifference_m = 0.0;
+    for (std::size_t i = 0; i < doodadCount; ++i) {
+        const std::array<double, 3>& position = doodadTransforms[i].position;
+        const std::array<double, 3>& otherPosition = otherDoodadTransforms[i].position;
+        const double dx = position[0] - otherPosition[0];
+        const double dy = position[1] - otherPosition[1];
+        const double dz = position[2] - otherPosition[2];
+        maxDifference_m = std::max(maxDifference_m, std::sqrt(dx * dx + dy * dy + dz * dz));
+    }
+
+    return maxDifference_m;
+}
+
+} // namespace
+
+void
+SnapshotBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject()
+        .write("rigidBodyCount", static_cast<uint64_t>(rigidBodyCount))
+        .write("doodadCount", static_cast<uint64_t>(doodadCount))
+        .write("tickCount", tickCount)
+        .write("snapshotBytes", snapshotBytes);
+    captureMicroseconds.write(jsonWriter, "captureMicroseconds");
+    restoreMicroseconds.write(jsonWriter, "restoreMicroseconds");
+    ringPushMicroseconds.write(jsonWriter, "ringPushMicroseconds");
+    jsonWriter
+        .write("ringCapacity", static_cast<uint64_t>(ringCapacity))
+        .write("meanDeltaBytes", meanDeltaBytes)
+        .write("ringBytes", ringBytes)
+        .write("rewoundTickCount", rewoundTickCount)
+        .write("rewindMicroseconds", rewindMicroseconds)
+        .write("maxResimulationError_m", maxResimulationError_m)
+        .endObject();
+}
+
+SnapshotBenchmarkResult
+runSnapshotBenchmark(
+    const std::size_t rigidBodyCount,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+) {
+    using Clock = std::chrono::steady_clock;
+    constexpr double ticksPerSecond = 60.0;
+    constexpr std::size_t ringCapacity = 5 * 60;
+    constexpr uint64_t rewoundTickCount = 60;
+
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} rigid bodies", rigidBodyCount);
+
+    const InputState idleInputState = InputState::idle();
+
+    HeadlessSimulation simulation(createBenchmarkSceneParameters(rigidBodyCount), ticksPerSecond);
+
+    for (uint64_t i = 0; i < warmupTickCount; ++i) {
+        simulation.tick(idleInputState);
+    }
+
+    // Only the first capture and the ring's first time round allocate, both before anything is timed
+    WorldSnapshot snapshot;
+    simulation.captureSnapshot(snapshot);
+    WorldSnapshotRing ring(ringCapacity);
+
+    std::vector<double> captureSamples;
+    std::vector<double> ringPushSamples;
+    captureSamples.reserve(tickCount);
+    ringPushSamples.reserve(tickCount);
+
+    for (uint64_t i = 0; i < tickCount; ++i) {
+        simulation.tick(idleInputState);
+
+        const Clock::time_point captureStartTime = Clock::now();
+        simulation.captureSnapshot(snapshot);
+        const Clock::time_point ringPushStartTime = Clock::now();
+        ring.push(snapshot);
+        const Clock::time_point ringPushEndTime = Clock::now();
+
+        captureSamples.push_back(std::chrono::duration<double, std::micro>(ringPushStartTime - captureStartTime).count());
+        ringPushSamples.push_back(std::chrono::duration<double, std::micro>(ringPushEndTime - ringPushStartTime).count());
+    }
+
+    const std::size_t snapshotCount = ring.getSnapshotCount();
+    const uint64_t ringBytes = ring.getByteCount();
+    const double meanDeltaBytes = snapshotCount > 1 ? static_cast<double>(ringBytes - snapshot.getByteCount()) / (snapshotCount - 1) : 0.0;
+
+    // Rewinding a second and playing it again should end up where the first time did, to within what the physics
+    // engine's rebuilt contact caches change
+    double rewindMicroseconds = 0.0;
+    double maxResimulationError_m = 0.0;
+    if (snapshotCount > rewoundTickCount) {
+        const WorldSnapshot newestSnapshot = snapshot;
+
+        const Clock::time_point rewindStartTime = Clock::now();
+        ring.rewind(rewoundTickCount, snapshot);
+        rewindMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - rewindStartTime).count();
+
+        simulation.restoreSnapshot(snapshot);
+        for (uint64_t i = 0; i < rewoundTickCount; ++i) {
+            simulation.tick(idleInputState);
+        }
+        simulation.captureSnapshot(snapshot);
+        maxResimulationError_m = computeMaxPositionDifference(snapshot, newestSnapshot);
+    }
+
+    // Every tick starts over from the same snapshot, like a run that is restarted over and over
+    std::vector<double> restoreSamples;
+    restoreSamples.reserve(tickCount);
+    for (uint64_t i = 0; i < tickCount; ++i) {
+        const Clock::time_point restoreStartTime = Clock::now();
+        simulation.restoreSnapshot(snapshot);
+        restoreSamples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - restoreStartTime).count());
+
+        simulation.tick(idleInputState);
+    }
+
+    const SnapshotBenchmarkResult result {
+        rigidBodyCount,
+        simulation.getDoodadCount(),
+        tickCount,
+        snapshot.getByteCount(),
+        DurationSummary::fromSamples(std::move(captureSamples)),
+        DurationSummary::fromSamples(std::move(restoreSamples)),
+        DurationSummary::fromSamples(std::move(ringPushSamples)),
+        ringCapacity,
+        meanDeltaBytes,
+        ringBytes,
+        snapshotCount > rewoundTickCount ? rewoundTickCount : 0,
+        rewindMicroseconds,
+        maxResimulationError_m
+    };
+
+    LOG_INFO(GENERAL, "{} rigid bodies: {} byte snapshots, capture mean {:.1f} us p99 {:.1f} us, restore mean {:.1f} us p99 {:.1f} us",
+        rigidBodyCount,
+        result.snapshotBytes,
+        result.captureMicroseconds.mean,
+        result.captureMicroseconds.p99,
+        result.restoreMicroseconds.mean,
+        result.restoreMicroseconds.p99
+    );
+    LOG_INFO(GENERAL, "{} rigid bodies: {:.0f} byte deltas, {} snapshots in {} ring bytes, push mean {:.1f} us, rewinding {} ticks took {:.1f} us and resimulating them ended up {:.3f} mm off",
+        rigidBodyCount,
+        result.meanDeltaBytes,
+        snapshotCount,
+        result.ringBytes,
+        result.ringPushMicroseconds.mean,
+        result.rewoundTickCount,
+        result.rewindMicroseconds,
+        result.maxResimulationError_m * 1000.0
+    );
+
+    return result;
+}
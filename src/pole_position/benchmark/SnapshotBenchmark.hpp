@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief The benchmark scene with a given number of rigid bodies captured into a snapshot after every tick, each
+ * snapshot pushed onto a ring of the last five seconds, and then restored from the newest snapshot before every tick
+ * of a second run. Once the ring is full it is rewound by a second and the second after it resimulated, and the
+ * resimulated doodads are compared against where they were the first time round. All durations are in microseconds
+ */
+struct SnapshotBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    std::size_t rigidBodyCount;
+    std::size_t doodadCount;
+    uint64_t tickCount;
+    uint64_t snapshotBytes;
+    DurationSummary captureMicroseconds;
+    DurationSummary restoreMicroseconds;
+    DurationSummary ringPushMicroseconds;
+
+    /**
+     * @brief The deltas the ring holds instead of whole snapshots, and the whole ring with its newest snapshot
+     */
+    std::size_t ringCapacity;
+    double meanDeltaBytes;
+    uint64_t ringBytes;
+
+    /**
+     * @brief Only measured when the run is long enough to fill the ring past the rewound ticks
+     */
+    uint64_t rewoundTickCount;
+    double rewindMicroseconds;
+    double maxResimulationError_m;
+};
+
+SnapshotBenchmarkResult
+runSnapshotBenchmark(
+    const std::size_t rigidBodyCount,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+);
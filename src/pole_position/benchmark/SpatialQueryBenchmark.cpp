@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/benchmark/BenchmarkScenes.hpp"
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/benchmark/SpatialQueryBenchmark.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/memory/FrameArena.hpp"
+#include "pole_position/scene/SceneParameters.hpp"
+#include "pole_position/spatial/Aabb.hpp"
+#include "pole_position/spatial/DynamicAabbTree.hpp"
+#include "pole_position/spatial/SpatialIndex.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+namespace {
+
+constexpr std::size_t queriesPerTick = 64;
+constexpr double queryRadius = 4.0;
+constexpr std::size_t nearestCount = 8;
+constexpr uint16_t queryCategoryBitMask = 0xFFFF;
+
+/**
+ * @brief What SpatialIndex::querySpheres finds, found by walking every doodad
+ */
+void
+bruteForceQuerySpheres(
+    const DoodadStore& doodadStore,
+    const std::vector<SpatialIndex::SphereQuery>& queries,
+    SpatialIndex::BatchResults& results
+) {
+    results.doodadIndices.clear();
+    results.offsets.assign(1, 0);
+
+    for (const SpatialIndex::SphereQuery& query : queries) {
+        for (std::size_t doodadIndex = 0; doodadIndex < doodadStore.size(); ++doodadIndex) {
+            if (!(doodadStore.collisionCategoryBitMasks[doodadIndex] & query.categoryBitMask)) {
+                continue;
+            }
+
+            const Aabb aabb = Aabb::fromSphere(doodadStore.positions[doodadIndex], doodadStore.boundingRadii[doodadIndex]);
+            if (aabb.getDistanceSquaredTo(query.center) <= query.radius * query.radius) {
+                results.doodadIndices.push_back(doodadIndex);
+            }
+        }
+        results.offsets.push_back(results.doodadIndices.size());
+    }
+}
+
+bool
+haveSameDoodads(
+    const SpatialIndex::BatchResults& lhs,
+    const SpatialIndex::BatchResults& rhs
+) {
+    if (lhs.offsets != rhs.offsets) {
+        return false;
+    }
+
+    for (std::size_t queryIndex = 0; queryIndex + 1 < lhs.offsets.size(); ++queryIndex) {
+        std::vector<std::size_t> lhsDoodadIndices(lhs.get(queryIndex).begin(), lhs.get(queryIndex).end());
+        std::vector<std::size_t> rhsDoodadIndices(rhs.get(queryIndex).begin(), rhs.get(queryIndex).end());
+        std::sort(lhsDoodadIndices.begin(), lhsDoodadIndices.end());
+        std::sort(rhsDoodadIndices.begin(), rhsDoodadIndices.end());
+        if (lhsDoodadIndices != rhsDoodadIndices) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+void
+SpatialQueryBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject()
+        .write("rigidBodyCount", static_cast<uint64_t>(rigidBodyCount))
+        .write("indexedDoodadCount", static_cast<uint64_t>(indexedDoodadCount))
+        .write("treeHeight", static_cast<uint64_t>(treeHeight))
+        .write("tickCount", tickCount);
+    indexUpdateMicroseconds.write(jsonWriter, "indexUpdateMicroseconds");
+    jsonWriter.write("meanReinsertCountPerTick", meanReinsertCountPerTick);
+    sphereQueryMicroseconds.write(jsonWriter, "sphereQueryMicroseconds");
+    aabbQueryMicroseconds.write(jsonWriter, "aabbQueryMicroseconds");
+    raycastMicroseconds.write(jsonWriter, "raycastMicroseconds");
+    nearestQueryMicroseconds.write(jsonWriter, "nearestQueryMicroseconds");
+    bruteForceSphereQueryMicroseconds.write(jsonWriter, "bruteForceSphereQueryMicroseconds");
+    jsonWriter
+        .write("matchesBruteForce", matchesBruteForce)
+        .endObject();
+}
+
+SpatialQueryBenchmarkResult
+runSpatialQueryBenchmark(
+    const std::size_t rigidBodyCount,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+) {
+    using Clock = std::chrono::steady_clock;
+
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} rigid bodies", rigidBodyCount);
+
+    const InputState idleInputState = InputState::idle();
+
+    HeadlessSimulation simulation(createBenchmarkSceneParameters(rigidBodyCount), 60.0);
+    const DoodadStore& doodadStore = simulation.getDoodadStore();
+    const SpatialIndex& spatialIndex = simulation.getSpatialIndex();
+
+    for (uint64_t i = 0; i < warmupTickCount; ++i) {
+        simulation.tick(idleInputState);
+    }
+
+    // Every query is centered on a doodad, like gameplay asking about the surroundings of something in the scene
+    std::vector<std::size_t> queriedDoodadIndices;
+    for (std::size_t doodadIndex = 0; doodadIndex < doodadStore.size(); ++doodadIndex) {
+        if (doodadStore.collisionCategoryBitMasks[doodadIndex] & static_cast<uint16_t>(CollisionCategories::Interactable)) {
+            queriedDoodadIndices.push_back(doodadIndex);
+        }
+    }
+    if (queriedDoodadIndices.empty()) {
+        queriedDoodadIndices.push_back(0);
+    }
+
+    std::vector<SpatialIndex::SphereQuery> sphereQueries(queriesPerTick);
+    std::vector<SpatialIndex::AabbQuery> aabbQueries(queriesPerTick);
+    std::vector<SpatialIndex::RayQuery> rayQueries(queriesPerTick);
+    std::vector<SpatialIndex::NearestQuery> nearestQueries(queriesPerTick);
+    SpatialIndex::BatchResults batchResults;
+    SpatialIndex::BatchResults bruteForceBatchResults;
+    std::vector<std::optional<DynamicAabbTree::RayHit>> rayHits;
+    FrameArena frameArena;
+
+    std::vector<double> indexUpdateSamples;
+    std::vector<double> sphereQuerySamples;
+    std::vector<double> aabbQuerySamples;
+    std::vector<double> raycastSamples;
+    std::vector<double> nearestQuerySamples;
+    std::vector<double> bruteForceSphereQuerySamples;
+    indexUpdateSamples.reserve(tickCount);
+    sphereQuerySamples.reserve(tickCount);
+    aabbQuerySamples.reserve(tickCount);
+    raycastSamples.reserve(tickCount);
+    nearestQuerySamples.reserve(tickCount);
+    bruteForceSphereQuerySamples.reserve(tickCount);
+    uint64_t reinsertCount = 0;
+    bool matchesBruteForce = true;
+
+    const auto timePerQuery = [] (const Clock::time_point startTime) {
+        return std::chrono::duration<double, std::micro>(Clock::now() - startTime).count() / queriesPerTick;
+    };
+
+    for (uint64_t i = 0; i < tickCount; ++i) {
+        simulation.tick(idleInputState);
+
+        const HeadlessSimulation::TickTimings& tickTimings = simulation.getLastTickTimings();
+        indexUpdateSamples.push_back(tickTimings.spatialIndexUpdateMicroseconds);
+        reinsertCount += tickTimings.spatialIndexReinsertCount;
+
+        for (std::size_t queryIndex = 0; queryIndex < queriesPerTick; ++queryIndex) {
+            const std::size_t doodadIndex = queriedDoodadIndices[(i * queriesPerTick + queryIndex) % queriedDoodadIndices.size()];
+            const math::Vec3& position = doodadStore.positions[doodadIndex];
+
+            sphereQueries[queryIndex] = {position, queryRadius, queryCategoryBitMask};
+            aabbQueries[queryIndex] = {Aabb::fromSphere(position, queryRadius), queryCategoryBitMask};
+            rayQueries[queryIndex] = {position + math::Vec3(0.0, queryRadius, 0.0), math::Vec3(0.0, -1.0, 0.0), 2.0 * queryRadius, queryCategoryBitMask};
+            nearestQueries[queryIndex] = {position, nearestCount, queryCategoryBitMask};
+        }
+
+        Clock::time_point startTime = Clock::now();
+        spatialIndex.querySpheres(sphereQueries, batchResults);
+        sphereQuerySamples.push_back(timePerQuery(startTime));
+
+        startTime = Clock::now();
+        bruteForceQuerySpheres(doodadStore, sphereQueries, bruteForceBatchResults);
+        bruteForceSphereQuerySamples.push_back(timePerQuery(startTime));
+        matchesBruteForce = matchesBruteForce && haveSameDoodads(batchResults, bruteForceBatchResults);
+
+        startTime = Clock::now();
+        spatialIndex.queryAabbs(aabbQueries, batchResults);
+        aabbQuerySamples.push_back(timePerQuery(startTime));
+
+        startTime = Clock::now();
+        spatialIndex.raycast(rayQueries, rayHits);
+        raycastSamples.push_back(timePerQuery(startTime));
+
+        frameArena.reset();
+        startTime = Clock::now();
+        spatialIndex.queryNearest(nearestQueries, batchResults, &frameArena);
+        nearestQuerySamples.push_back(timePerQuery(startTime));
+    }
+
+    const SpatialQueryBenchmarkResult result {
+        rigidBodyCount,
+        spatialIndex.getDoodadCount(),
+        spatialIndex.getHeight(),
+        tickCount,
+        DurationSummary::fromSamples(std::move(indexUpdateSamples)),
+        tickCount > 0 ? static_cast<double>(reinsertCount) / tickCount : 0.0,
+        DurationSummary::fromSamples(std::move(sphereQuerySamples)),
+        DurationSummary::fromSamples(std::move(aabbQuerySamples)),
+        DurationSummary::fromSamples(std::move(raycastSamples)),
+        DurationSummary::fromSamples(std::move(nearestQuerySamples)),
+        DurationSummary::fromSamples(std::move(bruteForceSphereQuerySamples)),
+        matchesBruteForce
+    };
+
+    LOG_INFO(GENERAL, "{} rigid bodies: index update mean {:.1f} us ( {} deep ), sphere {:.2f} us, aabb {:.2f} us, ray {:.2f} us, nearest {:.2f} us per query, brute force sphere {:.2f} us per query",
+        rigidBodyCount,
+        result.indexUpdateMicroseconds.mean,
+        result.treeHeight,
+        result.sphereQueryMicroseconds.mean,
+        result.aabbQueryMicroseconds.mean,
+        result.raycastMicroseconds.mean,
+        result.nearestQueryMicroseconds.mean,
+        result.bruteForceSphereQueryMicroseconds.mean
+    );
+    if (!result.matchesBruteForce) {
+        LOG_ERROR(GENERAL, "{} rigid bodies: the spatial index's sphere queries differ from walking every doodad", rigidBodyCount);
+    }
+
+    return result;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief Steps a benchmark scene and runs a batch of each kind of spatial index query around its doodads every
+ * tick, next to the same sphere queries answered by walking every doodad. Query durations are per query, all
+ * durations are in microseconds
+ */
+struct SpatialQueryBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    std::size_t rigidBodyCount;
+    std::size_t indexedDoodadCount;
+    int32_t treeHeight;
+    uint64_t tickCount;
+    DurationSummary indexUpdateMicroseconds;
+    double meanReinsertCountPerTick;
+    DurationSummary sphereQueryMicroseconds;
+    DurationSummary aabbQueryMicroseconds;
+    DurationSummary raycastMicroseconds;
+    DurationSummary nearestQueryMicroseconds;
+    DurationSummary bruteForceSphereQueryMicroseconds;
+
+    /**
+     * @brief Whether every sphere query found exactly the doodads that walking every doodad found
+     */
+    bool matchesBruteForce;
+};
+
+SpatialQueryBenchmarkResult
+runSpatialQueryBenchmark(
+    const std::size_t rigidBodyCount,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+);
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/benchmark/TransformKernelBenchmark.hpp"
+#include "pole_position/simd/TransformKernels.hpp"
+
+namespace {
+
+constexpr double toleranceEpsilons = 64.0;
+
+/**
+ * @brief Components of random vectors, unit quaternions, and scales, one vector per component. Half of the
+ * quaternions are built from random Euler angles with math::Quaternion::fromEulerAngles, the way the game builds
+ * most of its rotations, and the other half are random unit quaternions
+ */
+struct TransformKernelInputs {
+    std::vector<double> vectorX;
+    std::vector<double> vectorY;
+    std::vector<double> vectorZ;
+    std::vector<double> otherX;
+    std::vector<double> otherY;
+    std::vector<double> otherZ;
+    std::vector<double> rotationW;
+    std::vector<double> rotationX;
+    std::vector<double> rotationY;
+    std::vector<double> rotationZ;
+    std::vector<double> scaleX;
+    std::vector<double> scaleY;
+    std::vector<double> scaleZ;
+
+    ConstVec3Soa getVectors() const { return {vectorX, vectorY, vectorZ}; }
+    ConstVec3Soa getOthers() const { return {otherX, otherY, otherZ}; }
+    ConstQuaternionSoa getRotations() const { return {rotationW, rotationX, rotationY, rotationZ}; }
+    ConstVec3Soa getScales() const { return {scaleX, scaleY, scaleZ}; }
+    math::Vec3 getVector(const std::size_t i) const { return {vectorX[i], vectorY[i], vectorZ[i]}; }
+    math::Vec3 getOther(const std::size_t i) const { return {otherX[i], otherY[i], otherZ[i]}; }
+    math::Quaternion getRotation(const std::size_t i) const { return math::Quaternion(rotationW[i], rotationX[i], rotationY[i], rotationZ[i]); }
+};
+
+TransformKernelInputs
+createInputs(
+    const std::size_t elementCount
+) {
+    // Fixed seed so that every run and every instruction set sees the same data
+    std::mt19937 randomEngine(1234);
+    std::uniform_real_distribution<double> componentDistribution(-100.0, 100.0);
+    std::uniform_real_distribution<double> scaleDistribution(0.5, 2.0);
+    std::uniform_real_distribution<double> angleDistribution(-180.0, 180.0);
+
+    TransformKernelInputs inputs;
+    for (std::vector<double>* p_components : {
+        &inputs.vectorX, &inputs.vectorY, &inputs.vectorZ,
+        &inputs.otherX, &inputs.otherY, &inputs.otherZ,
+        &inputs.rotationW, &inputs.rotationX, &inputs.rotationY, &inputs.rotationZ
+    }) {
+        p_components->resize(elementCount);
+        for (double& component : *p_components) {
+            component = componentDistribution(randomEngine);
+        }
+    }
+    for (std::vector<double>* p_components : {&inputs.scaleX, &inputs.scaleY, &inputs.scaleZ}) {
+        p_components->resize(elementCount);
+        for (double& component : *p_components) {
+            component = scaleDistribution(randomEngine);
+        }
+    }
+
+    for (std::size_t i = 0; i < elementCount; ++i) {
+        const double magnitude = std::sqrt(
+            inputs.rotationW[i] * inputs.rotationW[i] +
+            inputs.rotationX[i] * inputs.rotationX[i] +
+            inputs.rotationY[i] * inputs.rotationY[i] +
+            inputs.rotationZ[i] * inputs.rotationZ[i]
+        );
+        inputs.rotationW[i] /= magnitude;
+        inputs.rotationX[i] /= magnitude;
+        inputs.rotationY[i] /= magnitude;
+        inputs.rotationZ[i] /= magnitude;
+    }
+
+    for (std::size_t i = 1; i < elementCount; i += 2) {
+        const double yawDegrees = angleDistribution(randomEngine);
+        const double pitchDegrees = angleDistribution(randomEngine);
+        const double rollDegrees = angleDistribution(randomEngine);
+        const math::Quaternion rotation = math::Quaternion::fromEulerAngles(yawDegrees, pitchDegrees, rollDegrees);
+        inputs.rotationW[i] = rotation.w;
+        inputs.rotationX[i] = rotation.x;
+        inputs.rotationY[i] = rotation.y;
+        inputs.rotationZ[i] = rotation.z;
+    }
+
+    // Zero length vectors take their own path through normalize
+    if (elementCount > 0) {
+        inputs.vectorX[0] = 0.0;
+        inputs.vectorY[0] = 0.0;
+        inputs.vectorZ[0] = 0.0;
+    }
+
+    return inputs;
+}
+
+math::Vec3
+applyMatrix(
+    const Matrix4& matrix,
+    const math::Vec3& point
+) {
+    const std::array<double, 16>& elements = matrix.elements;
+    return {
+        elements[0] * point.x + elements[4] * point.y + elements[8] * point.z + elements[12],
+        elements[1] * point.x + elements[5] * point.y + elements[9] * point.z + elements[13],
+        elements[2] * point.x + elements[6] * point.y + elements[10] * point.z + elements[14]
+    };
+}
+
+double
+getLargestComponent(
+    const math::Vec3& vector
+) {
+    return std::max({std::abs(vector.x), std::abs(vector.y), std::abs(vector.z)});
+}
+
+/**
+ * @brief How far apart two vectors are, in multiples of epsilon scaled by the size of the largest value involved
+ * in computing them
+ */
+double
+getErrorEpsilons(
+    const math::Vec3& actual,
+    const math::Vec3& expected,
+    const double largestValue
+) {
+    const double scale = std::max(1.0, largestValue);
+    const double error = std::max({std::abs(actual.x - expected.x), std::abs(actual.y - expected.y), std::abs(actual.z - expected.z)});
+    return error / (scale * std::numeric_limits<double>::epsilon());
+}
+
+/**
+ * @brief Runs a batch repetitionCount times and summarizes the time it took per element
+ */
+template<typename Batch>
+DurationSummary
+timeBatch(
+    const std::size_t elementCount,
+    const uint64_t repetitionCount,
+    const Batch& batch
+) {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<double> samples;
+    samples.reserve(repetitionCount);
+    for (uint64_t i = 0; i < repetitionCount; ++i) {
+        const Clock::time_point startTime = Clock::now();
+        batch();
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - startTime).count() / std::max<std::size_t>(elementCount, 1));
+    }
+
+    return DurationSummary::fromSamples(std::move(samples));
+}
+
+} // namespace
+
+void
+TransformKernelBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject()
+        .write("instructionSet", instructionSet)
+        .write("elementCount", static_cast<uint64_t>(elementCount))
+        .write("repetitionCount", repetitionCount);
+    normalizeNanoseconds.write(jsonWriter, "normalizeNanoseconds");
+    crossNanoseconds.write(jsonWriter, "crossNanoseconds");
+    rotateNanoseconds.write(jsonWriter, "rotateNanoseconds");
+    composeTrsNanoseconds.write(jsonWriter, "composeTrsNanoseconds");
+    composeInverseTrsNanoseconds.write(jsonWriter, "composeInverseTrsNanoseconds");
+    vec3NormalizeNanoseconds.write(jsonWriter, "vec3NormalizeNanoseconds");
+    vec3CrossNanoseconds.write(jsonWriter, "vec3CrossNanoseconds");
+    vec3RotateNanoseconds.write(jsonWriter, "vec3RotateNanoseconds");
+    jsonWriter
+        .write("maxErrorEpsilons", maxErrorEpsilons)
+        .write("withinTolerance", withinTolerance)
+        .endObject();
+}
+
+std::vector<TransformKernelBenchmarkResult>
+runTransformKernelBenchmark(
+    const std::size_t elementCount,
+    const uint64_t repetitionCount
+) {
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} elements", elementCount);
+
+    const TransformKernelInputs inputs = createInputs(elementCount);
+
+    // The math::Vec3 and math::Quaternion versions, one element at a time, which are both the baseline and the
+    // expected results
+    std::vector<math::Vec3> expectedNormalized(elementCount);
+    std::vector<math::Vec3> expectedCrossed(elementCount);
+    std::vector<math::Vec3> expectedRotated(elementCount);
+
+    const DurationSummary vec3NormalizeNanoseconds = timeBatch(elementCount, repetitionCount, [&] () {
+        for (std::size_t i = 0; i < elementCount; ++i) {
+            math::Vec3 vector = inputs.getVector(i);
+            if (vector.magnitude() > 0.0) {
+                vector.normalize();
+            }
+            expectedNormalized[i] = vector;
+        }
+    });
+    const DurationSummary vec3CrossNanoseconds = timeBatch(elementCount, repetitionCount, [&] () {
+        for (std::size_t i = 0; i < elementCount; ++i) {
+            expectedCrossed[i] = inputs.getVector(i).cross(inputs.getOther(i));
+        }
+    });
+    const DurationSummary vec3RotateNanoseconds = timeBatch(elementCount, repetitionCount, [&] () {
+        for (std::size_t i = 0; i < elementCount; ++i) {
+            expectedRotated[i] = inputs.getRotation(i).rotate(inputs.getVector(i));
+        }
+    });
+
+    std::vector<double> outputX(elementCount);
+    std::vector<double> outputY(elementCount);
+    std::vector<double> outputZ(elementCount);
+    const Vec3Soa outputs {outputX, outputY, outputZ};
+    std::vector<Matrix4> matrices(elementCount);
+    std::vector<Matrix4> inverseMatrices(elementCount);
+
+    std::vector<TransformKernelBenchmarkResult> results;
+    for (const TransformKernels::InstructionSet instructionSet : {
+        TransformKernels::InstructionSet::Scalar,
+        TransformKernels::InstructionSet::Sse2,
+        TransformKernels::InstructionSet::Avx2
+    }) {
+        if (!TransformKernels::isSupported(instructionSet)) {
+            LOG_INFO(GENERAL, "Skipping {}, which this build or CPU does not support", TransformKernels::getInstructionSetName(instructionSet));
+            continue;
+        }
+
+        const TransformKernels transformKernels(instructionSet);
+        double maxErrorEpsilons = 0.0;
+        const auto checkOutputs = [&] (const std::vector<math::Vec3>& expected, const auto& getLargestValue) {
+            for (std::size_t i = 0; i < elementCount; ++i) {
+                maxErrorEpsilons = std::max(maxErrorEpsilons, getErrorEpsilons({outputX[i], outputY[i], outputZ[i]}, expected[i], getLargestValue(i)));
+            }
+        };
+
+        const DurationSummary normalizeNanoseconds = timeBatch(elementCount, repetitionCount, [&] () {
+            transformKernels.normalize(inputs.getVectors(), outputs);
+        });
+        checkOutputs(expectedNormalized, [] (const std::size_t) { return 1.0; });
+
+        const DurationSummary crossNanoseconds = timeBatch(elementCount, repetitionCount, [&] () {
+            transformKernels.cross(inputs.getVectors(), inputs.getOthers(), outputs);
+        });
+        checkOutputs(expectedCrossed, [&] (const std::size_t i) {
+            return getLargestComponent(inputs.getVector(i)) * getLargestComponent(inputs.getOther(i));
+        });
+
+        const DurationSummary rotateNanoseconds = timeBatch(elementCount, repetitionCount, [&] () {
+            transformKernels.rotate(inputs.getRotations(), inputs.getVectors(), outputs);
+        });
+        checkOutputs(expectedRotated, [&] (const std::size_t i) {
+            return getLargestComponent(inputs.getVector(i));
+        });
+
+        const DurationSummary composeTrsNanoseconds = timeBatch(elementCount, repetitionCount, [&] () {
+            transformKernels.composeTrs(inputs.getOthers(), inputs.getRotations(), inputs.getScales(), matrices);
+        });
+        const DurationSummary composeInverseTrsNanoseconds = timeBatch(elementCount, repetitionCount, [&] () {
+            transformKernels.composeInverseTrs(inputs.getOthers(), inputs.getRotations(), inputs.getScales(), inverseMatrices);
+        });
+
+        // The matrix should move a point the way scaling, rotating, then translating it does, and its inverse
+        // should move it back
+        for (std::size_t i = 0; i < elementCount; ++i) {
+            const math::Vec3 point = inputs.getVector(i);
+            const math::Vec3 scaledPoint(point.x * inputs.scaleX[i], point.y * inputs.scaleY[i], point.z * inputs.scaleZ[i]);
+            const math::Vec3 transformedPoint = applyMatrix(matrices[i], point);
+            const double largestValue = std::max({getLargestComponent(scaledPoint), getLargestComponent(transformedPoint), getLargestComponent(inputs.getOther(i))});
+            maxErrorEpsilons = std::max(maxErrorEpsilons, getErrorEpsilons(transformedPoint, inputs.getRotation(i).rotate(scaledPoint) + inputs.getOther(i), largestValue));
+            maxErrorEpsilons = std::max(maxErrorEpsilons, getErrorEpsilons(applyMatrix(inverseMatrices[i], transformedPoint), point, largestValue));
+        }
+
+        const TransformKernelBenchmarkResult result {
+            TransformKernels::getInstructionSetName(instructionSet),
+            elementCount,
+            repetitionCount,
+            normalizeNanoseconds,
+            crossNanoseconds,
+            rotateNanoseconds,
+            composeTrsNanoseconds,
+            composeInverseTrsNanoseconds,
+            vec3NormalizeNanoseconds,
+            vec3CrossNanoseconds,
+            vec3RotateNanoseconds,
+            maxErrorEpsilons,
+            maxErrorEpsilons <= toleranceEpsilons
+        };
+
+        LOG_INFO(GENERAL, "{} elements, {}: normalize {:.2f} ns ( math::Vec3 {:.2f} ), cross {:.2f} ns ( {:.2f} ), rotate {:.2f} ns ( {:.2f} ), compose {:.2f} ns, inverse {:.2f} ns per element, max error {:.1f} epsilon",
+            elementCount,
+            result.instructionSet,
+            result.normalizeNanoseconds.mean,
+            result.vec3NormalizeNanoseconds.mean,
+            result.crossNanoseconds.mean,
+            result.vec3CrossNanoseconds.mean,
+            result.rotateNanoseconds.mean,
+            result.vec3RotateNanoseconds.mean,
+            result.composeTrsNanoseconds.mean,
+            result.composeInverseTrsNanoseconds.mean,
+            result.maxErrorEpsilons
+        );
+        if (!result.withinTolerance) {
+            LOG_ERROR(GENERAL, "{} elements, {}: results are more than {} epsilon away from the math library's", elementCount, result.instructionSet, toleranceEpsilons);
+        }
+
+        results.push_back(result);
+    }
+
+    return results;
+}
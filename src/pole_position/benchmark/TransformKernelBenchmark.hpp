@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief Times each TransformKernels kernel with one instruction set over a batch of random transforms, next to
+ * the same normalize, cross and rotate done one math::Vec3 and math::Quaternion at a time. Durations are in
+ * nanoseconds per element
+ */
+struct TransformKernelBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    const char* instructionSet;
+    std::size_t elementCount;
+    uint64_t repetitionCount;
+    DurationSummary normalizeNanoseconds;
+    DurationSummary crossNanoseconds;
+    DurationSummary rotateNanoseconds;
+    DurationSummary composeTrsNanoseconds;
+    DurationSummary composeInverseTrsNanoseconds;
+    DurationSummary vec3NormalizeNanoseconds;
+    DurationSummary vec3CrossNanoseconds;
+    DurationSummary vec3RotateNanoseconds;
+
+    /**
+     * @brief The largest difference from the math::Vec3 and math::Quaternion results, in multiples of epsilon
+     * scaled by the size of the expected value. The benchmark run fails when it is not within tolerance
+     */
+    double maxErrorEpsilons;
+    bool withinTolerance;
+};
+
+/**
+ * @brief One result for each instruction set the CPU supports
+ */
+std::vector<TransformKernelBenchmarkResult>
+runTransformKernelBenchmark(
+    const std::size_t elementCount,
+    const uint64_t repetitionCount
+);
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/benchmark/BenchmarkScenes.hpp"
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/benchmark/VehicleBenchmark.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/physics/Conversions.hpp"
+#include "pole_position/scene/SceneParameters.hpp"
+#include "pole_position/vehicle/VehicleAiSystem.hpp"
+#include "pole_position/vehicle/VehicleFleet.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+void
+VehicleBenchmarkResult::write(
+    JsonWriter& jsonWriter
+) const {
+    jsonWriter.beginObject()
+        .write("vehicleCount", static_cast<uint64_t>(vehicleCount))
+        .write("wheelCount", static_cast<uint64_t>(wheelCount))
+        .write("substepCount", static_cast<uint64_t>(substepCount))
+        .write("tickCount", tickCount);
+    fixedUpdateMicroseconds.write(jsonWriter, "fixedUpdateMicroseconds");
+    systemsFixedUpdateMicroseconds.write(jsonWriter, "systemsFixedUpdateMicroseconds");
+    vehicleRaycastMicroseconds.write(jsonWriter, "vehicleRaycastMicroseconds");
+    vehicleSolveMicroseconds.write(jsonWriter, "vehicleSolveMicroseconds");
+    physicsStepMicroseconds.write(jsonWriter, "physicsStepMicroseconds");
+    jsonWriter
+        .write("tickBudgetMicroseconds", tickBudgetMicroseconds)
+        .write("overBudgetTickCount", overBudgetTickCount)
+        .write("meanGroundedWheelFraction", meanGroundedWheelFraction)
+        .write("meanSpeed_mps", meanSpeed_mps)
+        .endObject();
+}
+
+VehicleBenchmarkResult
+runVehicleBenchmark(
+    const std::size_t vehicleCount,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+) {
+    constexpr double ticksPerSecond = 60.0;
+    constexpr uint32_t substepCount = 4;
+    constexpr std::size_t laneCount = 4;
+    constexpr double vehicleSpacing_m = 12.0;
+
+    LOG_FUNCTION_SCOPE_INFO(GENERAL, "{} vehicles", vehicleCount);
+
+    const InputState idleInputState = InputState::idle();
+
+    // The innermost lane is made long enough to fit its share of the grid
+    const std::size_t laneVehicleCount = (vehicleCount + laneCount - 1) / laneCount;
+    const VehicleAiSystem::Parameters trackParameters {
+        math::Vec3(0.0, 0.0, 0.0),
+        std::max(60.0, laneVehicleCount * vehicleSpacing_m / (2.0 * std::numbers::pi)),
+        5.0,
+        laneCount,
+        20.0,
+        15.0
+    };
+    const VehicleParameters vehicleParameters = createRaceCarVehicleParameters();
+
+    HeadlessSimulation simulation(createVehicleBenchmarkSceneParameters(vehicleCount, vehicleParameters, trackParameters), ticksPerSecond);
+    simulation.setPhysicsSubstepCount(substepCount);
+
+    std::vector<std::size_t> vehicleDoodadIndices(vehicleCount);
+    for (std::size_t i = 0; i < vehicleCount; ++i) {
+        vehicleDoodadIndices[i] = i;
+    }
+    simulation.addVehicles(vehicleDoodadIndices, vehicleParameters);
+    simulation.addSystem(std::make_unique<VehicleAiSystem>(trackParameters), vehicleDoodadIndices);
+
+    for (uint64_t i = 0; i < warmupTickCount; ++i) {
+        simulation.tick(idleInputState);
+    }
+
+    const double tickBudgetMicroseconds = 1'000'000.0 / ticksPerSecond;
+    std::vector<double> fixedUpdateSamples;
+    std::vector<double> systemsFixedUpdateSamples;
+    std::vector<double> vehicleRaycastSamples;
+    std::vector<double> vehicleSolveSamples;
+    std::vector<double> physicsStepSamples;
+    fixedUpdateSamples.reserve(tickCount);
+    systemsFixedUpdateSamples.reserve(tickCount);
+    vehicleRaycastSamples.reserve(tickCount);
+    vehicleSolveSamples.reserve(tickCount);
+    physicsStepSamples.reserve(tickCount);
+    uint64_t overBudgetTickCount = 0;
+    uint64_t groundedWheelCount = 0;
+    double speedSum_mps = 0.0;
+
+    const DoodadStore& doodadStore = simulation.getDoodadStore();
+    for (uint64_t i = 0; i < tickCount; ++i) {
+        simulation.tick(idleInputState);
+
+        const HeadlessSimulation::TickTimings& tickTimings = simulation.getLastTickTimings();
+        fixedUpdateSamples.push_back(tickTimings.fixedUpdateMicroseconds);
+        systemsFixedUpdateSamples.push_back(tickTimings.systemsFixedUpdateMicroseconds);
+        vehicleRaycastSamples.push_back(tickTimings.vehicleRaycastMicroseconds);
+        vehicleSolveSamples.push_back(tickTimings.vehicleSolveMicroseconds);
+        physicsStepSamples.push_back(tickTimings.physicsStepMicroseconds);
+        if (tickTimings.fixedUpdateMicroseconds > tickBudgetMicroseconds) {
+            ++overBudgetTickCount;
+        }
+        groundedWheelCount += tickTimings.groundedWheelCount;
+
+        for (const std::size_t doodadIndex : vehicleDoodadIndices) {
+            speedSum_mps += toMath(doodadStore.rigidBodies[doodadIndex]->getLinearVelocity()).magnitude();
+        }
+    }
+
+    const std::size_t wheelCount = simulation.getVehicleFleet()->getWheelCount();
+    const VehicleBenchmarkResult result {
+        vehicleCount,
+        wheelCount,
+        substepCount,
+        tickCount,
+        DurationSummary::fromSamples(std::move(fixedUpdateSamples)),
+        DurationSummary::fromSamples(std::move(systemsFixedUpdateSamples)),
+        DurationSummary::fromSamples(std::move(vehicleRaycastSamples)),
+        DurationSummary::fromSamples(std::move(vehicleSolveSamples)),
+        DurationSummary::fromSamples(std::move(physicsStepSamples)),
+        tickBudgetMicroseconds,
+        overBudgetTickCount,
+        tickCount > 0 && wheelCount > 0 ? static_cast<double>(groundedWheelCount) / (tickCount * wheelCount) : 0.0,
+        tickCount > 0 && vehicleCount > 0 ? speedSum_mps / (tickCount * vehicleCount) : 0.0
+    };
+
+    LOG_INFO(GENERAL, "{} vehicles: fixed update mean {:.1f} us p99 {:.1f} us, {} of {} ticks over the {:.0f} us budget",
+        vehicleCount,
+        result.fixedUpdateMicroseconds.mean,
+        result.fixedUpdateMicroseconds.p99,
+        result.overBudgetTickCount,
+        tickCount,
+        result.tickBudgetMicroseconds
+    );
+    LOG_INFO(GENERAL, "{} vehicles: wheel raycasts mean {:.1f} us, wheel solve mean {:.1f} us, physics step mean {:.1f} us over {} substeps",
+        vehicleCount,
+        result.vehicleRaycastMicroseconds.mean,
+        result.vehicleSolveMicroseconds.mean,
+        result.physicsStepMicroseconds.mean,
+        substepCount
+    );
+    LOG_INFO(GENERAL, "{} vehicles: {:.0f}% of wheels grounded, mean speed {:.1f} m/s", vehicleCount, result.meanGroundedWheelFraction * 100.0, result.meanSpeed_mps);
+
+    return result;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pole_position/benchmark/DurationSummary.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+
+/**
+ * @brief A grid of AI driven race cars lapping a circular track at 60 ticks per second, with the physics step cut
+ * into substeps for the vehicles. The vehicle costs are summed over each tick's substeps. All durations are in
+ * microseconds
+ */
+struct VehicleBenchmarkResult {
+public: // member functions
+    void write(JsonWriter& jsonWriter) const;
+
+public: // member variables
+    std::size_t vehicleCount;
+    std::size_t wheelCount;
+    uint32_t substepCount;
+    uint64_t tickCount;
+    DurationSummary fixedUpdateMicroseconds;
+    DurationSummary systemsFixedUpdateMicroseconds;
+    DurationSummary vehicleRaycastMicroseconds;
+    DurationSummary vehicleSolveMicroseconds;
+    DurationSummary physicsStepMicroseconds;
+
+    /**
+     * @brief The ticks whose fixed update took longer than a tick lasts
+     */
+    double tickBudgetMicroseconds;
+    uint64_t overBudgetTickCount;
+
+    /**
+     * @brief Whether the cars actually drove: how many wheels were on the ground and how fast the cars went
+     */
+    double meanGroundedWheelFraction;
+    double meanSpeed_mps;
+};
+
+VehicleBenchmarkResult
+runVehicleBenchmark(
+    const std::size_t vehicleCount,
+    const uint64_t warmupTickCount,
+    const uint64_t tickCount
+);
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/Boilerplate.hpp"
+#include "pole_position/benchmark/GhostBenchmark.hpp"
+#include "pole_position/benchmark/JobScalingBenchmark.hpp"
+#include "pole_position/benchmark/JsonWriter.hpp"
+#include "pole_position/benchmark/LoggingBenchmark.hpp"
+#include "pole_position/benchmark/SceneBenchmark.hpp"
+#include "pole_position/benchmark/SnapshotBenchmark.hpp"
+#include "pole_position/benchmark/SpatialQueryBenchmark.hpp"
+#include "pole_position/benchmark/TransformKernelBenchmark.hpp"
+#include "pole_position/benchmark/VehicleBenchmark.hpp"
+
+struct BenchmarkOptions {
+    std::vector<std::string> suites;
+    std::vector<std::size_t> rigidBodyCounts;
+    std::vector<std::size_t> workerCounts;
+    std::vector<std::size_t> vehicleCounts;
+    std::vector<std::size_t> ghostCounts;
+    uint64_t warmupTickCount;
+    uint64_t tickCount;
+    uint64_t logCallCount;
+    std::string outputFilepath;
+
+    bool shouldRun(const std::string& suite) const { return std::find(suites.begin(), suites.end(), suite) != suites.end(); }
+};
+
+const std::vector<std::string> allBenchmarkSuites = {"scenes", "jobs", "spatial", "simd", "logging", "vehicles", "ghosts", "snapshots"};
+
+std::vector<std::string>
+splitList(
+    const std::string& string
+) {
+    std::vector<std::string> elements;
+
+    std::size_t start = 0;
+    while (start <= string.size()) {
+        const std::size_t end = std::min(string.find(',', start), string.size());
+        elements.push_back(string.substr(start, end - start));
+        start = end + 1;
+    }
+
+    return elements;
+}
+
+std::optional<std::vector<std::size_t>>
+parseCountList(
+    const std::string& string
+) {
+    std::vector<std::size_t> counts;
+
+    for (const std::string& element : splitList(string)) {
+        char* p_end = nullptr;
+        errno = 0;
+        const unsigned long long count = std::strtoull(element.c_str(), &p_end, 10);
+        if (errno != 0 || element.empty() || *p_end != '\0' || element[0] == '-') {
+            return std::nullopt;
+        }
+        counts.push_back(static_cast<std::size_t>(count));
+    }
+
+    return counts;
+}
+
+std::vector<std::size_t>
+getDefaultWorkerCounts() {
+    // Powers of two up to the machine's thread count, and the thread count itself
+    const std::size_t hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<std::size_t> workerCounts;
+    for (std::size_t workerCount = 1; workerCount < hardwareThreadCount; workerCount *= 2) {
+        workerCounts.push_back(workerCount);
+    }
+    workerCounts.push_back(hardwareThreadCount);
+
+    return workerCounts;
+}
+
+std::optional<BenchmarkOptions>
+parseBenchmarkOptions(
+    const int argc,
+    const char* const argv[]
+) {
+    BenchmarkOptions options {
+        allBenchmarkSuites,
+        {10, 1000, 10000, 100000},
+        getDefaultWorkerCounts(),
+        {1, 50, 200},
+        {1, 100, 500},
+        30,
+        300,
+        10'000'000,
+        "PolePositionBenchmark.json"
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--suites" && hasValue) {
+            options.suites = splitList(argv[++i]);
+            for (const std::string& suite : options.suites) {
+                if (std::find(allBenchmarkSuites.begin(), allBenchmarkSuites.end(), suite) == allBenchmarkSuites.end()) {
+                    LOG_ERROR(GENERAL, "Unknown benchmark suite \"{}\"", suite);
+                    return std::nullopt;
+                }
+            }
+            continue;
+        }
+
+        if (argument == "--sizes" && hasValue) {
+            const std::optional<std::vector<std::size_t>> o_counts = parseCountList(argv[++i]);
+            if (!o_counts) {
+                LOG_ERROR(GENERAL, "Invalid size list \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.rigidBodyCounts = *o_counts;
+            continue;
+        }
+
+        if (argument == "--workers" && hasValue) {
+            const std::optional<std::vector<std::size_t>> o_counts = parseCountList(argv[++i]);
+            if (!o_counts) {
+                LOG_ERROR(GENERAL, "Invalid worker count list \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.workerCounts = *o_counts;
+            continue;
+        }
+
+        if (argument == "--vehicles" && hasValue) {
+            const std::optional<std::vector<std::size_t>> o_counts = parseCountList(argv[++i]);
+            if (!o_counts) {
+                LOG_ERROR(GENERAL, "Invalid vehicle count list \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.vehicleCounts = *o_counts;
+            continue;
+        }
+
+        if (argument == "--ghosts" && hasValue) {
+            const std::optional<std::vector<std::size_t>> o_counts = parseCountList(argv[++i]);
+            if (!o_counts) {
+                LOG_ERROR(GENERAL, "Invalid ghost count list \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.ghostCounts = *o_counts;
+            continue;
+        }
+
+        if ((argument == "--ticks" || argument == "--warmup" || argument == "--log-calls") && hasValue) {
+            const std::optional<std::vector<std::size_t>> o_counts = parseCountList(argv[++i]);
+            if (!o_counts || o_counts->size() != 1) {
+                LOG_ERROR(GENERAL, "Invalid count \"{}\" for {}", argv[i], argument);
+                return std::nullopt;
+            }
+            uint64_t& count =
+                argument == "--ticks" ? options.tickCount :
+                argument == "--warmup" ? options.warmupTickCount :
+                options.logCallCount;
+            count = o_counts->front();
+            continue;
+        }
+
+        if (argument == "--output" && hasValue) {
+            options.outputFilepath = argv[++i];
+            continue;
+        }
+
+        LOG_ERROR(GENERAL, "Unrecognized argument \"{}\"", argument);
+        LOG_INFO(GENERAL, "Usage: {} [--suites scenes,jobs,spatial,simd,logging,vehicles,ghosts,snapshots] [--sizes 10,1000,10000,100000] [--workers 1,2,4,8] [--vehicles 1,50,200] [--ghosts 1,100,500] [--warmup <ticks>] [--ticks <ticks>] [--log-calls <count>] [--output <file.json>]", argv[0]);
+        return std::nullopt;
+    }
+
+    return options;
+}
+
+int main(int argc, char* argv[]) {
+    DO_BOILERPLATE(false);
+
+    const std::optional<BenchmarkOptions> o_options = parseBenchmarkOptions(argc, argv);
+    if (!o_options) {
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream outputFile(o_options->outputFilepath);
+    if (!outputFile) {
+        LOG_ERROR(GENERAL, "Failed to open {} for writing", o_options->outputFilepath);
+        return EXIT_FAILURE;
+    }
+
+    JsonWriter jsonWriter(outputFile);
+    jsonWriter.beginObject()
+        .write("application", APPLICATION_NAME)
+        .write("version", std::to_string(APPLICATION_MAJOR_VERSION) + "." + std::to_string(APPLICATION_MINOR_VERSION) + "." + std::to_string(APPLICATION_PATCH_VERSION))
+        .write("warmupTickCount", o_options->warmupTickCount);
+
+    // A suite whose results disagree with their reference still writes them out, but the run fails so that
+    // scripts notice
+    bool allResultsAreCorrect = true;
+
+    try {
+        if (o_options->shouldRun("scenes")) {
+            jsonWriter.beginArray("scenes");
+            for (const std::size_t rigidBodyCount : o_options->rigidBodyCounts) {
+                runSceneBenchmark(rigidBodyCount, o_options->warmupTickCount, o_options->tickCount).write(jsonWriter);
+            }
+            jsonWriter.endArray();
+        }
+
+        if (o_options->shouldRun("jobs")) {
+            jsonWriter.beginArray("jobs");
+            for (const std::size_t rigidBodyCount : o_options->rigidBodyCounts) {
+                for (const JobScalingBenchmarkResult& result : runJobScalingBenchmark(rigidBodyCount, o_options->workerCounts, o_options->warmupTickCount, o_options->tickCount)) {
+                    result.write(jsonWriter);
+                    allResultsAreCorrect = allResultsAreCorrect && result.matchesSerial;
+                }
+            }
+            jsonWriter.endArray();
+        }
+
+        if (o_options->shouldRun("spatial")) {
+            jsonWriter.beginArray("spatial");
+            for (const std::size_t rigidBodyCount : o_options->rigidBodyCounts) {
+                runSpatialQueryBenchmark(rigidBodyCount, o_options->warmupTickCount, o_options->tickCount).write(jsonWriter);
+            }
+            jsonWriter.endArray();
+        }
+
+        if (o_options->shouldRun("simd")) {
+            jsonWriter.beginArray("simd");
+            for (const std::size_t elementCount : o_options->rigidBodyCounts) {
+                for (const TransformKernelBenchmarkResult& result : runTransformKernelBenchmark(elementCount, o_options->tickCount)) {
+                    result.write(jsonWriter);
+                    allResultsAreCorrect = allResultsAreCorrect && result.withinTolerance;
+                }
+            }
+            jsonWriter.endArray();
+        }
+
+        if (o_options->shouldRun("logging")) {
+            runLoggingBenchmark(o_options->logCallCount).write(jsonWriter);
+        }
+
+        if (o_options->shouldRun("vehicles")) {
+            jsonWriter.beginArray("vehicles");
+            for (const std::size_t vehicleCount : o_options->vehicleCounts) {
+                runVehicleBenchmark(vehicleCount, o_options->warmupTickCount, o_options->tickCount).write(jsonWriter);
+            }
+            jsonWriter.endArray();
+        }
+
+        if (o_options->shouldRun("ghosts")) {
+            runGhostBenchmark(o_options->ghostCounts, o_options->warmupTickCount, o_options->tickCount).write(jsonWriter);
+        }
+
+        if (o_options->shouldRun("snapshots")) {
+            jsonWriter.beginArray("snapshots");
+            for (const std::size_t rigidBodyCount : o_options->rigidBodyCounts) {
+                runSnapshotBenchmark(rigidBodyCount, o_options->warmupTickCount, o_options->tickCount).write(jsonWriter);
+            }
+            jsonWriter.endArray();
+        }
+    } catch (const std::exception& e) {
+        LOG_CRITICAL(GENERAL, "Caught exception");
+        LOG_CRITICAL(GENERAL, "{}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    jsonWriter.endObject();
+
+    LOG_INFO(GENERAL, "Wrote benchmark results to {}", o_options->outputFilepath);
+
+    if (!allResultsAreCorrect) {
+        LOG_ERROR(GENERAL, "Some benchmark results disagree with their reference, see the errors above");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,418 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/command_line/CommandLineOptions.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+
+namespace {
+
+std::optional<uint64_t>
+parseUnsignedInteger(
+    const char* const string
+) {
+    char* p_end = nullptr;
+    errno = 0;
+    const unsigned long long value = std::strtoull(string, &p_end, 10);
+    if (errno != 0 || p_end == string || *p_end != '\0' || string[0] == '-') {
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(value);
+}
+
+std::optional<double>
+parseDouble(
+    const char* const string
+) {
+    char* p_end = nullptr;
+    errno = 0;
+    const double value = std::strtod(string, &p_end);
+    if (errno != 0 || p_end == string || *p_end != '\0') {
+        return std::nullopt;
+    }
+    return value;
+}
+
+} // namespace
+
+std::optional<CommandLineOptions>
+CommandLineOptions::parse(
+    const int argc,
+    const char* const argv[]
+) {
+    CommandLineOptions options {
+        false,
+        60.0,
+        std::nullopt,
+        "",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "",
+        0,
+        false,
+        144.0,
+        false,
+        "",
+        200.0,
+        {},
+        "",
+        10.0,
+        {},
+        "",
+        120,
+        "",
+        "",
+        1000.0,
+        "",
+        {},
+        1,
+        "",
+        ""
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--help" || argument == "-h") {
+            CommandLineOptions::logUsage(argv[0]);
+            return std::nullopt;
+        }
+
+        if (argument == "--headless") {
+            options.headless = true;
+            continue;
+        }
+
+        if (argument == "--ticks" && hasValue) {
+            const std::optional<uint64_t> o_tickCount = parseUnsignedInteger(argv[++i]);
+            if (!o_tickCount) {
+                LOG_ERROR(GENERAL, "Invalid tick count \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.o_tickCount = *o_tickCount;
+            continue;
+        }
+
+        if (argument == "--tick-rate" && hasValue) {
+            const std::optional<double> o_ticksPerSecond = parseDouble(argv[++i]);
+            if (!o_ticksPerSecond || *o_ticksPerSecond <= 0.0) {
+                LOG_ERROR(GENERAL, "Invalid tick rate \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.ticksPerSecond = *o_ticksPerSecond;
+            continue;
+        }
+
+        if (argument == "--record" && hasValue) {
+            options.inputRecordingFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--replay" && hasValue) {
+            options.inputReplayFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--async-log" && hasValue) {
+            options.asyncLogFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--profile" && hasValue) {
+            options.profileTraceFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--asset-cache" && hasValue) {
+            options.assetCacheDirectory = argv[++i];
+            continue;
+        }
+
+        if (argument == "--scene" && hasValue) {
+            options.sceneFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--compile-scene" && hasValue) {
+            options.compiledSceneFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--jobs" && hasValue) {
+            const std::optional<uint64_t> o_jobWorkerCount = parseUnsignedInteger(argv[++i]);
+            if (!o_jobWorkerCount || *o_jobWorkerCount > 256) {
+                LOG_ERROR(GENERAL, "Invalid job worker count \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.jobWorkerCount = static_cast<uint32_t>(*o_jobWorkerCount);
+            continue;
+        }
+
+        if (argument == "--simulation-thread") {
+            options.simulationThread = true;
+            continue;
+        }
+
+        if (argument == "--frame-rate" && hasValue) {
+            const std::optional<double> o_framesPerSecond = parseDouble(argv[++i]);
+            if (!o_framesPerSecond || *o_framesPerSecond <= 0.0) {
+                LOG_ERROR(GENERAL, "Invalid frame rate \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.framesPerSecond = *o_framesPerSecond;
+            continue;
+        }
+
+        if (argument == "--cull") {
+            options.culling = true;
+            continue;
+        }
+
+        if (argument == "--cull-log" && hasValue) {
+            options.culling = true;
+            options.cullingFrameLogFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--draw-distance" && hasValue) {
+            const std::optional<double> o_maxDrawDistance = parseDouble(argv[++i]);
+            if (!o_maxDrawDistance || *o_maxDrawDistance <= 0.0) {
+                LOG_ERROR(GENERAL, "Invalid draw distance \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.maxDrawDistance = *o_maxDrawDistance;
+            continue;
+        }
+
+        if (argument == "--model-draw-distance" && i + 2 < argc) {
+            const std::string modelFilepath = argv[++i];
+            const std::optional<double> o_maxDrawDistance = parseDouble(argv[++i]);
+            if (!o_maxDrawDistance || *o_maxDrawDistance <= 0.0) {
+                LOG_ERROR(GENERAL, "Invalid draw distance \"{}\" for {}", argv[i], modelFilepath);
+                return std::nullopt;
+            }
+            options.maxDrawDistancesByModel[modelFilepath] = *o_maxDrawDistance;
+            continue;
+        }
+
+        if (argument == "--memory-report" && hasValue) {
+            options.memoryReportFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--memory-report-interval" && hasValue) {
+            const std::optional<double> o_memoryReportIntervalSeconds = parseDouble(argv[++i]);
+            if (!o_memoryReportIntervalSeconds || *o_memoryReportIntervalSeconds < 0.0) {
+                LOG_ERROR(GENERAL, "Invalid memory report interval \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.memoryReportIntervalSeconds = *o_memoryReportIntervalSeconds;
+            continue;
+        }
+
+        if (argument == "--memory-budget" && i + 2 < argc) {
+            const std::optional<MemoryTag> o_tag = MemoryTracker::findTag(argv[++i]);
+            if (!o_tag) {
+                LOG_ERROR(GENERAL, "Unknown memory tag \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            const std::optional<double> o_budgetMebibytes = parseDouble(argv[++i]);
+            if (!o_budgetMebibytes || *o_budgetMebibytes <= 0.0) {
+                LOG_ERROR(GENERAL, "Invalid memory budget \"{}\" for {}", argv[i], MemoryTracker::getTagName(*o_tag));
+                return std::nullopt;
+            }
+            options.memoryBudgetBytesByTag[*o_tag] = static_cast<uint64_t>(*o_budgetMebibytes * 1024.0 * 1024.0);
+            continue;
+        }
+
+        if (argument == "--next-scene" && hasValue) {
+            options.nextSceneFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--transition-tick" && hasValue) {
+            const std::optional<uint64_t> o_transitionTick = parseUnsignedInteger(argv[++i]);
+            if (!o_transitionTick) {
+                LOG_ERROR(GENERAL, "Invalid transition tick \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.transitionTick = *o_transitionTick;
+            continue;
+        }
+
+        if (argument == "--terrain" && hasValue) {
+            options.terrainFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--generate-terrain" && hasValue) {
+            options.generatedTerrainFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--terrain-load-radius" && hasValue) {
+            const std::optional<double> o_terrainLoadRadius = parseDouble(argv[++i]);
+            if (!o_terrainLoadRadius || *o_terrainLoadRadius <= 0.0) {
+                LOG_ERROR(GENERAL, "Invalid terrain load radius \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.terrainLoadRadius = *o_terrainLoadRadius;
+            continue;
+        }
+
+        if (argument == "--record-trajectory" && hasValue) {
+            options.trajectoryRecordingFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--ghost" && hasValue) {
+            options.ghostTrajectoryFilepaths.push_back(argv[++i]);
+            continue;
+        }
+
+        if (argument == "--ghost-count" && hasValue) {
+            const std::optional<uint64_t> o_ghostCount = parseUnsignedInteger(argv[++i]);
+            if (!o_ghostCount || *o_ghostCount == 0 || *o_ghostCount > 10000) {
+                LOG_ERROR(GENERAL, "Invalid ghost count \"{}\"", argv[i]);
+                return std::nullopt;
+            }
+            options.ghostCount = static_cast<uint32_t>(*o_ghostCount);
+            continue;
+        }
+
+        if (argument == "--load-snapshot" && hasValue) {
+            options.snapshotLoadFilepath = argv[++i];
+            continue;
+        }
+
+        if (argument == "--save-snapshot" && hasValue) {
+            options.snapshotSaveFilepath = argv[++i];
+            continue;
+        }
+
+        LOG_ERROR(GENERAL, "Unrecognized argument \"{}\"", argument);
+        CommandLineOptions::logUsage(argv[0]);
+        return std::nullopt;
+    }
+
+    if (options.o_tickCount && !options.headless) {
+        LOG_ERROR(GENERAL, "--ticks is only supported together with --headless");
+        return std::nullopt;
+    }
+
+    if (options.jobWorkerCount > 0 && !options.headless) {
+        LOG_ERROR(GENERAL, "--jobs is only supported together with --headless");
+        return std::nullopt;
+    }
+
+    if (options.simulationThread && !options.headless) {
+        LOG_ERROR(GENERAL, "--simulation-thread is only supported together with --headless");
+        return std::nullopt;
+    }
+
+    // Quartz submits every doodad itself, so the windowed application has nothing to hand the culling results to
+    if (options.culling && !options.headless) {
+        LOG_ERROR(GENERAL, "--cull and --cull-log are only supported together with --headless");
+        return std::nullopt;
+    }
+
+    // The windowed application's scenes belong to quartz, which has no way to swap one in for another yet
+    if (!options.nextSceneFilepath.empty() && !options.headless) {
+        LOG_ERROR(GENERAL, "--next-scene is only supported together with --headless");
+        return std::nullopt;
+    }
+
+    if (!options.nextSceneFilepath.empty() && (options.simulationThread || options.culling)) {
+        LOG_ERROR(GENERAL, "--next-scene is not supported together with --simulation-thread, --cull or --cull-log");
+        return std::nullopt;
+    }
+
+    // Quartz builds its own ground from the scene's doodads, and has nowhere to put a streamed one
+    if (!options.terrainFilepath.empty() && !options.headless) {
+        LOG_ERROR(GENERAL, "--terrain is only supported together with --headless");
+        return std::nullopt;
+    }
+
+    if (!options.terrainFilepath.empty() && !options.nextSceneFilepath.empty()) {
+        LOG_ERROR(GENERAL, "--terrain is not supported together with --next-scene");
+        return std::nullopt;
+    }
+
+    // Quartz moves its doodads only through their rigid bodies and callbacks, and ghosts have neither
+    if ((!options.trajectoryRecordingFilepath.empty() || !options.ghostTrajectoryFilepaths.empty()) && !options.headless) {
+        LOG_ERROR(GENERAL, "--record-trajectory and --ghost are only supported together with --headless");
+        return std::nullopt;
+    }
+
+    if ((!options.trajectoryRecordingFilepath.empty() || !options.ghostTrajectoryFilepaths.empty()) && !options.nextSceneFilepath.empty()) {
+        LOG_ERROR(GENERAL, "--record-trajectory and --ghost are not supported together with --next-scene");
+        return std::nullopt;
+    }
+
+    // Quartz keeps its world to itself, so only the headless simulation has state to capture or restore
+    if ((!options.snapshotLoadFilepath.empty() || !options.snapshotSaveFilepath.empty()) && !options.headless) {
+        LOG_ERROR(GENERAL, "--load-snapshot and --save-snapshot are only supported together with --headless");
+        return std::nullopt;
+    }
+
+    if ((!options.snapshotLoadFilepath.empty() || !options.snapshotSaveFilepath.empty()) && !options.nextSceneFilepath.empty()) {
+        LOG_ERROR(GENERAL, "--load-snapshot and --save-snapshot are not supported together with --next-scene");
+        return std::nullopt;
+    }
+
+    if (!options.compiledSceneFilepath.empty() && options.sceneFilepath.empty()) {
+        LOG_ERROR(GENERAL, "--compile-scene needs the scene to compile from --scene");
+        return std::nullopt;
+    }
+
+    return options;
+}
+
+void
+CommandLineOptions::logUsage(
+    const char* const executableName
+) {
+    LOG_INFO(GENERAL, "Usage: {} [options]", executableName);
+    LOG_INFO(GENERAL, "  --headless           Simulate the scene without a window, swapchain or renderer");
+    LOG_INFO(GENERAL, "  --ticks <count>      Stop the headless simulation after this many fixed updates");
+    LOG_INFO(GENERAL, "  --tick-rate <hz>     Fixed update rate the simulation steps with (default 60)");
+    LOG_INFO(GENERAL, "  --record <file>      Record the player's input to a file");
+    LOG_INFO(GENERAL, "  --replay <file>      Drive the player with recorded input instead of the keyboard and mouse");
+    LOG_INFO(GENERAL, "  --async-log <file>   Write ASYNC_LOG_* calls from a background thread to a file ( - for stdout )");
+    LOG_INFO(GENERAL, "  --profile <file>     Profile instrumented scopes and write a Chrome trace to a file on exit");
+    LOG_INFO(GENERAL, "  --asset-cache <dir>  Cook assets into binary blobs in a directory and map them from there");
+    LOG_INFO(GENERAL, "  --scene <file>       Load the scene from a text or binary scene file instead of the built in demo level");
+    LOG_INFO(GENERAL, "  --compile-scene <file>  Compile the --scene file into a binary scene file and exit");
+    LOG_INFO(GENERAL, "  --jobs <count>       Run the headless systems' fixed updates on this many worker threads");
+    LOG_INFO(GENERAL, "  --simulation-thread  Tick the headless simulation in real time on its own thread, presenting interpolated frames");
+    LOG_INFO(GENERAL, "  --frame-rate <hz>    Frame rate frames are presented at with --simulation-thread (default 144)");
+    LOG_INFO(GENERAL, "  --cull               Cull the headless scene for the player's camera every frame and report the counts");
+    LOG_INFO(GENERAL, "  --cull-log <file>    Cull like --cull and write every frame's counts to a file as comma separated values");
+    LOG_INFO(GENERAL, "  --draw-distance <m>  Distance past which doodads are culled (default 200)");
+    LOG_INFO(GENERAL, "  --model-draw-distance <model> <m>  Draw distance for the doodads of one model, can be repeated");
+    LOG_INFO(GENERAL, "  --next-scene <file>  Stream this scene file in the background during the headless run and switch to it once it is built");
+    LOG_INFO(GENERAL, "  --transition-tick <tick>  Tick at which --next-scene starts streaming (default 120)");
+    LOG_INFO(GENERAL, "  --terrain <file>     Collide the headless scene with a streamed heightfield terrain, paged in around the player's camera");
+    LOG_INFO(GENERAL, "  --generate-terrain <file>  Write a 64x64 chunk, 67 km2 terrain file to try --terrain with and exit");
+    LOG_INFO(GENERAL, "  --terrain-load-radius <m>  Distance around the camera --terrain chunks are paged in within (default 1000)");
+    LOG_INFO(GENERAL, "  --record-trajectory <file>  Record the player's headless trajectory to a file that ghosts can replay");
+    LOG_INFO(GENERAL, "  --ghost <file>       Replay a recorded trajectory on ghost cars in the headless scene, can be repeated");
+    LOG_INFO(GENERAL, "  --ghost-count <count>  Ghosts per --ghost trajectory, each starting a second after the one before (default 1)");
+    LOG_INFO(GENERAL, "  --load-snapshot <file>  Start the headless simulation from a world snapshot of the same scene instead of its first tick");
+    LOG_INFO(GENERAL, "  --save-snapshot <file>  Write a world snapshot of the headless simulation to a file once it stops");
+    LOG_INFO(GENERAL, "  --memory-report <file>  Write the memory used per subsystem and asset to a file every so often, on SIGUSR1 and on exit");
+    LOG_INFO(GENERAL, "  --memory-report-interval <s>  Seconds between --memory-report reports, 0 for only on SIGUSR1 and exit (default 10)");
+    LOG_INFO(GENERAL, "  --memory-budget <tag> <MiB>  Warn when a subsystem ( general, physics, scene, spatial, assets, logging, jobs, memory ) goes over a budget, can be repeated");
+    LOG_INFO(GENERAL, "  --help               Show this message");
+}
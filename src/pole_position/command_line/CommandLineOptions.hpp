@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pole_position/memory/MemoryTracker.hpp"
+
+/**
+ * @brief Everything the PolePosition executable can be told from the command line
+ */
+struct CommandLineOptions {
+public: // member functions
+    static std::optional<CommandLineOptions> parse(const int argc, const char* const argv[]);
+    static void logUsage(const char* const executableName);
+
+public: // member variables
+    bool headless;
+    double ticksPerSecond;
+    std::optional<uint64_t> o_tickCount;
+    std::string inputRecordingFilepath;
+    std::string inputReplayFilepath;
+    std::string asyncLogFilepath;
+    std::string profileTraceFilepath;
+    std::string assetCacheDirectory;
+    std::string sceneFilepath;
+    std::string compiledSceneFilepath;
+    uint32_t jobWorkerCount;
+    bool simulationThread;
+    double framesPerSecond;
+    bool culling;
+    std::string cullingFrameLogFilepath;
+    double maxDrawDistance;
+    std::unordered_map<std::string, double> maxDrawDistancesByModel;
+    std::string memoryReportFilepath;
+    double memoryReportIntervalSeconds;
+    std::unordered_map<MemoryTag, uint64_t> memoryBudgetBytesByTag;
+    std::string nextSceneFilepath;
+    uint64_t transitionTick;
+    std::string terrainFilepath;
+    std::string generatedTerrainFilepath;
+    double terrainLoadRadius;
+    std::string trajectoryRecordingFilepath;
+    std::vector<std::string> ghostTrajectoryFilepaths;
+    uint32_t ghostCount;
+    std::string snapshotLoadFilepath;
+    std::string snapshotSaveFilepath;
+};
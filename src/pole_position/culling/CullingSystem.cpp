@@ -0,0 +1,67 @@
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/scene/camera/Camera.hpp"
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/culling/CullingSystem.hpp"
+#include "pole_position/culling/VisibilityCuller.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/third_person_controller/ThirdPersonController.hpp"
+
+CullingSystem::CullingSystem(
+    const ThirdPersonController& playerController,
+    const quartz::scene::Scene::Parameters& sceneParameters,
+    const DoodadStore& doodadStore,
+    const VisibilityCuller::Parameters& cullerParameters,
+    const std::string& frameLogFilepath
+) :
+    m_playerController(playerController),
+    m_visibilityCuller(sceneParameters, doodadStore, cullerParameters),
+    m_frameLogStream(),
+    m_frameIndex(0)
+{
+    if (frameLogFilepath.empty()) {
+        return;
+    }
+
+    m_frameLogStream.open(frameLogFilepath);
+    if (!m_frameLogStream) {
+        LOG_CRITICALthis("Failed to open {} for writing", frameLogFilepath);
+        throw std::runtime_error("Failed to open culling frame log for writing");
+    }
+    m_frameLogStream << "frame,visible,frustum_culled,distance_culled\n";
+}
+
+void
+CullingSystem::update(
+    const SystemContext& context
+) {
+    const quartz::scene::Camera& camera = m_playerController.getCamera();
+    const VisibilityCuller::FrameStatistics frameStatistics = m_visibilityCuller.cull(
+        {camera.getPosition(), camera.getLookDirection(), static_cast<double>(camera.getFovDegrees())},
+        context.doodadStore
+    );
+
+    ASYNC_LOG_TRACE(GENERAL, "Frame {} has {} visible doodads, {} outside of the frustum and {} too far away", m_frameIndex, frameStatistics.visibleCount, frameStatistics.frustumCulledCount, frameStatistics.distanceCulledCount);
+
+    if (m_frameLogStream.is_open()) {
+        m_frameLogStream << m_frameIndex << ',' << frameStatistics.visibleCount << ',' << frameStatistics.frustumCulledCount << ',' << frameStatistics.distanceCulledCount << '\n';
+    }
+
+    ++m_frameIndex;
+}
+
+void
+CullingSystem::logStatistics() const {
+    const VisibilityCuller::Statistics statistics = m_visibilityCuller.getStatistics();
+
+    LOG_INFOthis("Culled {} frames of {} doodads", statistics.frameCount, m_visibilityCuller.getDoodadCount());
+    LOG_INFOthis("  mean {:.1f} visible, {:.1f} outside of the frustum, {:.1f} too far away", statistics.meanVisibleCount, statistics.meanFrustumCulledCount, statistics.meanDistanceCulledCount);
+    LOG_INFOthis("  static results reused in {} frames, cull mean {:.2f} us, max {:.2f} us", statistics.reusedStaticResultsFrameCount, statistics.meanCullMicroseconds, statistics.maxCullMicroseconds);
+}
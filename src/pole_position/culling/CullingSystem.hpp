@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/culling/VisibilityCuller.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/third_person_controller/ThirdPersonController.hpp"
+
+/**
+ * @brief Culls the scene for the player's camera once per frame, standing in for the culling stage in front of
+ * draw submission in a headless run. It has to be added after the player's controller so that it sees the camera
+ * the frame is drawn with. Registered over no doodads, the culler knows all of them already.
+ *
+ * With a frame log every frame's counts are written as a line of comma separated values, so the culling of a
+ * recorded camera path can be compared between builds
+ */
+class CullingSystem : public DoodadSystem {
+public: // member functions
+    CullingSystem(
+        const ThirdPersonController& playerController,
+        const quartz::scene::Scene::Parameters& sceneParameters,
+        const DoodadStore& doodadStore,
+        const VisibilityCuller::Parameters& cullerParameters,
+        const std::string& frameLogFilepath
+    );
+
+    const char* getName() const override { return "Culling system"; }
+    void update(const SystemContext& context) override;
+
+    const VisibilityCuller& getVisibilityCuller() const { return m_visibilityCuller; }
+    void logStatistics() const;
+
+    USE_LOGGER(GENERAL);
+
+private: // member variables
+    const ThirdPersonController& m_playerController;
+    VisibilityCuller m_visibilityCuller;
+    std::ofstream m_frameLogStream;
+    uint64_t m_frameIndex;
+};
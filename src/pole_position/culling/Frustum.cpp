@@ -0,0 +1,63 @@
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/macros.hpp"
+
+#include "pole_position/culling/Frustum.hpp"
+
+Frustum::Plane
+Frustum::createPlane(
+    const math::Vec3& normal,
+    const math::Vec3& point
+) {
+    return {normal, -normal.dot(point)};
+}
+
+Frustum::Frustum(
+    const Parameters& parameters
+) :
+    m_planes()
+{
+    QUARTZ_ASSERT(parameters.lookDirection.isNormalized(), "Frustum look direction must be normalized");
+
+    const math::Vec3& forward = parameters.lookDirection;
+    math::Vec3 right = forward.cross(math::Vec3::Up);
+    right.normalize();
+    math::Vec3 up = right.cross(forward);
+    up.normalize();
+
+    const double halfHeightSlope = std::tan(glm::radians(parameters.verticalFovDegrees) * 0.5);
+    const double halfWidthSlope = halfHeightSlope * parameters.aspectRatio;
+
+    // The side planes pass through the camera, tilted in from the look direction by half of the field of view
+    math::Vec3 leftNormal = forward * halfWidthSlope + right;
+    math::Vec3 rightNormal = forward * halfWidthSlope - right;
+    math::Vec3 bottomNormal = forward * halfHeightSlope + up;
+    math::Vec3 topNormal = forward * halfHeightSlope - up;
+
+    m_planes = {
+        Frustum::createPlane(forward, parameters.position + forward * parameters.nearPlaneDistance),
+        Frustum::createPlane(-forward, parameters.position + forward * parameters.farPlaneDistance),
+        Frustum::createPlane(leftNormal.normalize(), parameters.position),
+        Frustum::createPlane(rightNormal.normalize(), parameters.position),
+        Frustum::createPlane(bottomNormal.normalize(), parameters.position),
+        Frustum::createPlane(topNormal.normalize(), parameters.position)
+    };
+}
+
+bool
+Frustum::intersectsSphere(
+    const math::Vec3& center,
+    const double radius
+) const {
+    for (const Plane& plane : m_planes) {
+        if (plane.normal.dot(center) + plane.distance < -radius) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+
+#include "math/transform/Vec3.hpp"
+
+/**
+ * @brief The six planes of a perspective camera's view volume, each facing into it
+ */
+class Frustum {
+public: // classes and enums
+    struct Parameters {
+        math::Vec3 position;
+        math::Vec3 lookDirection;
+        double verticalFovDegrees;
+        double aspectRatio;
+        double nearPlaneDistance;
+        double farPlaneDistance;
+    };
+
+public: // member functions
+    /**
+     * @brief The camera is upright like the ThirdPersonController's, so its right is the look direction crossed
+     * with world up. The look direction must be normalized and not straight up or down
+     */
+    explicit Frustum(const Parameters& parameters);
+
+    /**
+     * @brief False only when the sphere is entirely outside of one of the planes. Spheres just outside of a corner
+     * pass, which is the usual price for a test this cheap
+     */
+    bool intersectsSphere(const math::Vec3& center, const double radius) const;
+
+private: // classes and enums
+    struct Plane {
+        math::Vec3 normal;
+        double distance;
+    };
+
+private: // helpers
+    static Plane createPlane(const math::Vec3& normal, const math::Vec3& point);
+
+private: // member variables
+    std::array<Plane, 6> m_planes;
+};
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/scene/doodad/Doodad.hpp"
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/asset_loading/Gltf.hpp"
+#include "pole_position/culling/Frustum.hpp"
+#include "pole_position/culling/VisibilityCuller.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+bool
+VisibilityCuller::View::operator==(
+    const View& other
+) const {
+    return
+        position.x == other.position.x && position.y == other.position.y && position.z == other.position.z &&
+        lookDirection.x == other.lookDirection.x && lookDirection.y == other.lookDirection.y && lookDirection.z == other.lookDirection.z &&
+        verticalFovDegrees == other.verticalFovDegrees;
+}
+
+double
+VisibilityCuller::getModelBoundingRadius(
+    const std::string& modelFilepath
+) {
+    // The radius around the model's origin of the furthest corner of its bounds
+    std::ifstream inputStream(modelFilepath, std::ios::binary);
+    const std::string contents((std::istreambuf_iterator<char>(inputStream)), std::istreambuf_iterator<char>());
+
+    const std::optional<GlbChunks> o_glbChunks = splitGlb(contents);
+    const std::optional<GltfBounds> o_bounds = getGltfBounds(o_glbChunks ? o_glbChunks->json : std::string_view(contents));
+    if (!o_bounds) {
+        // The glTF sample cube, which goes from -1 to 1
+        LOG_WARNING(GENERAL, "Could not read the bounds of {}, culling its doodads as 2 meter cubes", modelFilepath);
+        return std::sqrt(3.0);
+    }
+
+    double radiusSquared = 0.0;
+    for (std::size_t i = 0; i < o_bounds->min.size(); ++i) {
+        const double extent = std::max(std::abs(o_bounds->min[i]), std::abs(o_bounds->max[i]));
+        radiusSquared += extent * extent;
+    }
+
+    return std::sqrt(radiusSquared);
+}
+
+VisibilityCuller::VisibilityCuller(
+    const quartz::scene::Scene::Parameters& sceneParameters,
+    const DoodadStore& doodadStore,
+    const Parameters& parameters
+) :
+    m_boundingRadii(),
+    m_maxDrawDistances(),
+    m_staticPositions(doodadStore.positions),
+    m_staticDoodadIndices(),
+    m_movableDoodadIndices(doodadStore.movableDoodadIndices),
+    m_parameters(parameters),
+    mo_staticResultsView(),
+    m_staticVisibleDoodadIndices(),
+    m_staticCullCounts(),
+    m_visibleDoodadIndices(),
+    m_frameCount(0),
+    m_totalVisibleCount(0),
+    m_totalFrustumCulledCount(0),
+    m_totalDistanceCulledCount(0),
+    m_reusedStaticResultsFrameCount(0),
+    m_totalCullMicroseconds(0.0),
+    m_maxCullMicroseconds(0.0)
+{
+    LOG_FUNCTION_SCOPE_INFOthis("{} doodads", doodadStore.size());
+
+    // Thousands of doodads usually share a handful of models, so each model is only read once
+    std::unordered_map<std::string, double> modelBoundingRadii;
+
+    const std::size_t doodadCount = doodadStore.size();
+    m_boundingRadii.reserve(doodadCount);
+    m_maxDrawDistances.reserve(doodadCount);
+    for (std::size_t doodadIndex = 0; doodadIndex < doodadCount; ++doodadIndex) {
+        const std::string& modelFilepath = sceneParameters.doodadParameters[doodadIndex].objectFilepath;
+
+        auto modelBoundingRadiusIterator = modelBoundingRadii.find(modelFilepath);
+        if (modelBoundingRadiusIterator == modelBoundingRadii.end()) {
+            modelBoundingRadiusIterator = modelBoundingRadii.emplace(modelFilepath, VisibilityCuller::getModelBoundingRadius(modelFilepath)).first;
+        }
+
+        const math::Vec3& scale = doodadStore.scales[doodadIndex];
+        const double maxScale = std::max({std::abs(static_cast<double>(scale.x)), std::abs(static_cast<double>(scale.y)), std::abs(static_cast<double>(scale.z))});
+        m_boundingRadii.push_back(modelBoundingRadiusIterator->second * maxScale);
+
+        const auto maxDrawDistanceIterator = m_parameters.maxDrawDistancesByModel.find(modelFilepath);
+        m_maxDrawDistances.push_back(maxDrawDistanceIterator != m_parameters.maxDrawDistancesByModel.end() ? maxDrawDistanceIterator->second : m_parameters.defaultMaxDrawDistance);
+    }
+
+    // Ghosts have no rigid body but move every tick all the same
+    m_movableDoodadIndices.insert(m_movableDoodadIndices.end(), doodadStore.ghostDoodadIndices.begin(), doodadStore.ghostDoodadIndices.end());
+
+    std::vector<bool> isMovable(doodadCount, false);
+    for (const std::size_t doodadIndex : m_movableDoodadIndices) {
+        isMovable[doodadIndex] = true;
+    }
+    for (std::size_t doodadIndex = 0; doodadIndex < doodadCount; ++doodadIndex) {
+        if (!isMovable[doodadIndex]) {
+            m_staticDoodadIndices.push_back(doodadIndex);
+        }
+    }
+
+    LOG_INFOthis("Culling {} static and {} movable doodads of {} models", m_staticDoodadIndices.size(), m_movableDoodadIndices.size(), modelBoundingRadii.size());
+}
+
+VisibilityCuller::CullCounts
+VisibilityCuller::cullDoodads(
+    const Frustum& frustum,
+    const View& view,
+    const std::vector<std::size_t>& doodadIndices,
+    const std::vector<math::Vec3>& positions,
+    std::vector<std::size_t>& visibleDoodadIndices
+) const {
+    CullCounts cullCounts {0, 0};
+
+    for (const std::size_t doodadIndex : doodadIndices) {
+        const math::Vec3& position = positions[doodadIndex];
+        const double radius = m_boundingRadii[doodadIndex];
+
+        // Distance first, it is one comparison against the frustum's six
+        const double dx = static_cast<double>(position.x - view.position.x);
+        const double dy = static_cast<double>(position.y - view.position.y);
+        const double dz = static_cast<double>(position.z - view.position.z);
+        const double reach = m_maxDrawDistances[doodadIndex] + radius;
+        if (dx * dx + dy * dy + dz * dz > reach * reach) {
+            ++cullCounts.distanceCulledCount;
+            continue;
+        }
+
+        if (!frustum.intersectsSphere(position, radius)) {
+            ++cullCounts.frustumCulledCount;
+            continue;
+        }
+
+        visibleDoodadIndices.push_back(doodadIndex);
+    }
+
+    return cullCounts;
+}
+
+VisibilityCuller::FrameStatistics
+VisibilityCuller::cull(
+    const View& view,
+    const DoodadStore& doodadStore
+) {
+    PROFILE_SCOPE("Visibility culling");
+
+    const Clock::time_point startTime = Clock::now();
+
+    const Frustum frustum({
+        view.position,
+        view.lookDirection,
+        view.verticalFovDegrees,
+        m_parameters.aspectRatio,
+        m_parameters.nearPlaneDistance,
+        m_parameters.farPlaneDistance
+    });
+
+    const bool reuseStaticResults = mo_staticResultsView && *mo_staticResultsView == view;
+    if (!reuseStaticResults) {
+        m_staticVisibleDoodadIndices.clear();
+        m_staticCullCounts = this->cullDoodads(frustum, view, m_staticDoodadIndices, m_staticPositions, m_staticVisibleDoodadIndices);
+        mo_staticResultsView = view;
+    }
+
+    m_visibleDoodadIndices.assign(m_staticVisibleDoodadIndices.begin(), m_staticVisibleDoodadIndices.end());
+    const CullCounts movableCullCounts = this->cullDoodads(frustum, view, m_movableDoodadIndices, doodadStore.positions, m_visibleDoodadIndices);
+
+    const FrameStatistics frameStatistics {
+        static_cast<uint32_t>(m_visibleDoodadIndices.size()),
+        m_staticCullCounts.frustumCulledCount + movableCullCounts.frustumCulledCount,
+        m_staticCullCounts.distanceCulledCount + movableCullCounts.distanceCulledCount,
+        reuseStaticResults,
+        std::chrono::duration<double, std::micro>(Clock::now() - startTime).count()
+    };
+
+    ++m_frameCount;
+    m_totalVisibleCount += frameStatistics.visibleCount;
+    m_totalFrustumCulledCount += frameStatistics.frustumCulledCount;
+    m_totalDistanceCulledCount += frameStatistics.distanceCulledCount;
+    m_reusedStaticResultsFrameCount += reuseStaticResults ? 1 : 0;
+    m_totalCullMicroseconds += frameStatistics.cullMicroseconds;
+    m_maxCullMicroseconds = std::max(m_maxCullMicroseconds, frameStatistics.cullMicroseconds);
+
+    return frameStatistics;
+}
+
+VisibilityCuller::Statistics
+VisibilityCuller::getStatistics() const {
+    if (m_frameCount == 0) {
+        return {0, 0.0, 0.0, 0.0, 0, 0.0, 0.0};
+    }
+
+    return {
+        m_frameCount,
+        static_cast<double>(m_totalVisibleCount) / m_frameCount,
+        static_cast<double>(m_totalFrustumCulledCount) / m_frameCount,
+        static_cast<double>(m_totalDistanceCulledCount) / m_frameCount,
+        m_reusedStaticResultsFrameCount,
+        m_totalCullMicroseconds / m_frameCount,
+        m_maxCullMicroseconds
+    };
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/culling/Frustum.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+/**
+ * @brief Works out which doodads a camera can see before anything is drawn. Each doodad is bounded by the sphere
+ * around its position that holds its model however the doodad is rotated, taken from the model's glTF bounds and
+ * the doodad's scale. A doodad is culled when that sphere is further from the camera than its model's max draw
+ * distance, or is outside of the camera's frustum.
+ *
+ * Static doodads are culled against the frustum once per camera pose: their bounds are worked out once, and their
+ * results are reused for as long as the camera does not move, so a still camera only pays for the movable doodads.
+ */
+class VisibilityCuller {
+public: // classes and enums
+    struct Parameters {
+        double defaultMaxDrawDistance;
+
+        /**
+         * @brief Keyed by model filepath, overrides the default for every doodad of that model
+         */
+        std::unordered_map<std::string, double> maxDrawDistancesByModel;
+
+        double aspectRatio;
+        double nearPlaneDistance;
+        double farPlaneDistance;
+    };
+
+    /**
+     * @brief The pose and lens of the camera doodads are culled for
+     */
+    struct View {
+        math::Vec3 position;
+        math::Vec3 lookDirection;
+        double verticalFovDegrees;
+
+        bool operator==(const View& other) const;
+    };
+
+    struct FrameStatistics {
+        uint32_t visibleCount;
+        uint32_t frustumCulledCount;
+        uint32_t distanceCulledCount;
+        bool reusedStaticResults;
+        double cullMicroseconds;
+    };
+
+    struct Statistics {
+        uint64_t frameCount;
+        double meanVisibleCount;
+        double meanFrustumCulledCount;
+        double meanDistanceCulledCount;
+        uint64_t reusedStaticResultsFrameCount;
+        double meanCullMicroseconds;
+        double maxCullMicroseconds;
+    };
+
+public: // member functions
+    /**
+     * @brief The scene parameters must be the ones the doodad store was built from, so that doodad i of both is
+     * the same doodad
+     */
+    VisibilityCuller(
+        const quartz::scene::Scene::Parameters& sceneParameters,
+        const DoodadStore& doodadStore,
+        const Parameters& parameters
+    );
+
+    FrameStatistics cull(const View& view, const DoodadStore& doodadStore);
+
+    /**
+     * @brief The doodads the last cull found visible, static ones first, each group in doodad index order
+     */
+    const std::vector<std::size_t>& getVisibleDoodadIndices() const { return m_visibleDoodadIndices; }
+    std::size_t getDoodadCount() const { return m_boundingRadii.size(); }
+    Statistics getStatistics() const;
+
+    USE_LOGGER(GENERAL);
+
+private: // classes and enums
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Where in the doodads' bounds the visible and culled counts come from
+     */
+    struct CullCounts {
+        uint32_t frustumCulledCount;
+        uint32_t distanceCulledCount;
+    };
+
+private: // helpers
+    static double getModelBoundingRadius(const std::string& modelFilepath);
+
+private: // member functions
+    CullCounts cullDoodads(
+        const Frustum& frustum,
+        const View& view,
+        const std::vector<std::size_t>& doodadIndices,
+        const std::vector<math::Vec3>& positions,
+        std::vector<std::size_t>& visibleDoodadIndices
+    ) const;
+
+private: // member variables
+    std::vector<double> m_boundingRadii;
+    std::vector<double> m_maxDrawDistances;
+    std::vector<math::Vec3> m_staticPositions;
+    std::vector<std::size_t> m_staticDoodadIndices;
+    std::vector<std::size_t> m_movableDoodadIndices;
+    Parameters m_parameters;
+
+    std::optional<View> mo_staticResultsView;
+    std::vector<std::size_t> m_staticVisibleDoodadIndices;
+    CullCounts m_staticCullCounts;
+
+    std::vector<std::size_t> m_visibleDoodadIndices;
+
+    uint64_t m_frameCount;
+    uint64_t m_totalVisibleCount;
+    uint64_t m_totalFrustumCulledCount;
+    uint64_t m_totalDistanceCulledCount;
+    uint64_t m_reusedStaticResultsFrameCount;
+    double m_totalCullMicroseconds;
+    double m_maxCullMicroseconds;
+};
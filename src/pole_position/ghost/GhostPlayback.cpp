@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/ghost/GhostPlayback.hpp"
+#include "pole_position/ghost/TrajectoryCodec.hpp"
+#include "pole_position/ghost/TrajectoryFile.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/snapshot/Interpolation.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+void
+GhostPlayback::startBlock(
+    Decoder& decoder,
+    const TrajectoryFile& trajectoryFile,
+    const uint32_t blockIndex
+) {
+    const std::span<const uint8_t> blockBytes = trajectoryFile.getBlockBytes(blockIndex);
+    decoder.codec.reset();
+    decoder.blockIndex = blockIndex;
+    decoder.p_cursor = blockBytes.data();
+    decoder.p_blockEnd = blockBytes.data() + blockBytes.size();
+
+    if (blockIndex + 1 < trajectoryFile.getBlockCount()) {
+        trajectoryFile.prefetchBlock(blockIndex + 1);
+    }
+}
+
+bool
+GhostPlayback::decodeNextFrame(
+    Decoder& decoder,
+    const TrajectoryFile& trajectoryFile,
+    uint32_t& decodedFrameCount
+) {
+    const uint32_t frameIndex = decoder.toFrameIndex + 1;
+    if (frameIndex % trajectoryFile.getFramesPerBlock() == 0) {
+        GhostPlayback::startBlock(decoder, trajectoryFile, frameIndex / trajectoryFile.getFramesPerBlock());
+    }
+
+    TrajectoryCodec::QuantizedFrame frame;
+    if (!decoder.codec.decode(decoder.p_cursor, decoder.p_blockEnd, frame) || frame.largestRotationIndex > 3) {
+        return false;
+    }
+
+    decoder.fromFrame = decoder.toFrame;
+    decoder.toFrame = frame;
+    decoder.toFrameIndex = frameIndex;
+    ++decodedFrameCount;
+    return true;
+}
+
+bool
+GhostPlayback::seek(
+    Decoder& decoder,
+    const TrajectoryFile& trajectoryFile,
+    const uint32_t toFrameIndex,
+    uint32_t& decodedFrameCount
+) {
+    const uint32_t fromFrameIndex = toFrameIndex > 0 ? toFrameIndex - 1 : 0;
+    const uint32_t blockIndex = fromFrameIndex / trajectoryFile.getFramesPerBlock();
+    GhostPlayback::startBlock(decoder, trajectoryFile, blockIndex);
+
+    if (!decoder.codec.decode(decoder.p_cursor, decoder.p_blockEnd, decoder.toFrame) || decoder.toFrame.largestRotationIndex > 3) {
+        return false;
+    }
+    decoder.fromFrame = decoder.toFrame;
+    decoder.toFrameIndex = blockIndex * trajectoryFile.getFramesPerBlock();
+    ++decodedFrameCount;
+
+    while (decoder.toFrameIndex < toFrameIndex) {
+        if (!GhostPlayback::decodeNextFrame(decoder, trajectoryFile, decodedFrameCount)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+GhostPlayback::GhostPlayback() :
+    m_doodadIndices(),
+    m_trajectoryFiles(),
+    m_ghostParameters(),
+    m_ghostStates(),
+    m_decoders(),
+    m_activeGhostIndices(),
+    m_interpolationFactors(),
+    m_updateCount(0),
+    m_totalActiveGhostCount(0),
+    m_totalDecodedFrameCount(0),
+    m_totalUpdateMicroseconds(0.0)
+{}
+
+void
+GhostPlayback::addGhost(
+    DoodadStore& doodadStore,
+    const std::size_t doodadIndex,
+    const TrajectoryFile& trajectoryFile,
+    const GhostParameters& ghostParameters
+) {
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Scene);
+
+    if (doodadIndex >= doodadStore.size() || doodadStore.rigidBodies[doodadIndex]) {
+        LOG_CRITICALthis("Doodad {} is not a doodad without a rigid body that can be a ghost ({} doodads)", doodadIndex, doodadStore.size());
+        throw std::runtime_error("Invalid doodad for ghost");
+    }
+    if (std::find(m_doodadIndices.begin(), m_doodadIndices.end(), doodadIndex) != m_doodadIndices.end()) {
+        LOG_CRITICALthis("Doodad {} is already a ghost", doodadIndex);
+        throw std::runtime_error("Invalid doodad for ghost");
+    }
+
+    Decoder decoder {TrajectoryCodec(), 0, 0, nullptr, nullptr, {}, {}};
+    uint32_t decodedFrameCount = 0;
+    if (!GhostPlayback::seek(decoder, trajectoryFile, 0, decodedFrameCount)) {
+        LOG_CRITICALthis("The first frame of {} does not decode", trajectoryFile.getFilepath());
+        throw std::runtime_error("Invalid trajectory file for ghost");
+    }
+
+    const double positionQuantum = trajectoryFile.getPositionQuantum();
+    doodadStore.positions[doodadIndex] = TrajectoryCodec::dequantizePosition(decoder.toFrame, positionQuantum);
+    doodadStore.rotations[doodadIndex] = TrajectoryCodec::dequantizeRotation(decoder.toFrame);
+    doodadStore.ghostDoodadIndices.push_back(doodadIndex);
+
+    m_doodadIndices.push_back(doodadIndex);
+    m_trajectoryFiles.push_back(&trajectoryFile);
+    m_ghostParameters.push_back(ghostParameters);
+    m_ghostStates.push_back(GhostState::Waiting);
+    m_decoders.push_back(decoder);
+    m_activeGhostIndices.reserve(m_doodadIndices.size());
+    m_interpolationFactors.reserve(m_doodadIndices.size());
+}
+
+GhostPlayback::UpdateTimings
+GhostPlayback::update(
+    DoodadStore& doodadStore,
+    const double seconds,
+    const uint64_t tickIndex
+) {
+    PROFILE_SCOPE("Ghost playback");
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point startTime = Clock::now();
+
+    m_activeGhostIndices.clear();
+    m_interpolationFactors.clear();
+    uint32_t decodedFrameCount = 0;
+
+    // Decode pass, each ghost only touches its own decoder and the bytes of its trajectory it is playing
+    for (std::size_t ghostIndex = 0; ghostIndex < m_doodadIndices.size(); ++ghostIndex) {
+        GhostState& ghostState = m_ghostStates[ghostIndex];
+        if (ghostState == GhostState::Finished) {
+            continue;
+        }
+
+        const TrajectoryFile& trajectoryFile = *m_trajectoryFiles[ghostIndex];
+        const GhostParameters& ghostParameters = m_ghostParameters[ghostIndex];
+        double framePosition = (seconds - ghostParameters.startSeconds) * trajectoryFile.getFramesPerSecond();
+        if (framePosition < 0.0) {
+            continue;
+        }
+
+        const uint32_t lastFrameIndex = trajectoryFile.getFrameCount() - 1;
+        if (ghostParameters.isLooping && lastFrameIndex > 0) {
+            framePosition = std::fmod(framePosition, static_cast<double>(lastFrameIndex));
+            ghostState = GhostState::Playing;
+        } else if (framePosition >= lastFrameIndex) {
+            // The last frame is written once and the ghost stays there
+            framePosition = lastFrameIndex;
+            ghostState = GhostState::Finished;
+        } else {
+            ghostState = GhostState::Playing;
+        }
+
+        const uint32_t toFrameIndex = std::min(static_cast<uint32_t>(framePosition) + 1, lastFrameIndex);
+        const double factor = lastFrameIndex > 0 ? std::clamp(framePosition - (toFrameIndex - 1.0), 0.0, 1.0) : 0.0;
+
+        Decoder& decoder = m_decoders[ghostIndex];
+        bool isDecoded = true;
+        if (toFrameIndex < decoder.toFrameIndex || toFrameIndex / trajectoryFile.getFramesPerBlock() > decoder.blockIndex + 1) {
+            isDecoded = GhostPlayback::seek(decoder, trajectoryFile, toFrameIndex, decodedFrameCount);
+        }
+        while (isDecoded && decoder.toFrameIndex < toFrameIndex) {
+            isDecoded = GhostPlayback::decodeNextFrame(decoder, trajectoryFile, decodedFrameCount);
+        }
+
+        if (!isDecoded) {
+            ASYNC_LOG_WARNING(GHOST, "Frame {} of doodad {}'s trajectory does not decode, the ghost stops there", decoder.toFrameIndex + 1, m_doodadIndices[ghostIndex]);
+            ghostState = GhostState::Finished;
+            continue;
+        }
+
+        m_activeGhostIndices.push_back(ghostIndex);
+        m_interpolationFactors.push_back(factor);
+    }
+    const Clock::time_point decodeEndTime = Clock::now();
+
+    // Interpolation pass, over only the ghosts that moved
+    for (std::size_t i = 0; i < m_activeGhostIndices.size(); ++i) {
+        const std::size_t ghostIndex = m_activeGhostIndices[i];
+        const Decoder& decoder = m_decoders[ghostIndex];
+        const double positionQuantum = m_trajectoryFiles[ghostIndex]->getPositionQuantum();
+        const double factor = m_interpolationFactors[i];
+
+        const math::Vec3 fromPosition = TrajectoryCodec::dequantizePosition(decoder.fromFrame, positionQuantum);
+        const math::Vec3 toPosition = TrajectoryCodec::dequantizePosition(decoder.toFrame, positionQuantum);
+
+        const std::size_t doodadIndex = m_doodadIndices[ghostIndex];
+        doodadStore.positions[doodadIndex] = fromPosition + (toPosition - fromPosition) * factor;
+        doodadStore.rotations[doodadIndex] = interpolateRotation(TrajectoryCodec::dequantizeRotation(decoder.fromFrame), TrajectoryCodec::dequantizeRotation(decoder.toFrame), factor);
+        doodadStore.lastActiveTickIndices[doodadIndex] = tickIndex;
+    }
+    const Clock::time_point endTime = Clock::now();
+
+    const UpdateTimings updateTimings {
+        std::chrono::duration<double, std::micro>(decodeEndTime - startTime).count(),
+        std::chrono::duration<double, std::micro>(endTime - decodeEndTime).count(),
+        static_cast<uint32_t>(m_activeGhostIndices.size()),
+        decodedFrameCount
+    };
+
+    ++m_updateCount;
+    m_totalActiveGhostCount += updateTimings.activeGhostCount;
+    m_totalDecodedFrameCount += updateTimings.decodedFrameCount;
+    m_totalUpdateMicroseconds += updateTimings.decodeMicroseconds + updateTimings.interpolateMicroseconds;
+
+    return updateTimings;
+}
+
+void
+GhostPlayback::resetGhostStates() {
+    std::fill(m_ghostStates.begin(), m_ghostStates.end(), GhostState::Waiting);
+}
+
+GhostPlayback::Statistics
+GhostPlayback::getStatistics() const {
+    const std::unordered_set<const TrajectoryFile*> trajectoryFiles(m_trajectoryFiles.begin(), m_trajectoryFiles.end());
+    std::size_t trajectoryByteCount = 0;
+    double trajectorySeconds = 0.0;
+    for (const TrajectoryFile* const p_trajectoryFile : trajectoryFiles) {
+        trajectoryByteCount += p_trajectoryFile->getByteCount();
+        trajectorySeconds += p_trajectoryFile->getDurationSeconds();
+    }
+
+    const std::size_t ghostCount = m_doodadIndices.size();
+    constexpr std::size_t stateBytesPerGhost =
+        sizeof(std::size_t) + sizeof(const TrajectoryFile*) + sizeof(GhostParameters) + sizeof(GhostState) + sizeof(Decoder) +
+        sizeof(std::size_t) + sizeof(double);
+
+    return {
+        ghostCount,
+        trajectoryFiles.size(),
+        m_updateCount,
+        m_updateCount > 0 ? static_cast<double>(m_totalActiveGhostCount) / m_updateCount : 0.0,
+        m_updateCount > 0 ? static_cast<double>(m_totalDecodedFrameCount) / m_updateCount : 0.0,
+        m_totalActiveGhostCount > 0 ? m_totalUpdateMicroseconds * 1000.0 / m_totalActiveGhostCount : 0.0,
+        stateBytesPerGhost,
+        ghostCount > 0 ? static_cast<double>(trajectoryByteCount) / ghostCount : 0.0,
+        trajectorySeconds > 0.0 ? trajectoryByteCount / trajectorySeconds : 0.0
+    };
+}
+
+void
+GhostPlayback::logStatistics() const {
+    const Statistics statistics = this->getStatistics();
+
+    LOG_INFOthis("Played {} ghosts from {} trajectories over {} updates, mean {:.1f} playing and {:.1f} frames decoded per update", statistics.ghostCount, statistics.trajectoryFileCount, statistics.updateCount, statistics.meanActiveGhostCount, statistics.meanDecodedFramesPerUpdate);
+    LOG_INFOthis("  {:.0f} ns per playing ghost per update, {} bytes of playback state per ghost", statistics.meanNanosecondsPerActiveGhost, statistics.stateBytesPerGhost);
+    LOG_INFOthis("  {:.0f} bytes of trajectory per ghost at most, {:.0f} bytes per second of trajectory, paged in as it plays", statistics.trajectoryBytesPerGhost, statistics.trajectoryBytesPerSecond);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/ghost/TrajectoryCodec.hpp"
+#include "pole_position/ghost/TrajectoryFile.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+/**
+ * @brief Plays recorded trajectories back onto ghosts, doodads without a rigid body that are only ever put where
+ * their trajectory says. Ghosts cost nothing in the physics step and have no callback of their own.
+ *
+ * Every ghost is moved in one update per tick over flat arrays. The first pass walks every ghost's decoder up to
+ * the two frames around the ghost's time, which is usually one frame per ghost, and the second pass interpolates
+ * between them for every ghost that moved and writes the results into the doodad store. Each ghost's decoder only
+ * holds its place in its trajectory file and the two frames it is between, the file's bytes are read out of its
+ * mapping as they are played, and the block after the one being played is prefetched so it is in memory by the
+ * time it is reached.
+ *
+ * The ghosts are in the doodad store's ghostDoodadIndices, and their lastActiveTickIndices are kept up to date like
+ * the movable doodads'
+ */
+class GhostPlayback {
+public: // classes and enums
+    struct GhostParameters {
+        /**
+         * @brief The simulation time the trajectory's first frame plays at. The ghost waits at its first frame
+         * until then, and a negative time starts it partway through its trajectory
+         */
+        double startSeconds;
+
+        /**
+         * @brief Whether to start the trajectory over from its first frame at its end, or stop at its last frame
+         */
+        bool isLooping;
+    };
+
+    struct UpdateTimings {
+        double decodeMicroseconds;
+        double interpolateMicroseconds;
+        uint32_t activeGhostCount;
+        uint32_t decodedFrameCount;
+    };
+
+    /**
+     * @brief The state is what the playback holds in memory per ghost. The trajectory bytes are the files' sizes
+     * shared out over the ghosts that play them, which is the most the files' mappings can cost per ghost
+     */
+    struct Statistics {
+        std::size_t ghostCount;
+        std::size_t trajectoryFileCount;
+        uint64_t updateCount;
+        double meanActiveGhostCount;
+        double meanDecodedFramesPerUpdate;
+        double meanNanosecondsPerActiveGhost;
+        std::size_t stateBytesPerGhost;
+        double trajectoryBytesPerGhost;
+        double trajectoryBytesPerSecond;
+    };
+
+public: // member functions
+    GhostPlayback();
+    GhostPlayback(const GhostPlayback& other) = delete;
+    GhostPlayback& operator=(const GhostPlayback& other) = delete;
+
+    /**
+     * @brief Puts the doodad at its trajectory's first frame. The doodad must not have a rigid body, and the
+     * trajectory file must outlive the playback
+     */
+    void addGhost(DoodadStore& doodadStore, const std::size_t doodadIndex, const TrajectoryFile& trajectoryFile, const GhostParameters& ghostParameters);
+
+    /**
+     * @brief Moves every ghost that is playing to where its trajectory is at the simulation time, marking it active
+     * in the tick
+     */
+    UpdateTimings update(DoodadStore& doodadStore, const double seconds, const uint64_t tickIndex);
+
+    /**
+     * @brief For when the simulation time went back, like when a world snapshot is restored. Ghosts that had
+     * finished play again from wherever the next update's time puts them
+     */
+    void resetGhostStates();
+
+    std::size_t getGhostCount() const { return m_doodadIndices.size(); }
+    Statistics getStatistics() const;
+    void logStatistics() const;
+
+    USE_LOGGER(GHOST);
+
+private: // classes and enums
+    enum class GhostState : uint8_t {
+        Waiting,
+        Playing,
+        Finished
+    };
+
+    /**
+     * @brief The two frames the ghost is between, toFrame being frame toFrameIndex, and where the frame after
+     * toFrame starts in the mapping
+     */
+    struct Decoder {
+        TrajectoryCodec codec;
+        uint32_t blockIndex;
+        uint32_t toFrameIndex;
+        const uint8_t* p_cursor;
+        const uint8_t* p_blockEnd;
+        TrajectoryCodec::QuantizedFrame fromFrame;
+        TrajectoryCodec::QuantizedFrame toFrame;
+    };
+
+private: // helpers
+    static void startBlock(Decoder& decoder, const TrajectoryFile& trajectoryFile, const uint32_t blockIndex);
+    static bool decodeNextFrame(Decoder& decoder, const TrajectoryFile& trajectoryFile, uint32_t& decodedFrameCount);
+
+    /**
+     * @brief Decodes from the start of the block before toFrameIndex, for when the ghost went back or skipped
+     * more than a block ahead
+     */
+    static bool seek(Decoder& decoder, const TrajectoryFile& trajectoryFile, const uint32_t toFrameIndex, uint32_t& decodedFrameCount);
+
+private: // member variables
+    // Per ghost
+    std::vector<std::size_t> m_doodadIndices;
+    std::vector<const TrajectoryFile*> m_trajectoryFiles;
+    std::vector<GhostParameters> m_ghostParameters;
+    std::vector<GhostState> m_ghostStates;
+    std::vector<Decoder> m_decoders;
+
+    // Per ghost that moved in the current update, which is what the interpolation pass walks
+    std::vector<std::size_t> m_activeGhostIndices;
+    std::vector<double> m_interpolationFactors;
+
+    uint64_t m_updateCount;
+    uint64_t m_totalActiveGhostCount;
+    uint64_t m_totalDecodedFrameCount;
+    double m_totalUpdateMicroseconds;
+};
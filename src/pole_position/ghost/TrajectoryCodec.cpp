@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/ghost/TrajectoryCodec.hpp"
+
+TrajectoryCodec::TrajectoryCodec() :
+    m_lastFrame(),
+    m_secondLastFrame(),
+    m_blockFrameCount(0)
+{}
+
+TrajectoryCodec::QuantizedFrame
+TrajectoryCodec::quantize(
+    const math::Vec3& position,
+    const math::Quaternion& rotation,
+    const double positionQuantum
+) {
+    QuantizedFrame frame;
+    frame.position = {
+        std::llround(position.x / positionQuantum),
+        std::llround(position.y / positionQuantum),
+        std::llround(position.z / positionQuantum)
+    };
+
+    std::array<double, 4> components = {rotation.w, rotation.x, rotation.y, rotation.z};
+    const double magnitude = std::sqrt(components[0] * components[0] + components[1] * components[1] + components[2] * components[2] + components[3] * components[3]);
+    if (magnitude <= 0.0) {
+        components = {1.0, 0.0, 0.0, 0.0};
+    }
+
+    frame.largestRotationIndex = 0;
+    for (uint32_t i = 1; i < 4; ++i) {
+        if (std::abs(components[i]) > std::abs(components[frame.largestRotationIndex])) {
+            frame.largestRotationIndex = i;
+        }
+    }
+
+    // q and -q are the same rotation, so the one with a positive largest component is stored
+    const double scale = (components[frame.largestRotationIndex] < 0.0 ? -1.0 : 1.0) / (magnitude > 0.0 ? magnitude : 1.0);
+    uint32_t smallIndex = 0;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i == frame.largestRotationIndex) {
+            continue;
+        }
+        frame.rotation[smallIndex++] = std::clamp<int64_t>(std::llround(components[i] * scale * s_rotationComponentScale), -16383, 16383);
+    }
+
+    return frame;
+}
+
+math::Vec3
+TrajectoryCodec::dequantizePosition(
+    const QuantizedFrame& frame,
+    const double positionQuantum
+) {
+    return math::Vec3(
+        static_cast<double>(frame.position[0]) * positionQuantum,
+        static_cast<double>(frame.position[1]) * positionQuantum,
+        static_cast<double>(frame.position[2]) * positionQuantum
+    );
+}
+
+math::Quaternion
+TrajectoryCodec::dequantizeRotation(
+    const QuantizedFrame& frame
+) {
+    std::array<double, 4> components;
+    double smallSquaredSum = 0.0;
+    uint32_t smallIndex = 0;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i == frame.largestRotationIndex) {
+            continue;
+        }
+        components[i] = static_cast<double>(frame.rotation[smallIndex++]) / s_rotationComponentScale;
+        smallSquaredSum += components[i] * components[i];
+    }
+    components[frame.largestRotationIndex] = std::sqrt(std::max(0.0, 1.0 - smallSquaredSum));
+
+    return math::Quaternion(components[0], components[1], components[2], components[3]);
+}
+
+void
+TrajectoryCodec::writeVarint(
+    uint64_t value,
+    std::vector<uint8_t>& bytes
+) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+bool
+TrajectoryCodec::readVarint(
+    const uint8_t*& p_cursor,
+    const uint8_t* const p_end,
+    uint64_t& value
+) {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64 && p_cursor < p_end; shift += 7) {
+        const uint8_t byte = *p_cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TrajectoryCodec::QuantizedFrame
+TrajectoryCodec::predict() const {
+    if (m_blockFrameCount == 0) {
+        return {{0, 0, 0}, {0, 0, 0}, 0};
+    }
+    if (m_blockFrameCount == 1) {
+        return m_lastFrame;
+    }
+
+    QuantizedFrame prediction = m_lastFrame;
+    for (uint32_t i = 0; i < 3; ++i) {
+        prediction.position[i] += m_lastFrame.position[i] - m_secondLastFrame.position[i];
+        prediction.rotation[i] += m_lastFrame.rotation[i] - m_secondLastFrame.rotation[i];
+    }
+
+    return prediction;
+}
+
+void
+TrajectoryCodec::push(
+    const QuantizedFrame& frame
+) {
+    m_secondLastFrame = m_lastFrame;
+    m_lastFrame = frame;
+    ++m_blockFrameCount;
+}
+
+void
+TrajectoryCodec::encode(
+    const QuantizedFrame& frame,
+    std::vector<uint8_t>& bytes
+) {
+    // When the largest component changes the prediction is for the wrong components, which only costs that frame
+    // a few more bytes
+    const QuantizedFrame prediction = this->predict();
+    for (uint32_t i = 0; i < 3; ++i) {
+        TrajectoryCodec::writeVarint(TrajectoryCodec::zigzag(frame.position[i] - prediction.position[i]), bytes);
+    }
+    TrajectoryCodec::writeVarint((TrajectoryCodec::zigzag(frame.rotation[0] - prediction.rotation[0]) << 2) | frame.largestRotationIndex, bytes);
+    TrajectoryCodec::writeVarint(TrajectoryCodec::zigzag(frame.rotation[1] - prediction.rotation[1]), bytes);
+    TrajectoryCodec::writeVarint(TrajectoryCodec::zigzag(frame.rotation[2] - prediction.rotation[2]), bytes);
+
+    this->push(frame);
+}
+
+bool
+TrajectoryCodec::decode(
+    const uint8_t*& p_cursor,
+    const uint8_t* const p_end,
+    QuantizedFrame& frame
+) {
+    const QuantizedFrame prediction = this->predict();
+
+    std::array<uint64_t, 6> values;
+    for (uint64_t& value : values) {
+        if (!TrajectoryCodec::readVarint(p_cursor, p_end, value)) {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        frame.position[i] = prediction.position[i] + TrajectoryCodec::unzigzag(values[i]);
+    }
+    frame.largestRotationIndex = static_cast<uint32_t>(values[3] & 0b11);
+    frame.rotation[0] = prediction.rotation[0] + TrajectoryCodec::unzigzag(values[3] >> 2);
+    frame.rotation[1] = prediction.rotation[1] + TrajectoryCodec::unzigzag(values[4]);
+    frame.rotation[2] = prediction.rotation[2] + TrajectoryCodec::unzigzag(values[5]);
+
+    this->push(frame);
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+/**
+ * @brief Encodes and decodes the frames of one block of a trajectory file.
+ *
+ * A frame is quantized before it is encoded. Its position becomes whole multiples of the file's position quantum,
+ * and its rotation becomes the smallest three of its components in 15 bits and a sign each, the largest one being
+ * implied by the quaternion's unit length. Each frame is then stored as how far it is off from a prediction made
+ * from the block's frames before it, as zigzagged varints:
+ *
+ *   position x, y, z | rotation a << 2 | the largest component's index | rotation b, c
+ *
+ * The block's first frame is predicted to be all zeros, so it is stored as it is, its second frame is predicted
+ * to be the first, and every frame after that is predicted to carry on in a straight line from the two before it.
+ * A car is mostly going where it was already going, so most of a frame fits in a byte per value
+ */
+class TrajectoryCodec {
+public: // classes and enums
+    struct QuantizedFrame {
+        std::array<int64_t, 3> position;
+
+        /**
+         * @brief The rotation's components in w, x, y, z order with the largest one left out, after flipping the
+         * rotation so that the largest one is positive
+         */
+        std::array<int64_t, 3> rotation;
+        uint32_t largestRotationIndex;
+    };
+
+public: // member functions
+    TrajectoryCodec();
+
+    static QuantizedFrame quantize(const math::Vec3& position, const math::Quaternion& rotation, const double positionQuantum);
+    static math::Vec3 dequantizePosition(const QuantizedFrame& frame, const double positionQuantum);
+    static math::Quaternion dequantizeRotation(const QuantizedFrame& frame);
+
+    /**
+     * @brief Starts a block, whose first frame is predicted from nothing
+     */
+    void reset() { m_blockFrameCount = 0; }
+
+    void encode(const QuantizedFrame& frame, std::vector<uint8_t>& bytes);
+
+    /**
+     * @brief Reads the next frame from the cursor, which is left after it. False if the frame runs past p_end, in
+     * which case the frame and the cursor are garbage
+     */
+    bool decode(const uint8_t*& p_cursor, const uint8_t* const p_end, QuantizedFrame& frame);
+
+private: // helpers
+    static uint64_t zigzag(const int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+    static int64_t unzigzag(const uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+    static void writeVarint(uint64_t value, std::vector<uint8_t>& bytes);
+    static bool readVarint(const uint8_t*& p_cursor, const uint8_t* const p_end, uint64_t& value);
+
+private: // member functions
+    QuantizedFrame predict() const;
+    void push(const QuantizedFrame& frame);
+
+private: // static variables
+    /**
+     * @brief The smallest three components of a unit quaternion are within +-1/sqrt(2), which this maps to +-16383
+     */
+    static constexpr double s_rotationComponentScale = 16383.0 * std::numbers::sqrt2;
+
+private: // member variables
+    QuantizedFrame m_lastFrame;
+    QuantizedFrame m_secondLastFrame;
+    uint32_t m_blockFrameCount;
+};
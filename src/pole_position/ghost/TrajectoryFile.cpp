@@ -0,0 +1,73 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/asset_loading/MappedFile.hpp"
+#include "pole_position/ghost/TrajectoryFile.hpp"
+#include "pole_position/ghost/TrajectoryFileFormat.hpp"
+
+TrajectoryFile::TrajectoryFile(
+    const std::string& filepath
+) :
+    m_filepath(filepath),
+    m_mappedFile(filepath),
+    mp_header(nullptr),
+    mp_blockEntries(nullptr)
+{
+    const std::string_view contents = m_mappedFile.getContents();
+    if (contents.size() < sizeof(trajectory_file_format::Header)) {
+        throw std::runtime_error(filepath + " is not a trajectory file");
+    }
+
+    // The mapping starts on a page, and the block table is aligned by the recorder
+    mp_header = reinterpret_cast<const trajectory_file_format::Header*>(contents.data());
+    if (mp_header->magic != trajectory_file_format::magic || mp_header->version != trajectory_file_format::version) {
+        throw std::runtime_error(filepath + " is not a trajectory file of version " + std::to_string(trajectory_file_format::version));
+    }
+
+    if (mp_header->frameCount == 0 || mp_header->framesPerBlock == 0 || !(mp_header->framesPerSecond > 0.0) || !(mp_header->positionQuantum > 0.0)) {
+        throw std::runtime_error(filepath + " has no frames or a malformed header, it may not have been finished recording");
+    }
+    if (mp_header->blockCount != (mp_header->frameCount + mp_header->framesPerBlock - 1) / mp_header->framesPerBlock) {
+        throw std::runtime_error(fmt::format("{} has {} blocks for {} frames", filepath, mp_header->blockCount, mp_header->frameCount));
+    }
+
+    const uint64_t blockTableByteCount = static_cast<uint64_t>(mp_header->blockCount) * sizeof(trajectory_file_format::BlockEntry);
+    if (mp_header->blockTableOffset % alignof(trajectory_file_format::BlockEntry) != 0 || mp_header->blockTableOffset < sizeof(trajectory_file_format::Header) || mp_header->blockTableOffset > contents.size() || blockTableByteCount > contents.size() - mp_header->blockTableOffset) {
+        throw std::runtime_error(filepath + " is truncated");
+    }
+    mp_blockEntries = reinterpret_cast<const trajectory_file_format::BlockEntry*>(contents.data() + mp_header->blockTableOffset);
+
+    // The blocks themselves are only read once they are played, a block that does not decode ends its ghosts there
+    for (uint32_t blockIndex = 0; blockIndex < mp_header->blockCount; ++blockIndex) {
+        const trajectory_file_format::BlockEntry& blockEntry = mp_blockEntries[blockIndex];
+        if (blockEntry.byteOffset < sizeof(trajectory_file_format::Header) || blockEntry.byteOffset > mp_header->blockTableOffset || blockEntry.byteCount > mp_header->blockTableOffset - blockEntry.byteOffset) {
+            throw std::runtime_error(fmt::format("{} has block {} out of bounds", filepath, blockIndex));
+        }
+    }
+
+    LOG_INFOthis("Mapped {} frames ( {:.1f} seconds at {} frames per second ) in {} blocks from {}, {:.2f} bytes per frame", mp_header->frameCount, this->getDurationSeconds(), mp_header->framesPerSecond, mp_header->blockCount, filepath, static_cast<double>(contents.size()) / mp_header->frameCount);
+}
+
+std::span<const uint8_t>
+TrajectoryFile::getBlockBytes(
+    const uint32_t blockIndex
+) const {
+    const trajectory_file_format::BlockEntry& blockEntry = mp_blockEntries[blockIndex];
+    return {reinterpret_cast<const uint8_t*>(m_mappedFile.getContents().data()) + blockEntry.byteOffset, static_cast<std::size_t>(blockEntry.byteCount)};
+}
+
+void
+TrajectoryFile::prefetchBlock(
+    const uint32_t blockIndex
+) const {
+    const trajectory_file_format::BlockEntry& blockEntry = mp_blockEntries[blockIndex];
+    m_mappedFile.prefetch(blockEntry.byteOffset, blockEntry.byteCount);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/asset_loading/MappedFile.hpp"
+#include "pole_position/ghost/TrajectoryFileFormat.hpp"
+
+/**
+ * @brief A recorded trajectory, mapped straight out of its file and decoded where it lies. Only the blocks that
+ * are being played are ever paged in, so any number of ghosts can share one file and a long recording costs no
+ * more memory than a short one. Frame i is at i / framesPerSecond seconds into the recording
+ */
+class TrajectoryFile {
+public: // member functions
+    /**
+     * @brief Throws if the file cannot be mapped or is not a trajectory file
+     */
+    explicit TrajectoryFile(const std::string& filepath);
+    TrajectoryFile(const TrajectoryFile& other) = delete;
+    TrajectoryFile& operator=(const TrajectoryFile& other) = delete;
+
+    const std::string& getFilepath() const { return m_filepath; }
+    std::size_t getByteCount() const { return m_mappedFile.getByteCount(); }
+    uint32_t getFrameCount() const { return mp_header->frameCount; }
+    uint32_t getFramesPerBlock() const { return mp_header->framesPerBlock; }
+    uint32_t getBlockCount() const { return mp_header->blockCount; }
+    double getFramesPerSecond() const { return mp_header->framesPerSecond; }
+    double getPositionQuantum() const { return mp_header->positionQuantum; }
+    double getDurationSeconds() const { return (mp_header->frameCount - 1) / mp_header->framesPerSecond; }
+
+    std::span<const uint8_t> getBlockBytes(const uint32_t blockIndex) const;
+
+    /**
+     * @brief Ask the kernel to start paging the block in, so that playback does not fault on it when it gets there
+     */
+    void prefetchBlock(const uint32_t blockIndex) const;
+
+    USE_LOGGER(GHOST);
+
+private: // member variables
+    std::string m_filepath;
+    MappedFile m_mappedFile;
+    const trajectory_file_format::Header* mp_header;
+    const trajectory_file_format::BlockEntry* mp_blockEntries;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The layout of a trajectory file, the transform of one doodad once per frame at a fixed rate.
+ *
+ * The frames are cut into blocks of framesPerBlock frames, and each block is encoded on its own so that playback
+ * can start at any block without decoding the ones before it. The block table is written last, since a recording
+ * does not know how many blocks it will have until it ends:
+ *
+ *   Header | block 0 | block 1 | ... | padding to 8 bytes | BlockEntry[blockCount]
+ *
+ * How a block's frames are encoded is up to the TrajectoryCodec
+ */
+namespace trajectory_file_format {
+
+constexpr std::array<char, 4> magic = {'P', 'P', 'G', 'T'};
+constexpr uint16_t version = 1;
+
+/**
+ * @brief About four seconds at 60 frames per second, which keeps a seek under 256 frames of decoding and a block
+ * to a few pages
+ */
+constexpr uint16_t defaultFramesPerBlock = 256;
+
+/**
+ * @brief Positions are stored to the nearest half millimetre
+ */
+constexpr double defaultPositionQuantum = 1.0 / 1024.0;
+
+constexpr std::size_t streamBufferSize = 64 * 1024;
+
+struct Header {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint16_t framesPerBlock;
+    uint32_t frameCount;
+    uint32_t blockCount;
+    double framesPerSecond;
+    double positionQuantum;
+    uint64_t blockTableOffset;
+};
+static_assert(sizeof(Header) == 40);
+
+struct BlockEntry {
+    uint64_t byteOffset;
+    uint64_t byteCount;
+};
+static_assert(sizeof(BlockEntry) == 16);
+
+constexpr uint64_t
+alignUp(
+    const uint64_t offset
+) {
+    return (offset + alignof(BlockEntry) - 1) & ~static_cast<uint64_t>(alignof(BlockEntry) - 1);
+}
+
+} // namespace trajectory_file_format
@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/ghost/TrajectoryCodec.hpp"
+#include "pole_position/ghost/TrajectoryFileFormat.hpp"
+#include "pole_position/ghost/TrajectoryRecorder.hpp"
+
+TrajectoryRecorder::TrajectoryRecorder(
+    const std::string& filepath,
+    const double framesPerSecond
+) :
+    m_filepath(filepath),
+    m_framesPerSecond(framesPerSecond),
+    m_streamBuffer(),
+    m_outputStream(),
+    m_codec(),
+    m_blockBytes(),
+    m_blockEntries(),
+    m_byteOffset(sizeof(trajectory_file_format::Header)),
+    m_frameCount(0)
+{
+    m_outputStream.rdbuf()->pubsetbuf(m_streamBuffer.data(), m_streamBuffer.size());
+    m_outputStream.open(m_filepath, std::ios::binary | std::ios::trunc);
+    if (!m_outputStream) {
+        LOG_CRITICALthis("Failed to open {} for writing", m_filepath);
+        throw std::runtime_error("Failed to open trajectory recording for writing");
+    }
+
+    // The header is only known once the recording ends, so it is written over this then
+    const trajectory_file_format::Header header {};
+    this->writeValues(&header, 1);
+
+    LOG_INFOthis("Recording trajectory to {} at {} frames per second", m_filepath, m_framesPerSecond);
+}
+
+TrajectoryRecorder::~TrajectoryRecorder() {
+    if (!m_blockBytes.empty()) {
+        this->writeBlock();
+    }
+
+    const uint64_t blockTableOffset = trajectory_file_format::alignUp(m_byteOffset);
+    const std::vector<char> padding(blockTableOffset - m_byteOffset, 0);
+    this->writeValues(padding.data(), padding.size());
+    this->writeValues(m_blockEntries.data(), m_blockEntries.size());
+
+    const trajectory_file_format::Header header {
+        trajectory_file_format::magic,
+        trajectory_file_format::version,
+        trajectory_file_format::defaultFramesPerBlock,
+        m_frameCount,
+        static_cast<uint32_t>(m_blockEntries.size()),
+        m_framesPerSecond,
+        trajectory_file_format::defaultPositionQuantum,
+        blockTableOffset
+    };
+    m_outputStream.seekp(0);
+    this->writeValues(&header, 1);
+    m_outputStream.flush();
+
+    if (!m_outputStream) {
+        LOG_ERRORthis("Failed to write trajectory recording {}", m_filepath);
+        return;
+    }
+
+    // Against the three doubles and four doubles of a math::Vec3 and a math::Quaternion per frame
+    const uint64_t byteCount = blockTableOffset + m_blockEntries.size() * sizeof(trajectory_file_format::BlockEntry);
+    LOG_INFOthis("Recorded {} frames in {} blocks to {}, {} bytes ( {:.2f} bytes per frame, {:.1f}x smaller than raw transforms )",
+        m_frameCount,
+        m_blockEntries.size(),
+        m_filepath,
+        byteCount,
+        m_frameCount > 0 ? static_cast<double>(byteCount) / m_frameCount : 0.0,
+        byteCount > 0 ? static_cast<double>(m_frameCount) * 7 * sizeof(double) / byteCount : 0.0
+    );
+}
+
+void
+TrajectoryRecorder::writeBlock() {
+    m_blockEntries.push_back({m_byteOffset, m_blockBytes.size()});
+    this->writeValues(m_blockBytes.data(), m_blockBytes.size());
+    m_byteOffset += m_blockBytes.size();
+    m_blockBytes.clear();
+}
+
+void
+TrajectoryRecorder::record(
+    const math::Vec3& position,
+    const math::Quaternion& rotation
+) {
+    if (m_frameCount > 0 && m_frameCount % trajectory_file_format::defaultFramesPerBlock == 0) {
+        this->writeBlock();
+    }
+    if (m_frameCount % trajectory_file_format::defaultFramesPerBlock == 0) {
+        m_codec.reset();
+    }
+
+    m_codec.encode(TrajectoryCodec::quantize(position, rotation, trajectory_file_format::defaultPositionQuantum), m_blockBytes);
+    ++m_frameCount;
+}
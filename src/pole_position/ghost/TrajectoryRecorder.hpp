@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/ghost/TrajectoryCodec.hpp"
+#include "pole_position/ghost/TrajectoryFileFormat.hpp"
+
+/**
+ * @brief Writes one doodad's transform, once per frame, to a trajectory file (see TrajectoryFileFormat.hpp) that
+ * ghosts can be played back from. Each block is written as soon as it is full, so a recording only ever holds one
+ * block in memory however long it runs. The block table and the header are written when the recorder is destroyed
+ */
+class TrajectoryRecorder {
+public: // member functions
+    TrajectoryRecorder(
+        const std::string& filepath,
+        const double framesPerSecond
+    );
+    TrajectoryRecorder(const TrajectoryRecorder& other) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder& other) = delete;
+    ~TrajectoryRecorder();
+
+    void record(const math::Vec3& position, const math::Quaternion& rotation);
+
+    uint32_t getFrameCount() const { return m_frameCount; }
+
+    USE_LOGGER(GHOST);
+
+private: // member functions
+    void writeBlock();
+
+    template <typename T>
+    void writeValues(const T* p_values, const std::size_t count) { m_outputStream.write(reinterpret_cast<const char*>(p_values), static_cast<std::streamsize>(count * sizeof(T))); }
+
+private: // member variables
+    std::string m_filepath;
+    double m_framesPerSecond;
+    std::array<char, trajectory_file_format::streamBufferSize> m_streamBuffer;
+    std::ofstream m_outputStream;
+
+    TrajectoryCodec m_codec;
+    std::vector<uint8_t> m_blockBytes;
+    std::vector<trajectory_file_format::BlockEntry> m_blockEntries;
+    uint64_t m_byteOffset;
+    uint32_t m_frameCount;
+};
@@ -0,0 +1,899 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "util/macros.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "quartz/physics/collider/Collider.hpp"
+#include "quartz/physics/rigid_body/RigidBody.hpp"
+#include "quartz/scene/doodad/Doodad.hpp"
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/ghost/GhostPlayback.hpp"
+#include "pole_position/ghost/TrajectoryFile.hpp"
+#include "pole_position/ghost/TrajectoryRecorder.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/input/InputRecorder.hpp"
+#include "pole_position/input/InputReplayer.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/jobs/JobSystem.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+#include "pole_position/memory/AllocationCounter.hpp"
+#include "pole_position/memory/FrameArena.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/physics/ContactEventBuffer.hpp"
+#include "pole_position/physics/Conversions.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/snapshot/WorldSnapshot.hpp"
+#include "pole_position/snapshot/WorldSnapshotFormat.hpp"
+#include "pole_position/spatial/SpatialIndex.hpp"
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/third_person_controller/ThirdPersonController.hpp"
+#include "pole_position/third_person_controller/ThirdPersonControllerSystem.hpp"
+#include "pole_position/vehicle/VehicleControls.hpp"
+#include "pole_position/vehicle/VehicleFleet.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+std::atomic<bool> HeadlessSimulation::s_stopRequested = false;
+
+double
+HeadlessSimulation::getBoundingRadius(
+    const quartz::physics::Collider::Parameters& colliderParameters
+) {
+    if (const quartz::physics::BoxShape::Parameters* p_boxShapeParameters = std::get_if<quartz::physics::BoxShape::Parameters>(&colliderParameters.shapeParameters)) {
+        return p_boxShapeParameters->halfExtents_m.magnitude();
+    }
+
+    return std::get<quartz::physics::SphereShape::Parameters>(colliderParameters.shapeParameters).radius_m;
+}
+
+std::size_t
+HeadlessSimulation::getDoodadIndex(
+    const reactphysics3d::CollisionBody* const p_body
+) {
+    return static_cast<std::size_t>(reinterpret_cast<uintptr_t>(p_body->getUserData()));
+}
+
+reactphysics3d::BodyType
+HeadlessSimulation::getBodyType(
+    const quartz::physics::RigidBody::BodyType bodyType
+) {
+    switch (bodyType) {
+        case quartz::physics::RigidBody::BodyType::Static:
+            return reactphysics3d::BodyType::STATIC;
+        case quartz::physics::RigidBody::BodyType::Kinematic:
+            return reactphysics3d::BodyType::KINEMATIC;
+        case quartz::physics::RigidBody::BodyType::Dynamic:
+            return reactphysics3d::BodyType::DYNAMIC;
+    }
+
+    return reactphysics3d::BodyType::STATIC;
+}
+
+void
+HeadlessSimulation::ContactListener::record(
+    const ContactEventBuffer::EventType eventType,
+    const reactphysics3d::Collider* const p_collider1,
+    const reactphysics3d::Collider* const p_collider2,
+    const reactphysics3d::CollisionBody* const p_body1,
+    const reactphysics3d::CollisionBody* const p_body2,
+    const uint32_t contactPointCount
+) {
+    switch (eventType) {
+        case ContactEventBuffer::EventType::Start:
+            ++m_tickTimings.contactStartCount;
+            break;
+        case ContactEventBuffer::EventType::Stay:
+            ++m_tickTimings.contactStayCount;
+            break;
+        case ContactEventBuffer::EventType::End:
+            ++m_tickTimings.contactEndCount;
+            break;
+    }
+
+    if (m_contactEventBuffer.hasSubscribers()) {
+        m_contactEventBuffer.record(
+            eventType,
+            p_collider1->getCollisionCategoryBits(),
+            p_collider2->getCollisionCategoryBits(),
+            HeadlessSimulation::getDoodadIndex(p_body1),
+            HeadlessSimulation::getDoodadIndex(p_body2),
+            contactPointCount
+        );
+    }
+}
+
+void
+HeadlessSimulation::ContactListener::onContact(
+    const reactphysics3d::CollisionCallback::CallbackData& callbackData
+) {
+    PROFILE_SCOPE("Collision callback dispatch");
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point startTime = Clock::now();
+
+    for (uint32_t i = 0; i < callbackData.getNbContactPairs(); ++i) {
+        const reactphysics3d::CollisionCallback::ContactPair contactPair = callbackData.getContactPair(i);
+
+        ContactEventBuffer::EventType eventType = ContactEventBuffer::EventType::Start;
+        switch (contactPair.getEventType()) {
+            case reactphysics3d::CollisionCallback::ContactPair::EventType::ContactStart:
+                eventType = ContactEventBuffer::EventType::Start;
+                break;
+            case reactphysics3d::CollisionCallback::ContactPair::EventType::ContactStay:
+                eventType = ContactEventBuffer::EventType::Stay;
+                break;
+            case reactphysics3d::CollisionCallback::ContactPair::EventType::ContactExit:
+                eventType = ContactEventBuffer::EventType::End;
+                break;
+        }
+
+        this->record(eventType, contactPair.getCollider1(), contactPair.getCollider2(), contactPair.getBody1(), contactPair.getBody2(), contactPair.getNbContactPoints());
+    }
+
+    m_tickTimings.collisionCallbackMicroseconds += std::chrono::duration<double, std::micro>(Clock::now() - startTime).count();
+}
+
+void
+HeadlessSimulation::ContactListener::onTrigger(
+    const reactphysics3d::OverlapCallback::CallbackData& callbackData
+) {
+    PROFILE_SCOPE("Collision callback dispatch");
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point startTime = Clock::now();
+
+    for (uint32_t i = 0; i < callbackData.getNbOverlappingPairs(); ++i) {
+        const reactphysics3d::OverlapCallback::OverlapPair overlapPair = callbackData.getOverlappingPair(i);
+
+        ContactEventBuffer::EventType eventType = ContactEventBuffer::EventType::Start;
+        switch (overlapPair.getEventType()) {
+            case reactphysics3d::OverlapCallback::OverlapPair::EventType::OverlapStart:
+                eventType = ContactEventBuffer::EventType::Start;
+                break;
+            case reactphysics3d::OverlapCallback::OverlapPair::EventType::OverlapStay:
+                eventType = ContactEventBuffer::EventType::Stay;
+                break;
+            case reactphysics3d::OverlapCallback::OverlapPair::EventType::OverlapExit:
+                eventType = ContactEventBuffer::EventType::End;
+                break;
+        }
+
+        // Triggers only overlap, they have no contact points
+        this->record(eventType, overlapPair.getCollider1(), overlapPair.getCollider2(), overlapPair.getBody1(), overlapPair.getBody2(), 0);
+    }
+
+    m_tickTimings.collisionCallbackMicroseconds += std::chrono::duration<double, std::micro>(Clock::now() - startTime).count();
+}
+
+HeadlessSimulation::HeadlessSimulation(
+    const quartz::scene::Scene::Parameters& sceneParameters,
+    const double ticksPerSecond,
+    BuildMonitor* const p_buildMonitor
+) :
+    m_sceneName(sceneParameters.name),
+    m_ticksPerSecond(ticksPerSecond),
+    m_tickCount(0),
+    m_physicsSubstepCount(1),
+    m_physicsMemoryAllocator(),
+    m_physicsCommon(&m_physicsMemoryAllocator),
+    mp_physicsWorld(m_physicsCommon.createPhysicsWorld()),
+    m_collisionShapes(),
+    m_doodadStore(),
+    m_movableBodyWasAwakeFlags(),
+    mo_spatialIndex(),
+    mo_terrainColliders(),
+    mo_vehicleFleet(),
+    m_ghostPlayback(),
+    m_trajectoryRecorderEntries(),
+    m_systems(),
+    m_fixedUpdateSlices(),
+    m_commandBuffers(),
+    m_sliceFrameArenas(),
+    m_updateFrameArena(),
+    mp_jobSystem(nullptr),
+    mp_systemsMutex(nullptr),
+    mp_playerController(nullptr),
+    mp_inputRecorder(nullptr),
+    mp_inputReplayer(nullptr),
+    m_lastTickTimings(),
+    m_contactEventBuffer(),
+    m_contactListener(m_lastTickTimings, m_contactEventBuffer)
+{
+    LOG_FUNCTION_SCOPE_INFOthis("scene {}", m_sceneName);
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Scene);
+
+    mp_physicsWorld->setGravity(
+        sceneParameters.o_fieldParameters ?
+            toReactPhysics3d(sceneParameters.o_fieldParameters->gravity) :
+            reactphysics3d::Vector3(0.0, 0.0, 0.0)
+    );
+    mp_physicsWorld->setEventListener(&m_contactListener);
+
+    const std::size_t doodadCount = sceneParameters.doodadParameters.size();
+    m_doodadStore.positions.reserve(doodadCount);
+    m_doodadStore.rotations.reserve(doodadCount);
+    m_doodadStore.scales.reserve(doodadCount);
+    m_doodadStore.rigidBodies.reserve(doodadCount);
+    m_doodadStore.boundingRadii.reserve(doodadCount);
+    m_doodadStore.collisionCategoryBitMasks.reserve(doodadCount);
+    m_doodadStore.lastActiveTickIndices.reserve(doodadCount);
+    for (const quartz::scene::Doodad::Parameters& doodadParameters : sceneParameters.doodadParameters) {
+        if (p_buildMonitor && p_buildMonitor->isCancelRequested.load(std::memory_order_relaxed)) {
+            LOG_INFOthis("Cancelled building scene {} after {} of {} doodads", m_sceneName, m_doodadStore.size(), doodadCount);
+            throw std::runtime_error("Headless simulation build cancelled");
+        }
+
+        this->createDoodad(doodadParameters);
+
+        if (p_buildMonitor) {
+            p_buildMonitor->createdDoodadCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    mo_spatialIndex.emplace(m_doodadStore);
+
+    LOG_INFOthis("Created {} doodads ({} movable) sharing {} collision shapes for scene {}", m_doodadStore.size(), m_doodadStore.movableDoodadIndices.size(), m_collisionShapes.size(), m_sceneName);
+    LOG_INFOthis("Spatial index holds {} doodads, {} deep", mo_spatialIndex->getDoodadCount(), mo_spatialIndex->getHeight());
+}
+
+HeadlessSimulation::~HeadlessSimulation() {
+    // Its bodies live in the world
+    mo_terrainColliders.reset();
+    m_physicsCommon.destroyPhysicsWorld(mp_physicsWorld);
+}
+
+reactphysics3d::CollisionShape*
+HeadlessSimulation::createCollisionShape(
+    const quartz::physics::Collider::Parameters& colliderParameters
+) {
+    // Collision shapes hold no per body state, so every copy of a doodad can use the same one
+    CollisionShapeKey collisionShapeKey;
+    if (const quartz::physics::BoxShape::Parameters* p_boxShapeParameters = std::get_if<quartz::physics::BoxShape::Parameters>(&colliderParameters.shapeParameters)) {
+        const math::Vec3& halfExtents_m = p_boxShapeParameters->halfExtents_m;
+        collisionShapeKey = {colliderParameters.shapeParameters.index(), halfExtents_m.x, halfExtents_m.y, halfExtents_m.z};
+    } else {
+        const quartz::physics::SphereShape::Parameters& sphereShapeParameters = std::get<quartz::physics::SphereShape::Parameters>(colliderParameters.shapeParameters);
+        collisionShapeKey = {colliderParameters.shapeParameters.index(), static_cast<float>(sphereShapeParameters.radius_m), 0.0f, 0.0f};
+    }
+
+    reactphysics3d::CollisionShape*& p_collisionShape = m_collisionShapes[collisionShapeKey];
+    if (p_collisionShape) {
+        return p_collisionShape;
+    }
+
+    if (const quartz::physics::BoxShape::Parameters* p_boxShapeParameters = std::get_if<quartz::physics::BoxShape::Parameters>(&colliderParameters.shapeParameters)) {
+        p_collisionShape = m_physicsCommon.createBoxShape(toReactPhysics3d(p_boxShapeParameters->halfExtents_m));
+    } else {
+        const quartz::physics::SphereShape::Parameters& sphereShapeParameters = std::get<quartz::physics::SphereShape::Parameters>(colliderParameters.shapeParameters);
+        p_collisionShape = m_physicsCommon.createSphereShape(static_cast<reactphysics3d::decimal>(sphereShapeParameters.radius_m));
+    }
+
+    return p_collisionShape;
+}
+
+void
+HeadlessSimulation::createDoodad(
+    const quartz::scene::Doodad::Parameters& doodadParameters
+) {
+    const std::size_t doodadIndex = m_doodadStore.size();
+    m_doodadStore.positions.push_back(doodadParameters.transform.position);
+    m_doodadStore.rotations.push_back(doodadParameters.transform.rotation);
+    m_doodadStore.scales.push_back(doodadParameters.transform.scale);
+    m_doodadStore.lastActiveTickIndices.push_back(0);
+
+    if (!doodadParameters.o_rigidBodyParameters) {
+        m_doodadStore.rigidBodies.push_back(nullptr);
+        m_doodadStore.boundingRadii.push_back(0.0);
+        m_doodadStore.collisionCategoryBitMasks.push_back(0);
+        return;
+    }
+
+    const quartz::physics::RigidBody::Parameters& rigidBodyParameters = *doodadParameters.o_rigidBodyParameters;
+    const quartz::physics::Collider::Parameters& colliderParameters = rigidBodyParameters.colliderParameters;
+
+    reactphysics3d::RigidBody* p_rigidBody = mp_physicsWorld->createRigidBody({
+        toReactPhysics3d(doodadParameters.transform.position),
+        toReactPhysics3d(doodadParameters.transform.rotation)
+    });
+    p_rigidBody->setUserData(reinterpret_cast<void*>(static_cast<uintptr_t>(doodadIndex)));
+    p_rigidBody->setType(HeadlessSimulation::getBodyType(rigidBodyParameters.bodyType));
+    p_rigidBody->enableGravity(rigidBodyParameters.enableGravity);
+    p_rigidBody->setAngularLockAxisFactor(toReactPhysics3d(rigidBodyParameters.angularLockAxisFactor));
+
+    reactphysics3d::Collider* p_collider = p_rigidBody->addCollider(
+        this->createCollisionShape(colliderParameters),
+        reactphysics3d::Transform::identity()
+    );
+    p_collider->setIsTrigger(colliderParameters.isTrigger);
+    p_collider->setCollisionCategoryBits(colliderParameters.categoryProperties.categoryBitMask);
+    p_collider->setCollideWithMaskBits(colliderParameters.categoryProperties.collidableCategoriesBitMask);
+
+    m_doodadStore.rigidBodies.push_back(p_rigidBody);
+    m_doodadStore.boundingRadii.push_back(HeadlessSimulation::getBoundingRadius(colliderParameters));
+    m_doodadStore.collisionCategoryBitMasks.push_back(colliderParameters.categoryProperties.categoryBitMask);
+    if (rigidBodyParameters.bodyType != quartz::physics::RigidBody::BodyType::Static) {
+        m_doodadStore.movableDoodadIndices.push_back(doodadIndex);
+        m_movableBodyWasAwakeFlags.push_back(1);
+    }
+}
+
+void
+HeadlessSimulation::addSystem(
+    std::unique_ptr<DoodadSystem> p_system,
+    std::vector<std::size_t> doodadIndices
+) {
+    for (const std::size_t doodadIndex : doodadIndices) {
+        if (doodadIndex >= m_doodadStore.size() || !m_doodadStore.rigidBodies[doodadIndex]) {
+            LOG_CRITICALthis("Doodad index {} for system {} does not refer to a doodad with a rigid body ({} doodads)", doodadIndex, p_system->getName(), m_doodadStore.size());
+            throw std::runtime_error("Invalid doodad for headless simulation system");
+        }
+    }
+
+    LOG_INFOthis("Adding system {} over {} doodads", p_system->getName(), doodadIndices.size());
+
+    for (std::size_t firstIndex = 0; firstIndex < doodadIndices.size(); firstIndex += s_fixedUpdateSliceSize) {
+        m_fixedUpdateSlices.push_back({m_systems.size(), firstIndex, std::min(s_fixedUpdateSliceSize, doodadIndices.size() - firstIndex)});
+    }
+    m_commandBuffers.resize(m_fixedUpdateSlices.size());
+    m_sliceFrameArenas.resize(m_fixedUpdateSlices.size());
+
+    m_systems.push_back({std::move(p_system), std::move(doodadIndices)});
+}
+
+void
+HeadlessSimulation::setTerrain(
+    const TerrainFile& terrainFile
+) {
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Physics);
+
+    mo_terrainColliders.emplace(m_physicsCommon, mp_physicsWorld, terrainFile, s_terrainColliderMargin);
+    mo_terrainColliders->update(m_doodadStore, m_doodadStore.movableDoodadIndices, m_tickCount);
+
+    LOG_INFOthis("Colliding with {}x{} terrain chunks, {} of them near movable doodads", terrainFile.getChunkCountX(), terrainFile.getChunkCountZ(), mo_terrainColliders->getStatistics().colliderCount);
+}
+
+void
+HeadlessSimulation::addVehicles(
+    const std::vector<std::size_t>& doodadIndices,
+    const VehicleParameters& vehicleParameters
+) {
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Physics);
+
+    if (!mo_vehicleFleet) {
+        mo_vehicleFleet.emplace(mp_physicsWorld);
+        m_doodadStore.vehicleControls.assign(m_doodadStore.size(), VehicleControls::idle());
+    }
+
+    mo_vehicleFleet->addVehicles(m_doodadStore, doodadIndices, vehicleParameters);
+}
+
+void
+HeadlessSimulation::addGhost(
+    const std::size_t doodadIndex,
+    const TrajectoryFile& trajectoryFile,
+    const GhostPlayback::GhostParameters& ghostParameters
+) {
+    m_ghostPlayback.addGhost(m_doodadStore, doodadIndex, trajectoryFile, ghostParameters);
+}
+
+void
+HeadlessSimulation::addTrajectoryRecorder(
+    TrajectoryRecorder& trajectoryRecorder,
+    const std::size_t doodadIndex
+) {
+    if (doodadIndex >= m_doodadStore.size()) {
+        LOG_CRITICALthis("Doodad index {} to record a trajectory of does not refer to a doodad ({} doodads)", doodadIndex, m_doodadStore.size());
+        throw std::runtime_error("Invalid doodad for trajectory recording");
+    }
+
+    m_trajectoryRecorderEntries.push_back({&trajectoryRecorder, doodadIndex});
+}
+
+void
+HeadlessSimulation::setPhysicsSubstepCount(
+    const uint32_t physicsSubstepCount
+) {
+    if (physicsSubstepCount == 0) {
+        LOG_CRITICALthis("A tick needs at least one physics substep");
+        throw std::runtime_error("Invalid physics substep count");
+    }
+
+    LOG_INFOthis("Stepping physics {} times per tick", physicsSubstepCount);
+    m_physicsSubstepCount = physicsSubstepCount;
+}
+
+void
+HeadlessSimulation::attachPlayerController(
+    ThirdPersonController& playerController,
+    const std::size_t playerDoodadIndex
+) {
+    this->addSystem(std::make_unique<ThirdPersonControllerSystem>(playerController), {playerDoodadIndex});
+    mp_playerController = &playerController;
+}
+
+void
+HeadlessSimulation::syncDoodadTransforms() {
+    PROFILE_SCOPE("Doodad transform sync");
+
+    // Static bodies never move and sleeping ones stay put until something wakes them, so only the awake bodies are
+    // read back. A body that fell asleep during the step may still have moved in it, so it gets one last read, but
+    // only the one: from then on it was already asleep at the end of the tick before
+    m_doodadStore.activeDoodadIndices.clear();
+    const std::vector<std::size_t>& movableDoodadIndices = m_doodadStore.movableDoodadIndices;
+    for (std::size_t i = 0; i < movableDoodadIndices.size(); ++i) {
+        const std::size_t doodadIndex = movableDoodadIndices[i];
+        const reactphysics3d::RigidBody* const p_rigidBody = m_doodadStore.rigidBodies[doodadIndex];
+        const bool isAwake = !p_rigidBody->isSleeping();
+        const bool wasAwake = m_movableBodyWasAwakeFlags[i] != 0;
+        m_movableBodyWasAwakeFlags[i] = isAwake ? 1 : 0;
+        if (!isAwake && !wasAwake) {
+            continue;
+        }
+
+        const reactphysics3d::Transform& bodyTransform = p_rigidBody->getTransform();
+        m_doodadStore.positions[doodadIndex] = toMath(bodyTransform.getPosition());
+        m_doodadStore.rotations[doodadIndex] = toMath(bodyTransform.getOrientation());
+        m_doodadStore.activeDoodadIndices.push_back(doodadIndex);
+        m_doodadStore.lastActiveTickIndices[doodadIndex] = m_tickCount;
+    }
+
+    m_lastTickTimings.activeDoodadCount = static_cast<uint32_t>(m_doodadStore.activeDoodadIndices.size());
+    m_lastTickTimings.sleepingDoodadCount = static_cast<uint32_t>(m_doodadStore.movableDoodadIndices.size() - m_doodadStore.activeDoodadIndices.size());
+}
+
+void
+HeadlessSimulation::fixedUpdateSystems(
+    const InputState& inputState
+) {
+    {
+        std::unique_lock<std::mutex> lock;
+        if (mp_systemsMutex) {
+            lock = std::unique_lock<std::mutex>(*mp_systemsMutex);
+        }
+
+        for (SystemEntry& systemEntry : m_systems) {
+            systemEntry.p_system->prepareFixedUpdate(inputState, m_ticksPerSecond);
+        }
+    }
+
+    // Read phase, every slice sees the transforms from the end of the previous step no matter what runs alongside it
+    const auto runSlice = [this, &inputState] (const std::size_t sliceIndex) {
+        const FixedUpdateSlice& slice = m_fixedUpdateSlices[sliceIndex];
+        const SystemEntry& systemEntry = m_systems[slice.systemIndex];
+        PROFILE_SCOPE(systemEntry.p_system->getName());
+
+        CommandBuffer& commandBuffer = m_commandBuffers[sliceIndex];
+        commandBuffer.clear();
+        FrameArena& frameArena = m_sliceFrameArenas[sliceIndex];
+        frameArena.reset();
+
+        const SystemContext context {
+            m_doodadStore,
+            &*mo_spatialIndex,
+            std::span<const std::size_t>(systemEntry.doodadIndices).subspan(slice.firstIndex, slice.indexCount),
+            inputState,
+            m_ticksPerSecond,
+            frameArena
+        };
+        systemEntry.p_system->fixedUpdate(context, commandBuffer);
+    };
+
+    if (mp_jobSystem) {
+        mp_jobSystem->parallelFor(m_fixedUpdateSlices.size(), runSlice);
+    } else {
+        for (std::size_t i = 0; i < m_fixedUpdateSlices.size(); ++i) {
+            runSlice(i);
+        }
+    }
+
+    // Write phase, always in slice order so that it does not matter which thread ran which slice
+    PROFILE_SCOPE("Command buffer playback");
+    for (const CommandBuffer& commandBuffer : m_commandBuffers) {
+        commandBuffer.apply(m_doodadStore);
+    }
+}
+
+void
+HeadlessSimulation::update(
+    const InputState& inputState,
+    const DoodadStore& doodadStore
+) {
+    PROFILE_SCOPE("Systems update");
+
+    // The spatial index only describes our own doodad store
+    const SpatialIndex* const p_spatialIndex = &doodadStore == &m_doodadStore ? &*mo_spatialIndex : nullptr;
+
+    std::unique_lock<std::mutex> lock;
+    if (mp_systemsMutex) {
+        lock = std::unique_lock<std::mutex>(*mp_systemsMutex);
+    }
+
+    for (SystemEntry& systemEntry : m_systems) {
+        PROFILE_SCOPE(systemEntry.p_system->getName());
+
+        m_updateFrameArena.reset();
+        const SystemContext context {doodadStore, p_spatialIndex, systemEntry.doodadIndices, inputState, m_ticksPerSecond, m_updateFrameArena};
+        systemEntry.p_system->update(context);
+    }
+}
+
+void
+HeadlessSimulation::tick(
+    const InputState& inputState
+) {
+    PROFILE_SCOPE("Tick");
+
+    this->fixedTick(inputState);
+    this->update(inputState, m_doodadStore);
+}
+
+void
+HeadlessSimulation::fixedTick(
+    const InputState& inputState
+) {
+    PROFILE_SCOPE("Fixed tick");
+
+    using Clock = std::chrono::steady_clock;
+
+    m_lastTickTimings = {};
+    m_contactEventBuffer.clear();
+    const uint64_t initialAllocationCount = AllocationCounter::getAllocationCount();
+    const Clock::time_point startTime = Clock::now();
+
+    {
+        PROFILE_SCOPE("Systems fixed update");
+        this->fixedUpdateSystems(inputState);
+    }
+    const Clock::time_point systemsEndTime = Clock::now();
+
+    {
+        PROFILE_SCOPE("Physics step");
+
+        const double substepSeconds = 1.0 / (m_ticksPerSecond * m_physicsSubstepCount);
+        for (uint32_t i = 0; i < m_physicsSubstepCount; ++i) {
+            if (mo_vehicleFleet) {
+                const VehicleFleet::SubstepTimings substepTimings = mo_vehicleFleet->substep(m_doodadStore, substepSeconds);
+                m_lastTickTimings.vehicleRaycastMicroseconds += substepTimings.raycastMicroseconds;
+                m_lastTickTimings.vehicleSolveMicroseconds += substepTimings.solveMicroseconds;
+                m_lastTickTimings.groundedWheelCount = substepTimings.groundedWheelCount;
+            }
+
+            const Clock::time_point physicsStartTime = Clock::now();
+            mp_physicsWorld->update(static_cast<reactphysics3d::decimal>(substepSeconds));
+            m_lastTickTimings.physicsStepMicroseconds += std::chrono::duration<double, std::micro>(Clock::now() - physicsStartTime).count();
+        }
+    }
+
+    const Clock::time_point transformSyncStartTime = Clock::now();
+    this->syncDoodadTransforms();
+    if (m_ghostPlayback.getGhostCount() > 0) {
+        const GhostPlayback::UpdateTimings ghostTimings = m_ghostPlayback.update(m_doodadStore, m_tickCount / m_ticksPerSecond, m_tickCount);
+        m_lastTickTimings.ghostDecodeMicroseconds = ghostTimings.decodeMicroseconds;
+        m_lastTickTimings.ghostInterpolateMicroseconds = ghostTimings.interpolateMicroseconds;
+        m_lastTickTimings.activeGhostCount = ghostTimings.activeGhostCount;
+    }
+    for (const TrajectoryRecorderEntry& trajectoryRecorderEntry : m_trajectoryRecorderEntries) {
+        trajectoryRecorderEntry.p_trajectoryRecorder->record(m_doodadStore.positions[trajectoryRecorderEntry.doodadIndex], m_doodadStore.rotations[trajectoryRecorderEntry.doodadIndex]);
+    }
+    m_lastTickTimings.transformSyncMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - transformSyncStartTime).count();
+
+    const Clock::time_point spatialIndexStartTime = Clock::now();
+    m_lastTickTimings.spatialIndexReinsertCount = static_cast<uint32_t>(mo_spatialIndex->update(m_doodadStore));
+    m_lastTickTimings.spatialIndexUpdateMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - spatialIndexStartTime).count();
+
+    // Ready for the next step, before which nothing moves
+    if (mo_terrainColliders) {
+        mo_terrainColliders->update(m_doodadStore, m_doodadStore.activeDoodadIndices, m_tickCount);
+    }
+
+    const Clock::time_point dispatchStartTime = Clock::now();
+    m_contactEventBuffer.dispatch();
+    m_lastTickTimings.contactEventCount = static_cast<uint32_t>(m_contactEventBuffer.size());
+    m_lastTickTimings.contactDispatchMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - dispatchStartTime).count();
+
+    m_lastTickTimings.systemsFixedUpdateMicroseconds = std::chrono::duration<double, std::micro>(systemsEndTime - startTime).count();
+    m_lastTickTimings.fixedUpdateMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - startTime).count();
+    m_lastTickTimings.allocationCount = AllocationCounter::getAllocationCount() - initialAllocationCount;
+
+    ASYNC_LOG_TRACE(HEADLESS, "Tick {} fixed update took {:.2f} us with {} contact events", m_tickCount, m_lastTickTimings.fixedUpdateMicroseconds, m_lastTickTimings.contactStartCount + m_lastTickTimings.contactStayCount + m_lastTickTimings.contactEndCount);
+
+    ++m_tickCount;
+}
+
+void
+HeadlessSimulation::captureSnapshot(
+    WorldSnapshot& snapshot
+) const {
+    PROFILE_SCOPE("World snapshot capture");
+
+    const std::size_t doodadCount = m_doodadStore.size();
+    const std::vector<std::size_t>& movableDoodadIndices = m_doodadStore.movableDoodadIndices;
+    const reactphysics3d::Vector3 gravity = mp_physicsWorld->getGravity();
+    snapshot.reset({
+        world_snapshot_format::magic,
+        world_snapshot_format::version,
+        static_cast<uint16_t>(mp_playerController ? world_snapshot_format::HasPlayerController : 0),
+        static_cast<uint32_t>(doodadCount),
+        static_cast<uint32_t>(movableDoodadIndices.size()),
+        static_cast<uint32_t>(mo_vehicleFleet ? mo_vehicleFleet->getVehicleCount() : 0),
+        static_cast<uint32_t>(mo_vehicleFleet ? mo_vehicleFleet->getWheelCount() : 0),
+        m_tickCount,
+        {gravity.x, gravity.y, gravity.z},
+        0
+    });
+    const world_snapshot_format::Header& header = snapshot.getHeader();
+    const world_snapshot_format::Layout& layout = snapshot.getLayout();
+
+    const std::span<world_snapshot_format::DoodadTransform> doodadTransforms = snapshot.getSection<world_snapshot_format::DoodadTransform>(layout.doodadTransformsOffset, doodadCount);
+    for (std::size_t doodadIndex = 0; doodadIndex < doodadCount; ++doodadIndex) {
+        const math::Vec3& position = m_doodadStore.positions[doodadIndex];
+        const math::Quaternion& rotation = m_doodadStore.rotations[doodadIndex];
+        doodadTransforms[doodadIndex] = {
+            {position.x, position.y, position.z},
+            {rotation.w, rotation.x, rotation.y, rotation.z}
+        };
+    }
+
+    const std::span<uint64_t> lastActiveTickIndices = snapshot.getSection<uint64_t>(layout.lastActiveTickIndicesOffset, doodadCount);
+    std::copy(m_doodadStore.lastActiveTickIndices.begin(), m_doodadStore.lastActiveTickIndices.end(), lastActiveTickIndices.begin());
+
+    // Read from the bodies themselves, a sleeping body's doodad transform is only as fresh as the tick it fell asleep
+    const std::span<world_snapshot_format::BodyState> bodyStates = snapshot.getSection<world_snapshot_format::BodyState>(layout.bodyStatesOffset, movableDoodadIndices.size());
+    for (std::size_t i = 0; i < movableDoodadIndices.size(); ++i) {
+        const reactphysics3d::RigidBody* const p_rigidBody = m_doodadStore.rigidBodies[movableDoodadIndices[i]];
+        const reactphysics3d::Transform& bodyTransform = p_rigidBody->getTransform();
+        const reactphysics3d::Vector3& position = bodyTransform.getPosition();
+        const reactphysics3d::Quaternion& orientation = bodyTransform.getOrientation();
+        const reactphysics3d::Vector3& linearVelocity = p_rigidBody->getLinearVelocity();
+        const reactphysics3d::Vector3& angularVelocity = p_rigidBody->getAngularVelocity();
+        bodyStates[i] = {
+            {position.x, position.y, position.z},
+            {orientation.w, orientation.x, orientation.y, orientation.z},
+            {linearVelocity.x, linearVelocity.y, linearVelocity.z},
+            {angularVelocity.x, angularVelocity.y, angularVelocity.z},
+            p_rigidBody->isSleeping() ? 1u : 0u
+        };
+    }
+
+    if (header.vehicleCount > 0) {
+        const std::span<world_snapshot_format::VehicleControls> vehicleControls = snapshot.getSection<world_snapshot_format::VehicleControls>(layout.vehicleControlsOffset, doodadCount);
+        for (std::size_t doodadIndex = 0; doodadIndex < doodadCount; ++doodadIndex) {
+            const VehicleControls& controls = m_doodadStore.vehicleControls[doodadIndex];
+            vehicleControls[doodadIndex] = {controls.throttle, controls.brake, controls.steering};
+        }
+
+        mo_vehicleFleet->writeState(
+            snapshot.getSection<world_snapshot_format::VehicleState>(layout.vehicleStatesOffset, header.vehicleCount),
+            snapshot.getSection<world_snapshot_format::WheelState>(layout.wheelStatesOffset, header.wheelCount)
+        );
+    }
+
+    if (mp_playerController) {
+        const ThirdPersonController::State playerControllerState = mp_playerController->getState();
+        snapshot.getSection<world_snapshot_format::PlayerControllerState>(layout.playerControllerStateOffset, 1).front() = {
+            {playerControllerState.cameraEulerAngles.yawDegrees, playerControllerState.cameraEulerAngles.pitchDegrees, playerControllerState.cameraEulerAngles.rollDegrees},
+            {playerControllerState.cameraPosition.x, playerControllerState.cameraPosition.y, playerControllerState.cameraPosition.z},
+            playerControllerState.cameraDistance,
+            playerControllerState.horizontalMovementSpeed
+        };
+    }
+}
+
+void
+HeadlessSimulation::restoreSnapshot(
+    const WorldSnapshot& snapshot
+) {
+    PROFILE_SCOPE("World snapshot restore");
+
+    const std::size_t doodadCount = m_doodadStore.size();
+    const std::vector<std::size_t>& movableDoodadIndices = m_doodadStore.movableDoodadIndices;
+    const std::size_t vehicleCount = mo_vehicleFleet ? mo_vehicleFleet->getVehicleCount() : 0;
+    const std::size_t wheelCount = mo_vehicleFleet ? mo_vehicleFleet->getWheelCount() : 0;
+    if (snapshot.isEmpty()) {
+        LOG_CRITICALthis("Cannot restore scene {} from an empty snapshot", m_sceneName);
+        throw std::runtime_error("Empty world snapshot");
+    }
+
+    const world_snapshot_format::Header& header = snapshot.getHeader();
+    if (header.doodadCount != doodadCount || header.movableDoodadCount != movableDoodadIndices.size() || header.vehicleCount != vehicleCount || header.wheelCount != wheelCount) {
+        LOG_CRITICALthis("The snapshot of tick {} has {} doodads ( {} movable ) and {} vehicles with {} wheels, scene {} has {} ( {} ) and {} with {}",
+            header.tickCount,
+            header.doodadCount,
+            header.movableDoodadCount,
+            header.vehicleCount,
+            header.wheelCount,
+            m_sceneName,
+            doodadCount,
+            movableDoodadIndices.size(),
+            vehicleCount,
+            wheelCount
+        );
+        throw std::runtime_error("World snapshot does not match the simulation");
+    }
+    const world_snapshot_format::Layout& layout = snapshot.getLayout();
+    if (header.vehicleCount > 0) {
+        mo_vehicleFleet->checkState(snapshot.getSection<world_snapshot_format::VehicleState>(layout.vehicleStatesOffset, header.vehicleCount));
+    }
+
+    m_tickCount = header.tickCount;
+    mp_physicsWorld->setGravity({
+        static_cast<reactphysics3d::decimal>(header.gravity_mps2[0]),
+        static_cast<reactphysics3d::decimal>(header.gravity_mps2[1]),
+        static_cast<reactphysics3d::decimal>(header.gravity_mps2[2])
+    });
+
+    const std::span<const world_snapshot_format::DoodadTransform> doodadTransforms = snapshot.getSection<world_snapshot_format::DoodadTransform>(layout.doodadTransformsOffset, doodadCount);
+    for (std::size_t doodadIndex = 0; doodadIndex < doodadCount; ++doodadIndex) {
+        const world_snapshot_format::DoodadTransform& doodadTransform = doodadTransforms[doodadIndex];
+        m_doodadStore.positions[doodadIndex] = math::Vec3(doodadTransform.position[0], doodadTransform.position[1], doodadTransform.position[2]);
+        m_doodadStore.rotations[doodadIndex] = math::Quaternion(doodadTransform.rotation[0], doodadTransform.rotation[1], doodadTransform.rotation[2], doodadTransform.rotation[3]);
+    }
+
+    const std::span<const uint64_t> lastActiveTickIndices = snapshot.getSection<uint64_t>(layout.lastActiveTickIndicesOffset, doodadCount);
+    std::copy(lastActiveTickIndices.begin(), lastActiveTickIndices.end(), m_doodadStore.lastActiveTickIndices.begin());
+
+    // The velocities go in before the sleep state, since putting a body to sleep clears them
+    const std::span<const world_snapshot_format::BodyState> bodyStates = snapshot.getSection<world_snapshot_format::BodyState>(layout.bodyStatesOffset, movableDoodadIndices.size());
+    for (std::size_t i = 0; i < movableDoodadIndices.size(); ++i) {
+        const world_snapshot_format::BodyState& bodyState = bodyStates[i];
+        reactphysics3d::RigidBody* const p_rigidBody = m_doodadStore.rigidBodies[movableDoodadIndices[i]];
+        p_rigidBody->setTransform({
+            toReactPhysics3d(math::Vec3(bodyState.position[0], bodyState.position[1], bodyState.position[2])),
+            toReactPhysics3d(math::Quaternion(bodyState.orientation[0], bodyState.orientation[1], bodyState.orientation[2], bodyState.orientation[3]))
+        });
+        p_rigidBody->setLinearVelocity(toReactPhysics3d(math::Vec3(bodyState.linearVelocity_mps[0], bodyState.linearVelocity_mps[1], bodyState.linearVelocity_mps[2])));
+        p_rigidBody->setAngularVelocity(toReactPhysics3d(math::Vec3(bodyState.angularVelocity_radps[0], bodyState.angularVelocity_radps[1], bodyState.angularVelocity_radps[2])));
+        p_rigidBody->setIsSleeping(bodyState.isSleeping != 0);
+    }
+
+    if (header.vehicleCount > 0) {
+        const std::span<const world_snapshot_format::VehicleControls> vehicleControls = snapshot.getSection<world_snapshot_format::VehicleControls>(layout.vehicleControlsOffset, doodadCount);
+        for (std::size_t doodadIndex = 0; doodadIndex < doodadCount; ++doodadIndex) {
+            m_doodadStore.vehicleControls[doodadIndex] = {vehicleControls[doodadIndex].throttle, vehicleControls[doodadIndex].brake, vehicleControls[doodadIndex].steering};
+        }
+
+        mo_vehicleFleet->readState(
+            snapshot.getSection<world_snapshot_format::VehicleState>(layout.vehicleStatesOffset, header.vehicleCount),
+            snapshot.getSection<world_snapshot_format::WheelState>(layout.wheelStatesOffset, header.wheelCount)
+        );
+    }
+
+    if (mp_playerController && (header.flags & world_snapshot_format::HasPlayerController)) {
+        const world_snapshot_format::PlayerControllerState& playerControllerState = snapshot.getSection<world_snapshot_format::PlayerControllerState>(layout.playerControllerStateOffset, 1).front();
+        mp_playerController->setState({
+            {playerControllerState.cameraEulerAngles_deg[0], playerControllerState.cameraEulerAngles_deg[1], playerControllerState.cameraEulerAngles_deg[2]},
+            math::Vec3(playerControllerState.cameraPosition[0], playerControllerState.cameraPosition[1], playerControllerState.cameraPosition[2]),
+            playerControllerState.cameraDistance,
+            playerControllerState.horizontalMovementSpeed_mps
+        });
+    }
+
+    // Everything downstream of the physics step has to catch up with every movable doodad, not only the ones the
+    // last tick moved
+    m_doodadStore.activeDoodadIndices.assign(movableDoodadIndices.begin(), movableDoodadIndices.end());
+    for (std::size_t i = 0; i < movableDoodadIndices.size(); ++i) {
+        m_movableBodyWasAwakeFlags[i] = bodyStates[i].isSleeping != 0 ? 0 : 1;
+    }
+    mo_spatialIndex->update(m_doodadStore);
+    if (mo_terrainColliders) {
+        mo_terrainColliders->update(m_doodadStore, m_doodadStore.activeDoodadIndices, m_tickCount);
+    }
+    m_ghostPlayback.resetGhostStates();
+    m_contactEventBuffer.clear();
+
+    ASYNC_LOG_TRACE(HEADLESS, "Restored to tick {}", m_tickCount);
+}
+
+std::optional<InputState>
+HeadlessSimulation::readTickInput() {
+    const std::optional<InputState> o_inputState = mp_inputReplayer ? mp_inputReplayer->readNextTick() : InputState::idle();
+    if (o_inputState && mp_inputRecorder) {
+        mp_inputRecorder->recordFixedUpdate(*o_inputState, m_ticksPerSecond);
+        mp_inputRecorder->recordUpdate(*o_inputState);
+    }
+
+    return o_inputState;
+}
+
+HeadlessSimulation::Statistics
+HeadlessSimulation::run(
+    const std::optional<uint64_t> o_tickCount
+) {
+    using Clock = std::chrono::steady_clock;
+
+    LOG_FUNCTION_SCOPE_INFOthis("{} ticks at {} ticks per second", o_tickCount ? std::to_string(*o_tickCount) : "unlimited", m_ticksPerSecond);
+
+    const uint64_t initialTickCount = m_tickCount;
+    double totalTickMicroseconds = 0.0;
+    double maxTickMicroseconds = 0.0;
+    uint64_t totalActiveDoodadCount = 0;
+    uint64_t totalSleepingDoodadCount = 0;
+    uint64_t totalAllocationCount = 0;
+    uint64_t maxAllocationCount = 0;
+
+    const Clock::time_point startTime = Clock::now();
+    Clock::time_point lastReportTime = startTime;
+    uint64_t lastReportTickCount = m_tickCount;
+
+    while (!s_stopRequested.load(std::memory_order_relaxed)) {
+        if (o_tickCount && m_tickCount - initialTickCount >= *o_tickCount) {
+            break;
+        }
+
+        const std::optional<InputState> o_inputState = this->readTickInput();
+        if (!o_inputState) {
+            break;
+        }
+
+        const Clock::time_point tickStartTime = Clock::now();
+        this->tick(*o_inputState);
+        const Clock::time_point tickEndTime = Clock::now();
+
+        // Without a renderer every tick is a frame
+        PROFILE_FRAME_END();
+
+        const double tickMicroseconds = std::chrono::duration<double, std::micro>(tickEndTime - tickStartTime).count();
+        totalTickMicroseconds += tickMicroseconds;
+        maxTickMicroseconds = std::max(maxTickMicroseconds, tickMicroseconds);
+        totalActiveDoodadCount += m_lastTickTimings.activeDoodadCount;
+        totalSleepingDoodadCount += m_lastTickTimings.sleepingDoodadCount;
+        totalAllocationCount += m_lastTickTimings.allocationCount;
+        maxAllocationCount = std::max(maxAllocationCount, m_lastTickTimings.allocationCount);
+
+        const double secondsSinceReport = std::chrono::duration<double>(tickEndTime - lastReportTime).count();
+        if (secondsSinceReport >= 5.0) {
+            LOG_INFOthis("{} ticks, {:.1f} ticks/sec over the last {:.1f} seconds", m_tickCount, (m_tickCount - lastReportTickCount) / secondsSinceReport, secondsSinceReport);
+            lastReportTime = tickEndTime;
+            lastReportTickCount = m_tickCount;
+        }
+    }
+
+    const uint64_t ticksRun = m_tickCount - initialTickCount;
+    const double elapsedSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+    const Statistics statistics {
+        ticksRun,
+        elapsedSeconds,
+        elapsedSeconds > 0.0 ? ticksRun / elapsedSeconds : 0.0,
+        ticksRun > 0 ? totalTickMicroseconds / ticksRun : 0.0,
+        maxTickMicroseconds,
+        ticksRun > 0 ? static_cast<double>(totalActiveDoodadCount) / ticksRun : 0.0,
+        ticksRun > 0 ? static_cast<double>(totalSleepingDoodadCount) / ticksRun : 0.0,
+        ticksRun > 0 ? static_cast<double>(totalAllocationCount) / ticksRun : 0.0,
+        maxAllocationCount
+    };
+
+    LOG_INFOthis("Ran {} ticks of scene {} in {:.3f} seconds", statistics.tickCount, m_sceneName, statistics.elapsedSeconds);
+    LOG_INFOthis("  {:.1f} ticks/sec ( {:.1f}x real time at {} ticks/sec )", statistics.achievedTicksPerSecond, statistics.achievedTicksPerSecond / m_ticksPerSecond, m_ticksPerSecond);
+    LOG_INFOthis("  mean tick {:.2f} us, max tick {:.2f} us", statistics.meanTickMicroseconds, statistics.maxTickMicroseconds);
+    LOG_INFOthis("  of {} doodads, {} static, mean {:.1f} active and {:.1f} sleeping", m_doodadStore.size(), m_doodadStore.size() - m_doodadStore.movableDoodadIndices.size(), statistics.meanActiveDoodadCount, statistics.meanSleepingDoodadCount);
+    if (AllocationCounter::isEnabled()) {
+        LOG_INFOthis("  mean {:.1f} allocations per fixed tick, max {}", statistics.meanAllocationsPerTick, statistics.maxAllocationsPerTick);
+    }
+    if (m_ghostPlayback.getGhostCount() > 0) {
+        m_ghostPlayback.logStatistics();
+    }
+    if (mo_terrainColliders) {
+        const TerrainColliders::Statistics terrainColliderStatistics = mo_terrainColliders->getStatistics();
+        LOG_INFOthis("  {} terrain chunk colliders, max {}, {} created and {} destroyed", terrainColliderStatistics.colliderCount, terrainColliderStatistics.maxColliderCount, terrainColliderStatistics.createdColliderCount, terrainColliderStatistics.destroyedColliderCount);
+    }
+
+    return statistics;
+}
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/physics/collider/Collider.hpp"
+#include "quartz/scene/doodad/Doodad.hpp"
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/ghost/GhostPlayback.hpp"
+#include "pole_position/ghost/TrajectoryFile.hpp"
+#include "pole_position/ghost/TrajectoryRecorder.hpp"
+#include "pole_position/input/InputRecorder.hpp"
+#include "pole_position/input/InputReplayer.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/jobs/JobSystem.hpp"
+#include "pole_position/memory/AllocationCounter.hpp"
+#include "pole_position/memory/FrameArena.hpp"
+#include "pole_position/physics/ContactEventBuffer.hpp"
+#include "pole_position/snapshot/WorldSnapshot.hpp"
+#include "pole_position/spatial/SpatialIndex.hpp"
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/terrain/TerrainColliders.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+#include "pole_position/third_person_controller/ThirdPersonController.hpp"
+#include "pole_position/vehicle/VehicleFleet.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+/**
+ * @brief Steps a scene's physics and the player controller without creating a window, swapchain, Vulkan device
+ * or loading any models. The doodads' rigid bodies are built straight from the scene parameters into our own
+ * reactphysics3d world, so nothing here needs a display or a GPU.
+ *
+ * The quartz::scene::Doodad callbacks take a quartz::scene::Doodad pointer, which only exists inside of a
+ * rendering quartz::Application, so behaviours run as DoodadSystems instead. Each system is called once per tick
+ * with the doodads it was registered for, so doodads without a behaviour cost nothing outside of the physics step.
+ *
+ * The systems' fixed updates are cut into slices of doodads which, given a JobSystem, run in parallel. Slices only
+ * read the doodad store and record their writes into their own CommandBuffer, and the buffers are applied in slice
+ * order afterwards, so a parallel tick ends in exactly the same state as a serial one.
+ */
+class HeadlessSimulation {
+public: // classes and enums
+    struct Statistics {
+        uint64_t tickCount;
+        double elapsedSeconds;
+        double achievedTicksPerSecond;
+        double meanTickMicroseconds;
+        double maxTickMicroseconds;
+        double meanActiveDoodadCount;
+        double meanSleepingDoodadCount;
+        double meanAllocationsPerTick;
+        uint64_t maxAllocationsPerTick;
+    };
+
+    /**
+     * @brief Where the time of the most recent tick went. The collision callback time is spent inside of the
+     * physics step, so it is also included in physicsStepMicroseconds. The contact counts are every pair the
+     * physics engine reported, contactEventCount only the pair sides someone subscribed to
+     */
+    struct TickTimings {
+        double fixedUpdateMicroseconds;
+        double systemsFixedUpdateMicroseconds;
+        double physicsStepMicroseconds;
+        double collisionCallbackMicroseconds;
+        double contactDispatchMicroseconds;
+        uint32_t contactStartCount;
+        uint32_t contactStayCount;
+        uint32_t contactEndCount;
+        uint32_t contactEventCount;
+        double spatialIndexUpdateMicroseconds;
+        uint32_t spatialIndexReinsertCount;
+        double transformSyncMicroseconds;
+
+        /**
+         * @brief Summed over the tick's physics substeps, and outside of physicsStepMicroseconds. The grounded wheel
+         * count is the last substep's
+         */
+        double vehicleRaycastMicroseconds;
+        double vehicleSolveMicroseconds;
+        uint32_t groundedWheelCount;
+
+        /**
+         * @brief The ghosts moved after the physics step, which are part of transformSyncMicroseconds
+         */
+        double ghostDecodeMicroseconds;
+        double ghostInterpolateMicroseconds;
+        uint32_t activeGhostCount;
+
+        /**
+         * @brief Of the movable doodads, the ones the tick moved and the ones whose bodies slept through it. Static
+         * doodads are neither
+         */
+        uint32_t activeDoodadCount;
+        uint32_t sleepingDoodadCount;
+
+        /**
+         * @brief Heap allocations made on any thread during the fixed tick. Always 0 unless built with
+         * POLE_POSITION_ENABLE_ALLOCATION_COUNTING
+         */
+        uint64_t allocationCount;
+    };
+
+    /**
+     * @brief Lets a simulation that is being built on another thread be followed, and abandoned part of the way
+     * through, in which case the constructor throws
+     */
+    struct BuildMonitor {
+        std::atomic<std::size_t> createdDoodadCount;
+        std::atomic<bool> isCancelRequested;
+    };
+
+public: // member functions
+    HeadlessSimulation(
+        const quartz::scene::Scene::Parameters& sceneParameters,
+        const double ticksPerSecond,
+        BuildMonitor* const p_buildMonitor = nullptr
+    );
+    HeadlessSimulation(const HeadlessSimulation& other) = delete;
+    HeadlessSimulation& operator=(const HeadlessSimulation& other) = delete;
+    ~HeadlessSimulation();
+
+    void addSystem(std::unique_ptr<DoodadSystem> p_system, std::vector<std::size_t> doodadIndices);
+    void attachPlayerController(ThirdPersonController& playerController, const std::size_t playerDoodadIndex);
+
+    /**
+     * @brief Without a job system the systems' fixed updates run on the calling thread
+     */
+    void setJobSystem(JobSystem* const p_jobSystem) { mp_jobSystem = p_jobSystem; }
+    void setInputRecorder(InputRecorder* const p_inputRecorder) { mp_inputRecorder = p_inputRecorder; }
+    void setInputReplayer(InputReplayer* const p_inputReplayer) { mp_inputReplayer = p_inputReplayer; }
+
+    /**
+     * @brief Collides the doodads with a streamed heightfield terrain, which has to outlive the simulation. Only the
+     * chunks near movable doodads get colliders, see TerrainColliders
+     */
+    void setTerrain(const TerrainFile& terrainFile);
+
+    /**
+     * @brief Drives the doodads as raycast vehicles, see VehicleFleet. Their controls are set through
+     * CommandBuffer::setVehicleControls, and stay idle until a system does
+     */
+    void addVehicles(const std::vector<std::size_t>& doodadIndices, const VehicleParameters& vehicleParameters);
+
+    /**
+     * @brief Plays a recorded trajectory back onto a doodad without a rigid body, see GhostPlayback. The trajectory
+     * file has to outlive the simulation
+     */
+    void addGhost(const std::size_t doodadIndex, const TrajectoryFile& trajectoryFile, const GhostPlayback::GhostParameters& ghostParameters);
+
+    /**
+     * @brief Records the doodad's transform at the end of every tick, after the ghosts have moved. The recorder has
+     * to outlive the simulation, and records at the simulation's tick rate
+     */
+    void addTrajectoryRecorder(TrajectoryRecorder& trajectoryRecorder, const std::size_t doodadIndex);
+
+    /**
+     * @brief Cuts each tick's physics step into this many equal substeps, before each of which the vehicles are
+     * solved. The contacts of every substep end up in the tick's contact events
+     */
+    void setPhysicsSubstepCount(const uint32_t physicsSubstepCount);
+
+    /**
+     * @brief The systems' fixed update, the physics step and the systems' update of one tick
+     */
+    void tick(const InputState& inputState);
+
+    /**
+     * @brief A tick without the systems' update, for when the update runs elsewhere against an interpolated copy
+     * of the doodad store. The doodad store must only be read while no fixed tick is running
+     */
+    void fixedTick(const InputState& inputState);
+    void update(const InputState& inputState, const DoodadStore& doodadStore);
+
+    /**
+     * @brief When the systems' update runs on another thread than their fixed update, both lock this around the
+     * parts that touch the systems' own state. Slices of the fixed update only read what prepareFixedUpdate left
+     * behind and do not take it
+     */
+    void setSystemsMutex(std::mutex* const p_systemsMutex) { mp_systemsMutex = p_systemsMutex; }
+
+    /**
+     * @brief Copies everything the next tick depends on into the snapshot: the doodads' transforms, the movable
+     * doodads' bodies and velocities, the vehicles' drivetrains and wheel contacts, the player's controller and the
+     * gravity. What the systems keep to themselves is not part of it, and neither are the physics engine's contact
+     * caches, which it has no way to set, so the first step after a restore rebuilds them. Like the doodad store,
+     * must only be called while no fixed tick is running
+     */
+    void captureSnapshot(WorldSnapshot& snapshot) const;
+
+    /**
+     * @brief Puts the simulation back to a snapshot of it, or of another simulation of the same scene. Throws if the
+     * snapshot's doodads, bodies or vehicles do not match. The player's controller is put back if both have one
+     */
+    void restoreSnapshot(const WorldSnapshot& snapshot);
+
+    /**
+     * @brief The next tick's input from the input replayer, or idle input without one, recorded to the input
+     * recorder if there is one. Empty once the replay has run out
+     */
+    std::optional<InputState> readTickInput();
+
+    /**
+     * @brief Ticks until o_tickCount ticks have run, the input replayer runs out of input or a stop is requested.
+     * Without an input replayer every tick sees idle input
+     */
+    Statistics run(const std::optional<uint64_t> o_tickCount);
+
+    static void requestStop() { s_stopRequested.store(true, std::memory_order_relaxed); }
+    static bool isStopRequested() { return s_stopRequested.load(std::memory_order_relaxed); }
+
+    const std::string& getSceneName() const { return m_sceneName; }
+    double getTicksPerSecond() const { return m_ticksPerSecond; }
+    uint64_t getTickCount() const { return m_tickCount; }
+    std::size_t getDoodadCount() const { return m_doodadStore.size(); }
+    std::size_t getSystemCount() const { return m_systems.size(); }
+    const DoodadStore& getDoodadStore() const { return m_doodadStore; }
+
+    /**
+     * @brief Subscribe here to the contacts of each tick. The subscribers run during the fixed tick, after the
+     * doodads' transforms have been synced
+     */
+    ContactEventBuffer& getContactEventBuffer() { return m_contactEventBuffer; }
+
+    /**
+     * @brief Kept in sync with the doodad store at the end of every physics step, like the doodad store it must
+     * only be read while no fixed tick is running
+     */
+    const SpatialIndex& getSpatialIndex() const { return *mo_spatialIndex; }
+    const TickTimings& getLastTickTimings() const { return m_lastTickTimings; }
+
+    /**
+     * @brief Null until vehicles have been added
+     */
+    const VehicleFleet* getVehicleFleet() const { return mo_vehicleFleet ? &*mo_vehicleFleet : nullptr; }
+    const GhostPlayback& getGhostPlayback() const { return m_ghostPlayback; }
+
+    USE_LOGGER(HEADLESS);
+
+private: // classes and enums
+    struct SystemEntry {
+        std::unique_ptr<DoodadSystem> p_system;
+        std::vector<std::size_t> doodadIndices;
+    };
+
+    struct TrajectoryRecorderEntry {
+        TrajectoryRecorder* p_trajectoryRecorder;
+        std::size_t doodadIndex;
+    };
+
+    struct FixedUpdateSlice {
+        std::size_t systemIndex;
+        std::size_t firstIndex;
+        std::size_t indexCount;
+    };
+
+    /**
+     * @brief Receives the physics world's contacts and trigger overlaps during the step, accounts for them and the
+     * time spent on them, and writes the ones that have subscribers into the contact event buffer. An overlap is
+     * recorded like a contact without contact points
+     */
+    class ContactListener : public reactphysics3d::EventListener {
+    public:
+        ContactListener(TickTimings& tickTimings, ContactEventBuffer& contactEventBuffer) : m_tickTimings(tickTimings), m_contactEventBuffer(contactEventBuffer) {}
+        void onContact(const reactphysics3d::CollisionCallback::CallbackData& callbackData) override;
+        void onTrigger(const reactphysics3d::OverlapCallback::CallbackData& callbackData) override;
+
+    private:
+        void record(
+            const ContactEventBuffer::EventType eventType,
+            const reactphysics3d::Collider* const p_collider1,
+            const reactphysics3d::Collider* const p_collider2,
+            const reactphysics3d::CollisionBody* const p_body1,
+            const reactphysics3d::CollisionBody* const p_body2,
+            const uint32_t contactPointCount
+        );
+
+        TickTimings& m_tickTimings;
+        ContactEventBuffer& m_contactEventBuffer;
+    };
+
+    /**
+     * @brief The kind of shape and its dimensions. Colliders with the same key share one collision shape
+     */
+    using CollisionShapeKey = std::tuple<std::size_t, float, float, float>;
+
+private: // helpers
+    static double getBoundingRadius(const quartz::physics::Collider::Parameters& colliderParameters);
+    static std::size_t getDoodadIndex(const reactphysics3d::CollisionBody* const p_body);
+    static reactphysics3d::BodyType getBodyType(const quartz::physics::RigidBody::BodyType bodyType);
+
+private: // member functions
+    reactphysics3d::CollisionShape* createCollisionShape(const quartz::physics::Collider::Parameters& colliderParameters);
+    void createDoodad(const quartz::scene::Doodad::Parameters& doodadParameters);
+    void syncDoodadTransforms();
+    void fixedUpdateSystems(const InputState& inputState);
+
+private: // static variables
+    static std::atomic<bool> s_stopRequested;
+
+    /**
+     * @brief Big enough that a slice is worth handing to another thread, small enough to balance across workers
+     */
+    static constexpr std::size_t s_fixedUpdateSliceSize = 256;
+
+    /**
+     * @brief How far past its bounding radius a doodad keeps the terrain's chunks collidable, which has to cover
+     * how far it can move in a tick
+     */
+    static constexpr double s_terrainColliderMargin = 16.0;
+
+private: // member variables
+    std::string m_sceneName;
+    double m_ticksPerSecond;
+    uint64_t m_tickCount;
+    uint32_t m_physicsSubstepCount;
+
+    PhysicsMemoryAllocator m_physicsMemoryAllocator;
+    reactphysics3d::PhysicsCommon m_physicsCommon;
+    reactphysics3d::PhysicsWorld* mp_physicsWorld;
+    std::map<CollisionShapeKey, reactphysics3d::CollisionShape*> m_collisionShapes;
+    DoodadStore m_doodadStore;
+
+    /**
+     * @brief Whether each movable doodad's body was awake at the end of the last tick, in the order of
+     * movableDoodadIndices. A body that has just fallen asleep gets one last read, and only this tells it apart from
+     * one that was already asleep
+     */
+    std::vector<uint8_t> m_movableBodyWasAwakeFlags;
+
+    std::optional<SpatialIndex> mo_spatialIndex;
+    std::optional<TerrainColliders> mo_terrainColliders;
+    std::optional<VehicleFleet> mo_vehicleFleet;
+    GhostPlayback m_ghostPlayback;
+    std::vector<TrajectoryRecorderEntry> m_trajectoryRecorderEntries;
+    std::vector<SystemEntry> m_systems;
+    std::vector<FixedUpdateSlice> m_fixedUpdateSlices;
+    std::vector<CommandBuffer> m_commandBuffers;
+    std::vector<FrameArena> m_sliceFrameArenas;
+    FrameArena m_updateFrameArena;
+
+    JobSystem* mp_jobSystem;
+    std::mutex* mp_systemsMutex;
+    ThirdPersonController* mp_playerController;
+
+    InputRecorder* mp_inputRecorder;
+    InputReplayer* mp_inputReplayer;
+
+    TickTimings m_lastTickTimings;
+    ContactEventBuffer m_contactEventBuffer;
+    ContactListener m_contactListener;
+};
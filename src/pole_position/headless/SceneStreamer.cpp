@@ -0,0 +1,249 @@
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/asset_loading/AssetPreloader.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/headless/SceneStreamer.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/scene/BehaviourRegistry.hpp"
+#include "pole_position/scene/SceneFile.hpp"
+
+const char*
+SceneStreamer::getStageName(
+    const Stage stage
+) {
+    switch (stage) {
+        case Stage::Idle:
+            return "idle";
+        case Stage::ReadingScene:
+            return "reading scene";
+        case Stage::LoadingAssets:
+            return "loading assets";
+        case Stage::BuildingWorld:
+            return "building world";
+        case Stage::Ready:
+            return "ready";
+        case Stage::Cancelled:
+            return "cancelled";
+        case Stage::Failed:
+            return "failed";
+    }
+
+    return "unknown";
+}
+
+SceneStreamer::SceneStreamer(
+    const BehaviourRegistry& behaviourRegistry,
+    AssetPreloader* const p_assetPreloader
+) :
+    m_behaviourRegistry(behaviourRegistry),
+    mp_assetPreloader(p_assetPreloader),
+    m_mutex(),
+    m_stage(Stage::Idle),
+    m_initialAssetProgress(),
+    m_doodadCount(0),
+    mo_streamedScene(),
+    m_buildMonitor(),
+    m_streamThread(),
+    m_retireThread()
+{}
+
+SceneStreamer::~SceneStreamer() {
+    this->cancel();
+    if (m_retireThread.joinable()) {
+        m_retireThread.join();
+    }
+}
+
+void
+SceneStreamer::begin(
+    const std::string& sceneFilepath,
+    const double ticksPerSecond
+) {
+    this->cancel();
+
+    LOG_INFOthis("Streaming scene {} in the background", sceneFilepath);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stage = Stage::ReadingScene;
+        m_initialAssetProgress = {};
+        m_doodadCount = 0;
+    }
+    m_buildMonitor.createdDoodadCount.store(0, std::memory_order_relaxed);
+    m_buildMonitor.isCancelRequested.store(false, std::memory_order_relaxed);
+
+    m_streamThread = std::thread(&SceneStreamer::stream, this, sceneFilepath, ticksPerSecond);
+}
+
+void
+SceneStreamer::cancel() {
+    m_buildMonitor.isCancelRequested.store(true, std::memory_order_relaxed);
+    this->join();
+
+    // A scene that finished streaming but was never taken is cancelled all the same
+    std::optional<StreamedScene> o_streamedScene;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stage == Stage::Ready) {
+            o_streamedScene = std::move(mo_streamedScene);
+            mo_streamedScene.reset();
+            m_stage = Stage::Cancelled;
+        }
+    }
+    if (o_streamedScene) {
+        this->retire(std::move(o_streamedScene->p_simulation));
+    }
+}
+
+SceneStreamer::Progress
+SceneStreamer::getProgress() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const AssetPreloader::Progress assetProgress = mp_assetPreloader ? mp_assetPreloader->getProgress() : AssetPreloader::Progress {};
+    const std::size_t createdDoodadCount = m_buildMonitor.createdDoodadCount.load(std::memory_order_relaxed);
+
+    // Until the scene's assets are enqueued, whatever the preloader is doing belongs to someone else
+    const bool hasEnqueuedAssets = m_stage == Stage::LoadingAssets || m_stage == Stage::BuildingWorld || m_stage == Stage::Ready;
+    const std::size_t loadedAssetCount = hasEnqueuedAssets ? assetProgress.loadedCount - m_initialAssetProgress.loadedCount : 0;
+    const std::size_t assetCount = hasEnqueuedAssets ? assetProgress.enqueuedCount - m_initialAssetProgress.enqueuedCount : 0;
+
+    const std::size_t totalCount = assetCount + m_doodadCount;
+    double fraction = totalCount > 0 ? static_cast<double>(loadedAssetCount + createdDoodadCount) / totalCount : 0.0;
+    if (m_stage == Stage::Ready) {
+        fraction = 1.0;
+    }
+
+    return {
+        m_stage,
+        loadedAssetCount,
+        assetCount,
+        createdDoodadCount,
+        m_doodadCount,
+        fraction
+    };
+}
+
+std::optional<SceneStreamer::StreamedScene>
+SceneStreamer::take() {
+    std::optional<StreamedScene> o_streamedScene;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stage != Stage::Ready) {
+            return std::nullopt;
+        }
+
+        o_streamedScene = std::move(mo_streamedScene);
+        mo_streamedScene.reset();
+        m_stage = Stage::Idle;
+    }
+
+    // The thread has nothing left to do but return
+    this->join();
+
+    return o_streamedScene;
+}
+
+void
+SceneStreamer::retire(
+    std::unique_ptr<HeadlessSimulation> p_simulation
+) {
+    if (m_retireThread.joinable()) {
+        m_retireThread.join();
+    }
+
+    m_retireThread = std::thread([p_retiredSimulation = std::move(p_simulation)] () mutable {
+        const MemoryTracker::ScopedTag scopedTag(MemoryTag::Scene);
+        PROFILE_SCOPE("Retire scene");
+        p_retiredSimulation.reset();
+    });
+}
+
+void
+SceneStreamer::stream(
+    const std::string& sceneFilepath,
+    const double ticksPerSecond
+) {
+    PROFILE_SCOPE("Stream scene");
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Scene);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point startTime = Clock::now();
+
+    try {
+        SceneFile::LoadedScene loadedScene = SceneFile::load(sceneFilepath, m_behaviourRegistry);
+        if (m_buildMonitor.isCancelRequested.load(std::memory_order_relaxed)) {
+            this->setStage(Stage::Cancelled);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_doodadCount = loadedScene.sceneParameters.doodadParameters.size();
+        }
+
+        if (mp_assetPreloader) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_initialAssetProgress = mp_assetPreloader->getProgress();
+                m_stage = Stage::LoadingAssets;
+            }
+            mp_assetPreloader->enqueueScene(loadedScene.sceneParameters);
+
+            // Wake up every so often to see whether we have been cancelled
+            while (!mp_assetPreloader->waitFor(std::chrono::milliseconds(10))) {
+                if (m_buildMonitor.isCancelRequested.load(std::memory_order_relaxed)) {
+                    LOG_INFOthis("Cancelled streaming scene {} while loading its assets", sceneFilepath);
+                    this->setStage(Stage::Cancelled);
+                    return;
+                }
+            }
+        }
+
+        this->setStage(Stage::BuildingWorld);
+        std::unique_ptr<HeadlessSimulation> p_simulation = std::make_unique<HeadlessSimulation>(loadedScene.sceneParameters, ticksPerSecond, &m_buildMonitor);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        mo_streamedScene = StreamedScene {
+            std::move(p_simulation),
+            loadedScene.findFirstDoodadWithBehaviour("third_person_controller")
+        };
+        m_stage = Stage::Ready;
+    } catch (const std::exception& e) {
+        if (m_buildMonitor.isCancelRequested.load(std::memory_order_relaxed)) {
+            this->setStage(Stage::Cancelled);
+            return;
+        }
+
+        LOG_ERRORthis("Failed to stream scene {}: {}", sceneFilepath, e.what());
+        this->setStage(Stage::Failed);
+        return;
+    }
+
+    LOG_INFOthis("Streamed scene {} in {:.2f} ms", sceneFilepath, std::chrono::duration<double, std::milli>(Clock::now() - startTime).count());
+}
+
+void
+SceneStreamer::setStage(
+    const Stage stage
+) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stage = stage;
+}
+
+void
+SceneStreamer::join() {
+    if (m_streamThread.joinable()) {
+        m_streamThread.join();
+    }
+}
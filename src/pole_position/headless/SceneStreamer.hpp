@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/asset_loading/AssetPreloader.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/scene/BehaviourRegistry.hpp"
+
+/**
+ * @brief Loads the next scene on a background thread while the current one keeps ticking, so that a level
+ * transition costs the frame loop no more than swapping one simulation for another. The scene file is read, its
+ * assets are read through the asset preloader if there is one, and its physics world and doodads are built, all
+ * off of the calling thread. Once the stage is Ready the caller takes the simulation and swaps it in, and hands
+ * the one it replaced back to be destroyed in the background too.
+ *
+ * Only one scene streams at a time. Cancelling stops at the next doodad or asset check, assets that are already
+ * queued on the preloader are still read
+ */
+class SceneStreamer {
+public: // classes and enums
+    enum class Stage {
+        Idle,
+        ReadingScene,
+        LoadingAssets,
+        BuildingWorld,
+        Ready,
+        Cancelled,
+        Failed
+    };
+
+    struct Progress {
+        Stage stage;
+        std::size_t loadedAssetCount;
+        std::size_t assetCount;
+        std::size_t createdDoodadCount;
+        std::size_t doodadCount;
+
+        /**
+         * @brief Of the assets and the doodads together, 1 once the stage is Ready
+         */
+        double fraction;
+    };
+
+    struct StreamedScene {
+        std::unique_ptr<HeadlessSimulation> p_simulation;
+        std::optional<std::size_t> o_playerDoodadIndex;
+    };
+
+public: // member functions
+    static const char* getStageName(const Stage stage);
+
+    /**
+     * @brief The asset preloader may be null, in which case no assets are read
+     */
+    SceneStreamer(
+        const BehaviourRegistry& behaviourRegistry,
+        AssetPreloader* const p_assetPreloader
+    );
+    SceneStreamer(const SceneStreamer& other) = delete;
+    SceneStreamer& operator=(const SceneStreamer& other) = delete;
+    ~SceneStreamer();
+
+    /**
+     * @brief Cancels whatever is streaming and starts streaming the given scene file
+     */
+    void begin(const std::string& sceneFilepath, const double ticksPerSecond);
+
+    /**
+     * @brief Returns once the background thread has stopped
+     */
+    void cancel();
+
+    Progress getProgress();
+    bool isReady() { return this->getProgress().stage == Stage::Ready; }
+
+    /**
+     * @brief The streamed scene once the stage is Ready, after which the streamer is Idle again. Empty otherwise
+     */
+    std::optional<StreamedScene> take();
+
+    /**
+     * @brief Destroys a simulation on a background thread, so the frame that swaps it out does not pay for it
+     */
+    void retire(std::unique_ptr<HeadlessSimulation> p_simulation);
+
+    USE_LOGGER(HEADLESS);
+
+private: // member functions
+    void stream(const std::string& sceneFilepath, const double ticksPerSecond);
+    void setStage(const Stage stage);
+    void join();
+
+private: // member variables
+    const BehaviourRegistry& m_behaviourRegistry;
+    AssetPreloader* mp_assetPreloader;
+
+    std::mutex m_mutex;
+    Stage m_stage;
+    AssetPreloader::Progress m_initialAssetProgress;
+    std::size_t m_doodadCount;
+    std::optional<StreamedScene> mo_streamedScene;
+    HeadlessSimulation::BuildMonitor m_buildMonitor;
+
+    std::thread m_streamThread;
+    std::thread m_retireThread;
+};
@@ -0,0 +1,169 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/headless/SimulationThread.hpp"
+#include "pole_position/headless/TransformSnapshot.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+SimulationThread::SimulationThread(
+    HeadlessSimulation& simulation,
+    const std::optional<uint64_t> o_tickCount,
+    const uint32_t maxCatchUpTickCount
+) :
+    m_simulation(simulation),
+    mo_tickCount(o_tickCount),
+    m_maxCatchUpTickCount(maxCatchUpTickCount),
+    m_snapshots(),
+    m_previousPositions(simulation.getDoodadStore().positions),
+    m_previousRotations(simulation.getDoodadStore().rotations),
+    m_totalInputState(InputState::idle()),
+    m_stopRequested(false),
+    m_isFinished(false),
+    m_tickCount(0),
+    m_caughtUpTickCount(0),
+    m_droppedTickCount(0),
+    m_thread()
+{
+    LOG_FUNCTION_SCOPE_INFOthis("at {} ticks per second, catching up at most {} ticks", m_simulation.getTicksPerSecond(), m_maxCatchUpTickCount);
+
+    // Everything the thread uses has to be constructed before it starts
+    m_thread = std::thread(&SimulationThread::threadLoop, this);
+}
+
+SimulationThread::~SimulationThread() {
+    this->stop();
+    m_thread.join();
+
+    const Statistics statistics = this->getStatistics();
+    LOG_INFOthis("Simulation thread ran {} ticks, {} of them late, and dropped {}", statistics.tickCount, statistics.caughtUpTickCount, statistics.droppedTickCount);
+}
+
+void
+SimulationThread::stop() {
+    m_stopRequested.store(true, std::memory_order_relaxed);
+}
+
+SimulationThread::Statistics
+SimulationThread::getStatistics() const {
+    return {
+        m_tickCount.load(std::memory_order_relaxed),
+        m_caughtUpTickCount.load(std::memory_order_relaxed),
+        m_droppedTickCount.load(std::memory_order_relaxed)
+    };
+}
+
+void
+SimulationThread::publishSnapshot(
+    const InputState& inputState,
+    const Clock::time_point scheduledTime
+) {
+    PROFILE_SCOPE("Publish transform snapshot");
+
+    m_totalInputState.keyDown_w = inputState.keyDown_w;
+    m_totalInputState.keyDown_a = inputState.keyDown_a;
+    m_totalInputState.keyDown_s = inputState.keyDown_s;
+    m_totalInputState.keyDown_d = inputState.keyDown_d;
+    m_totalInputState.mousePositionOffset_x += inputState.mousePositionOffset_x;
+    m_totalInputState.mousePositionOffset_y += inputState.mousePositionOffset_y;
+    m_totalInputState.scrollOffset_y += inputState.scrollOffset_y;
+
+    const DoodadStore& doodadStore = m_simulation.getDoodadStore();
+    TransformSnapshot& snapshot = m_snapshots.getWriteSlot();
+    if (snapshot.positions.size() != doodadStore.size()) {
+        // The slot's first write, after which only the doodads that moved need copying into it
+        snapshot.previousPositions = m_previousPositions;
+        snapshot.previousRotations = m_previousRotations;
+        snapshot.positions = doodadStore.positions;
+        snapshot.rotations = doodadStore.rotations;
+        snapshot.lastActiveTickIndices = doodadStore.lastActiveTickIndices;
+    } else {
+        // The slot was last written at its tick index. A doodad that has not been active since then has been at
+        // rest since before that tick, so both of its transforms in the slot are still its current one
+        const auto copyDoodad = [this, &doodadStore, &snapshot] (const std::size_t doodadIndex) {
+            if (doodadStore.lastActiveTickIndices[doodadIndex] < snapshot.tickIndex) {
+                return;
+            }
+            snapshot.previousPositions[doodadIndex] = m_previousPositions[doodadIndex];
+            snapshot.previousRotations[doodadIndex] = m_previousRotations[doodadIndex];
+            snapshot.positions[doodadIndex] = doodadStore.positions[doodadIndex];
+            snapshot.rotations[doodadIndex] = doodadStore.rotations[doodadIndex];
+            snapshot.lastActiveTickIndices[doodadIndex] = doodadStore.lastActiveTickIndices[doodadIndex];
+        };
+        for (const std::size_t doodadIndex : doodadStore.movableDoodadIndices) {
+            copyDoodad(doodadIndex);
+        }
+        for (const std::size_t doodadIndex : doodadStore.ghostDoodadIndices) {
+            copyDoodad(doodadIndex);
+        }
+    }
+    snapshot.tickIndex = m_simulation.getTickCount() - 1;
+    snapshot.scheduledTime = scheduledTime;
+    snapshot.inputState = m_totalInputState;
+    snapshot.publishTime = Clock::now();
+    m_snapshots.publish();
+
+    for (const std::size_t doodadIndex : doodadStore.activeDoodadIndices) {
+        m_previousPositions[doodadIndex] = doodadStore.positions[doodadIndex];
+        m_previousRotations[doodadIndex] = doodadStore.rotations[doodadIndex];
+    }
+    for (const std::size_t doodadIndex : doodadStore.ghostDoodadIndices) {
+        if (doodadStore.lastActiveTickIndices[doodadIndex] == snapshot.tickIndex) {
+            m_previousPositions[doodadIndex] = doodadStore.positions[doodadIndex];
+            m_previousRotations[doodadIndex] = doodadStore.rotations[doodadIndex];
+        }
+    }
+}
+
+void
+SimulationThread::threadLoop() {
+    LOG_FUNCTION_SCOPE_TRACEthis("");
+
+    const Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_simulation.getTicksPerSecond()));
+    Clock::time_point nextTickTime = Clock::now();
+
+    while (!m_stopRequested.load(std::memory_order_relaxed) && !HeadlessSimulation::isStopRequested()) {
+        if (mo_tickCount && m_tickCount.load(std::memory_order_relaxed) >= *mo_tickCount) {
+            break;
+        }
+
+        const Clock::time_point now = Clock::now();
+        if (now < nextTickTime) {
+            std::this_thread::sleep_until(nextTickTime);
+            continue;
+        }
+
+        const uint64_t ticksBehind = static_cast<uint64_t>((now - nextTickTime) / tickDuration);
+        if (ticksBehind > m_maxCatchUpTickCount) {
+            const uint64_t droppedTickCount = ticksBehind - m_maxCatchUpTickCount;
+            m_droppedTickCount.fetch_add(droppedTickCount, std::memory_order_relaxed);
+            nextTickTime += droppedTickCount * tickDuration;
+            ASYNC_LOG_WARNING(HEADLESS, "Simulation thread is {} ticks behind, dropping {} of them", ticksBehind, droppedTickCount);
+        }
+        if (ticksBehind > 0) {
+            m_caughtUpTickCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        const std::optional<InputState> o_inputState = m_simulation.readTickInput();
+        if (!o_inputState) {
+            break;
+        }
+
+        m_simulation.fixedTick(*o_inputState);
+        this->publishSnapshot(*o_inputState, nextTickTime);
+        m_tickCount.fetch_add(1, std::memory_order_relaxed);
+
+        nextTickTime += tickDuration;
+    }
+
+    m_isFinished.store(true, std::memory_order_release);
+}
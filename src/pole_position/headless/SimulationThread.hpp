@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/headless/TransformSnapshot.hpp"
+#include "pole_position/headless/TripleBuffer.hpp"
+#include "pole_position/input/InputState.hpp"
+
+/**
+ * @brief Runs a simulation's fixed ticks on their own thread, paced to the simulation's tick rate, and publishes
+ * the doodads' transforms after every tick through a triple buffer. A slow reader never holds up a tick, it just
+ * picks up the newest snapshot whenever it gets around to it.
+ *
+ * When the thread falls behind it runs the missed ticks back to back to catch up, but never more than
+ * maxCatchUpTickCount of them. Anything beyond that is dropped, so one long stall does not turn into a burst of
+ * ticks that stalls everything after it.
+ */
+class SimulationThread {
+public: // classes and enums
+    struct Statistics {
+        uint64_t tickCount;
+        uint64_t caughtUpTickCount;
+        uint64_t droppedTickCount;
+    };
+
+public: // member functions
+    SimulationThread(
+        HeadlessSimulation& simulation,
+        const std::optional<uint64_t> o_tickCount,
+        const uint32_t maxCatchUpTickCount
+    );
+    SimulationThread(const SimulationThread& other) = delete;
+    SimulationThread& operator=(const SimulationThread& other) = delete;
+    ~SimulationThread();
+
+    void stop();
+
+    /**
+     * @brief Whether the thread ran out of ticks, ran out of replayed input or was stopped
+     */
+    bool isFinished() const { return m_isFinished.load(std::memory_order_acquire); }
+    Statistics getStatistics() const;
+
+    /**
+     * @brief Only one thread may read the snapshots. Returns whether a newer snapshot was picked up, and until the
+     * first one is, getSnapshot is empty
+     */
+    bool acquireSnapshot() { return m_snapshots.acquire(); }
+    const TransformSnapshot& getSnapshot() const { return m_snapshots.getReadSlot(); }
+
+    USE_LOGGER(HEADLESS);
+
+private: // classes and enums
+    using Clock = std::chrono::steady_clock;
+
+private: // member functions
+    void threadLoop();
+    void publishSnapshot(const InputState& inputState, const Clock::time_point scheduledTime);
+
+private: // member variables
+    HeadlessSimulation& m_simulation;
+    std::optional<uint64_t> mo_tickCount;
+    uint32_t m_maxCatchUpTickCount;
+
+    TripleBuffer<TransformSnapshot> m_snapshots;
+    std::vector<math::Vec3> m_previousPositions;
+    std::vector<math::Quaternion> m_previousRotations;
+    InputState m_totalInputState;
+
+    std::atomic<bool> m_stopRequested;
+    std::atomic<bool> m_isFinished;
+    std::atomic<uint64_t> m_tickCount;
+    std::atomic<uint64_t> m_caughtUpTickCount;
+    std::atomic<uint64_t> m_droppedTickCount;
+
+    std::thread m_thread;
+};
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/headless/SimulationThread.hpp"
+#include "pole_position/headless/SnapshotPresenter.hpp"
+#include "pole_position/headless/TransformSnapshot.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/snapshot/Interpolation.hpp"
+
+SnapshotPresenter::SnapshotPresenter(
+    HeadlessSimulation& simulation,
+    const double framesPerSecond
+) :
+    m_simulation(simulation),
+    m_framesPerSecond(framesPerSecond),
+    m_tickDuration(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / simulation.getTicksPerSecond()))),
+    m_presentedDoodadStore(simulation.getDoodadStore()),
+    m_lastTotalInputState(InputState::idle()),
+    mo_lastTickIndex(),
+    m_frameCount(0),
+    m_framesWithoutNewTickCount(0),
+    m_snapshotAgeSampleCount(0),
+    m_snapshotAgeSumMicroseconds(0.0),
+    m_maxSnapshotAgeMicroseconds(0.0),
+    m_snapshotAgeWindow()
+{
+    m_snapshotAgeWindow.reserve(snapshotAgeWindowFrameCount);
+}
+
+void
+SnapshotPresenter::presentFrame(
+    SimulationThread& simulationThread,
+    const Clock::time_point now
+) {
+    PROFILE_SCOPE("Present frame");
+
+    const bool hasNewTick = simulationThread.acquireSnapshot();
+    if (!hasNewTick && !mo_lastTickIndex) {
+        return;
+    }
+
+    const TransformSnapshot& snapshot = simulationThread.getSnapshot();
+    if (!hasNewTick) {
+        ++m_framesWithoutNewTickCount;
+    }
+    if (mo_lastTickIndex && hasNewTick && snapshot.tickIndex > *mo_lastTickIndex + 1) {
+        ASYNC_LOG_TRACE(HEADLESS, "Frame {} skipped {} ticks", m_frameCount, snapshot.tickIndex - *mo_lastTickIndex - 1);
+    }
+
+    // Doodads that have not been active since the last frame's tick were already presented where they are now
+    const uint64_t firstChangedTickIndex = mo_lastTickIndex.value_or(0);
+    mo_lastTickIndex = snapshot.tickIndex;
+
+    // Once the window is full each age takes the slot of the one from a window ago
+    const double snapshotAgeMicroseconds = std::chrono::duration<double, std::micro>(now - snapshot.publishTime).count();
+    if (m_snapshotAgeWindow.size() < snapshotAgeWindowFrameCount) {
+        m_snapshotAgeWindow.push_back(snapshotAgeMicroseconds);
+    } else {
+        m_snapshotAgeWindow[m_snapshotAgeSampleCount % snapshotAgeWindowFrameCount] = snapshotAgeMicroseconds;
+    }
+    ++m_snapshotAgeSampleCount;
+    m_snapshotAgeSumMicroseconds += snapshotAgeMicroseconds;
+    m_maxSnapshotAgeMicroseconds = std::max(m_maxSnapshotAgeMicroseconds, snapshotAgeMicroseconds);
+
+    // How far we are into the tick after the snapshot's, which is how far to move from its previous to its current
+    const double factor = std::clamp(std::chrono::duration<double>(now - snapshot.scheduledTime) / m_tickDuration, 0.0, 1.0);
+
+    // Static bodies never move, so only the movable doodads and the ghosts need interpolating
+    const auto interpolateDoodad = [this, &snapshot, firstChangedTickIndex, factor] (const std::size_t doodadIndex) {
+        if (snapshot.lastActiveTickIndices[doodadIndex] < firstChangedTickIndex) {
+            return;
+        }
+
+        const math::Vec3& previousPosition = snapshot.previousPositions[doodadIndex];
+        m_presentedDoodadStore.positions[doodadIndex] = previousPosition + (snapshot.positions[doodadIndex] - previousPosition) * factor;
+        m_presentedDoodadStore.rotations[doodadIndex] = interpolateRotation(snapshot.previousRotations[doodadIndex], snapshot.rotations[doodadIndex], factor);
+    };
+    for (const std::size_t doodadIndex : m_presentedDoodadStore.movableDoodadIndices) {
+        interpolateDoodad(doodadIndex);
+    }
+    for (const std::size_t doodadIndex : m_presentedDoodadStore.ghostDoodadIndices) {
+        interpolateDoodad(doodadIndex);
+    }
+
+    // Camera movement is applied once, by the first frame after the ticks it arrived with
+    InputState inputState = snapshot.inputState;
+    inputState.mousePositionOffset_x -= m_lastTotalInputState.mousePositionOffset_x;
+    inputState.mousePositionOffset_y -= m_lastTotalInputState.mousePositionOffset_y;
+    inputState.scrollOffset_y -= m_lastTotalInputState.scrollOffset_y;
+    m_lastTotalInputState = snapshot.inputState;
+
+    m_simulation.update(inputState, m_presentedDoodadStore);
+    ++m_frameCount;
+}
+
+SnapshotPresenter::Statistics
+SnapshotPresenter::calculateStatistics() const {
+    if (m_snapshotAgeWindow.empty()) {
+        return {m_frameCount, m_framesWithoutNewTickCount, 0.0, 0.0, 0.0, 0.0};
+    }
+
+    std::vector<double> sortedSnapshotAges = m_snapshotAgeWindow;
+    std::sort(sortedSnapshotAges.begin(), sortedSnapshotAges.end());
+    const auto getPercentile = [&sortedSnapshotAges] (const double percentile) {
+        return sortedSnapshotAges[static_cast<std::size_t>(percentile * (sortedSnapshotAges.size() - 1))];
+    };
+
+    return {
+        m_frameCount,
+        m_framesWithoutNewTickCount,
+        m_snapshotAgeSumMicroseconds / m_snapshotAgeSampleCount,
+        getPercentile(0.5),
+        getPercentile(0.99),
+        m_maxSnapshotAgeMicroseconds
+    };
+}
+
+SnapshotPresenter::Statistics
+SnapshotPresenter::run(
+    SimulationThread& simulationThread
+) {
+    LOG_FUNCTION_SCOPE_INFOthis("at {} frames per second", m_framesPerSecond);
+
+    const Clock::duration frameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_framesPerSecond));
+    Clock::time_point nextFrameTime = Clock::now();
+
+    while (!simulationThread.isFinished() && !HeadlessSimulation::isStopRequested()) {
+        std::this_thread::sleep_until(nextFrameTime);
+        const Clock::time_point now = Clock::now();
+
+        this->presentFrame(simulationThread, now);
+        PROFILE_FRAME_END();
+
+        // A late frame does not try to make up for itself, the next one is simply a frame after this one
+        nextFrameTime = std::max(nextFrameTime + frameDuration, now);
+    }
+
+    const Statistics statistics = this->calculateStatistics();
+    LOG_INFOthis("Presented {} frames, {} of them without a new tick", statistics.frameCount, statistics.framesWithoutNewTickCount);
+    LOG_INFOthis("  snapshot age mean {:.1f} us, p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us", statistics.meanSnapshotAgeMicroseconds, statistics.p50SnapshotAgeMicroseconds, statistics.p99SnapshotAgeMicroseconds, statistics.maxSnapshotAgeMicroseconds);
+
+    return statistics;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/headless/SimulationThread.hpp"
+#include "pole_position/headless/TransformSnapshot.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+/**
+ * @brief Stands in for the render thread of a headless run that has its simulation on a SimulationThread. Once a
+ * frame it picks up the newest snapshot, interpolates the doodads between the two ticks it holds and runs the
+ * systems' update (the player's camera) against the result, so the update always sees one consistent, smoothly
+ * moving state however the ticks and frames line up.
+ *
+ * Rendering lags the simulation by up to one tick, which is what makes the interpolation possible.
+ */
+class SnapshotPresenter {
+public: // classes and enums
+    /**
+     * @brief Snapshot ages are how long a snapshot had been published when a frame used it. The mean and max are
+     * over the whole run, the percentiles over its last snapshotAgeWindowFrameCount frames
+     */
+    struct Statistics {
+        uint64_t frameCount;
+        uint64_t framesWithoutNewTickCount;
+        double meanSnapshotAgeMicroseconds;
+        double p50SnapshotAgeMicroseconds;
+        double p99SnapshotAgeMicroseconds;
+        double maxSnapshotAgeMicroseconds;
+    };
+
+public: // member functions
+    /**
+     * @brief Must be created before the simulation thread starts, since it copies the simulation's doodad store
+     */
+    SnapshotPresenter(
+        HeadlessSimulation& simulation,
+        const double framesPerSecond
+    );
+    SnapshotPresenter(const SnapshotPresenter& other) = delete;
+    SnapshotPresenter& operator=(const SnapshotPresenter& other) = delete;
+
+    /**
+     * @brief Presents frames until the simulation thread finishes or a stop is requested
+     */
+    Statistics run(SimulationThread& simulationThread);
+
+    USE_LOGGER(HEADLESS);
+
+private: // classes and enums
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Bounds the ages kept for the percentiles, so a long run does not grow them forever
+     */
+    static constexpr std::size_t snapshotAgeWindowFrameCount = 4096;
+
+private: // member functions
+    void presentFrame(SimulationThread& simulationThread, const Clock::time_point now);
+    Statistics calculateStatistics() const;
+
+private: // member variables
+    HeadlessSimulation& m_simulation;
+    double m_framesPerSecond;
+    Clock::duration m_tickDuration;
+
+    DoodadStore m_presentedDoodadStore;
+    InputState m_lastTotalInputState;
+    std::optional<uint64_t> mo_lastTickIndex;
+
+    uint64_t m_frameCount;
+    uint64_t m_framesWithoutNewTickCount;
+    uint64_t m_snapshotAgeSampleCount;
+    double m_snapshotAgeSumMicroseconds;
+    double m_maxSnapshotAgeMicroseconds;
+    std::vector<double> m_snapshotAgeWindow;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/input/InputState.hpp"
+
+/**
+ * @brief The doodads' transforms before and after one tick, as the simulation thread publishes them. Carrying both
+ * ticks lets a reader interpolate across the tick even when it missed the snapshot before it
+ */
+struct TransformSnapshot {
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t tickIndex;
+
+    /**
+     * @brief When the tick was due, which is what interpolation is measured from, and when it was actually published
+     */
+    Clock::time_point scheduledTime;
+    Clock::time_point publishTime;
+
+    std::vector<math::Vec3> previousPositions;
+    std::vector<math::Quaternion> previousRotations;
+    std::vector<math::Vec3> positions;
+    std::vector<math::Quaternion> rotations;
+
+    /**
+     * @brief DoodadStore::lastActiveTickIndices as of this tick. Only the doodads active since a slot was last
+     * written are copied into it, and a reader only has to interpolate the doodads active since its last snapshot
+     */
+    std::vector<uint64_t> lastActiveTickIndices;
+
+    /**
+     * @brief The most recent tick's input. Its camera offsets are replaced by running totals over every tick so far,
+     * so a reader that skips snapshots can still apply all of the camera movement exactly once
+     */
+    InputState inputState;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Hands values from one writer thread to one reader thread without either of them ever waiting. The writer
+ * fills its own slot and swaps it with the shared middle slot, the reader swaps the middle slot for its own when the
+ * middle one holds something newer. Neither side touches the other's slot, so the reader always sees one complete
+ * value and the writer never stalls on a slow reader, it just overwrites what the reader has not picked up yet.
+ *
+ * Slots are reused, so a value's storage, like a vector's capacity, survives across writes.
+ */
+template<typename Value>
+class TripleBuffer {
+public: // member functions
+    TripleBuffer() :
+        m_slots(),
+        m_middleState(1),
+        m_writeIndex(0),
+        m_readIndex(2)
+    {}
+    TripleBuffer(const TripleBuffer& other) = delete;
+    TripleBuffer& operator=(const TripleBuffer& other) = delete;
+
+    /**
+     * @brief Only the writer may call these two
+     */
+    Value& getWriteSlot() { return m_slots[m_writeIndex]; }
+    void publish() {
+        m_writeIndex = m_middleState.exchange(m_writeIndex | s_freshBit, std::memory_order_acq_rel) & s_indexMask;
+    }
+
+    /**
+     * @brief Only the reader may call these two. Returns whether anything newer was picked up, the read slot keeps
+     * the last value picked up either way
+     */
+    bool acquire() {
+        if (!(m_middleState.load(std::memory_order_relaxed) & s_freshBit)) {
+            return false;
+        }
+
+        m_readIndex = m_middleState.exchange(m_readIndex, std::memory_order_acq_rel) & s_indexMask;
+        return true;
+    }
+    const Value& getReadSlot() const { return m_slots[m_readIndex]; }
+
+private: // static variables
+    static constexpr uint8_t s_indexMask = 0x3;
+    static constexpr uint8_t s_freshBit = 0x4;
+
+private: // member variables
+    std::array<Value, 3> m_slots;
+    std::atomic<uint8_t> m_middleState;
+    uint8_t m_writeIndex;
+    uint8_t m_readIndex;
+};
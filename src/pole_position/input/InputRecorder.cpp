@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/input/InputRecorder.hpp"
+#include "pole_position/input/InputRecordingFormat.hpp"
+#include "pole_position/input/InputState.hpp"
+
+InputRecorder::InputRecorder(
+    const std::string& filepath,
+    const double ticksPerSecond
+) :
+    m_filepath(filepath),
+    m_streamBuffer(),
+    m_outputStream(),
+    m_ticksPerSecond(ticksPerSecond),
+    m_fixedUpdateRecordCount(0),
+    m_updateRecordCount(0)
+{
+    m_outputStream.rdbuf()->pubsetbuf(m_streamBuffer.data(), m_streamBuffer.size());
+    m_outputStream.open(m_filepath, std::ios::binary | std::ios::trunc);
+    if (!m_outputStream) {
+        LOG_CRITICALthis("Failed to open {} for writing", m_filepath);
+        throw std::runtime_error("Failed to open input recording for writing");
+    }
+
+    this->writeHeader(m_ticksPerSecond);
+    m_outputStream.flush();
+
+    LOG_INFOthis("Recording input to {}", m_filepath);
+}
+
+InputRecorder::~InputRecorder() {
+    m_outputStream.flush();
+    LOG_INFOthis("Recorded {} fixed updates and {} updates to {}", m_fixedUpdateRecordCount, m_updateRecordCount, m_filepath);
+}
+
+void
+InputRecorder::writeHeader(
+    const double ticksPerSecond
+) {
+    m_outputStream.write(input_recording_format::magic.data(), input_recording_format::magic.size());
+    this->writeValue<uint16_t>(input_recording_format::version);
+    this->writeValue<double>(ticksPerSecond);
+}
+
+void
+InputRecorder::recordFixedUpdate(
+    const InputState& inputState,
+    const double ticksPerSecond
+) {
+    // Nothing has been written after the header yet, so it can be written over in place
+    if (m_fixedUpdateRecordCount == 0 && ticksPerSecond != m_ticksPerSecond) {
+        LOG_INFOthis("Recording at {} ticks per second instead of {}", ticksPerSecond, m_ticksPerSecond);
+        m_ticksPerSecond = ticksPerSecond;
+        m_outputStream.seekp(0);
+        this->writeHeader(m_ticksPerSecond);
+    }
+
+    uint8_t tag = 0;
+    tag |= inputState.keyDown_w ? input_recording_format::keyBit_w : 0;
+    tag |= inputState.keyDown_a ? input_recording_format::keyBit_a : 0;
+    tag |= inputState.keyDown_s ? input_recording_format::keyBit_s : 0;
+    tag |= inputState.keyDown_d ? input_recording_format::keyBit_d : 0;
+    this->writeValue<uint8_t>(tag);
+
+    ++m_fixedUpdateRecordCount;
+}
+
+void
+InputRecorder::recordUpdate(
+    const InputState& inputState
+) {
+    // Updates before the first fixed update cannot be attributed to a tick, and updates without any movement
+    // are implied by their absence
+    const bool hasMousePositionOffset = inputState.mousePositionOffset_x != 0.0 || inputState.mousePositionOffset_y != 0.0;
+    const bool hasScrollOffset = inputState.scrollOffset_y != 0.0;
+    if (m_fixedUpdateRecordCount == 0 || (!hasMousePositionOffset && !hasScrollOffset)) {
+        return;
+    }
+
+    uint8_t tag = input_recording_format::updateRecordBit;
+    tag |= hasMousePositionOffset ? input_recording_format::hasMousePositionOffsetBit : 0;
+    tag |= hasScrollOffset ? input_recording_format::hasScrollOffsetBit : 0;
+    this->writeValue<uint8_t>(tag);
+
+    if (hasMousePositionOffset) {
+        this->writeValue<double>(inputState.mousePositionOffset_x);
+        this->writeValue<double>(inputState.mousePositionOffset_y);
+    }
+    if (hasScrollOffset) {
+        this->writeValue<double>(inputState.scrollOffset_y);
+    }
+
+    ++m_updateRecordCount;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/input/InputRecordingFormat.hpp"
+#include "pole_position/input/InputState.hpp"
+
+/**
+ * @brief Writes the input the player controller consumes to a compact binary stream (see InputRecordingFormat.hpp)
+ * so that a session can be replayed deterministically by an InputReplayer
+ */
+class InputRecorder {
+public: // member functions
+    /**
+     * @brief Writes the header straight away, so that a session that ends before its first tick still leaves a
+     * valid, empty recording
+     */
+    InputRecorder(const std::string& filepath, const double ticksPerSecond);
+    InputRecorder(const InputRecorder& other) = delete;
+    InputRecorder& operator=(const InputRecorder& other) = delete;
+    ~InputRecorder();
+
+    /**
+     * @brief The first fixed update rewrites the header if it ticks at another rate than the recorder was opened
+     * with, which the windowed application, whose tick rate is quartz's own, can
+     */
+    void recordFixedUpdate(const InputState& inputState, const double ticksPerSecond);
+    void recordUpdate(const InputState& inputState);
+
+    uint64_t getFixedUpdateRecordCount() const { return m_fixedUpdateRecordCount; }
+
+    USE_LOGGER(INPUT_RECORDING);
+
+private: // member functions
+    void writeHeader(const double ticksPerSecond);
+
+    template <typename T>
+    void writeValue(const T value) { m_outputStream.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+private: // member variables
+    std::string m_filepath;
+    std::array<char, input_recording_format::streamBufferSize> m_streamBuffer;
+    std::ofstream m_outputStream;
+    double m_ticksPerSecond;
+    uint64_t m_fixedUpdateRecordCount;
+    uint64_t m_updateRecordCount;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief The layout of an input recording.
+ *
+ * The stream starts with a header of the magic bytes, the format version and the fixed update rate (a double)
+ * the recording was made at. It is followed by one record per fixed update and one record per update (frame)
+ * that had any mouse or scroll movement, in the order they happened. Every record starts with a single tag byte,
+ * so a tick with no camera movement costs one byte:
+ *
+ *   fixed update : 0b0000dsaw                            -- the state of the w, a, s and d keys
+ *   update       : 0b100000sm  [mouse x, mouse y] [scroll y]  -- doubles that are only present when m or s is set
+ */
+namespace input_recording_format {
+
+constexpr std::array<char, 4> magic = {'P', 'P', 'I', 'R'};
+constexpr uint16_t version = 1;
+
+constexpr uint8_t updateRecordBit = 0b10000000;
+
+constexpr uint8_t keyBit_w = 0b00000001;
+constexpr uint8_t keyBit_a = 0b00000010;
+constexpr uint8_t keyBit_s = 0b00000100;
+constexpr uint8_t keyBit_d = 0b00001000;
+
+constexpr uint8_t hasMousePositionOffsetBit = 0b00000001;
+constexpr uint8_t hasScrollOffsetBit = 0b00000010;
+
+constexpr std::size_t streamBufferSize = 64 * 1024;
+
+} // namespace input_recording_format
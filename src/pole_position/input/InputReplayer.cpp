@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/input/InputRecordingFormat.hpp"
+#include "pole_position/input/InputReplayer.hpp"
+#include "pole_position/input/InputState.hpp"
+
+InputReplayer::InputReplayer(
+    const std::string& filepath
+) :
+    m_filepath(filepath),
+    m_streamBuffer(),
+    m_inputStream(),
+    m_ticksPerSecond(0.0),
+    m_tickCount(0),
+    mo_pendingFixedUpdateTag()
+{
+    m_inputStream.rdbuf()->pubsetbuf(m_streamBuffer.data(), m_streamBuffer.size());
+    m_inputStream.open(m_filepath, std::ios::binary);
+    if (!m_inputStream) {
+        LOG_CRITICALthis("Failed to open {} for reading", m_filepath);
+        throw std::runtime_error("Failed to open input recording for reading");
+    }
+
+    std::array<char, input_recording_format::magic.size()> magic {};
+    uint16_t version = 0;
+    if (
+        !m_inputStream.read(magic.data(), magic.size()) ||
+        !std::equal(magic.begin(), magic.end(), input_recording_format::magic.begin()) ||
+        !this->readValue(version) ||
+        version != input_recording_format::version ||
+        !this->readValue(m_ticksPerSecond)
+    ) {
+        LOG_CRITICALthis("{} is not a version {} input recording", m_filepath, input_recording_format::version);
+        throw std::runtime_error("Invalid input recording");
+    }
+
+    LOG_INFOthis("Replaying input from {} recorded at {} ticks per second", m_filepath, m_ticksPerSecond);
+}
+
+bool
+InputReplayer::readUpdateRecord(
+    const uint8_t tag,
+    InputState& inputState
+) {
+    if (tag & input_recording_format::hasMousePositionOffsetBit) {
+        double mousePositionOffset_x = 0.0;
+        double mousePositionOffset_y = 0.0;
+        if (!this->readValue(mousePositionOffset_x) || !this->readValue(mousePositionOffset_y)) {
+            return false;
+        }
+        inputState.mousePositionOffset_x += mousePositionOffset_x;
+        inputState.mousePositionOffset_y += mousePositionOffset_y;
+    }
+
+    if (tag & input_recording_format::hasScrollOffsetBit) {
+        double scrollOffset_y = 0.0;
+        if (!this->readValue(scrollOffset_y)) {
+            return false;
+        }
+        inputState.scrollOffset_y += scrollOffset_y;
+    }
+
+    return true;
+}
+
+std::optional<InputState>
+InputReplayer::readNextTick() {
+    uint8_t fixedUpdateTag = 0;
+    if (mo_pendingFixedUpdateTag) {
+        fixedUpdateTag = *mo_pendingFixedUpdateTag;
+        mo_pendingFixedUpdateTag.reset();
+    } else if (!this->readValue(fixedUpdateTag)) {
+        LOG_INFOthis("Reached the end of {} after {} ticks", m_filepath, m_tickCount);
+        return std::nullopt;
+    }
+
+    InputState inputState {
+        static_cast<bool>(fixedUpdateTag & input_recording_format::keyBit_w),
+        static_cast<bool>(fixedUpdateTag & input_recording_format::keyBit_a),
+        static_cast<bool>(fixedUpdateTag & input_recording_format::keyBit_s),
+        static_cast<bool>(fixedUpdateTag & input_recording_format::keyBit_d),
+        0.0,
+        0.0,
+        0.0
+    };
+
+    uint8_t tag = 0;
+    while (this->readValue(tag)) {
+        if (!(tag & input_recording_format::updateRecordBit)) {
+            mo_pendingFixedUpdateTag = tag;
+            break;
+        }
+
+        if (!this->readUpdateRecord(tag, inputState)) {
+            LOG_WARNINGthis("{} is truncated after {} ticks", m_filepath, m_tickCount);
+            break;
+        }
+    }
+
+    ++m_tickCount;
+
+    return inputState;
+}
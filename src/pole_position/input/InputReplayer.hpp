@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/input/InputRecordingFormat.hpp"
+#include "pole_position/input/InputState.hpp"
+
+/**
+ * @brief Streams an InputRecorder recording back from disk one tick at a time, so a recording of any length
+ * only ever costs the size of the stream buffer
+ */
+class InputReplayer {
+public: // member functions
+    explicit InputReplayer(const std::string& filepath);
+    InputReplayer(const InputReplayer& other) = delete;
+    InputReplayer& operator=(const InputReplayer& other) = delete;
+
+    /**
+     * @brief The key state of the next fixed update, together with the mouse and scroll offsets of all of the
+     * updates that were recorded between it and the fixed update after it. Empty once the recording is exhausted
+     */
+    std::optional<InputState> readNextTick();
+
+    double getTicksPerSecond() const { return m_ticksPerSecond; }
+    uint64_t getTickCount() const { return m_tickCount; }
+
+    USE_LOGGER(INPUT_RECORDING);
+
+private: // member functions
+    template <typename T>
+    bool readValue(T& value) { return static_cast<bool>(m_inputStream.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+    bool readUpdateRecord(const uint8_t tag, InputState& inputState);
+
+private: // member variables
+    std::string m_filepath;
+    std::array<char, input_recording_format::streamBufferSize> m_streamBuffer;
+    std::ifstream m_inputStream;
+    double m_ticksPerSecond;
+    uint64_t m_tickCount;
+    std::optional<uint8_t> mo_pendingFixedUpdateTag;
+};
@@ -0,0 +1,18 @@
+#include "quartz/managers/input_manager/InputManager.hpp"
+
+#include "pole_position/input/InputState.hpp"
+
+InputState
+InputState::fromInputManager(
+    const quartz::managers::InputManager& inputManager
+) {
+    return {
+        inputManager.getKeyDown_w(),
+        inputManager.getKeyDown_a(),
+        inputManager.getKeyDown_s(),
+        inputManager.getKeyDown_d(),
+        inputManager.getMousePositionOffset_x(),
+        inputManager.getMousePositionOffset_y(),
+        inputManager.getScrollOffset_y()
+    };
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "quartz/managers/input_manager/InputManager.hpp"
+
+/**
+ * @brief A plain copy of the input that the player controller reads each tick. Decoupling the controller
+ * from the InputManager lets us drive it without GLFW (headless runs, replays)
+ */
+struct InputState {
+public: // member functions
+    static InputState fromInputManager(const quartz::managers::InputManager& inputManager);
+    static InputState idle() { return {false, false, false, false, 0.0, 0.0, 0.0}; }
+
+public: // member variables
+    bool keyDown_w;
+    bool keyDown_a;
+    bool keyDown_s;
+    bool keyDown_d;
+
+    double mousePositionOffset_x;
+    double mousePositionOffset_y;
+    double scrollOffset_y;
+};
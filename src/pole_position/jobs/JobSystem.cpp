@@ -0,0 +1,193 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/jobs/JobSystem.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+
+JobSystem::JobSystem(
+    const uint32_t workerCount
+) :
+    m_workers(),
+    m_wakeMutex(),
+    m_wakeCondition(),
+    m_queuedJobCount(0),
+    m_isStopping(false),
+    m_jobCount(0),
+    m_stolenJobCount(0)
+{
+    LOG_FUNCTION_SCOPE_TRACEthis("{} workers", workerCount);
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Jobs);
+
+    // Every queue has to exist before any worker starts looking for something to steal
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (std::size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_isStopping = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (std::unique_ptr<Worker>& p_worker : m_workers) {
+        p_worker->thread.join();
+    }
+
+    const Statistics statistics = this->getStatistics();
+    LOG_INFOthis("Ran {} jobs on {} workers, {} of them stolen", statistics.jobCount, m_workers.size(), statistics.stolenJobCount);
+}
+
+JobSystem::Statistics
+JobSystem::getStatistics() const {
+    return {
+        m_jobCount.load(std::memory_order_relaxed),
+        m_stolenJobCount.load(std::memory_order_relaxed)
+    };
+}
+
+bool
+JobSystem::tryRunJob(
+    const std::size_t thiefIndex
+) {
+    // Our own queue first, newest job first since its data is the most likely to still be in cache
+    std::optional<Job> o_job;
+    if (thiefIndex < m_workers.size()) {
+        Worker& worker = *m_workers[thiefIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.firstJobIndex < worker.jobs.size()) {
+            o_job.emplace(worker.jobs.back());
+            worker.jobs.pop_back();
+            if (worker.firstJobIndex == worker.jobs.size()) {
+                worker.jobs.clear();
+                worker.firstJobIndex = 0;
+            }
+        }
+    }
+
+    // Then the oldest job of whoever has one, starting after ourselves so that thieves spread out
+    for (std::size_t i = 1; !o_job && i <= m_workers.size(); ++i) {
+        const std::size_t victimIndex = (thiefIndex + i) % m_workers.size();
+        if (victimIndex == thiefIndex) {
+            continue;
+        }
+
+        Worker& victim = *m_workers[victimIndex];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.firstJobIndex < victim.jobs.size()) {
+            o_job.emplace(victim.jobs[victim.firstJobIndex++]);
+            if (victim.firstJobIndex == victim.jobs.size()) {
+                victim.jobs.clear();
+                victim.firstJobIndex = 0;
+            }
+            m_stolenJobCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (!o_job) {
+        return false;
+    }
+
+    m_queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+    Batch& batch = *o_job->p_batch;
+    try {
+        (*o_job->p_function)(o_job->taskIndex);
+    } catch (...) {
+        // The task still counts as finished, otherwise the waiting thread would never return to rethrow it
+        std::lock_guard<std::mutex> lock(batch.exceptionMutex);
+        if (!batch.firstException) {
+            batch.firstException = std::current_exception();
+        }
+    }
+    batch.remainingTaskCount.fetch_sub(1, std::memory_order_release);
+    m_jobCount.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+void
+JobSystem::workerLoop(
+    const std::size_t workerIndex
+) {
+    LOG_TRACEthis("Job worker {} started", workerIndex);
+
+    while (true) {
+        if (this->tryRunJob(workerIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.wait(lock, [this] { return m_isStopping || m_queuedJobCount.load(std::memory_order_relaxed) > 0; });
+        if (m_isStopping) {
+            break;
+        }
+    }
+
+    LOG_TRACEthis("Job worker {} stopped", workerIndex);
+}
+
+void
+JobSystem::parallelFor(
+    const std::size_t taskCount,
+    const std::function<void(std::size_t)>& function
+) {
+    if (taskCount == 0) {
+        return;
+    }
+
+    if (m_workers.empty() || taskCount == 1) {
+        for (std::size_t i = 0; i < taskCount; ++i) {
+            function(i);
+        }
+        m_jobCount.fetch_add(taskCount, std::memory_order_relaxed);
+        return;
+    }
+
+    PROFILE_SCOPE("Parallel for");
+
+    Batch batch;
+    batch.remainingTaskCount.store(taskCount, std::memory_order_relaxed);
+
+    // Counted before they are queued so that a job is never taken before it has been counted. Taking the lock
+    // orders the count against a worker that is about to wait on it
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_queuedJobCount.fetch_add(taskCount, std::memory_order_relaxed);
+    }
+
+    // Deal the tasks out round robin, stealing evens out whatever that gets wrong
+    for (std::size_t i = 0; i < taskCount; ++i) {
+        Worker& worker = *m_workers[i % m_workers.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.jobs.push_back({&function, &batch, i});
+    }
+    m_wakeCondition.notify_all();
+
+    // The caller has no queue of its own, so it only ever steals
+    while (batch.remainingTaskCount.load(std::memory_order_acquire) > 0) {
+        if (!this->tryRunJob(m_workers.size())) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Every task has finished, so nothing else touches the exception any more
+    if (batch.firstException) {
+        std::rethrow_exception(batch.firstException);
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+
+/**
+ * @brief A pool of worker threads that each own a queue of jobs. Workers take the newest job from their own queue
+ * and, once it is empty, steal the oldest job from another worker's queue, so uneven jobs still keep every worker
+ * busy. The thread waiting on a parallelFor steals jobs too instead of sleeping.
+ *
+ * With no workers everything runs on the calling thread, in order.
+ */
+class JobSystem {
+public: // classes and enums
+    struct Statistics {
+        uint64_t jobCount;
+        uint64_t stolenJobCount;
+    };
+
+public: // member functions
+    explicit JobSystem(const uint32_t workerCount);
+    JobSystem(const JobSystem& other) = delete;
+    JobSystem& operator=(const JobSystem& other) = delete;
+    ~JobSystem();
+
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    Statistics getStatistics() const;
+
+    /**
+     * @brief Runs function(i) for every i in [0, taskCount) and returns once they have all finished. Tasks may
+     * run in any order on any thread, so they must not depend on each other. If any task throws, the rest still
+     * run and the first exception is rethrown here once they have all finished
+     */
+    void parallelFor(const std::size_t taskCount, const std::function<void(std::size_t)>& function);
+
+    USE_LOGGER(JOBS);
+
+private: // classes and enums
+    /**
+     * @brief What the tasks of one parallelFor share, living on the stack of the thread waiting on it
+     */
+    struct Batch {
+        std::atomic<std::size_t> remainingTaskCount;
+        std::mutex exceptionMutex;
+        std::exception_ptr firstException;
+    };
+
+    /**
+     * @brief One task of a parallelFor. Plain data rather than a std::function, so that queueing one never
+     * allocates
+     */
+    struct Job {
+        const std::function<void(std::size_t)>* p_function;
+        Batch* p_batch;
+        std::size_t taskIndex;
+    };
+
+    /**
+     * @brief The jobs from firstJobIndex to the end of jobs are queued, oldest first. The vector is only cleared
+     * once the queue runs empty, so it keeps its capacity from one parallelFor to the next
+     */
+    struct Worker {
+        std::mutex mutex;
+        std::vector<Job> jobs;
+        std::size_t firstJobIndex = 0;
+        std::thread thread;
+    };
+
+private: // member functions
+    bool tryRunJob(const std::size_t thiefIndex);
+    void workerLoop(const std::size_t workerIndex);
+
+private: // member variables
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<std::size_t> m_queuedJobCount;
+    bool m_isStopping;
+
+    std::atomic<uint64_t> m_jobCount;
+    std::atomic<uint64_t> m_stolenJobCount;
+};
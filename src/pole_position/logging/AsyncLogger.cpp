@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+
+namespace {
+
+struct LoggerLevel {
+    std::string loggerName;
+    std::atomic<int> level;
+};
+
+/**
+ * @brief Everything the background thread and the call site registration share. Logger levels are never destroyed,
+ * because call sites keep pointers to them for the rest of the process. A ring buffer lives until its thread exits
+ * and, while the background thread runs, until the background thread has drained and freed it, since only the
+ * background thread reads ring buffers without holding ringBuffersMutex
+ */
+struct BackendState {
+    std::mutex ringBuffersMutex;
+    std::vector<std::unique_ptr<AsyncLogger::RingBuffer>> ringBuffers;
+    uint64_t freedDroppedRecordCount = 0;
+
+    std::mutex loggerLevelsMutex;
+    std::deque<LoggerLevel> loggerLevels;
+
+    std::mutex lifecycleMutex;
+    std::thread writerThread;
+    std::atomic<bool> stopRequested = false;
+    std::FILE* p_outputFile = nullptr;
+    uint64_t reportedDroppedRecordCount = 0;
+
+    uint64_t startTimestampTicks = 0;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+BackendState&
+getBackendState() {
+    static BackendState backendState;
+    return backendState;
+}
+
+const char*
+getLevelName(
+    const util::Logger::Level level
+) {
+    switch (level) {
+        case util::Logger::Level::trace:
+            return "trace";
+        case util::Logger::Level::debug:
+            return "debug";
+        case util::Logger::Level::info:
+            return "info";
+        case util::Logger::Level::warning:
+            return "warning";
+        case util::Logger::Level::error:
+            return "error";
+        case util::Logger::Level::critical:
+            return "critical";
+        default:
+            return "off";
+    }
+}
+
+std::atomic<int>&
+getLoggerLevel(
+    const std::string& loggerName
+) {
+    BackendState& backendState = getBackendState();
+    std::lock_guard<std::mutex> lock(backendState.loggerLevelsMutex);
+
+    for (LoggerLevel& loggerLevel : backendState.loggerLevels) {
+        if (loggerLevel.loggerName == loggerName) {
+            return loggerLevel.level;
+        }
+    }
+
+    // Until we are told otherwise everything is enabled, the same as the loggers' declared trace level
+    LoggerLevel& loggerLevel = backendState.loggerLevels.emplace_back();
+    loggerLevel.loggerName = loggerName;
+    loggerLevel.level.store(static_cast<int>(util::Logger::Level::trace), std::memory_order_relaxed);
+    return loggerLevel.level;
+}
+
+std::size_t
+writeRecords(
+    BackendState& backendState
+) {
+    std::vector<AsyncLogger::RingBuffer*> ringBuffers;
+    {
+        std::lock_guard<std::mutex> lock(backendState.ringBuffersMutex);
+        ringBuffers.reserve(backendState.ringBuffers.size());
+        for (const std::unique_ptr<AsyncLogger::RingBuffer>& p_ringBuffer : backendState.ringBuffers) {
+            ringBuffers.push_back(p_ringBuffer.get());
+        }
+    }
+
+    // Calibrate the timestamp ticks against the steady clock over everything we have seen since starting
+    const uint64_t elapsedTicks = AsyncLogger::getTimestampTicks() - backendState.startTimestampTicks;
+    const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - backendState.startTime).count();
+    const double secondsPerTick = elapsedTicks > 0 && elapsedSeconds > 0.0 ? elapsedSeconds / elapsedTicks : 1e-9;
+
+    std::size_t writtenRecordCount = 0;
+    for (AsyncLogger::RingBuffer* p_ringBuffer : ringBuffers) {
+        writtenRecordCount += p_ringBuffer->drain([&backendState, secondsPerTick] (const AsyncLogger::Record& record) {
+            fmt::print(
+                backendState.p_outputFile,
+                "[{:>14.6f}] [{}] [{}] {}\n",
+                static_cast<double>(static_cast<int64_t>(record.timestampTicks - backendState.startTimestampTicks)) * secondsPerTick,
+                record.p_callSite->loggerName,
+                getLevelName(record.p_callSite->level),
+                record.formatFunction(record.p_callSite->format, record.payload.data())
+            );
+        });
+    }
+
+    // Whatever the exited threads wrote was drained above, and nothing writes to them anymore
+    {
+        std::lock_guard<std::mutex> lock(backendState.ringBuffersMutex);
+        std::erase_if(backendState.ringBuffers, [&backendState] (const std::unique_ptr<AsyncLogger::RingBuffer>& p_ringBuffer) {
+            if (!p_ringBuffer->isRetired() || !p_ringBuffer->isEmpty()) {
+                return false;
+            }
+            backendState.freedDroppedRecordCount += p_ringBuffer->getDroppedRecordCount();
+            return true;
+        });
+    }
+
+    const uint64_t droppedRecordCount = AsyncLogger::getDroppedRecordCount();
+    if (droppedRecordCount != backendState.reportedDroppedRecordCount) {
+        fmt::print(backendState.p_outputFile, "[async logger] dropped {} records because a ring buffer was full\n", droppedRecordCount - backendState.reportedDroppedRecordCount);
+        backendState.reportedDroppedRecordCount = droppedRecordCount;
+    }
+
+    return writtenRecordCount;
+}
+
+void
+runWriterThread(
+    BackendState& backendState
+) {
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Logging);
+
+    while (true) {
+        const bool stopRequested = backendState.stopRequested.load(std::memory_order_acquire);
+        const std::size_t writtenRecordCount = writeRecords(backendState);
+
+        // Once a stop is requested keep going until the buffers are empty
+        if (stopRequested && writtenRecordCount == 0) {
+            break;
+        }
+
+        if (writtenRecordCount == 0) {
+            std::fflush(backendState.p_outputFile);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::fflush(backendState.p_outputFile);
+}
+
+} // namespace
+
+std::atomic<bool> AsyncLogger::s_isRunning = false;
+
+AsyncLogger::CallSite
+AsyncLogger::createCallSite(
+    const char* const loggerName,
+    const util::Logger::Level level,
+    const char* const format
+) {
+    return {
+        loggerName,
+        level,
+        format,
+        &getLoggerLevel(loggerName)
+    };
+}
+
+void
+AsyncLogger::setLevels(
+    const std::vector<std::pair<std::string, util::Logger::Level>>& loggerLevels
+) {
+    for (const std::pair<std::string, util::Logger::Level>& loggerLevel : loggerLevels) {
+        getLoggerLevel(loggerLevel.first).store(static_cast<int>(loggerLevel.second), std::memory_order_relaxed);
+    }
+}
+
+AsyncLogger::RingBuffer*
+AsyncLogger::registerThreadRingBuffer() {
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Logging);
+    BackendState& backendState = getBackendState();
+    std::lock_guard<std::mutex> lock(backendState.ringBuffersMutex);
+    return backendState.ringBuffers.emplace_back(std::make_unique<RingBuffer>()).get();
+}
+
+void
+AsyncLogger::unregisterThreadRingBuffer(
+    RingBuffer* const p_ringBuffer
+) {
+    BackendState& backendState = getBackendState();
+
+    // Without the background thread nothing else reads the ring buffer, and nothing would ever drain it
+    std::lock_guard<std::mutex> lifecycleLock(backendState.lifecycleMutex);
+    if (s_isRunning.load(std::memory_order_relaxed)) {
+        p_ringBuffer->retire();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(backendState.ringBuffersMutex);
+    std::erase_if(backendState.ringBuffers, [&backendState, p_ringBuffer] (const std::unique_ptr<RingBuffer>& p_registeredRingBuffer) {
+        if (p_registeredRingBuffer.get() != p_ringBuffer) {
+            return false;
+        }
+        backendState.freedDroppedRecordCount += p_ringBuffer->getDroppedRecordCount();
+        return true;
+    });
+}
+
+uint64_t
+AsyncLogger::getDroppedRecordCount() {
+    BackendState& backendState = getBackendState();
+    std::lock_guard<std::mutex> lock(backendState.ringBuffersMutex);
+
+    uint64_t droppedRecordCount = backendState.freedDroppedRecordCount;
+    for (const std::unique_ptr<RingBuffer>& p_ringBuffer : backendState.ringBuffers) {
+        droppedRecordCount += p_ringBuffer->getDroppedRecordCount();
+    }
+    return droppedRecordCount;
+}
+
+void
+AsyncLogger::start(
+    const std::string& filepath
+) {
+    BackendState& backendState = getBackendState();
+    std::lock_guard<std::mutex> lock(backendState.lifecycleMutex);
+    if (s_isRunning.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    backendState.p_outputFile = filepath == "-" ? stdout : std::fopen(filepath.c_str(), "w");
+    if (!backendState.p_outputFile) {
+        LOG_ERROR(GENERAL, "Failed to open {} for async logging", filepath);
+        throw std::runtime_error("Failed to open async log file");
+    }
+
+    backendState.startTimestampTicks = AsyncLogger::getTimestampTicks();
+    backendState.startTime = std::chrono::steady_clock::now();
+    backendState.stopRequested.store(false, std::memory_order_relaxed);
+    backendState.writerThread = std::thread(runWriterThread, std::ref(backendState));
+    s_isRunning.store(true, std::memory_order_release);
+
+    LOG_INFO(GENERAL, "Async logging to {}", filepath == "-" ? "stdout" : filepath);
+}
+
+void
+AsyncLogger::stop() {
+    BackendState& backendState = getBackendState();
+    std::lock_guard<std::mutex> lock(backendState.lifecycleMutex);
+    if (!s_isRunning.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    s_isRunning.store(false, std::memory_order_release);
+    backendState.stopRequested.store(true, std::memory_order_release);
+    backendState.writerThread.join();
+
+    if (backendState.p_outputFile != stdout) {
+        std::fclose(backendState.p_outputFile);
+    }
+    backendState.p_outputFile = nullptr;
+
+    if (backendState.reportedDroppedRecordCount > 0) {
+        LOG_WARNING(GENERAL, "Async logging dropped {} records in total", backendState.reportedDroppedRecordCount);
+    }
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#include <spdlog/fmt/fmt.h>
+
+#include "util/macros.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+
+/**
+ * @brief A logging backend for hot paths. While it is running, a log call only checks its logger's level and copies
+ * a pointer to its call site (logger, level, format string) and its raw arguments into a lock-free ring buffer owned
+ * by the calling thread. A background thread formats the records and writes them out. When a thread's ring buffer is
+ * full the record is dropped and counted instead of blocking the caller.
+ *
+ * Because formatting happens later on another thread, the arguments are copied bytewise: they must be trivially
+ * copyable values (numbers, bools, enums with a formatter), not pointers or strings.
+ *
+ * Use the ASYNC_LOG_* macros with loggers declared through DECLARE_POLE_POSITION_LOGGER. Calls below the logger's
+ * compile-time floor compile to nothing, and when the backend is not running they forward to the regular LOG_* macros.
+ */
+class AsyncLogger {
+public: // classes and enums
+    struct CallSite {
+    public: // member functions
+        bool isEnabled() const { return static_cast<int>(level) >= p_loggerLevel->load(std::memory_order_relaxed); }
+
+    public: // member variables
+        const char* loggerName;
+        util::Logger::Level level;
+        const char* format;
+        const std::atomic<int>* p_loggerLevel;
+    };
+
+    static constexpr std::size_t recordPayloadSize = 40;
+
+    using FormatFunction = std::string (*)(const char* const format, const std::byte* const p_payload);
+
+    struct Record {
+        const CallSite* p_callSite;
+        FormatFunction formatFunction;
+        uint64_t timestampTicks;
+        std::array<std::byte, recordPayloadSize> payload;
+    };
+
+    /**
+     * @brief A single producer, single consumer ring buffer. The owning thread writes, the background thread reads
+     */
+    class RingBuffer {
+    public: // member variables
+        static constexpr std::size_t capacity = 4096;
+        static_assert((capacity & (capacity - 1)) == 0, "Ring buffer capacity must be a power of two");
+
+    public: // member functions
+        RingBuffer() : m_head(0), m_tail(0), m_droppedRecordCount(0), m_isRetired(false), m_records() {}
+
+        Record* beginWrite() {
+            const uint64_t head = m_head.load(std::memory_order_relaxed);
+            if (head - m_tail.load(std::memory_order_acquire) >= capacity) {
+                m_droppedRecordCount.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            return &m_records[head & (capacity - 1)];
+        }
+
+        void commitWrite() {
+            m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        template <typename Function>
+        std::size_t drain(Function&& function) {
+            const uint64_t head = m_head.load(std::memory_order_acquire);
+            uint64_t tail = m_tail.load(std::memory_order_relaxed);
+            const std::size_t drainedRecordCount = head - tail;
+            for (; tail != head; ++tail) {
+                function(m_records[tail & (capacity - 1)]);
+            }
+            m_tail.store(tail, std::memory_order_release);
+            return drainedRecordCount;
+        }
+
+        uint64_t getDroppedRecordCount() const { return m_droppedRecordCount.load(std::memory_order_relaxed); }
+        bool isEmpty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Set by the owning thread as it exits, after its last write, so that the background thread frees
+         * the ring buffer once it has drained it
+         */
+        void retire() { m_isRetired.store(true, std::memory_order_release); }
+        bool isRetired() const { return m_isRetired.load(std::memory_order_acquire); }
+
+    private: // member variables
+        alignas(64) std::atomic<uint64_t> m_head;
+        alignas(64) std::atomic<uint64_t> m_tail;
+        alignas(64) std::atomic<uint64_t> m_droppedRecordCount;
+        std::atomic<bool> m_isRetired;
+        std::array<Record, capacity> m_records;
+    };
+
+    /**
+     * @brief Runs the backend for as long as it is alive
+     */
+    class ScopedSession {
+    public: // member functions
+        explicit ScopedSession(const std::string& filepath) { AsyncLogger::start(filepath); }
+        ScopedSession(const ScopedSession& other) = delete;
+        ScopedSession& operator=(const ScopedSession& other) = delete;
+        ~ScopedSession() { AsyncLogger::stop(); }
+    };
+
+public: // member functions
+    static CallSite createCallSite(const char* const loggerName, const util::Logger::Level level, const char* const format);
+    static void setLevels(const std::vector<std::pair<std::string, util::Logger::Level>>& loggerLevels);
+
+    /**
+     * @brief Start writing records to the given file ( "-" for stdout ) from the background thread
+     */
+    static void start(const std::string& filepath);
+    static void stop();
+    static bool isRunning() { return s_isRunning.load(std::memory_order_relaxed); }
+
+    static uint64_t getDroppedRecordCount();
+
+    template <typename... Args>
+    static void push(const CallSite& callSite, const Args&... args);
+
+    /**
+     * @brief Reading the steady clock costs more than the rest of a log call combined on some machines, so where
+     * we can we stamp records with the cycle counter and let the writer thread convert it
+     */
+    static uint64_t getTimestampTicks() {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+private: // helpers
+    template <typename... Args>
+    static std::string formatRecord(const char* const format, const std::byte* const p_payload);
+
+    /**
+     * @brief Registers the calling thread's ring buffer on its first log call and unregisters it when the thread
+     * exits, so that threads that come and go, like job workers, do not leave their ring buffers behind
+     */
+    class ThreadRingBuffer {
+    public: // member functions
+        ThreadRingBuffer() : mp_ringBuffer(AsyncLogger::registerThreadRingBuffer()) {}
+        ThreadRingBuffer(const ThreadRingBuffer& other) = delete;
+        ThreadRingBuffer& operator=(const ThreadRingBuffer& other) = delete;
+        ~ThreadRingBuffer() { AsyncLogger::unregisterThreadRingBuffer(mp_ringBuffer); }
+
+        RingBuffer& get() { return *mp_ringBuffer; }
+
+    private: // member variables
+        RingBuffer* mp_ringBuffer;
+    };
+
+    static RingBuffer& getThreadRingBuffer() {
+        thread_local ThreadRingBuffer threadRingBuffer;
+        return threadRingBuffer.get();
+    }
+
+    static RingBuffer* registerThreadRingBuffer();
+    static void unregisterThreadRingBuffer(RingBuffer* const p_ringBuffer);
+
+private: // static variables
+    static std::atomic<bool> s_isRunning;
+};
+
+template <typename... Args>
+void
+AsyncLogger::push(
+    const CallSite& callSite,
+    const Args&... args
+) {
+    static_assert(((std::is_trivially_copyable_v<Args> && !std::is_pointer_v<Args> && !std::is_array_v<Args>) && ...), "Async log arguments must be trivially copyable values");
+    static_assert((sizeof(Args) + ... + 0) <= recordPayloadSize, "Async log arguments do not fit in a record");
+
+    RingBuffer& ringBuffer = AsyncLogger::getThreadRingBuffer();
+    Record* const p_record = ringBuffer.beginWrite();
+    if (!p_record) {
+        return;
+    }
+
+    p_record->p_callSite = &callSite;
+    p_record->formatFunction = &AsyncLogger::formatRecord<Args...>;
+    p_record->timestampTicks = AsyncLogger::getTimestampTicks();
+
+    UNUSED std::byte* p_destination = p_record->payload.data();
+    ((std::memcpy(p_destination, &args, sizeof(Args)), p_destination += sizeof(Args)), ...);
+
+    ringBuffer.commitWrite();
+}
+
+template <typename... Args>
+std::string
+AsyncLogger::formatRecord(
+    const char* const format,
+    const std::byte* const p_payload
+) {
+    std::tuple<Args...> arguments;
+
+    UNUSED const std::byte* p_source = p_payload;
+    std::apply(
+        [&p_source] (Args&... unpackedArguments) {
+            ((std::memcpy(&unpackedArguments, p_source, sizeof(Args)), p_source += sizeof(Args)), ...);
+        },
+        arguments
+    );
+
+    return std::apply(
+        [format] (const Args&... unpackedArguments) {
+            return fmt::format(fmt::runtime(format), unpackedArguments...);
+        },
+        arguments
+    );
+}
+
+#define ASYNC_LOG_IMPL(LOGGER, LEVEL, SYNC_LOG_MACRO, format, ...)                                                                         \
+    if constexpr (static_cast<int>(util::Logger::Level::LEVEL) >= static_cast<int>(LOGGER##_LOG_LEVEL_FLOOR)) {                            \
+        static const AsyncLogger::CallSite s_asyncLogCallSite = AsyncLogger::createCallSite(#LOGGER, util::Logger::Level::LEVEL, format);  \
+        if (AsyncLogger::isRunning()) {                                                                                                    \
+            if (s_asyncLogCallSite.isEnabled()) {                                                                                          \
+                AsyncLogger::push(s_asyncLogCallSite __VA_OPT__(,) __VA_ARGS__);                                                           \
+            }                                                                                                                              \
+        } else {                                                                                                                           \
+            SYNC_LOG_MACRO(LOGGER, format __VA_OPT__(,) __VA_ARGS__);                                                                      \
+        }                                                                                                                                  \
+    }                                                                                                                                      \
+    REQUIRE_SEMICOLON
+
+#define ASYNC_LOG_TRACE(LOGGER, format, ...) ASYNC_LOG_IMPL(LOGGER, trace, LOG_TRACE, format __VA_OPT__(,) __VA_ARGS__)
+#define ASYNC_LOG_DEBUG(LOGGER, format, ...) ASYNC_LOG_IMPL(LOGGER, debug, LOG_DEBUG, format __VA_OPT__(,) __VA_ARGS__)
+#define ASYNC_LOG_INFO(LOGGER, format, ...) ASYNC_LOG_IMPL(LOGGER, info, LOG_INFO, format __VA_OPT__(,) __VA_ARGS__)
+#define ASYNC_LOG_WARNING(LOGGER, format, ...) ASYNC_LOG_IMPL(LOGGER, warning, LOG_WARNING, format __VA_OPT__(,) __VA_ARGS__)
+#define ASYNC_LOG_ERROR(LOGGER, format, ...) ASYNC_LOG_IMPL(LOGGER, error, LOG_ERROR, format __VA_OPT__(,) __VA_ARGS__)
@@ -1,31 +1,432 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <memory>
 #include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <reactphysics3d/reactphysics3d.h>
 
 #include "util/logger/Logger.hpp"
 
 #include "quartz/application/Application.hpp"
+#include "quartz/scene/doodad/Doodad.hpp"
 
 #include "pole_position/Loggers.hpp"
 #include "pole_position/Boilerplate.hpp"
+#include "pole_position/asset_loading/AssetCache.hpp"
+#include "pole_position/asset_loading/AssetPreloader.hpp"
+#include "pole_position/command_line/CommandLineOptions.hpp"
+#include "pole_position/culling/CullingSystem.hpp"
+#include "pole_position/culling/VisibilityCuller.hpp"
+#include "pole_position/ghost/GhostPlayback.hpp"
+#include "pole_position/ghost/TrajectoryFile.hpp"
+#include "pole_position/ghost/TrajectoryRecorder.hpp"
+#include "pole_position/headless/HeadlessSimulation.hpp"
+#include "pole_position/headless/SceneStreamer.hpp"
+#include "pole_position/headless/SimulationThread.hpp"
+#include "pole_position/headless/SnapshotPresenter.hpp"
+#include "pole_position/input/InputRecorder.hpp"
+#include "pole_position/input/InputReplayer.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/jobs/JobSystem.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/scene/BehaviourRegistry.hpp"
+#include "pole_position/scene/SceneFile.hpp"
 #include "pole_position/scene/SceneParameters.hpp"
+#include "pole_position/snapshot/WorldSnapshot.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+#include "pole_position/terrain/TerrainPager.hpp"
+#include "pole_position/terrain/TerrainSystem.hpp"
 #include "pole_position/third_person_controller/ThirdPersonController.hpp"
 
-int main() {
+/**
+ * @brief Ticks the current scene up to the transition tick, then keeps ticking it while the next scene streams in
+ * and swaps the next scene in within one tick, then ticks the next scene for the rest of the run. Without a
+ * renderer every tick is a frame, so the ticks from the start of streaming up to and including the swap are the
+ * frames the transition cost. They are compared against the ticks before it
+ */
+void
+runSceneTransition(
+    const CommandLineOptions& options,
+    std::unique_ptr<HeadlessSimulation>& p_simulation,
+    const BehaviourRegistry& behaviourRegistry,
+    ThirdPersonController& playerController,
+    JobSystem* const p_jobSystem,
+    InputRecorder* const p_inputRecorder,
+    InputReplayer* const p_inputReplayer
+) {
+    using Clock = std::chrono::steady_clock;
+
+    const uint64_t ticksBeforeTransition = options.o_tickCount ? std::min(*options.o_tickCount, options.transitionTick) : options.transitionTick;
+    const HeadlessSimulation::Statistics statisticsBeforeTransition = p_simulation->run(ticksBeforeTransition);
+    uint64_t tickCount = statisticsBeforeTransition.tickCount;
+
+    AssetPreloader assetPreloader(2);
+    SceneStreamer sceneStreamer(behaviourRegistry, &assetPreloader);
+    sceneStreamer.begin(options.nextSceneFilepath, p_simulation->getTicksPerSecond());
+
+    const Clock::time_point transitionStartTime = Clock::now();
+    Clock::time_point lastProgressTime = transitionStartTime;
+    uint64_t transitionFrameCount = 0;
+    double totalFrameMicroseconds = 0.0;
+    double maxFrameMicroseconds = 0.0;
+    double swapFrameMicroseconds = 0.0;
+    bool isSwapped = false;
+
+    while (!isSwapped) {
+        if (HeadlessSimulation::isStopRequested() || (options.o_tickCount && tickCount >= *options.o_tickCount)) {
+            sceneStreamer.cancel();
+            break;
+        }
+
+        const SceneStreamer::Progress progress = sceneStreamer.getProgress();
+        if (progress.stage == SceneStreamer::Stage::Failed || progress.stage == SceneStreamer::Stage::Cancelled) {
+            break;
+        }
+
+        const std::optional<InputState> o_inputState = p_simulation->readTickInput();
+        if (!o_inputState) {
+            sceneStreamer.cancel();
+            break;
+        }
+
+        const Clock::time_point frameStartTime = Clock::now();
+
+        // Everything expensive about the next scene was done in the background, what is left is hooking it up
+        std::optional<SceneStreamer::StreamedScene> o_streamedScene = sceneStreamer.take();
+        if (o_streamedScene) {
+            std::unique_ptr<HeadlessSimulation>& p_nextSimulation = o_streamedScene->p_simulation;
+            p_nextSimulation->setJobSystem(p_jobSystem);
+            if (o_streamedScene->o_playerDoodadIndex) {
+                p_nextSimulation->attachPlayerController(playerController, *o_streamedScene->o_playerDoodadIndex);
+            }
+            p_nextSimulation->setInputRecorder(p_inputRecorder);
+            p_nextSimulation->setInputReplayer(p_inputReplayer);
+
+            sceneStreamer.retire(std::move(p_simulation));
+            p_simulation = std::move(p_nextSimulation);
+            isSwapped = true;
+        }
+
+        p_simulation->tick(*o_inputState);
+        const Clock::time_point frameEndTime = Clock::now();
+        PROFILE_FRAME_END();
+
+        const double frameMicroseconds = std::chrono::duration<double, std::micro>(frameEndTime - frameStartTime).count();
+        totalFrameMicroseconds += frameMicroseconds;
+        maxFrameMicroseconds = std::max(maxFrameMicroseconds, frameMicroseconds);
+        if (isSwapped) {
+            swapFrameMicroseconds = frameMicroseconds;
+        }
+        ++transitionFrameCount;
+        ++tickCount;
+
+        if (std::chrono::duration<double>(frameEndTime - lastProgressTime).count() >= 0.5) {
+            LOG_INFO(GENERAL, "Streaming {}: {} ( {:.0f}% ), {} of {} assets, {} of {} doodads", options.nextSceneFilepath, SceneStreamer::getStageName(progress.stage), progress.fraction * 100.0, progress.loadedAssetCount, progress.assetCount, progress.createdDoodadCount, progress.doodadCount);
+            lastProgressTime = frameEndTime;
+        }
+    }
+
+    if (!isSwapped) {
+        LOG_WARNING(GENERAL, "Did not switch to {}, streaming it ended {}", options.nextSceneFilepath, SceneStreamer::getStageName(sceneStreamer.getProgress().stage));
+    } else {
+        LOG_INFO(GENERAL, "Switched to scene {} after {:.2f} ms of streaming over {} frames", p_simulation->getSceneName(), std::chrono::duration<double, std::milli>(Clock::now() - transitionStartTime).count(), transitionFrameCount);
+        LOG_INFO(GENERAL, "  mean frame {:.2f} us, worst frame {:.2f} us, swap frame {:.2f} us ( worst frame before the transition {:.2f} us )", totalFrameMicroseconds / transitionFrameCount, maxFrameMicroseconds, swapFrameMicroseconds, statisticsBeforeTransition.maxTickMicroseconds);
+    }
+
+    if (options.o_tickCount && tickCount >= *options.o_tickCount) {
+        return;
+    }
+    p_simulation->run(options.o_tickCount ? std::optional<uint64_t>(*options.o_tickCount - tickCount) : std::nullopt);
+}
+
+int
+runHeadless(
+    const CommandLineOptions& options,
+    const quartz::scene::Scene::Parameters& sceneParameters,
+    const BehaviourRegistry& behaviourRegistry,
+    ThirdPersonController& playerController,
+    const std::optional<std::size_t> o_playerDoodadIndex,
+    const std::vector<std::size_t>& ghostDoodadIndices,
+    InputRecorder* const p_inputRecorder,
+    InputReplayer* const p_inputReplayer
+) {
+    std::signal(SIGINT, [] (UNUSED int signal) { HeadlessSimulation::requestStop(); });
+
+    // A replay is only deterministic at the rate it was recorded at
+    double ticksPerSecond = options.ticksPerSecond;
+    if (p_inputReplayer && p_inputReplayer->getTicksPerSecond() != ticksPerSecond) {
+        LOG_INFO(GENERAL, "Using the replay's tick rate of {} instead of {}", p_inputReplayer->getTicksPerSecond(), ticksPerSecond);
+        ticksPerSecond = p_inputReplayer->getTicksPerSecond();
+    }
+
+    try {
+        std::optional<JobSystem> o_jobSystem;
+        if (options.jobWorkerCount > 0) {
+            o_jobSystem.emplace(options.jobWorkerCount);
+        }
+
+        // Outlives the simulation, whose colliders read their heights out of it
+        std::optional<TerrainFile> o_terrainFile;
+        if (!options.terrainFilepath.empty()) {
+            o_terrainFile.emplace(options.terrainFilepath);
+        }
+
+        // Both outlive the simulation too, the ghosts play straight out of the files' mappings and the recorder
+        // only writes its block table once the simulation is done with it
+        std::vector<std::unique_ptr<TrajectoryFile>> trajectoryFiles;
+        trajectoryFiles.reserve(options.ghostTrajectoryFilepaths.size());
+        for (const std::string& ghostTrajectoryFilepath : options.ghostTrajectoryFilepaths) {
+            trajectoryFiles.push_back(std::make_unique<TrajectoryFile>(ghostTrajectoryFilepath));
+        }
+        std::optional<TrajectoryRecorder> o_trajectoryRecorder;
+        if (!options.trajectoryRecordingFilepath.empty()) {
+            o_trajectoryRecorder.emplace(options.trajectoryRecordingFilepath, ticksPerSecond);
+        }
+
+        std::unique_ptr<HeadlessSimulation> p_simulation = std::make_unique<HeadlessSimulation>(sceneParameters, ticksPerSecond);
+        p_simulation->setJobSystem(o_jobSystem ? &*o_jobSystem : nullptr);
+
+        if (o_playerDoodadIndex) {
+            p_simulation->attachPlayerController(playerController, *o_playerDoodadIndex);
+        } else {
+            LOG_WARNING(GENERAL, "The scene has no doodad with the third_person_controller behaviour, simulating without a player");
+        }
+        p_simulation->setInputRecorder(p_inputRecorder);
+        p_simulation->setInputReplayer(p_inputReplayer);
+
+        if (o_trajectoryRecorder) {
+            if (o_playerDoodadIndex) {
+                p_simulation->addTrajectoryRecorder(*o_trajectoryRecorder, *o_playerDoodadIndex);
+            } else {
+                LOG_WARNING(GENERAL, "The scene has no player, not recording a trajectory to {}", options.trajectoryRecordingFilepath);
+            }
+        }
+
+        // Each trajectory's ghosts start a second apart and loop, so they spread out along it instead of stacking.
+        // Added before the terrain and culling so that both see them from the first tick
+        for (std::size_t i = 0; i < ghostDoodadIndices.size(); ++i) {
+            const std::size_t fileIndex = i / options.ghostCount;
+            const std::size_t ghostIndexInFile = i % options.ghostCount;
+            const GhostPlayback::GhostParameters ghostParameters {
+                static_cast<double>(ghostIndexInFile),
+                true
+            };
+            p_simulation->addGhost(ghostDoodadIndices[i], *trajectoryFiles[fileIndex], ghostParameters);
+        }
+
+        // Like the culling below, paged for the camera the player's controller just moved
+        TerrainSystem* p_terrainSystem = nullptr;
+        if (o_terrainFile) {
+            p_simulation->setTerrain(*o_terrainFile);
+
+            const TerrainPager::Parameters pagerParameters {
+                options.terrainLoadRadius,
+                {150.0, 400.0, 800.0}
+            };
+            std::unique_ptr<TerrainSystem> p_ownedTerrainSystem = std::make_unique<TerrainSystem>(playerController, *o_terrainFile, pagerParameters);
+            p_terrainSystem = p_ownedTerrainSystem.get();
+            p_simulation->addSystem(std::move(p_ownedTerrainSystem), {});
+        }
+
+        // Added after the player's controller, so it culls for the camera the controller just moved. The frustum is
+        // the one of the 800x600 window the application opens
+        CullingSystem* p_cullingSystem = nullptr;
+        if (options.culling) {
+            const VisibilityCuller::Parameters cullerParameters {
+                options.maxDrawDistance,
+                options.maxDrawDistancesByModel,
+                800.0 / 600.0,
+                0.1,
+                1000.0
+            };
+            std::unique_ptr<CullingSystem> p_ownedCullingSystem = std::make_unique<CullingSystem>(playerController, sceneParameters, p_simulation->getDoodadStore(), cullerParameters, options.cullingFrameLogFilepath);
+            p_cullingSystem = p_ownedCullingSystem.get();
+            p_simulation->addSystem(std::move(p_ownedCullingSystem), {});
+        }
+
+        // Restored once everything is attached, so the player's controller and the terrain colliders pick it up too
+        if (!options.snapshotLoadFilepath.empty()) {
+            p_simulation->restoreSnapshot(WorldSnapshot::readFromFile(options.snapshotLoadFilepath));
+        }
+
+        if (options.simulationThread) {
+            std::mutex systemsMutex;
+            p_simulation->setSystemsMutex(&systemsMutex);
+
+            SnapshotPresenter snapshotPresenter(*p_simulation, options.framesPerSecond);
+            SimulationThread simulationThread(*p_simulation, options.o_tickCount, 5);
+            snapshotPresenter.run(simulationThread);
+        } else if (!options.nextSceneFilepath.empty()) {
+            runSceneTransition(options, p_simulation, behaviourRegistry, playerController, o_jobSystem ? &*o_jobSystem : nullptr, p_inputRecorder, p_inputReplayer);
+        } else {
+            p_simulation->run(options.o_tickCount);
+        }
+
+        if (!options.snapshotSaveFilepath.empty()) {
+            WorldSnapshot snapshot;
+            p_simulation->captureSnapshot(snapshot);
+            snapshot.writeToFile(options.snapshotSaveFilepath);
+        }
+
+        if (p_cullingSystem) {
+            p_cullingSystem->logStatistics();
+        }
+        if (p_terrainSystem) {
+            p_terrainSystem->getTerrainPager().logStatistics();
+        }
+    } catch (const std::exception& e) {
+        LOG_CRITICAL(GENERAL, "Caught exception");
+        LOG_CRITICAL(GENERAL, "{}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    LOG_TRACE(GENERAL, "Terminating headless simulation");
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
     DO_BOILERPLATE(false);
 
+    const std::optional<CommandLineOptions> o_options = CommandLineOptions::parse(argc, argv);
+    if (!o_options) {
+        return EXIT_FAILURE;
+    }
+
+    std::optional<MemoryTracker::ScopedSession> o_memoryTrackerSession;
+    std::optional<AsyncLogger::ScopedSession> o_asyncLoggerSession;
+    std::optional<Profiler::ScopedSession> o_profilerSession;
+    std::optional<InputRecorder> o_inputRecorder;
+    std::optional<InputReplayer> o_inputReplayer;
+    try {
+        for (const auto& [tag, budgetBytes] : o_options->memoryBudgetBytesByTag) {
+            MemoryTracker::setBudget(tag, budgetBytes);
+        }
+        if (!o_options->memoryReportFilepath.empty() || !o_options->memoryBudgetBytesByTag.empty()) {
+            o_memoryTrackerSession.emplace(o_options->memoryReportFilepath, o_options->memoryReportIntervalSeconds);
+        }
+        if (!o_options->asyncLogFilepath.empty()) {
+            o_asyncLoggerSession.emplace(o_options->asyncLogFilepath);
+        }
+        if (!o_options->profileTraceFilepath.empty()) {
+#ifndef POLE_POSITION_ENABLE_PROFILING
+            LOG_WARNING(GENERAL, "Built without POLE_POSITION_ENABLE_PROFILING, so the trace will be empty");
+#endif
+            o_profilerSession.emplace(o_options->profileTraceFilepath);
+        }
+        if (!o_options->inputReplayFilepath.empty()) {
+            o_inputReplayer.emplace(o_options->inputReplayFilepath);
+        }
+        // Headless runs tick at the replay's rate when there is one, see runHeadless
+        if (!o_options->inputRecordingFilepath.empty()) {
+            o_inputRecorder.emplace(o_options->inputRecordingFilepath, o_inputReplayer ? o_inputReplayer->getTicksPerSecond() : o_options->ticksPerSecond);
+        }
+    } catch (const std::exception& e) {
+        LOG_CRITICAL(GENERAL, "{}", e.what());
+        return EXIT_FAILURE;
+    }
+    InputRecorder* const p_inputRecorder = o_inputRecorder ? &*o_inputRecorder : nullptr;
+    InputReplayer* const p_inputReplayer = o_inputReplayer ? &*o_inputReplayer : nullptr;
+
+    ThirdPersonController playerController;
+    BehaviourRegistry behaviourRegistry;
+    registerDemoBehaviours(behaviourRegistry, playerController);
+
+    // createDemoLevelSceneParameters places the player's doodad first
+    std::optional<quartz::scene::Scene::Parameters> o_sceneParameters;
+    std::optional<std::size_t> o_playerDoodadIndex = 0;
+    std::vector<std::size_t> ghostDoodadIndices;
+    try {
+        const MemoryTracker::ScopedTag scopedTag(MemoryTag::Scene);
+
+        if (!o_options->generatedTerrainFilepath.empty()) {
+            TerrainFile::generate(o_options->generatedTerrainFilepath, {64, 64, 65, 4, 128.0, 60.0, 1});
+            return EXIT_SUCCESS;
+        }
+
+        if (!o_options->compiledSceneFilepath.empty()) {
+            SceneFile::compile(o_options->sceneFilepath, o_options->compiledSceneFilepath);
+            return EXIT_SUCCESS;
+        }
+
+        if (!o_options->sceneFilepath.empty()) {
+            SceneFile::LoadedScene loadedScene = SceneFile::load(o_options->sceneFilepath, behaviourRegistry);
+            o_playerDoodadIndex = loadedScene.findFirstDoodadWithBehaviour("third_person_controller");
+            o_sceneParameters.emplace(std::move(loadedScene.sceneParameters));
+        } else {
+            o_sceneParameters.emplace(createDemoLevelSceneParameters(playerController));
+        }
+
+        // The ghosts go after the scene's own doodads, so that no index a scene file refers to moves
+        const std::size_t ghostCount = o_options->ghostTrajectoryFilepaths.size() * o_options->ghostCount;
+        const math::Vec3 ghostHalfExtents_m = createRaceCarVehicleParameters().chassisHalfExtents_m;
+        ghostDoodadIndices.reserve(ghostCount);
+        o_sceneParameters->doodadParameters.reserve(o_sceneParameters->doodadParameters.size() + ghostCount);
+        for (std::size_t i = 0; i < ghostCount; ++i) {
+            ghostDoodadIndices.push_back(o_sceneParameters->doodadParameters.size());
+            o_sceneParameters->doodadParameters.push_back(createGhostDoodadParameters(ghostHalfExtents_m));
+        }
+    } catch (const std::exception& e) {
+        LOG_CRITICAL(GENERAL, "{}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (o_options->headless) {
+        return runHeadless(*o_options, *o_sceneParameters, behaviourRegistry, playerController, o_playerDoodadIndex, ghostDoodadIndices, p_inputRecorder, p_inputReplayer);
+    }
+
+    playerController.setInputRecorder(p_inputRecorder);
+    playerController.setInputReplayer(p_inputReplayer);
+
+    // Quartz gives us no hook at the end of a frame, but it updates every doodad exactly once per frame, so the
+    // first doodad's update marks the frame boundary however many doodads the player's controller drives
+    if (o_profilerSession && !o_sceneParameters->doodadParameters.empty()) {
+        quartz::scene::Doodad::UpdateCallback& frameUpdateCallback = o_sceneParameters->doodadParameters.front().updateCallback;
+        frameUpdateCallback = [doodadUpdateCallback = std::move(frameUpdateCallback)] (quartz::scene::Doodad::UpdateCallbackParameters parameters) {
+            PROFILE_FRAME_END();
+            if (doodadUpdateCallback) {
+                doodadUpdateCallback(parameters);
+            }
+        };
+    }
+
+    std::vector<quartz::scene::Scene::Parameters> quartzSceneParameters;
+    quartzSceneParameters.push_back(std::move(*o_sceneParameters));
+
+    std::optional<AssetCache> o_assetCache;
+    if (!o_options->assetCacheDirectory.empty()) {
+        try {
+            o_assetCache.emplace(o_options->assetCacheDirectory);
+        } catch (const std::exception& e) {
+            LOG_CRITICAL(GENERAL, "{}", e.what());
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Get the assets off of the disk while the window and device are being created
+    AssetPreloader assetPreloader(std::clamp(std::thread::hardware_concurrency(), 2u, 8u));
+    assetPreloader.setAssetCache(o_assetCache ? &*o_assetCache : nullptr);
+    for (const quartz::scene::Scene::Parameters& sceneParameters : quartzSceneParameters) {
+        assetPreloader.enqueueScene(sceneParameters);
+    }
+
+    DO_WINDOWING_BOILERPLATE();
+
 #ifdef QUARTZ_RELEASE
     const bool validationLayersEnabled = false;
 #else
     const bool validationLayersEnabled = true;
 #endif
 
-    ThirdPersonController playerController;
-
-    std::vector<quartz::scene::Scene::Parameters> quartzSceneParameters {
-        createDemoLevelSceneParameters(playerController)
-    };
-
     quartz::Application application(
         APPLICATION_NAME,
         APPLICATION_MAJOR_VERSION,
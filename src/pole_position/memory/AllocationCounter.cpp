@@ -0,0 +1,135 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "pole_position/memory/AllocationCounter.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+
+std::atomic<uint64_t> AllocationCounter::s_allocationCount = 0;
+
+void*
+PhysicsMemoryAllocator::allocate(
+    size_t size
+) {
+    AllocationCounter::recordAllocation();
+    MemoryTracker::recordAllocation(MemoryTag::Physics, size);
+    return std::malloc(size);
+}
+
+void
+PhysicsMemoryAllocator::release(
+    void* pointer,
+    size_t size
+) {
+    MemoryTracker::recordRelease(MemoryTag::Physics, size);
+    std::free(pointer);
+}
+
+#ifdef POLE_POSITION_ENABLE_ALLOCATION_COUNTING
+
+/**
+ * @brief The replacements of the global operator new and delete. Every form has to be replaced, so that nothing
+ * frees memory through a different allocator than the one that allocated it.
+ *
+ * Each allocation is preceded by an AllocationHeader, so that delete knows how many bytes to give back to which
+ * tag, and where the block it has to free starts
+ */
+namespace {
+
+struct AllocationHeader {
+    uint64_t size;
+    uint32_t offset; // from the start of the block to the memory handed out
+    MemoryTag tag;
+};
+
+/**
+ * @brief Keeps the memory handed out aligned to at least the default alignment
+ */
+constexpr std::size_t headerSize = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+static_assert(sizeof(AllocationHeader) <= headerSize);
+
+void*
+allocateCounted(
+    const std::size_t size,
+    const std::size_t alignment
+) {
+    // The header goes right before the memory handed out, which for over aligned allocations means a whole
+    // alignment's worth of space in front of it
+    const std::size_t offset = alignment <= headerSize ? headerSize : alignment;
+
+    void* p_block = nullptr;
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        p_block = std::malloc(offset + size);
+    } else {
+        // aligned_alloc wants the size to be a multiple of the alignment
+        p_block = std::aligned_alloc(alignment, offset + (size + alignment - 1) / alignment * alignment);
+    }
+    if (!p_block) {
+        return nullptr;
+    }
+
+    const MemoryTag tag = MemoryTracker::getCurrentTag();
+    AllocationCounter::recordAllocation();
+    MemoryTracker::recordAllocation(tag, size);
+
+    std::byte* const p_memory = static_cast<std::byte*>(p_block) + offset;
+    new (p_memory - sizeof(AllocationHeader)) AllocationHeader{size, static_cast<uint32_t>(offset), tag};
+
+    return p_memory;
+}
+
+void*
+allocateCountedOrThrow(
+    const std::size_t size,
+    const std::size_t alignment
+) {
+    void* const p_memory = allocateCounted(size, alignment);
+    if (!p_memory) {
+        throw std::bad_alloc();
+    }
+
+    return p_memory;
+}
+
+void
+releaseCounted(
+    void* const p_memory
+) {
+    if (!p_memory) {
+        return;
+    }
+
+    const AllocationHeader* const p_header = reinterpret_cast<const AllocationHeader*>(static_cast<std::byte*>(p_memory) - sizeof(AllocationHeader));
+    MemoryTracker::recordRelease(p_header->tag, p_header->size);
+    std::free(static_cast<std::byte*>(p_memory) - p_header->offset);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocateCountedOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size) { return allocateCountedOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateCountedOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateCountedOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateCounted(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateCounted(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateCounted(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateCounted(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* p_memory) noexcept { releaseCounted(p_memory); }
+void operator delete[](void* p_memory) noexcept { releaseCounted(p_memory); }
+void operator delete(void* p_memory, std::size_t) noexcept { releaseCounted(p_memory); }
+void operator delete[](void* p_memory, std::size_t) noexcept { releaseCounted(p_memory); }
+void operator delete(void* p_memory, std::align_val_t) noexcept { releaseCounted(p_memory); }
+void operator delete[](void* p_memory, std::align_val_t) noexcept { releaseCounted(p_memory); }
+void operator delete(void* p_memory, std::size_t, std::align_val_t) noexcept { releaseCounted(p_memory); }
+void operator delete[](void* p_memory, std::size_t, std::align_val_t) noexcept { releaseCounted(p_memory); }
+void operator delete(void* p_memory, const std::nothrow_t&) noexcept { releaseCounted(p_memory); }
+void operator delete[](void* p_memory, const std::nothrow_t&) noexcept { releaseCounted(p_memory); }
+void operator delete(void* p_memory, std::align_val_t, const std::nothrow_t&) noexcept { releaseCounted(p_memory); }
+void operator delete[](void* p_memory, std::align_val_t, const std::nothrow_t&) noexcept { releaseCounted(p_memory); }
+
+#endif
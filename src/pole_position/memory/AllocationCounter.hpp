@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+/**
+ * @brief Counts heap allocations made by any thread, so that hot paths can be checked for allocating. Built with
+ * POLE_POSITION_ENABLE_ALLOCATION_COUNTING the global operator new is replaced with one that counts, and the
+ * physics engine's allocations are counted through the PhysicsMemoryAllocator it is given. Without it nothing is
+ * replaced and the count stays at 0. Both also feed the MemoryTracker with the bytes of each allocation.
+ *
+ * Counting costs a relaxed atomic increment per allocation. Measure a stretch of code by taking the difference of
+ * two counts around it, which includes whatever other threads allocated in the meantime
+ */
+class AllocationCounter {
+public: // member functions
+#ifdef POLE_POSITION_ENABLE_ALLOCATION_COUNTING
+    static constexpr bool isEnabled() { return true; }
+#else
+    static constexpr bool isEnabled() { return false; }
+#endif
+
+    static uint64_t getAllocationCount() { return s_allocationCount.load(std::memory_order_relaxed); }
+
+    static void recordAllocation() {
+        if constexpr (AllocationCounter::isEnabled()) {
+            s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private: // static variables
+    static std::atomic<uint64_t> s_allocationCount;
+};
+
+/**
+ * @brief The physics engine's base allocator. reactphysics3d already keeps its bodies, colliders and per step
+ * data in its own pools and frame allocator, and only goes to the base allocator to grow them, so this is what
+ * tells us whether the physics step allocates once the pools are warm
+ */
+class PhysicsMemoryAllocator : public reactphysics3d::MemoryAllocator {
+public: // member functions
+    void* allocate(size_t size) override;
+    void release(void* pointer, size_t size) override;
+};
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "util/macros.hpp"
+
+#include "pole_position/memory/FrameArena.hpp"
+
+namespace {
+
+std::byte*
+alignUp(
+    std::byte* const p_address,
+    const std::size_t alignment
+) {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(p_address);
+    return p_address + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+}
+
+} // namespace
+
+FrameArena::FrameArena(
+    const std::size_t capacity
+) :
+    mp_block(capacity > 0 ? std::make_unique_for_overwrite<std::byte[]>(capacity) : nullptr),
+    m_capacity(capacity),
+    m_usedBytes(0),
+    m_overflowBlocks(),
+    m_overflowBytes(0),
+    m_peakUsedBytes(0)
+{}
+
+void*
+FrameArena::allocate(
+    const std::size_t size,
+    const std::size_t alignment
+) {
+    QUARTZ_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Frame arena alignment must be a power of two");
+
+    if (mp_block) {
+        std::byte* const p_allocation = alignUp(mp_block.get() + m_usedBytes, alignment);
+        const std::size_t usedBytes = static_cast<std::size_t>(p_allocation - mp_block.get()) + size;
+        if (usedBytes <= m_capacity) {
+            m_usedBytes = usedBytes;
+            m_peakUsedBytes = std::max(m_peakUsedBytes, this->getUsedBytes());
+            return p_allocation;
+        }
+    }
+
+    // Room for the worst case padding, so that the next reset makes the arena big enough whatever the alignment
+    const std::size_t overflowBlockSize = size + alignment;
+    m_overflowBlocks.push_back(std::make_unique_for_overwrite<std::byte[]>(overflowBlockSize));
+    m_overflowBytes += overflowBlockSize;
+    m_peakUsedBytes = std::max(m_peakUsedBytes, this->getUsedBytes());
+
+    return alignUp(m_overflowBlocks.back().get(), alignment);
+}
+
+void
+FrameArena::reset() {
+    if (!m_overflowBlocks.empty()) {
+        m_capacity += m_overflowBytes;
+        mp_block = std::make_unique_for_overwrite<std::byte[]>(m_capacity);
+        m_overflowBlocks.clear();
+        m_overflowBytes = 0;
+    }
+
+    m_usedBytes = 0;
+}
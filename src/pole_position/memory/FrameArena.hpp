@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief A bump allocator for temporaries that only live until the end of a tick. Allocating is a pointer bump
+ * and freeing is a no-op, everything is released at once by reset.
+ *
+ * When a tick needs more than the arena holds, the rest comes from overflow blocks on the heap, and the next reset
+ * grows the arena to fit all of it. After the first few ticks of a steady workload the arena is big enough and
+ * never touches the heap again.
+ *
+ * Not thread safe, each thread that needs temporaries needs its own arena.
+ */
+class FrameArena {
+public: // member functions
+    explicit FrameArena(const std::size_t capacity = 0);
+    FrameArena(FrameArena&& other) = default;
+    FrameArena& operator=(FrameArena&& other) = default;
+
+    /**
+     * @brief Never returns null, alignment must be a power of two
+     */
+    void* allocate(const std::size_t size, const std::size_t alignment);
+
+    /**
+     * @brief Frees everything allocated since the last reset
+     */
+    void reset();
+
+    std::size_t getCapacity() const { return m_capacity; }
+    std::size_t getUsedBytes() const { return m_usedBytes + m_overflowBytes; }
+    std::size_t getPeakUsedBytes() const { return m_peakUsedBytes; }
+
+private: // member variables
+    std::unique_ptr<std::byte[]> mp_block;
+    std::size_t m_capacity;
+    std::size_t m_usedBytes;
+
+    std::vector<std::unique_ptr<std::byte[]>> m_overflowBlocks;
+    std::size_t m_overflowBytes;
+
+    std::size_t m_peakUsedBytes;
+};
+
+/**
+ * @brief Lets standard containers take their memory from a FrameArena. Without an arena it falls back to the
+ * heap, so code can take an optional arena and use the same container type either way.
+ *
+ * The arena never gets memory back before it is reset, so containers that grow leave their old buffers behind
+ * until then. Reserve up front where the size is known
+ */
+template<typename T>
+class FrameArenaAllocator {
+public: // classes and enums
+    using value_type = T;
+
+public: // member functions
+    FrameArenaAllocator(FrameArena* const p_frameArena) : mp_frameArena(p_frameArena) {}
+    template<typename U>
+    FrameArenaAllocator(const FrameArenaAllocator<U>& other) : mp_frameArena(other.getFrameArena()) {}
+
+    T* allocate(const std::size_t count) {
+        return mp_frameArena ? static_cast<T*>(mp_frameArena->allocate(count * sizeof(T), alignof(T))) : std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* const p_values, const std::size_t count) {
+        if (!mp_frameArena) {
+            std::allocator<T>().deallocate(p_values, count);
+        }
+    }
+
+    FrameArena* getFrameArena() const { return mp_frameArena; }
+
+    template<typename U>
+    bool operator==(const FrameArenaAllocator<U>& other) const { return mp_frameArena == other.getFrameArena(); }
+
+private: // member variables
+    FrameArena* mp_frameArena;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "util/macros.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+
+namespace {
+
+/**
+ * @brief How often the session wakes up to check the budgets and whether a report is due
+ */
+constexpr std::chrono::milliseconds pollInterval(250);
+
+struct AssetCounters {
+    uint64_t currentBytes;
+    uint64_t peakBytes;
+};
+
+/**
+ * @brief Everything the session's thread and the asset accounting share
+ */
+struct SessionState {
+    std::mutex assetsMutex;
+    std::unordered_map<std::string, AssetCounters> assets;
+
+    std::mutex lifecycleMutex;
+    std::thread reporterThread;
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool stopRequested = false;
+    bool isRunning = false;
+
+    std::FILE* p_reportFile = nullptr;
+    std::chrono::duration<double> reportInterval;
+    std::chrono::steady_clock::time_point startTime;
+    std::array<bool, memoryTagCount> isOverBudget {};
+};
+
+SessionState&
+getSessionState() {
+    static SessionState sessionState;
+    return sessionState;
+}
+
+void
+raiseToAtLeast(
+    std::atomic<uint64_t>& value,
+    const uint64_t minimum
+) {
+    uint64_t current = value.load(std::memory_order_relaxed);
+    while (current < minimum && !value.compare_exchange_weak(current, minimum, std::memory_order_relaxed)) {}
+}
+
+void
+writeReport(
+    SessionState& sessionState,
+    const char* const reason
+) {
+    if (!sessionState.p_reportFile) {
+        return;
+    }
+
+    const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - sessionState.startTime).count();
+
+    std::string report = fmt::format("memory report at {:.3f} s ( {} )\n", elapsedSeconds, reason);
+    report += fmt::format("  {:<10} {:>16} {:>16} {:>14} {:>16}\n", "tag", "current bytes", "peak bytes", "allocations", "budget bytes");
+    for (const MemoryTracker::TagStatistics& tagStatistics : MemoryTracker::getTagStatistics()) {
+        report += fmt::format("  {:<10} {:>16} {:>16} {:>14} {:>16}\n",
+            MemoryTracker::getTagName(tagStatistics.tag),
+            tagStatistics.currentBytes,
+            tagStatistics.peakBytes,
+            tagStatistics.allocationCount,
+            tagStatistics.budgetBytes > 0 ? std::to_string(tagStatistics.budgetBytes) : "-"
+        );
+    }
+
+    // Largest first, which are the ones anyone reading this is looking for
+    std::vector<MemoryTracker::AssetStatistics> assetStatistics = MemoryTracker::getAssetStatistics();
+    std::sort(assetStatistics.begin(), assetStatistics.end(), [] (const MemoryTracker::AssetStatistics& a, const MemoryTracker::AssetStatistics& b) {
+        return a.currentBytes != b.currentBytes ? a.currentBytes > b.currentBytes : a.name < b.name;
+    });
+    if (!assetStatistics.empty()) {
+        report += fmt::format("  {:>16} {:>16}  asset\n", "current bytes", "peak bytes");
+    }
+    for (const MemoryTracker::AssetStatistics& asset : assetStatistics) {
+        report += fmt::format("  {:>16} {:>16}  {}\n", asset.currentBytes, asset.peakBytes, asset.name);
+    }
+    report += "\n";
+
+    std::fputs(report.c_str(), sessionState.p_reportFile);
+    std::fflush(sessionState.p_reportFile);
+}
+
+/**
+ * @brief Warns once each time a tag goes over its budget, and again only after it has been back under it
+ */
+void
+checkBudgets(
+    SessionState& sessionState
+) {
+    for (const MemoryTracker::TagStatistics& tagStatistics : MemoryTracker::getTagStatistics()) {
+        bool& isOverBudget = sessionState.isOverBudget[static_cast<std::size_t>(tagStatistics.tag)];
+        const bool wasOverBudget = isOverBudget;
+        isOverBudget = tagStatistics.budgetBytes > 0 && tagStatistics.currentBytes > tagStatistics.budgetBytes;
+
+        if (isOverBudget && !wasOverBudget) {
+            LOG_WARNING(MEMORY, "{} is using {:.1f} MiB, over its budget of {:.1f} MiB", MemoryTracker::getTagName(tagStatistics.tag), tagStatistics.currentBytes / (1024.0 * 1024.0), tagStatistics.budgetBytes / (1024.0 * 1024.0));
+        } else if (wasOverBudget && !isOverBudget) {
+            LOG_INFO(MEMORY, "{} is back under its budget at {:.1f} MiB", MemoryTracker::getTagName(tagStatistics.tag), tagStatistics.currentBytes / (1024.0 * 1024.0));
+        }
+    }
+}
+
+void
+runReporterThread(
+    SessionState& sessionState
+) {
+    // Reports are the tracker's own overhead, so they are kept apart from the subsystems they report on
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Memory);
+
+    std::chrono::steady_clock::time_point lastReportTime = std::chrono::steady_clock::now();
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(sessionState.stopMutex);
+            if (sessionState.stopCondition.wait_for(lock, pollInterval, [&sessionState] { return sessionState.stopRequested; })) {
+                break;
+            }
+        }
+
+        checkBudgets(sessionState);
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (MemoryTracker::takeReportRequest()) {
+            writeReport(sessionState, "requested");
+            lastReportTime = now;
+        } else if (sessionState.reportInterval.count() > 0.0 && now - lastReportTime >= sessionState.reportInterval) {
+            writeReport(sessionState, "periodic");
+            lastReportTime = now;
+        }
+    }
+
+    checkBudgets(sessionState);
+    writeReport(sessionState, "exit");
+}
+
+} // namespace
+
+std::array<MemoryTracker::TagCounters, memoryTagCount> MemoryTracker::s_tagCounters = {};
+thread_local MemoryTag MemoryTracker::s_currentTag = MemoryTag::General;
+std::atomic<bool> MemoryTracker::s_reportRequested = false;
+
+const char*
+MemoryTracker::getTagName(
+    const MemoryTag tag
+) {
+    switch (tag) {
+        case MemoryTag::General:
+            return "general";
+        case MemoryTag::Physics:
+            return "physics";
+        case MemoryTag::Scene:
+            return "scene";
+        case MemoryTag::Spatial:
+            return "spatial";
+        case MemoryTag::Assets:
+            return "assets";
+        case MemoryTag::Logging:
+            return "logging";
+        case MemoryTag::Jobs:
+            return "jobs";
+        case MemoryTag::Memory:
+            return "memory";
+    }
+
+    return "unknown";
+}
+
+std::optional<MemoryTag>
+MemoryTracker::findTag(
+    const std::string_view name
+) {
+    for (std::size_t i = 0; i < memoryTagCount; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        if (name == MemoryTracker::getTagName(tag)) {
+            return tag;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void
+MemoryTracker::recordAllocation(
+    const MemoryTag tag,
+    const uint64_t byteCount
+) {
+    TagCounters& tagCounters = s_tagCounters[static_cast<std::size_t>(tag)];
+    const uint64_t currentBytes = tagCounters.currentBytes.fetch_add(byteCount, std::memory_order_relaxed) + byteCount;
+    tagCounters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+    raiseToAtLeast(tagCounters.peakBytes, currentBytes);
+}
+
+void
+MemoryTracker::recordRelease(
+    const MemoryTag tag,
+    const uint64_t byteCount
+) {
+    s_tagCounters[static_cast<std::size_t>(tag)].currentBytes.fetch_sub(byteCount, std::memory_order_relaxed);
+}
+
+void
+MemoryTracker::recordAssetAllocation(
+    const std::string& name,
+    const uint64_t byteCount
+) {
+    MemoryTracker::recordAllocation(MemoryTag::Assets, byteCount);
+
+    SessionState& sessionState = getSessionState();
+    std::lock_guard<std::mutex> lock(sessionState.assetsMutex);
+    AssetCounters& assetCounters = sessionState.assets[name];
+    assetCounters.currentBytes += byteCount;
+    assetCounters.peakBytes = std::max(assetCounters.peakBytes, assetCounters.currentBytes);
+}
+
+void
+MemoryTracker::recordAssetRelease(
+    const std::string& name,
+    const uint64_t byteCount
+) {
+    MemoryTracker::recordRelease(MemoryTag::Assets, byteCount);
+
+    SessionState& sessionState = getSessionState();
+    std::lock_guard<std::mutex> lock(sessionState.assetsMutex);
+    AssetCounters& assetCounters = sessionState.assets[name];
+    assetCounters.currentBytes -= std::min(assetCounters.currentBytes, byteCount);
+}
+
+void
+MemoryTracker::setBudget(
+    const MemoryTag tag,
+    const uint64_t byteCount
+) {
+    s_tagCounters[static_cast<std::size_t>(tag)].budgetBytes.store(byteCount, std::memory_order_relaxed);
+}
+
+std::vector<MemoryTracker::TagStatistics>
+MemoryTracker::getTagStatistics() {
+    std::vector<TagStatistics> tagStatistics;
+    tagStatistics.reserve(memoryTagCount);
+    for (std::size_t i = 0; i < memoryTagCount; ++i) {
+        const TagCounters& tagCounters = s_tagCounters[i];
+        tagStatistics.push_back({
+            static_cast<MemoryTag>(i),
+            tagCounters.currentBytes.load(std::memory_order_relaxed),
+            tagCounters.peakBytes.load(std::memory_order_relaxed),
+            tagCounters.allocationCount.load(std::memory_order_relaxed),
+            tagCounters.budgetBytes.load(std::memory_order_relaxed)
+        });
+    }
+
+    return tagStatistics;
+}
+
+std::vector<MemoryTracker::AssetStatistics>
+MemoryTracker::getAssetStatistics() {
+    SessionState& sessionState = getSessionState();
+    std::lock_guard<std::mutex> lock(sessionState.assetsMutex);
+
+    std::vector<AssetStatistics> assetStatistics;
+    assetStatistics.reserve(sessionState.assets.size());
+    for (const auto& [name, assetCounters] : sessionState.assets) {
+        assetStatistics.push_back({name, assetCounters.currentBytes, assetCounters.peakBytes});
+    }
+
+    return assetStatistics;
+}
+
+void
+MemoryTracker::start(
+    const std::string& reportFilepath,
+    const double reportIntervalSeconds
+) {
+    SessionState& sessionState = getSessionState();
+    std::lock_guard<std::mutex> lock(sessionState.lifecycleMutex);
+    if (sessionState.isRunning) {
+        return;
+    }
+
+    if (!reportFilepath.empty()) {
+        sessionState.p_reportFile = std::fopen(reportFilepath.c_str(), "w");
+        if (!sessionState.p_reportFile) {
+            LOG_CRITICALthis("Failed to open {} for memory reports", reportFilepath);
+            throw std::runtime_error("Failed to open memory report file");
+        }
+    }
+
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, [] (UNUSED int signal) { MemoryTracker::requestReport(); });
+#endif
+
+    sessionState.reportInterval = std::chrono::duration<double>(reportIntervalSeconds);
+    sessionState.startTime = std::chrono::steady_clock::now();
+    sessionState.stopRequested = false;
+    sessionState.isOverBudget = {};
+    sessionState.reporterThread = std::thread(runReporterThread, std::ref(sessionState));
+    sessionState.isRunning = true;
+
+    if (!reportFilepath.empty()) {
+        LOG_INFOthis("Writing memory reports to {} every {} seconds and on SIGUSR1", reportFilepath, reportIntervalSeconds);
+    }
+}
+
+void
+MemoryTracker::stop() {
+    SessionState& sessionState = getSessionState();
+    std::lock_guard<std::mutex> lock(sessionState.lifecycleMutex);
+    if (!sessionState.isRunning) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> stopLock(sessionState.stopMutex);
+        sessionState.stopRequested = true;
+    }
+    sessionState.stopCondition.notify_all();
+    sessionState.reporterThread.join();
+    sessionState.isRunning = false;
+
+    if (sessionState.p_reportFile) {
+        std::fclose(sessionState.p_reportFile);
+        sessionState.p_reportFile = nullptr;
+    }
+}
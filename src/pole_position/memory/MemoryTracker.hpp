@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+
+/**
+ * @brief The subsystems memory is accounted to
+ */
+enum class MemoryTag : uint8_t {
+    General,
+    Physics,
+    Scene,
+    Spatial,
+    Assets,
+    Logging,
+    Jobs,
+    Memory
+};
+
+constexpr std::size_t memoryTagCount = 8;
+
+/**
+ * @brief Current and peak bytes per subsystem, and per asset, with optional budgets per subsystem.
+ *
+ * The physics engine's memory is accounted exactly through its base allocator, and assets by the bytes their
+ * ResourceCache keeps resident. Built with POLE_POSITION_ENABLE_ALLOCATION_COUNTING, every other heap allocation
+ * is accounted too, to whichever tag the allocating thread has in scope through a ScopedTag, or General without
+ * one. Without it, only the physics engine and the assets are accounted.
+ *
+ * A session writes a report of everything to a file every so often, whenever the process gets SIGUSR1, and on
+ * exit, and logs a warning whenever a tag goes over its budget
+ */
+class MemoryTracker {
+public: // classes and enums
+    struct TagStatistics {
+        MemoryTag tag;
+        uint64_t currentBytes;
+        uint64_t peakBytes;
+        uint64_t allocationCount;
+        uint64_t budgetBytes; // 0 without a budget
+    };
+
+    struct AssetStatistics {
+        std::string name;
+        uint64_t currentBytes;
+        uint64_t peakBytes;
+    };
+
+    /**
+     * @brief Accounts the calling thread's allocations to a tag for as long as it is alive
+     */
+    class ScopedTag {
+    public: // member functions
+        explicit ScopedTag(const MemoryTag tag) : m_previousTag(s_currentTag) { s_currentTag = tag; }
+        ScopedTag(const ScopedTag& other) = delete;
+        ScopedTag& operator=(const ScopedTag& other) = delete;
+        ~ScopedTag() { s_currentTag = m_previousTag; }
+
+    private: // member variables
+        MemoryTag m_previousTag;
+    };
+
+    /**
+     * @brief Reports to the given file ( none if empty ) and checks the budgets for as long as it is alive
+     */
+    class ScopedSession {
+    public: // member functions
+        ScopedSession(const std::string& reportFilepath, const double reportIntervalSeconds) { MemoryTracker::start(reportFilepath, reportIntervalSeconds); }
+        ScopedSession(const ScopedSession& other) = delete;
+        ScopedSession& operator=(const ScopedSession& other) = delete;
+        ~ScopedSession() { MemoryTracker::stop(); }
+    };
+
+public: // member functions
+    static const char* getTagName(const MemoryTag tag);
+    static std::optional<MemoryTag> findTag(const std::string_view name);
+    static MemoryTag getCurrentTag() { return s_currentTag; }
+
+    /**
+     * @brief Never allocate, so they can be called from inside of an allocator
+     */
+    static void recordAllocation(const MemoryTag tag, const uint64_t byteCount);
+    static void recordRelease(const MemoryTag tag, const uint64_t byteCount);
+
+    /**
+     * @brief Also accounted to the Assets tag
+     */
+    static void recordAssetAllocation(const std::string& name, const uint64_t byteCount);
+    static void recordAssetRelease(const std::string& name, const uint64_t byteCount);
+
+    static void setBudget(const MemoryTag tag, const uint64_t byteCount);
+
+    static std::vector<TagStatistics> getTagStatistics();
+    static std::vector<AssetStatistics> getAssetStatistics();
+
+    /**
+     * @brief Asks the session for a report as soon as it can, safe to call from a signal handler
+     */
+    static void requestReport() { s_reportRequested.store(true, std::memory_order_relaxed); }
+    static bool takeReportRequest() { return s_reportRequested.exchange(false, std::memory_order_relaxed); }
+
+    static void start(const std::string& reportFilepath, const double reportIntervalSeconds);
+    static void stop();
+
+    USE_LOGGER(MEMORY);
+
+private: // classes and enums
+    struct TagCounters {
+        std::atomic<uint64_t> currentBytes;
+        std::atomic<uint64_t> peakBytes;
+        std::atomic<uint64_t> allocationCount;
+        std::atomic<uint64_t> budgetBytes;
+    };
+
+private: // static variables
+    static std::array<TagCounters, memoryTagCount> s_tagCounters;
+    static thread_local MemoryTag s_currentTag;
+    static std::atomic<bool> s_reportRequested;
+};
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/physics/ContactEventBuffer.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+
+ContactEventBuffer::ContactEventBuffer() :
+    m_subscriptions(),
+    m_wantedOtherCategoriesBitMasks(),
+    m_events()
+{}
+
+void
+ContactEventBuffer::subscribe(
+    const uint16_t categoryBitMask,
+    const uint16_t otherCategoriesBitMask,
+    Subscriber subscriber
+) {
+    if (!std::has_single_bit(categoryBitMask)) {
+        LOG_CRITICALthis("Contact subscribers must subscribe to exactly one category, not {:#06x}", categoryBitMask);
+        throw std::runtime_error("Invalid contact subscription category");
+    }
+
+    m_wantedOtherCategoriesBitMasks[std::countr_zero(categoryBitMask)] |= otherCategoriesBitMask;
+    m_subscriptions.push_back({categoryBitMask, std::move(subscriber)});
+}
+
+void
+ContactEventBuffer::recordSide(
+    const EventType eventType,
+    const uint16_t categoryBitMask,
+    const uint16_t otherCategoryBitMask,
+    const std::size_t doodadIndex,
+    const std::size_t otherDoodadIndex,
+    const uint32_t contactPointCount
+) {
+    // Colliders with no category can not be subscribed to
+    if (categoryBitMask == 0) {
+        return;
+    }
+
+    // A collider in several categories is filed under the lowest of them
+    const int categoryBit = std::countr_zero(categoryBitMask);
+    if (m_wantedOtherCategoriesBitMasks[categoryBit] & otherCategoryBitMask) {
+        m_events.push_back({static_cast<uint16_t>(1u << categoryBit), otherCategoryBitMask, eventType, contactPointCount, doodadIndex, otherDoodadIndex});
+    }
+}
+
+void
+ContactEventBuffer::record(
+    const EventType eventType,
+    const uint16_t categoryBitMask1,
+    const uint16_t categoryBitMask2,
+    const std::size_t doodadIndex1,
+    const std::size_t doodadIndex2,
+    const uint32_t contactPointCount
+) {
+    this->recordSide(eventType, categoryBitMask1, categoryBitMask2, doodadIndex1, doodadIndex2, contactPointCount);
+    this->recordSide(eventType, categoryBitMask2, categoryBitMask1, doodadIndex2, doodadIndex1, contactPointCount);
+}
+
+void
+ContactEventBuffer::dispatch() {
+    if (m_events.empty()) {
+        return;
+    }
+
+    PROFILE_SCOPE("Contact event dispatch");
+
+    std::sort(m_events.begin(), m_events.end(), [] (const ContactEvent& a, const ContactEvent& b) {
+        return
+            std::tie(a.categoryBitMask, a.eventType, a.doodadIndex, a.otherDoodadIndex) <
+            std::tie(b.categoryBitMask, b.eventType, b.doodadIndex, b.otherDoodadIndex);
+    });
+
+    for (const Subscription& subscription : m_subscriptions) {
+        const uint16_t categoryBitMask = subscription.categoryBitMask;
+        const std::vector<ContactEvent>::const_iterator begin = std::partition_point(m_events.cbegin(), m_events.cend(), [categoryBitMask] (const ContactEvent& event) { return event.categoryBitMask < categoryBitMask; });
+        const std::vector<ContactEvent>::const_iterator end = std::partition_point(begin, m_events.cend(), [categoryBitMask] (const ContactEvent& event) { return event.categoryBitMask == categoryBitMask; });
+        if (begin != end) {
+            subscription.subscriber(std::span<const ContactEvent>(begin, end));
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+
+/**
+ * @brief Every contact of a physics step as one flat buffer, instead of one callback per contact.
+ * A collider in several categories is filed under the lowest of them.
+ *
+ * Subscribers ask for a collision category (one of the CollisionCategories bits) and the categories on the
+ * other side that they care about. While the step runs, each side of a contact pair is written only if a
+ * subscriber asked for its category and the other side's category, so categories nobody listens to are never
+ * written at all. Once the step is over the buffer is sorted by category, and each subscriber is handed the
+ * contiguous run of events for its category in a single call.
+ */
+class ContactEventBuffer {
+public: // classes and enums
+    enum class EventType : uint8_t {
+        Start,
+        Stay,
+        End
+    };
+
+    /**
+     * @brief The doodad index of a side that is not a doodad, like a streamed terrain chunk
+     */
+    static constexpr std::size_t noDoodadIndex = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief One side of a contact pair, seen from the doodad whose category the event is filed under. A trigger
+     * overlapping another collider is a pair too, with no contact points
+     */
+    struct ContactEvent {
+        uint16_t categoryBitMask;
+        uint16_t otherCategoryBitMask;
+        EventType eventType;
+        uint32_t contactPointCount;
+        std::size_t doodadIndex;
+        std::size_t otherDoodadIndex;
+    };
+
+    /**
+     * @brief Receives the tick's events for its category. Events are filtered by the union of the other categories
+     * every subscriber to the category asked for, so a subscriber sharing its category with a broader one should
+     * check otherCategoryBitMask
+     */
+    using Subscriber = std::function<void(std::span<const ContactEvent> events)>;
+
+public: // member functions
+    ContactEventBuffer();
+
+    /**
+     * @brief categoryBitMask must have exactly one bit set
+     */
+    void subscribe(const uint16_t categoryBitMask, const uint16_t otherCategoriesBitMask, Subscriber subscriber);
+    bool hasSubscribers() const { return !m_subscriptions.empty(); }
+
+    void clear() { m_events.clear(); }
+    void record(
+        const EventType eventType,
+        const uint16_t categoryBitMask1,
+        const uint16_t categoryBitMask2,
+        const std::size_t doodadIndex1,
+        const std::size_t doodadIndex2,
+        const uint32_t contactPointCount
+    );
+
+    /**
+     * @brief Sorts the recorded events and hands them to the subscribers. The order within a category is fixed by
+     * the event's contents, not by the order the physics engine reported the pairs in
+     */
+    void dispatch();
+
+    std::size_t size() const { return m_events.size(); }
+
+    USE_LOGGER(HEADLESS);
+
+private: // classes and enums
+    struct Subscription {
+        uint16_t categoryBitMask;
+        Subscriber subscriber;
+    };
+
+private: // member functions
+    void recordSide(
+        const EventType eventType,
+        const uint16_t categoryBitMask,
+        const uint16_t otherCategoryBitMask,
+        const std::size_t doodadIndex,
+        const std::size_t otherDoodadIndex,
+        const uint32_t contactPointCount
+    );
+
+private: // member variables
+    std::vector<Subscription> m_subscriptions;
+
+    /**
+     * @brief For each category bit, the other categories some subscriber to it wants. Zero for categories without
+     * subscribers, which makes recording a side for them a single load and compare
+     */
+    uint16_t m_wantedOtherCategoriesBitMasks[16];
+
+    std::vector<ContactEvent> m_events;
+};
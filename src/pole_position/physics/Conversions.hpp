@@ -0,0 +1,57 @@
+#pragma once
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+/**
+ * @brief Conversions between our math types and reactphysics3d's, for the places where the application talks
+ * to a physics world directly instead of going through quartz::physics
+ */
+
+inline reactphysics3d::Vector3
+toReactPhysics3d(
+    const math::Vec3& vec
+) {
+    return {
+        static_cast<reactphysics3d::decimal>(vec.x),
+        static_cast<reactphysics3d::decimal>(vec.y),
+        static_cast<reactphysics3d::decimal>(vec.z)
+    };
+}
+
+inline reactphysics3d::Quaternion
+toReactPhysics3d(
+    const math::Quaternion& quaternion
+) {
+    return {
+        static_cast<reactphysics3d::decimal>(quaternion.x),
+        static_cast<reactphysics3d::decimal>(quaternion.y),
+        static_cast<reactphysics3d::decimal>(quaternion.z),
+        static_cast<reactphysics3d::decimal>(quaternion.w)
+    };
+}
+
+inline math::Vec3
+toMath(
+    const reactphysics3d::Vector3& vec
+) {
+    return math::Vec3(
+        static_cast<double>(vec.x),
+        static_cast<double>(vec.y),
+        static_cast<double>(vec.z)
+    );
+}
+
+inline math::Quaternion
+toMath(
+    const reactphysics3d::Quaternion& quaternion
+) {
+    return math::Quaternion(
+        static_cast<double>(quaternion.w),
+        static_cast<double>(quaternion.x),
+        static_cast<double>(quaternion.y),
+        static_cast<double>(quaternion.z)
+    );
+}
@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/profiling/Profiler.hpp"
+
+namespace {
+
+struct ScopeEvent {
+    const char* name;
+    uint64_t startNanoseconds;
+    uint64_t endNanoseconds;
+};
+
+/**
+ * @brief The time a scope name took on one thread so far this frame
+ */
+struct ScopeSum {
+    const char* name;
+    double microseconds;
+};
+
+/**
+ * @brief A thread's timeline and its scope sums for the current frame. Only the owning thread appends, but the
+ * frame summary and the trace writer read them from other threads, so they are guarded by a mutex that is
+ * uncontended almost all of the time.
+ *
+ * The events are a ring that keeps the thread's most recent scopes for the trace, so a long run neither grows it
+ * without bound nor stops tracing once it is full. The frame summary only ever looks at the scope sums, which
+ * endFrame drains
+ */
+struct ThreadTimeline {
+    uint32_t threadIndex;
+    std::mutex mutex;
+    std::vector<ScopeEvent> events;
+    std::size_t nextEventIndex = 0;
+    uint64_t overwrittenEventCount = 0;
+    std::vector<ScopeSum> frameScopeSums;
+};
+
+struct ProfilerState {
+    static constexpr std::size_t maxEventsPerThread = 1024 * 1024;
+    static constexpr std::size_t summaryWindowFrameCount = 600;
+    static constexpr uint64_t summaryLogIntervalFrames = 600;
+
+    // Marks the frames of a scope's window in which the scope did not run
+    static constexpr double noSampleMicroseconds = -1.0;
+
+    std::mutex timelinesMutex;
+    std::vector<std::unique_ptr<ThreadTimeline>> timelines;
+
+    std::mutex summaryMutex;
+    std::unordered_map<std::string, std::vector<double>> frameMicrosecondsByScope;
+    uint64_t frameCount = 0;
+
+    uint64_t startNanoseconds = 0;
+};
+
+ProfilerState&
+getProfilerState() {
+    static ProfilerState profilerState;
+    return profilerState;
+}
+
+ThreadTimeline&
+getThreadTimeline() {
+    thread_local ThreadTimeline* const p_threadTimeline = [] {
+        ProfilerState& profilerState = getProfilerState();
+        std::lock_guard<std::mutex> lock(profilerState.timelinesMutex);
+        std::unique_ptr<ThreadTimeline>& p_timeline = profilerState.timelines.emplace_back(std::make_unique<ThreadTimeline>());
+        p_timeline->threadIndex = static_cast<uint32_t>(profilerState.timelines.size() - 1);
+        return p_timeline.get();
+    }();
+    return *p_threadTimeline;
+}
+
+double
+getPercentile(
+    std::vector<double> samples,
+    const double fraction
+) {
+    const std::size_t index = std::min(static_cast<std::size_t>(fraction * samples.size()), samples.size() - 1);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+} // namespace
+
+std::atomic<bool> Profiler::s_isEnabled = false;
+
+void
+Profiler::enable() {
+    ProfilerState& profilerState = getProfilerState();
+    if (profilerState.startNanoseconds == 0) {
+        profilerState.startNanoseconds = Profiler::now();
+    }
+    s_isEnabled.store(true, std::memory_order_relaxed);
+}
+
+void
+Profiler::disable() {
+    s_isEnabled.store(false, std::memory_order_relaxed);
+}
+
+void
+Profiler::recordScope(
+    const char* const name,
+    const uint64_t startNanoseconds,
+    const uint64_t endNanoseconds
+) {
+    ThreadTimeline& threadTimeline = getThreadTimeline();
+    std::lock_guard<std::mutex> lock(threadTimeline.mutex);
+
+    // A thread only runs a handful of different scopes, so a linear search beats hashing the name
+    const double microseconds = (endNanoseconds - startNanoseconds) / 1000.0;
+    const auto scopeSumIt = std::find_if(threadTimeline.frameScopeSums.begin(), threadTimeline.frameScopeSums.end(), [name] (const ScopeSum& scopeSum) { return scopeSum.name == name; });
+    if (scopeSumIt != threadTimeline.frameScopeSums.end()) {
+        scopeSumIt->microseconds += microseconds;
+    } else {
+        threadTimeline.frameScopeSums.push_back({name, microseconds});
+    }
+
+    if (threadTimeline.events.size() < ProfilerState::maxEventsPerThread) {
+        threadTimeline.events.push_back({name, startNanoseconds, endNanoseconds});
+        return;
+    }
+    threadTimeline.events[threadTimeline.nextEventIndex] = {name, startNanoseconds, endNanoseconds};
+    threadTimeline.nextEventIndex = (threadTimeline.nextEventIndex + 1) % ProfilerState::maxEventsPerThread;
+    ++threadTimeline.overwrittenEventCount;
+}
+
+void
+Profiler::endFrame() {
+    if (!Profiler::isEnabled()) {
+        return;
+    }
+
+    ProfilerState& profilerState = getProfilerState();
+
+    // Sum the time every scope took this frame, over all threads and all occurrences
+    std::unordered_map<std::string_view, double> frameMicroseconds;
+    {
+        std::lock_guard<std::mutex> timelinesLock(profilerState.timelinesMutex);
+        for (const std::unique_ptr<ThreadTimeline>& p_timeline : profilerState.timelines) {
+            std::lock_guard<std::mutex> timelineLock(p_timeline->mutex);
+            for (const ScopeSum& scopeSum : p_timeline->frameScopeSums) {
+                frameMicroseconds[scopeSum.name] += scopeSum.microseconds;
+            }
+            p_timeline->frameScopeSums.clear();
+        }
+    }
+
+    uint64_t frameCount = 0;
+    {
+        std::lock_guard<std::mutex> summaryLock(profilerState.summaryMutex);
+        const std::size_t windowIndex = profilerState.frameCount % ProfilerState::summaryWindowFrameCount;
+        for (const auto& [name, microseconds] : frameMicroseconds) {
+            std::vector<double>& window = profilerState.frameMicrosecondsByScope[std::string(name)];
+            if (window.size() < ProfilerState::summaryWindowFrameCount) {
+                window.resize(ProfilerState::summaryWindowFrameCount, ProfilerState::noSampleMicroseconds);
+            }
+        }
+
+        // Every scope's slot is written every frame, so a scope that did not run this frame does not keep a sample
+        // from a window ago in it
+        for (auto& [name, window] : profilerState.frameMicrosecondsByScope) {
+            const auto frameMicrosecondsIt = frameMicroseconds.find(name);
+            window[windowIndex] = frameMicrosecondsIt != frameMicroseconds.end() ? frameMicrosecondsIt->second : ProfilerState::noSampleMicroseconds;
+        }
+        frameCount = ++profilerState.frameCount;
+    }
+
+    if (frameCount % ProfilerState::summaryLogIntervalFrames == 0) {
+        Profiler::logFrameSummary();
+    }
+}
+
+std::vector<Profiler::ScopeSummary>
+Profiler::getFrameSummary() {
+    ProfilerState& profilerState = getProfilerState();
+    std::lock_guard<std::mutex> lock(profilerState.summaryMutex);
+
+    std::vector<ScopeSummary> scopeSummaries;
+    scopeSummaries.reserve(profilerState.frameMicrosecondsByScope.size());
+    for (const auto& [name, window] : profilerState.frameMicrosecondsByScope) {
+        std::vector<double> samples;
+        samples.reserve(window.size());
+        std::copy_if(window.begin(), window.end(), std::back_inserter(samples), [] (const double microseconds) { return microseconds != ProfilerState::noSampleMicroseconds; });
+        if (samples.empty()) {
+            continue;
+        }
+
+        scopeSummaries.push_back({
+            name,
+            samples.size(),
+            getPercentile(samples, 0.50),
+            getPercentile(samples, 0.99),
+            *std::max_element(samples.begin(), samples.end())
+        });
+    }
+
+    std::sort(scopeSummaries.begin(), scopeSummaries.end(), [] (const ScopeSummary& a, const ScopeSummary& b) { return a.p99Microseconds > b.p99Microseconds; });
+
+    return scopeSummaries;
+}
+
+void
+Profiler::logFrameSummary() {
+    const std::vector<ScopeSummary> scopeSummaries = Profiler::getFrameSummary();
+
+    LOG_INFOthis("Per frame scope times over the last {} frames", ProfilerState::summaryWindowFrameCount);
+    for (const ScopeSummary& scopeSummary : scopeSummaries) {
+        LOG_INFOthis("  {:<48} p50 {:>9.2f} us  p99 {:>9.2f} us  max {:>9.2f} us  ( {} frames )", scopeSummary.name, scopeSummary.p50Microseconds, scopeSummary.p99Microseconds, scopeSummary.maxMicroseconds, scopeSummary.frameCount);
+    }
+}
+
+bool
+Profiler::writeChromeTrace(
+    const std::string& filepath
+) {
+    ProfilerState& profilerState = getProfilerState();
+
+    std::ofstream outputStream(filepath);
+    if (!outputStream) {
+        LOG_ERRORthis("Failed to open {} for writing", filepath);
+        return false;
+    }
+
+    outputStream << std::fixed << std::setprecision(3);
+    outputStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    outputStream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"" << APPLICATION_NAME << "\"}}";
+
+    std::size_t eventCount = 0;
+    uint64_t overwrittenEventCount = 0;
+    std::lock_guard<std::mutex> timelinesLock(profilerState.timelinesMutex);
+    for (const std::unique_ptr<ThreadTimeline>& p_timeline : profilerState.timelines) {
+        std::lock_guard<std::mutex> timelineLock(p_timeline->mutex);
+
+        outputStream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << p_timeline->threadIndex << ",\"args\":{\"name\":\"thread " << p_timeline->threadIndex << "\"}}";
+        // Oldest first, which once the ring has wrapped starts at the next slot to be overwritten
+        const std::vector<ScopeEvent>& events = p_timeline->events;
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const ScopeEvent& event = events[(p_timeline->nextEventIndex + i) % events.size()];
+            outputStream
+                << ",\n{\"name\":\"" << event.name
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << p_timeline->threadIndex
+                << ",\"ts\":" << (event.startNanoseconds - profilerState.startNanoseconds) / 1000.0
+                << ",\"dur\":" << (event.endNanoseconds - event.startNanoseconds) / 1000.0
+                << "}";
+        }
+
+        eventCount += events.size();
+        overwrittenEventCount += p_timeline->overwrittenEventCount;
+    }
+
+    outputStream << "\n]}\n";
+
+    LOG_INFOthis("Wrote {} scopes from {} threads to {}", eventCount, profilerState.timelines.size(), filepath);
+    if (overwrittenEventCount > 0) {
+        LOG_INFOthis("The trace holds each thread's last {} scopes, {} older ones were overwritten", ProfilerState::maxEventsPerThread, overwrittenEventCount);
+    }
+
+    return true;
+}
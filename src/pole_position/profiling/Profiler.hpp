@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/macros.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+
+/**
+ * @brief Scoped timing of hot paths. Each thread records the scopes it completes into its own timeline, which keeps
+ * its most recent scopes and can be written out as a Chrome trace ( chrome://tracing or ui.perfetto.dev ). Each
+ * thread also sums its scopes per name as it goes, and at the end of every frame those sums go into a rolling
+ * window, which is periodically summarized (p50/p99/max).
+ *
+ * With POLE_POSITION_ENABLE_PROFILING off the PROFILE_* macros compile to nothing. With it on but the profiler
+ * not enabled, a scope costs a single relaxed atomic load.
+ */
+class Profiler {
+public: // classes and enums
+    struct ScopeSummary {
+        std::string name;
+        uint64_t frameCount;
+        double p50Microseconds;
+        double p99Microseconds;
+        double maxMicroseconds;
+    };
+
+    /**
+     * @brief Profiles for as long as it is alive, then logs the frame summary and writes the Chrome trace
+     */
+    class ScopedSession {
+    public: // member functions
+        explicit ScopedSession(const std::string& traceFilepath) : m_traceFilepath(traceFilepath) { Profiler::enable(); }
+        ScopedSession(const ScopedSession& other) = delete;
+        ScopedSession& operator=(const ScopedSession& other) = delete;
+        ~ScopedSession() {
+            Profiler::disable();
+            Profiler::logFrameSummary();
+            Profiler::writeChromeTrace(m_traceFilepath);
+        }
+
+    private: // member variables
+        std::string m_traceFilepath;
+    };
+
+public: // member functions
+    static void enable();
+    static void disable();
+    static bool isEnabled() { return s_isEnabled.load(std::memory_order_relaxed); }
+
+    static uint64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+    static void recordScope(const char* const name, const uint64_t startNanoseconds, const uint64_t endNanoseconds);
+
+    static void endFrame();
+    static std::vector<ScopeSummary> getFrameSummary();
+    static void logFrameSummary();
+
+    static bool writeChromeTrace(const std::string& filepath);
+
+    USE_LOGGER(PROFILER);
+
+private: // static variables
+    static std::atomic<bool> s_isEnabled;
+};
+
+class ProfileScope {
+public: // member functions
+    explicit ProfileScope(const char* const name) :
+        mp_name(Profiler::isEnabled() ? name : nullptr),
+        m_startNanoseconds(mp_name ? Profiler::now() : 0)
+    {}
+    ProfileScope(const ProfileScope& other) = delete;
+    ProfileScope& operator=(const ProfileScope& other) = delete;
+    ~ProfileScope() {
+        if (mp_name) {
+            Profiler::recordScope(mp_name, m_startNanoseconds, Profiler::now());
+        }
+    }
+
+private: // member variables
+    const char* mp_name;
+    uint64_t m_startNanoseconds;
+};
+
+#define PROFILE_CONCATENATE_IMPL(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_IMPL(a, b)
+
+#ifdef POLE_POSITION_ENABLE_PROFILING
+#define PROFILE_SCOPE(name) const ProfileScope PROFILE_CONCATENATE(profileScope_, __LINE__)(name)
+#define PROFILE_FRAME_END() Profiler::endFrame()
+#else
+#define PROFILE_SCOPE(name) REQUIRE_SEMICOLON
+#define PROFILE_FRAME_END() REQUIRE_SEMICOLON
+#endif
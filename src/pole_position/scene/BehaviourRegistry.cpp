@@ -0,0 +1,22 @@
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/scene/BehaviourRegistry.hpp"
+
+void
+BehaviourRegistry::registerBehaviour(
+    const std::string& name,
+    const Behaviour& behaviour
+) {
+    LOG_TRACEthis("Registering behaviour {}", name);
+    m_behaviours.insert_or_assign(name, behaviour);
+}
+
+const Behaviour*
+BehaviourRegistry::findBehaviour(
+    const std::string& name
+) const {
+    const auto behaviourIterator = m_behaviours.find(name);
+    return behaviourIterator != m_behaviours.end() ? &behaviourIterator->second : nullptr;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/physics/collider/Collider.hpp"
+#include "quartz/scene/doodad/Doodad.hpp"
+
+#include "pole_position/Loggers.hpp"
+
+/**
+ * @brief The callbacks a doodad runs, under the name scene files refer to them by. Any of them may be empty
+ */
+struct Behaviour {
+    quartz::scene::Doodad::AwakenCallback awakenCallback;
+    quartz::scene::Doodad::FixedUpdateCallback fixedUpdateCallback;
+    quartz::scene::Doodad::UpdateCallback updateCallback;
+    quartz::physics::Collider::CollisionCallback collisionStartCallback;
+    quartz::physics::Collider::CollisionCallback collisionStayCallback;
+    quartz::physics::Collider::CollisionCallback collisionEndCallback;
+};
+
+/**
+ * @brief Lets scene files bind doodads to controllers that only exist at runtime, such as the player's
+ * ThirdPersonController, by name
+ */
+class BehaviourRegistry {
+public: // member functions
+    BehaviourRegistry() = default;
+    BehaviourRegistry(const BehaviourRegistry& other) = delete;
+    BehaviourRegistry& operator=(const BehaviourRegistry& other) = delete;
+
+    /**
+     * @brief Replaces any behaviour already registered under the name
+     */
+    void registerBehaviour(const std::string& name, const Behaviour& behaviour);
+    const Behaviour* findBehaviour(const std::string& name) const;
+
+    USE_LOGGER(SCENE_FILE);
+
+private: // member variables
+    std::unordered_map<std::string, Behaviour> m_behaviours;
+};
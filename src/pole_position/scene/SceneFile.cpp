@@ -0,0 +1,710 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "math/transform/Transform.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+#include "util/file_system/FileSystem.hpp"
+
+#include "quartz/physics/collider/Collider.hpp"
+#include "quartz/physics/field/Field.hpp"
+#include "quartz/physics/rigid_body/RigidBody.hpp"
+#include "quartz/scene/doodad/Doodad.hpp"
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/scene/BehaviourRegistry.hpp"
+#include "pole_position/scene/SceneFile.hpp"
+#include "pole_position/scene/SceneFileFormat.hpp"
+#include "pole_position/scene/SceneParameters.hpp"
+
+namespace {
+
+constexpr std::size_t doodadRecordChunkSize = 4096;
+
+math::Vec3
+toVec3(
+    const scene_file_format::Vec3Record& record
+) {
+    return math::Vec3(record.x, record.y, record.z);
+}
+
+/**
+ * @brief Turns records into quartz parameters, resolving every string at most once no matter how many doodads
+ * share it
+ */
+class SceneBuilder {
+public: // member functions
+    SceneBuilder(
+        const std::string& filepath,
+        const std::vector<std::string>& strings,
+        const BehaviourRegistry& behaviourRegistry,
+        const uint64_t doodadCount
+    ) :
+        m_filepath(filepath),
+        m_strings(strings),
+        m_behaviourRegistry(behaviourRegistry),
+        m_resolvedFilepaths(strings.size()),
+        m_behaviours(strings.size(), nullptr),
+        m_doodadParameters(),
+        m_doodadIndicesByBehaviour()
+    {
+        m_doodadParameters.reserve(doodadCount);
+    }
+
+    void
+    addDoodad(
+        const scene_file_format::DoodadRecord& record
+    ) {
+        const Behaviour* const p_behaviour = record.behaviourStringIndex == scene_file_format::noStringIndex ? nullptr : &this->getBehaviour(record.behaviourStringIndex);
+        const Behaviour emptyBehaviour {};
+        const Behaviour& behaviour = p_behaviour ? *p_behaviour : emptyBehaviour;
+
+        std::optional<quartz::physics::RigidBody::Parameters> o_rigidBodyParameters;
+        if (record.hasRigidBody) {
+            if (record.bodyType > static_cast<uint8_t>(quartz::physics::RigidBody::BodyType::Dynamic)) {
+                throw std::runtime_error(fmt::format("{}: unknown body type {}", m_filepath, record.bodyType));
+            }
+            if (record.shapeKind != scene_file_format::ShapeKind::box && record.shapeKind != scene_file_format::ShapeKind::sphere) {
+                throw std::runtime_error(fmt::format("{}: unknown shape kind {}", m_filepath, static_cast<uint8_t>(record.shapeKind)));
+            }
+
+            o_rigidBodyParameters.emplace(
+                static_cast<quartz::physics::RigidBody::BodyType>(record.bodyType),
+                record.enableGravity != 0,
+                toVec3(record.angularLockAxisFactor),
+                quartz::physics::Collider::Parameters(
+                    record.isTrigger != 0,
+                    {
+                        record.categoryBitMask,
+                        record.collidableCategoriesBitMask
+                    },
+                    record.shapeKind == scene_file_format::ShapeKind::sphere ?
+                        std::variant<quartz::physics::BoxShape::Parameters, quartz::physics::SphereShape::Parameters>(quartz::physics::SphereShape::Parameters(record.shapeDimensions.x)) :
+                        std::variant<quartz::physics::BoxShape::Parameters, quartz::physics::SphereShape::Parameters>(quartz::physics::BoxShape::Parameters(toVec3(record.shapeDimensions))),
+                    behaviour.collisionStartCallback,
+                    behaviour.collisionStayCallback,
+                    behaviour.collisionEndCallback
+                )
+            );
+        }
+
+        if (p_behaviour) {
+            m_doodadIndicesByBehaviour[m_strings[record.behaviourStringIndex]].push_back(m_doodadParameters.size());
+        }
+
+        m_doodadParameters.emplace_back(
+            this->getResolvedFilepath(record.modelStringIndex),
+            math::Transform(
+                toVec3(record.position),
+                record.rotationAmount,
+                toVec3(record.rotationAxis),
+                toVec3(record.scale)
+            ),
+            o_rigidBodyParameters,
+            behaviour.awakenCallback,
+            behaviour.fixedUpdateCallback,
+            behaviour.updateCallback
+        );
+    }
+
+    SceneFile::LoadedScene
+    finish(
+        const scene_file_format::EnvironmentRecord& environment,
+        const std::vector<scene_file_format::PointLightRecord>& pointLightRecords,
+        const std::vector<scene_file_format::SpotLightRecord>& spotLightRecords
+    ) {
+        std::vector<quartz::scene::PointLight> pointLights;
+        pointLights.reserve(pointLightRecords.size());
+        for (const scene_file_format::PointLightRecord& record : pointLightRecords) {
+            pointLights.push_back({toVec3(record.color), toVec3(record.position), record.attenuationLinearFactor, record.attenuationQuadraticFactor});
+        }
+
+        std::vector<quartz::scene::SpotLight> spotLights;
+        spotLights.reserve(spotLightRecords.size());
+        for (const scene_file_format::SpotLightRecord& record : spotLightRecords) {
+            spotLights.push_back({toVec3(record.color), toVec3(record.position), toVec3(record.direction), record.innerRadiusDegrees, record.outerRadiusDegrees, record.attenuationLinearFactor, record.attenuationQuadraticFactor});
+        }
+
+        std::array<std::string, 6> skyBoxInformation;
+        for (std::size_t i = 0; i < skyBoxInformation.size(); ++i) {
+            skyBoxInformation[i] = this->getResolvedFilepath(environment.skyBoxStringIndices[i]);
+        }
+
+        std::optional<quartz::physics::Field::Parameters> o_fieldParameters;
+        if (environment.hasGravity) {
+            o_fieldParameters = quartz::physics::Field::Parameters({toVec3(environment.gravity)});
+        }
+
+        return {
+            quartz::scene::Scene::Parameters(
+                this->getString(environment.nameStringIndex),
+                quartz::scene::AmbientLight(toVec3(environment.ambientLightColor)),
+                quartz::scene::DirectionalLight(toVec3(environment.directionalLightColor), toVec3(environment.directionalLightDirection)),
+                pointLights,
+                spotLights,
+                toVec3(environment.screenClearColor),
+                skyBoxInformation,
+                std::move(m_doodadParameters),
+                o_fieldParameters
+            ),
+            std::move(m_doodadIndicesByBehaviour)
+        };
+    }
+
+private: // member functions
+    const std::string&
+    getString(
+        const uint32_t stringIndex
+    ) const {
+        if (stringIndex >= m_strings.size()) {
+            throw std::runtime_error(fmt::format("{} refers to string {} but only has {}", m_filepath, stringIndex, m_strings.size()));
+        }
+        return m_strings[stringIndex];
+    }
+
+    const std::string&
+    getResolvedFilepath(
+        const uint32_t stringIndex
+    ) {
+        const std::string& filepath = this->getString(stringIndex);
+        std::optional<std::string>& o_resolvedFilepath = m_resolvedFilepaths[stringIndex];
+        if (!o_resolvedFilepath) {
+            o_resolvedFilepath = std::filesystem::path(filepath).is_absolute() ? filepath : util::FileSystem::getAbsoluteFilepathInProjectDirectory(filepath);
+        }
+        return *o_resolvedFilepath;
+    }
+
+    const Behaviour&
+    getBehaviour(
+        const uint32_t stringIndex
+    ) {
+        const std::string& behaviourName = this->getString(stringIndex);
+        const Behaviour*& p_behaviour = m_behaviours[stringIndex];
+        if (!p_behaviour) {
+            p_behaviour = m_behaviourRegistry.findBehaviour(behaviourName);
+            if (!p_behaviour) {
+                throw std::runtime_error(fmt::format("{} uses behaviour {}, which is not registered", m_filepath, behaviourName));
+            }
+        }
+        return *p_behaviour;
+    }
+
+private: // member variables
+    const std::string& m_filepath;
+    const std::vector<std::string>& m_strings;
+    const BehaviourRegistry& m_behaviourRegistry;
+    std::vector<std::optional<std::string>> m_resolvedFilepaths;
+    std::vector<const Behaviour*> m_behaviours;
+    std::vector<quartz::scene::Doodad::Parameters> m_doodadParameters;
+    std::unordered_map<std::string, std::vector<std::size_t>> m_doodadIndicesByBehaviour;
+};
+
+/**
+ * @brief Walks the tokens of one line of the text form, reporting errors with the line they came from
+ */
+class LineParser {
+public: // member functions
+    LineParser(
+        const std::string& filepath,
+        const std::size_t lineNumber,
+        const std::string_view line
+    ) :
+        m_filepath(filepath),
+        m_lineNumber(lineNumber),
+        m_tokens(),
+        m_nextTokenIndex(0)
+    {
+        // Tokens are separated by whitespace unless they are quoted
+        std::size_t position = 0;
+        while (true) {
+            position = line.find_first_not_of(" \t\r", position);
+            if (position == std::string_view::npos || line[position] == '#') {
+                break;
+            }
+
+            if (line[position] == '"') {
+                const std::size_t closingQuotePosition = line.find('"', position + 1);
+                if (closingQuotePosition == std::string_view::npos) {
+                    this->fail("unterminated quote");
+                }
+                m_tokens.emplace_back(line.substr(position + 1, closingQuotePosition - position - 1));
+                position = closingQuotePosition + 1;
+                continue;
+            }
+
+            const std::size_t end = std::min(line.find_first_of(" \t\r", position), line.size());
+            m_tokens.emplace_back(line.substr(position, end - position));
+            position = end;
+        }
+    }
+
+    bool isDone() const { return m_nextTokenIndex >= m_tokens.size(); }
+
+    [[noreturn]] void
+    fail(
+        const std::string& message
+    ) const {
+        throw std::runtime_error(fmt::format("{}:{}: {}", m_filepath, m_lineNumber, message));
+    }
+
+    std::string
+    readString(
+        const std::string_view what
+    ) {
+        if (this->isDone()) {
+            this->fail(fmt::format("expected {}", what));
+        }
+        return m_tokens[m_nextTokenIndex++];
+    }
+
+    float
+    readFloat(
+        const std::string_view what
+    ) {
+        const std::string token = this->readString(what);
+        char* p_end = nullptr;
+        errno = 0;
+        const float value = std::strtof(token.c_str(), &p_end);
+        if (errno != 0 || p_end == token.c_str() || *p_end != '\0') {
+            this->fail(fmt::format("expected {} but found \"{}\"", what, token));
+        }
+        return value;
+    }
+
+    scene_file_format::Vec3Record
+    readVec3(
+        const std::string_view what
+    ) {
+        const float x = this->readFloat(what);
+        const float y = this->readFloat(what);
+        const float z = this->readFloat(what);
+        return {x, y, z};
+    }
+
+    bool
+    readSwitch(
+        const std::string_view what
+    ) {
+        const std::string token = this->readString(what);
+        if (token == "on") { return true; }
+        if (token == "off") { return false; }
+        this->fail(fmt::format("expected on or off for {} but found \"{}\"", what, token));
+    }
+
+    uint16_t
+    readCategories(
+        const std::string_view what
+    ) {
+        const std::string token = this->readString(what);
+        if (token.rfind("all^", 0) == 0) {
+            return 0xFFFF ^ this->parseCategories(token.substr(4), what);
+        }
+        return this->parseCategories(token, what);
+    }
+
+private: // member functions
+    uint16_t
+    parseCategories(
+        const std::string& token,
+        const std::string_view what
+    ) const {
+        uint16_t categories = 0;
+        std::size_t start = 0;
+        while (start <= token.size()) {
+            const std::size_t end = std::min(token.find('|', start), token.size());
+            const std::string category = token.substr(start, end - start);
+            start = end + 1;
+
+            if (category == "all") { categories |= 0xFFFF; continue; }
+            if (category == "none" || category == "Default") { continue; }
+            if (category == "Player") { categories |= static_cast<uint16_t>(CollisionCategories::Player); continue; }
+            if (category == "Terrain") { categories |= static_cast<uint16_t>(CollisionCategories::Terrain); continue; }
+            if (category == "Interactable") { categories |= static_cast<uint16_t>(CollisionCategories::Interactable); continue; }
+
+            char* p_end = nullptr;
+            errno = 0;
+            const unsigned long value = std::strtoul(category.c_str(), &p_end, 0);
+            if (errno != 0 || category.empty() || *p_end != '\0' || value > 0xFFFF) {
+                this->fail(fmt::format("unknown collision category \"{}\" in {}", category, what));
+            }
+            categories |= static_cast<uint16_t>(value);
+        }
+        return categories;
+    }
+
+private: // member variables
+    const std::string& m_filepath;
+    std::size_t m_lineNumber;
+    std::vector<std::string> m_tokens;
+    std::size_t m_nextTokenIndex;
+};
+
+template <typename T>
+void
+readExactly(
+    std::ifstream& inputStream,
+    T* p_values,
+    const std::size_t count,
+    const std::string& filepath
+) {
+    if (!inputStream.read(reinterpret_cast<char*>(p_values), static_cast<std::streamsize>(count * sizeof(T)))) {
+        throw std::runtime_error(fmt::format("{} is truncated", filepath));
+    }
+}
+
+/**
+ * @brief Checks that count values of T fit in what is left of the file before anything is sized from count, so a
+ * truncated or corrupt header fails like a short read instead of asking for a huge allocation
+ */
+template <typename T>
+void
+requireRemaining(
+    std::ifstream& inputStream,
+    const uint64_t fileByteCount,
+    const uint64_t count,
+    const std::string& filepath
+) {
+    const uint64_t remainingByteCount = fileByteCount - static_cast<uint64_t>(inputStream.tellg());
+    if (count > remainingByteCount / sizeof(T)) {
+        throw std::runtime_error(fmt::format("{} is truncated", filepath));
+    }
+}
+
+template <typename T>
+void
+writeValues(
+    std::ofstream& outputStream,
+    const T* p_values,
+    const std::size_t count
+) {
+    outputStream.write(reinterpret_cast<const char*>(p_values), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+std::optional<std::size_t>
+SceneFile::LoadedScene::findFirstDoodadWithBehaviour(
+    const std::string& behaviourName
+) const {
+    const auto doodadIndicesIterator = doodadIndicesByBehaviour.find(behaviourName);
+    if (doodadIndicesIterator == doodadIndicesByBehaviour.end() || doodadIndicesIterator->second.empty()) {
+        return std::nullopt;
+    }
+    return doodadIndicesIterator->second.front();
+}
+
+bool
+SceneFile::isBinary(
+    const std::string& filepath
+) {
+    std::ifstream inputStream(filepath, std::ios::binary);
+    std::array<char, 4> magic {};
+    return inputStream.read(magic.data(), magic.size()) && magic == scene_file_format::magic;
+}
+
+SceneFile::LoadedScene
+SceneFile::load(
+    const std::string& filepath,
+    const BehaviourRegistry& behaviourRegistry
+) {
+    PROFILE_SCOPE("Scene file load");
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Scene);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point startTime = Clock::now();
+
+    LoadedScene loadedScene = SceneFile::isBinary(filepath) ?
+        SceneFile::loadBinary(filepath, behaviourRegistry) :
+        SceneFile::loadText(filepath, behaviourRegistry);
+
+    LOG_INFOthis("Loaded scene {} with {} doodads from {} in {:.2f} ms", loadedScene.sceneParameters.name, loadedScene.sceneParameters.doodadParameters.size(), filepath, std::chrono::duration<double, std::milli>(Clock::now() - startTime).count());
+
+    return loadedScene;
+}
+
+SceneFile::Records
+SceneFile::parseText(
+    const std::string& filepath
+) {
+    std::ifstream inputStream(filepath);
+    if (!inputStream) {
+        throw std::runtime_error("Failed to open scene file " + filepath);
+    }
+
+    Records records {};
+    records.environment.directionalLightDirection = {0.0f, -1.0f, 0.0f};
+    records.environment.skyBoxStringIndices.fill(scene_file_format::noStringIndex);
+
+    std::unordered_map<std::string, uint32_t> stringIndices;
+    const auto internString = [&] (const std::string& string) {
+        const auto [stringIndexIterator, inserted] = stringIndices.try_emplace(string, static_cast<uint32_t>(records.strings.size()));
+        if (inserted) {
+            records.strings.push_back(string);
+        }
+        return stringIndexIterator->second;
+    };
+    records.environment.nameStringIndex = internString(std::filesystem::path(filepath).stem().string());
+
+    std::string line;
+    for (std::size_t lineNumber = 1; std::getline(inputStream, line); ++lineNumber) {
+        LineParser lineParser(filepath, lineNumber, line);
+        if (lineParser.isDone()) {
+            continue;
+        }
+
+        const std::string statement = lineParser.readString("a statement");
+        if (statement == "name") {
+            records.environment.nameStringIndex = internString(lineParser.readString("the scene name"));
+        } else if (statement == "ambient_light") {
+            records.environment.ambientLightColor = lineParser.readVec3("the ambient light color");
+        } else if (statement == "directional_light") {
+            records.environment.directionalLightColor = lineParser.readVec3("the directional light color");
+            records.environment.directionalLightDirection = lineParser.readVec3("the directional light direction");
+        } else if (statement == "point_light") {
+            scene_file_format::PointLightRecord& record = records.pointLights.emplace_back();
+            record.color = lineParser.readVec3("the point light color");
+            record.position = lineParser.readVec3("the point light position");
+            record.attenuationLinearFactor = lineParser.readFloat("the linear attenuation");
+            record.attenuationQuadraticFactor = lineParser.readFloat("the quadratic attenuation");
+        } else if (statement == "spot_light") {
+            scene_file_format::SpotLightRecord& record = records.spotLights.emplace_back();
+            record.color = lineParser.readVec3("the spot light color");
+            record.position = lineParser.readVec3("the spot light position");
+            record.direction = lineParser.readVec3("the spot light direction");
+            record.innerRadiusDegrees = lineParser.readFloat("the inner radius");
+            record.outerRadiusDegrees = lineParser.readFloat("the outer radius");
+            record.attenuationLinearFactor = lineParser.readFloat("the linear attenuation");
+            record.attenuationQuadraticFactor = lineParser.readFloat("the quadratic attenuation");
+        } else if (statement == "clear_color") {
+            records.environment.screenClearColor = lineParser.readVec3("the clear color");
+        } else if (statement == "sky_box") {
+            for (uint32_t& skyBoxStringIndex : records.environment.skyBoxStringIndices) {
+                skyBoxStringIndex = internString(lineParser.readString("six sky box faces"));
+            }
+        } else if (statement == "gravity") {
+            records.environment.hasGravity = 1;
+            records.environment.gravity = lineParser.readVec3("the gravity");
+        } else if (statement == "doodad") {
+            scene_file_format::DoodadRecord& record = records.doodads.emplace_back();
+            record.modelStringIndex = internString(lineParser.readString("the doodad's model"));
+            record.behaviourStringIndex = scene_file_format::noStringIndex;
+            record.rotationAxis = {0.0f, 0.0f, 1.0f};
+            record.scale = {1.0f, 1.0f, 1.0f};
+            record.enableGravity = 1;
+            record.angularLockAxisFactor = {1.0f, 1.0f, 1.0f};
+            record.collidableCategoriesBitMask = 0xFFFF;
+
+            bool hasPosition = false;
+            bool hasShape = false;
+            while (!lineParser.isDone()) {
+                const std::string keyword = lineParser.readString("a doodad keyword");
+                const bool isBodyKeyword = keyword == "gravity" || keyword == "lock" || keyword == "trigger" || keyword == "category" || keyword == "collides" || keyword == "box" || keyword == "sphere";
+                if (isBodyKeyword && !record.hasRigidBody) {
+                    lineParser.fail(fmt::format("{} needs a body before it", keyword));
+                }
+
+                if (keyword == "position") {
+                    record.position = lineParser.readVec3("the position");
+                    hasPosition = true;
+                } else if (keyword == "rotation") {
+                    record.rotationAmount = lineParser.readFloat("the rotation amount");
+                    record.rotationAxis = lineParser.readVec3("the rotation axis");
+                } else if (keyword == "scale") {
+                    record.scale = lineParser.readVec3("the scale");
+                } else if (keyword == "behaviour") {
+                    record.behaviourStringIndex = internString(lineParser.readString("the behaviour name"));
+                } else if (keyword == "body") {
+                    const std::string bodyType = lineParser.readString("the body type");
+                    record.hasRigidBody = 1;
+                    if (bodyType == "static") {
+                        record.bodyType = static_cast<uint8_t>(quartz::physics::RigidBody::BodyType::Static);
+                    } else if (bodyType == "kinematic") {
+                        record.bodyType = static_cast<uint8_t>(quartz::physics::RigidBody::BodyType::Kinematic);
+                    } else if (bodyType == "dynamic") {
+                        record.bodyType = static_cast<uint8_t>(quartz::physics::RigidBody::BodyType::Dynamic);
+                    } else {
+                        lineParser.fail(fmt::format("unknown body type \"{}\"", bodyType));
+                    }
+                } else if (keyword == "gravity") {
+                    record.enableGravity = lineParser.readSwitch("gravity");
+                } else if (keyword == "lock") {
+                    record.angularLockAxisFactor = lineParser.readVec3("the angular lock axis factor");
+                } else if (keyword == "trigger") {
+                    record.isTrigger = lineParser.readSwitch("trigger");
+                } else if (keyword == "category") {
+                    record.categoryBitMask = lineParser.readCategories("the category");
+                } else if (keyword == "collides") {
+                    record.collidableCategoriesBitMask = lineParser.readCategories("the collidable categories");
+                } else if (keyword == "box") {
+                    record.shapeKind = scene_file_format::ShapeKind::box;
+                    record.shapeDimensions = lineParser.readVec3("the box half extents");
+                    hasShape = true;
+                } else if (keyword == "sphere") {
+                    record.shapeKind = scene_file_format::ShapeKind::sphere;
+                    record.shapeDimensions = {lineParser.readFloat("the sphere radius"), 0.0f, 0.0f};
+                    hasShape = true;
+                } else {
+                    lineParser.fail(fmt::format("unknown doodad keyword \"{}\"", keyword));
+                }
+            }
+
+            if (!hasPosition) {
+                lineParser.fail("a doodad needs a position");
+            }
+            if (record.hasRigidBody && !hasShape) {
+                lineParser.fail("a body needs a box or sphere shape");
+            }
+        } else {
+            lineParser.fail(fmt::format("unknown statement \"{}\"", statement));
+        }
+
+        if (!lineParser.isDone()) {
+            lineParser.fail("unexpected trailing tokens");
+        }
+    }
+
+    if (records.environment.skyBoxStringIndices[0] == scene_file_format::noStringIndex) {
+        throw std::runtime_error(filepath + " has no sky_box");
+    }
+
+    return records;
+}
+
+SceneFile::LoadedScene
+SceneFile::loadText(
+    const std::string& filepath,
+    const BehaviourRegistry& behaviourRegistry
+) {
+    const Records records = SceneFile::parseText(filepath);
+
+    SceneBuilder sceneBuilder(filepath, records.strings, behaviourRegistry, records.doodads.size());
+    for (const scene_file_format::DoodadRecord& record : records.doodads) {
+        sceneBuilder.addDoodad(record);
+    }
+
+    return sceneBuilder.finish(records.environment, records.pointLights, records.spotLights);
+}
+
+SceneFile::LoadedScene
+SceneFile::loadBinary(
+    const std::string& filepath,
+    const BehaviourRegistry& behaviourRegistry
+) {
+    std::ifstream inputStream(filepath, std::ios::binary);
+    if (!inputStream) {
+        throw std::runtime_error("Failed to open scene file " + filepath);
+    }
+
+    scene_file_format::Header header;
+    readExactly(inputStream, &header, 1, filepath);
+    if (header.magic != scene_file_format::magic) {
+        throw std::runtime_error(filepath + " is not a binary scene file");
+    }
+    if (header.version != scene_file_format::version) {
+        throw std::runtime_error(fmt::format("{} is version {} but we only read version {}", filepath, header.version, scene_file_format::version));
+    }
+
+    // Every string starts with its byte count, so the string count can be checked before the strings are read
+    const uint64_t fileByteCount = static_cast<uint64_t>(std::filesystem::file_size(filepath));
+    requireRemaining<uint32_t>(inputStream, fileByteCount, header.stringCount, filepath);
+    std::vector<std::string> strings(header.stringCount);
+    for (std::string& string : strings) {
+        uint32_t byteCount = 0;
+        readExactly(inputStream, &byteCount, 1, filepath);
+        requireRemaining<char>(inputStream, fileByteCount, byteCount, filepath);
+        string.resize(byteCount);
+        readExactly(inputStream, string.data(), byteCount, filepath);
+    }
+
+    scene_file_format::EnvironmentRecord environment;
+    readExactly(inputStream, &environment, 1, filepath);
+
+    requireRemaining<scene_file_format::PointLightRecord>(inputStream, fileByteCount, header.pointLightCount, filepath);
+    std::vector<scene_file_format::PointLightRecord> pointLights(header.pointLightCount);
+    readExactly(inputStream, pointLights.data(), pointLights.size(), filepath);
+
+    requireRemaining<scene_file_format::SpotLightRecord>(inputStream, fileByteCount, header.spotLightCount, filepath);
+    std::vector<scene_file_format::SpotLightRecord> spotLights(header.spotLightCount);
+    readExactly(inputStream, spotLights.data(), spotLights.size(), filepath);
+
+    // Only a chunk of the doodad records is ever in memory, each goes straight into its doodad's parameters
+    requireRemaining<scene_file_format::DoodadRecord>(inputStream, fileByteCount, header.doodadCount, filepath);
+    SceneBuilder sceneBuilder(filepath, strings, behaviourRegistry, header.doodadCount);
+    std::vector<scene_file_format::DoodadRecord> doodadRecords(static_cast<std::size_t>(std::min<uint64_t>(header.doodadCount, doodadRecordChunkSize)));
+    for (uint64_t doodadIndex = 0; doodadIndex < header.doodadCount; ) {
+        const std::size_t chunkSize = static_cast<std::size_t>(std::min<uint64_t>(header.doodadCount - doodadIndex, doodadRecordChunkSize));
+        readExactly(inputStream, doodadRecords.data(), chunkSize, filepath);
+        for (std::size_t i = 0; i < chunkSize; ++i) {
+            sceneBuilder.addDoodad(doodadRecords[i]);
+        }
+        doodadIndex += chunkSize;
+    }
+
+    return sceneBuilder.finish(environment, pointLights, spotLights);
+}
+
+void
+SceneFile::compile(
+    const std::string& sceneFilepath,
+    const std::string& binaryFilepath
+) {
+    LOG_FUNCTION_SCOPE_INFOthis("{} -> {}", sceneFilepath, binaryFilepath);
+
+    if (SceneFile::isBinary(sceneFilepath)) {
+        throw std::runtime_error(sceneFilepath + " is already a binary scene file");
+    }
+
+    const Records records = SceneFile::parseText(sceneFilepath);
+
+    std::ofstream outputStream(binaryFilepath, std::ios::binary | std::ios::trunc);
+    if (!outputStream) {
+        throw std::runtime_error("Failed to open " + binaryFilepath + " for writing");
+    }
+
+    const scene_file_format::Header header {
+        scene_file_format::magic,
+        scene_file_format::version,
+        0,
+        static_cast<uint32_t>(records.strings.size()),
+        static_cast<uint32_t>(records.pointLights.size()),
+        static_cast<uint32_t>(records.spotLights.size()),
+        0,
+        records.doodads.size()
+    };
+    writeValues(outputStream, &header, 1);
+
+    for (const std::string& string : records.strings) {
+        const uint32_t byteCount = static_cast<uint32_t>(string.size());
+        writeValues(outputStream, &byteCount, 1);
+        writeValues(outputStream, string.data(), string.size());
+    }
+
+    writeValues(outputStream, &records.environment, 1);
+    writeValues(outputStream, records.pointLights.data(), records.pointLights.size());
+    writeValues(outputStream, records.spotLights.data(), records.spotLights.size());
+    writeValues(outputStream, records.doodads.data(), records.doodads.size());
+
+    if (!outputStream) {
+        throw std::runtime_error("Failed to write " + binaryFilepath);
+    }
+
+    LOG_INFOthis("Compiled {} doodads and {} strings into {}", records.doodads.size(), records.strings.size(), binaryFilepath);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "quartz/scene/scene/Scene.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/scene/BehaviourRegistry.hpp"
+#include "pole_position/scene/SceneFileFormat.hpp"
+
+/**
+ * @brief Loads scenes from files instead of code. Scenes are authored in a text form and compiled into the
+ * binary form described in SceneFileFormat.hpp, which is what large levels should ship as. Both are accepted
+ * anywhere a scene file is; binary files are told apart by their magic bytes.
+ *
+ * The text form has one statement per line, and # starts a comment:
+ *
+ *   name <scene name>
+ *   ambient_light <r g b>
+ *   directional_light <r g b> <direction x y z>
+ *   point_light <r g b> <x y z> <linear attenuation> <quadratic attenuation>
+ *   spot_light <r g b> <x y z> <direction x y z> <inner degrees> <outer degrees> <linear attenuation> <quadratic attenuation>
+ *   clear_color <r g b>
+ *   sky_box <+x> <-x> <+y> <-y> <+z> <-z>
+ *   gravity <x y z>
+ *   doodad <model> position <x y z> [rotation <amount> <axis x y z>] [scale <x y z>] [behaviour <name>] [body ...]
+ *
+ * where body is
+ *
+ *   body <static|kinematic|dynamic> [gravity <on|off>] [lock <x y z>] [trigger <on|off>]
+ *       [category <categories>] [collides <categories>] <box <half x y z> | sphere <radius>>
+ *
+ * Categories are CollisionCategories names joined with |, all, none, all^<categories> or a number. Relative
+ * filepaths are relative to the project directory
+ */
+class SceneFile {
+public: // classes and enums
+    struct LoadedScene {
+        quartz::scene::Scene::Parameters sceneParameters;
+        std::unordered_map<std::string, std::vector<std::size_t>> doodadIndicesByBehaviour;
+
+        std::optional<std::size_t> findFirstDoodadWithBehaviour(const std::string& behaviourName) const;
+    };
+
+public: // member functions
+    /**
+     * @brief Throws if the file cannot be read, is malformed or names a behaviour that is not registered
+     */
+    static LoadedScene load(const std::string& filepath, const BehaviourRegistry& behaviourRegistry);
+
+    /**
+     * @brief Convert a scene file into the binary form. Throws if either file cannot be used
+     */
+    static void compile(const std::string& sceneFilepath, const std::string& binaryFilepath);
+
+    static bool isBinary(const std::string& filepath);
+
+    USE_LOGGER(SCENE_FILE);
+
+private: // classes and enums
+    /**
+     * @brief A whole scene in the records of the binary form
+     */
+    struct Records {
+        scene_file_format::EnvironmentRecord environment;
+        std::vector<std::string> strings;
+        std::vector<scene_file_format::PointLightRecord> pointLights;
+        std::vector<scene_file_format::SpotLightRecord> spotLights;
+        std::vector<scene_file_format::DoodadRecord> doodads;
+    };
+
+private: // helpers
+    static Records parseText(const std::string& filepath);
+    static LoadedScene loadText(const std::string& filepath, const BehaviourRegistry& behaviourRegistry);
+    static LoadedScene loadBinary(const std::string& filepath, const BehaviourRegistry& behaviourRegistry);
+};
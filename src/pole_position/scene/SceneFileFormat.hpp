@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief The layout of a binary scene file.
+ *
+ * A header, a table of every string the scene uses (each a uint32 byte count followed by the bytes), then the
+ * environment, the point lights, the spot lights and finally one fixed size record per doodad. Records refer to
+ * strings by their index in the table, so a model shared by thousands of doodads is stored and resolved once, and
+ * the doodad records can be streamed in without ever holding all of them in memory:
+ *
+ *   Header | strings | EnvironmentRecord | PointLightRecord[] | SpotLightRecord[] | DoodadRecord[]
+ *
+ * Everything is little endian, which is every platform we build for
+ */
+namespace scene_file_format {
+
+constexpr std::array<char, 4> magic = {'P', 'P', 'S', 'C'};
+constexpr uint16_t version = 1;
+
+constexpr uint32_t noStringIndex = std::numeric_limits<uint32_t>::max();
+
+enum class ShapeKind : uint8_t {
+    box = 0,
+    sphere = 1
+};
+
+struct Vec3Record {
+    float x;
+    float y;
+    float z;
+};
+
+struct Header {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t stringCount;
+    uint32_t pointLightCount;
+    uint32_t spotLightCount;
+    uint32_t reserved2;
+    uint64_t doodadCount;
+};
+static_assert(sizeof(Header) == 32);
+
+struct EnvironmentRecord {
+    uint32_t nameStringIndex;
+    Vec3Record ambientLightColor;
+    Vec3Record directionalLightColor;
+    Vec3Record directionalLightDirection;
+    Vec3Record screenClearColor;
+    std::array<uint32_t, 6> skyBoxStringIndices;
+    uint8_t hasGravity;
+    std::array<uint8_t, 3> reserved;
+    Vec3Record gravity;
+};
+static_assert(sizeof(EnvironmentRecord) == 92);
+
+struct PointLightRecord {
+    Vec3Record color;
+    Vec3Record position;
+    float attenuationLinearFactor;
+    float attenuationQuadraticFactor;
+};
+static_assert(sizeof(PointLightRecord) == 32);
+
+struct SpotLightRecord {
+    Vec3Record color;
+    Vec3Record position;
+    Vec3Record direction;
+    float innerRadiusDegrees;
+    float outerRadiusDegrees;
+    float attenuationLinearFactor;
+    float attenuationQuadraticFactor;
+};
+static_assert(sizeof(SpotLightRecord) == 52);
+
+struct DoodadRecord {
+    uint32_t modelStringIndex;
+    uint32_t behaviourStringIndex; // noStringIndex for doodads without a behaviour
+    Vec3Record position;
+    float rotationAmount;
+    Vec3Record rotationAxis;
+    Vec3Record scale;
+
+    // Only meaningful when hasRigidBody is set
+    uint8_t hasRigidBody;
+    uint8_t bodyType; // quartz::physics::RigidBody::BodyType
+    uint8_t enableGravity;
+    uint8_t isTrigger;
+    Vec3Record angularLockAxisFactor;
+    uint16_t categoryBitMask;
+    uint16_t collidableCategoriesBitMask;
+    ShapeKind shapeKind;
+    std::array<uint8_t, 3> reserved;
+    Vec3Record shapeDimensions; // half extents of a box, or the radius of a sphere in x
+};
+static_assert(sizeof(DoodadRecord) == 84);
+
+} // namespace scene_file_format
@@ -1,5 +1,10 @@
+#include <cmath>
+#include <iterator>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "math/transform/Quaternion.hpp"
 #include "math/transform/Vec3.hpp"
 
 #include "util/logger/Logger.hpp"
@@ -10,8 +15,25 @@
 #include "quartz/scene/scene/Scene.hpp"
 
 #include "pole_position/Loggers.hpp"
+#include "pole_position/scene/BehaviourRegistry.hpp"
 #include "pole_position/scene/SceneParameters.hpp"
 #include "pole_position/third_person_controller/ThirdPersonController.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+void
+registerDemoBehaviours(
+    BehaviourRegistry& behaviourRegistry,
+    ThirdPersonController& playerController
+) {
+    behaviourRegistry.registerBehaviour("third_person_controller", {
+        [&playerController] (quartz::scene::Doodad::AwakenCallbackParameters parameters) { playerController.awakenCallback(parameters); },
+        [&playerController] (quartz::scene::Doodad::FixedUpdateCallbackParameters parameters) { playerController.fixedUpdateCallback(parameters); },
+        [&playerController] (quartz::scene::Doodad::UpdateCallbackParameters parameters) { playerController.updateCallback(parameters); },
+        [&playerController] (quartz::physics::Collider::CollisionCallbackParameters parameters) { playerController.collisionStartCallback(parameters); },
+        [&playerController] (quartz::physics::Collider::CollisionCallbackParameters parameters) { playerController.collisionStayCallback(parameters); },
+        [&playerController] (quartz::physics::Collider::CollisionCallbackParameters parameters) { playerController.collisionEndCallback(parameters); }
+    });
+}
 
 quartz::scene::Doodad::Parameters
 createPlayerDoodadParameters(
@@ -70,14 +92,14 @@ createObjectsDoodadParameter() {
                         0xFFFF
                     },
                     quartz::physics::BoxShape::Parameters({1.0f, 1.0f, 1.0f}),
-                    [&] (UNUSED quartz::physics::Collider::CollisionCallbackParameters parameters) { },
-                    [&] (UNUSED quartz::physics::Collider::CollisionCallbackParameters parameters) { },
-                    [&] (UNUSED quartz::physics::Collider::CollisionCallbackParameters parameters) { }
+                    {},
+                    {},
+                    {}
                 }
             }},
-            [&] (UNUSED quartz::scene::Doodad::AwakenCallbackParameters parameters) { },
-            [&] (UNUSED quartz::scene::Doodad::FixedUpdateCallbackParameters parameters) { },
-            [&] (UNUSED quartz::scene::Doodad::UpdateCallbackParameters parameters) { }
+            {},
+            {},
+            {}
         },
 
         // The boombox
@@ -100,14 +122,14 @@ createObjectsDoodadParameter() {
                         0xFFFF
                     },
                     quartz::physics::BoxShape::Parameters({1.0f, 1.0f, 1.0f}),
-                    [&] (UNUSED quartz::physics::Collider::CollisionCallbackParameters parameters) { },
-                    [&] (UNUSED quartz::physics::Collider::CollisionCallbackParameters parameters) { },
-                    [&] (UNUSED quartz::physics::Collider::CollisionCallbackParameters parameters) { }
+                    {},
+                    {},
+                    {}
                 }
             }},
-            [&] (UNUSED quartz::scene::Doodad::AwakenCallbackParameters parameters) { },
-            [&] (UNUSED quartz::scene::Doodad::FixedUpdateCallbackParameters parameters) { },
-            [&] (UNUSED quartz::scene::Doodad::UpdateCallbackParameters parameters) { }
+            {},
+            {},
+            {}
         },
     };
 }
@@ -147,17 +169,105 @@ createTerrainDoodadParameter() {
     };
 }
 
-quartz::scene::Scene::Parameters
-createDemoLevelSceneParameters(
-    ThirdPersonController& playerController
+VehicleParameters
+createRaceCarVehicleParameters() {
+    return {
+        1200.0,
+        math::Vec3(0.9, 0.35, 2.2),
+        math::Vec3(0.0, -0.3, 0.0),
+        {
+            {math::Vec3(-0.8, -0.35, 1.4), true, false},
+            {math::Vec3(0.8, -0.35, 1.4), true, false},
+            {math::Vec3(-0.8, -0.35, -1.4), false, true},
+            {math::Vec3(0.8, -0.35, -1.4), false, true}
+        },
+        0.33,
+        1.2,
+        0.3,
+        30000.0,
+        2500.0,
+        20000.0,
+        static_cast<uint16_t>(0xFFFF ^ static_cast<uint16_t>(CollisionCategories::Vehicle)),
+        1.1,
+        10.0,
+        12.0,
+        0.5,
+        400.0,
+        1000.0,
+        7500.0,
+        6800.0,
+        3000.0,
+        {3.2, 2.2, 1.6, 1.25, 1.0, 0.82},
+        3.9,
+        2500.0
+    };
+}
+
+quartz::scene::Doodad::Parameters
+createVehicleDoodadParameters(
+    const VehicleParameters& vehicleParameters,
+    const math::Vec3& position,
+    const double heading_rad
 ) {
-    std::vector<quartz::scene::Doodad::Parameters> objectsDoodadParameters = createObjectsDoodadParameter();
-    std::vector<quartz::scene::Doodad::Parameters> terrainDoodadParameters = createTerrainDoodadParameter();
-    std::vector<quartz::scene::Doodad::Parameters> doodadParameters = { createPlayerDoodadParameters(playerController) };
-    doodadParameters.reserve(doodadParameters.size() + objectsDoodadParameters.size() + terrainDoodadParameters.size());
-    doodadParameters.insert(doodadParameters.end(), objectsDoodadParameters.begin(), objectsDoodadParameters.end());
-    doodadParameters.insert(doodadParameters.end(), terrainDoodadParameters.begin(), terrainDoodadParameters.end());
+    const math::Vec3& halfExtents_m = vehicleParameters.chassisHalfExtents_m;
+
+    quartz::scene::Doodad::Parameters parameters(
+        util::FileSystem::getAbsoluteFilepathInProjectDirectory("assets/models/unit_models/unit_cube/glb/unit_cube.glb"),
+        {
+            position,
+            0.0f,
+            { 0.0f, 1.0f, 0.0f },
+            halfExtents_m
+        },
+        {{
+            quartz::physics::RigidBody::BodyType::Dynamic,
+            true,
+            math::Vec3(1.0, 1.0, 1.0),
+            {
+                false,
+                {
+                    static_cast<uint16_t>(CollisionCategories::Vehicle),
+                    0xFFFF
+                },
+                quartz::physics::BoxShape::Parameters(halfExtents_m),
+                {},
+                {},
+                {}
+            }
+        }},
+        {},
+        {},
+        {}
+    );
+    parameters.transform.rotation = math::Quaternion(std::cos(heading_rad * 0.5), 0.0, std::sin(heading_rad * 0.5), 0.0);
+
+    return parameters;
+}
+
+quartz::scene::Doodad::Parameters
+createGhostDoodadParameters(
+    const math::Vec3& halfExtents_m
+) {
+    return quartz::scene::Doodad::Parameters(
+        util::FileSystem::getAbsoluteFilepathInProjectDirectory("assets/models/unit_models/unit_cube/glb/unit_cube.glb"),
+        {
+            math::Vec3(0.0, 0.0, 0.0),
+            0.0f,
+            { 0.0f, 1.0f, 0.0f },
+            halfExtents_m
+        },
+        {},
+        {},
+        {},
+        {}
+    );
+}
 
+quartz::scene::Scene::Parameters
+createDemoEnvironmentSceneParameters(
+    const std::string& name,
+    std::vector<quartz::scene::Doodad::Parameters> doodadParameters
+) {
     quartz::scene::AmbientLight ambientLight({ 0.1f, 0.1f, 0.1f });
 
     quartz::scene::DirectionalLight directionalLight({ 0.5f, 0.5f, 0.5f }, { 3.0f, -2.0f, 2.0f });
@@ -180,15 +290,28 @@ createDemoLevelSceneParameters(
     std::optional<quartz::physics::Field::Parameters> o_fieldParameters({{0.0, -1.0, 0.0}});
 
     return { 
-        "default_test_scene_00",
+        name,
         ambientLight,
         directionalLight,
         pointLights,
         spotLights,
         screenClearColor,
         skyBoxInformation,
-        doodadParameters,
+        std::move(doodadParameters),
         o_fieldParameters
     };
 }
 
+quartz::scene::Scene::Parameters
+createDemoLevelSceneParameters(
+    ThirdPersonController& playerController
+) {
+    std::vector<quartz::scene::Doodad::Parameters> objectsDoodadParameters = createObjectsDoodadParameter();
+    std::vector<quartz::scene::Doodad::Parameters> terrainDoodadParameters = createTerrainDoodadParameter();
+    std::vector<quartz::scene::Doodad::Parameters> doodadParameters = { createPlayerDoodadParameters(playerController) };
+    doodadParameters.reserve(doodadParameters.size() + objectsDoodadParameters.size() + terrainDoodadParameters.size());
+    doodadParameters.insert(doodadParameters.end(), std::make_move_iterator(objectsDoodadParameters.begin()), std::make_move_iterator(objectsDoodadParameters.end()));
+    doodadParameters.insert(doodadParameters.end(), std::make_move_iterator(terrainDoodadParameters.begin()), std::make_move_iterator(terrainDoodadParameters.end()));
+
+    return createDemoEnvironmentSceneParameters("default_test_scene_00", std::move(doodadParameters));
+}
@@ -1,18 +1,34 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
+#include "math/transform/Vec3.hpp"
+
 #include "quartz/scene/scene/Scene.hpp"
 
+#include "pole_position/scene/BehaviourRegistry.hpp"
 #include "pole_position/third_person_controller/ThirdPersonController.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
 
 enum class CollisionCategories : uint16_t {
     Default         = 0b0000000000000000,
     Player          = 0b0000000000000001,
     Terrain         = 0b0000000000000010,
     Interactable    = 0b0000000000000100,
+    Vehicle         = 0b0000000000001000,
 };
 
+/**
+ * @brief Register the behaviours scene files can give doodads, which is the player's controller as
+ * "third_person_controller"
+ */
+void
+registerDemoBehaviours(
+    BehaviourRegistry& behaviourRegistry,
+    ThirdPersonController& playerController
+);
+
 quartz::scene::Doodad::Parameters
 createPlayerDoodadParameters(
     ThirdPersonController& playerController
@@ -24,6 +40,41 @@ createObjectsDoodadParameter();
 std::vector<quartz::scene::Doodad::Parameters>
 createTerrainDoodadParameter();
 
+/**
+ * @brief A rear wheel drive car of about 1200 kg, whose wheels ride on anything but other vehicles
+ */
+VehicleParameters
+createRaceCarVehicleParameters();
+
+/**
+ * @brief A vehicle's chassis, a dynamic box of the vehicle's size in the Vehicle category. Its heading is measured
+ * around +y from +z toward +x
+ */
+quartz::scene::Doodad::Parameters
+createVehicleDoodadParameters(
+    const VehicleParameters& vehicleParameters,
+    const math::Vec3& position,
+    const double heading_rad
+);
+
+/**
+ * @brief A ghost, a box of the given size without a rigid body, which only moves where a GhostPlayback puts it
+ */
+quartz::scene::Doodad::Parameters
+createGhostDoodadParameters(
+    const math::Vec3& halfExtents_m
+);
+
+/**
+ * @brief The demo level's lights, sky box and gravity around an arbitrary set of doodads. Takes the doodads by
+ * value so callers that are done with theirs can move them in instead of copying every callback
+ */
+quartz::scene::Scene::Parameters
+createDemoEnvironmentSceneParameters(
+    const std::string& name,
+    std::vector<quartz::scene::Doodad::Parameters> doodadParameters
+);
+
 quartz::scene::Scene::Parameters
 createDemoLevelSceneParameters(
     ThirdPersonController& playerController
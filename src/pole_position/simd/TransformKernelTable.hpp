@@ -0,0 +1,21 @@
+#pragma once
+
+#include <span>
+
+#include "pole_position/simd/TransformKernels.hpp"
+
+/**
+ * @brief One instruction set's build of the kernels. Each instruction set lives in its own translation unit so
+ * that only that file is compiled for it, and its getter returns nullptr when the compiler could not target it
+ */
+struct TransformKernelTable {
+    void (*normalize)(const ConstVec3Soa& vectors, const Vec3Soa& normalizedVectors);
+    void (*cross)(const ConstVec3Soa& lhs, const ConstVec3Soa& rhs, const Vec3Soa& products);
+    void (*rotate)(const ConstQuaternionSoa& rotations, const ConstVec3Soa& vectors, const Vec3Soa& rotatedVectors);
+    void (*composeTrs)(const ConstVec3Soa& translations, const ConstQuaternionSoa& rotations, const ConstVec3Soa& scales, std::span<Matrix4> matrices);
+    void (*composeInverseTrs)(const ConstVec3Soa& translations, const ConstQuaternionSoa& rotations, const ConstVec3Soa& scales, std::span<Matrix4> matrices);
+};
+
+const TransformKernelTable* getScalarTransformKernelTable();
+const TransformKernelTable* getSse2TransformKernelTable();
+const TransformKernelTable* getAvx2TransformKernelTable();
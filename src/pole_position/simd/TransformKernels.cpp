@@ -0,0 +1,134 @@
+#include <span>
+
+#include "util/macros.hpp"
+
+#include "pole_position/simd/TransformKernelTable.hpp"
+#include "pole_position/simd/TransformKernels.hpp"
+#include "pole_position/simd/TransformKernelsImpl.hpp"
+
+namespace {
+
+const TransformKernelTable*
+getTable(
+    const TransformKernels::InstructionSet instructionSet
+) {
+    switch (instructionSet) {
+        case TransformKernels::InstructionSet::Scalar:
+            return getScalarTransformKernelTable();
+        case TransformKernels::InstructionSet::Sse2:
+            return getSse2TransformKernelTable();
+        case TransformKernels::InstructionSet::Avx2:
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            // The AVX2 kernels can be compiled in on any x86 machine, but can only run on one that has AVX2
+            return __builtin_cpu_supports("avx2") ? getAvx2TransformKernelTable() : nullptr;
+#else
+            return getAvx2TransformKernelTable();
+#endif
+    }
+
+    return nullptr;
+}
+
+TransformKernels::InstructionSet
+getBestSupportedInstructionSet() {
+    if (getTable(TransformKernels::InstructionSet::Avx2)) {
+        return TransformKernels::InstructionSet::Avx2;
+    }
+
+    if (getTable(TransformKernels::InstructionSet::Sse2)) {
+        return TransformKernels::InstructionSet::Sse2;
+    }
+
+    return TransformKernels::InstructionSet::Scalar;
+}
+
+} // namespace
+
+const TransformKernelTable*
+getScalarTransformKernelTable() {
+    return getTransformKernelTable<ScalarLanes>();
+}
+
+bool
+TransformKernels::isSupported(
+    const InstructionSet instructionSet
+) {
+    return getTable(instructionSet) != nullptr;
+}
+
+const char*
+TransformKernels::getInstructionSetName(
+    const InstructionSet instructionSet
+) {
+    switch (instructionSet) {
+        case InstructionSet::Scalar:
+            return "scalar";
+        case InstructionSet::Sse2:
+            return "sse2";
+        case InstructionSet::Avx2:
+            return "avx2";
+    }
+
+    return "unknown";
+}
+
+TransformKernels::TransformKernels() :
+    m_instructionSet(getBestSupportedInstructionSet())
+{}
+
+TransformKernels::TransformKernels(
+    const InstructionSet instructionSet
+) :
+    m_instructionSet(TransformKernels::isSupported(instructionSet) ? instructionSet : getBestSupportedInstructionSet())
+{}
+
+void
+TransformKernels::normalize(
+    const ConstVec3Soa& vectors,
+    const Vec3Soa& normalizedVectors
+) const {
+    QUARTZ_ASSERT(normalizedVectors.size() == vectors.size(), "Output size must match input size");
+    getTable(m_instructionSet)->normalize(vectors, normalizedVectors);
+}
+
+void
+TransformKernels::cross(
+    const ConstVec3Soa& lhs,
+    const ConstVec3Soa& rhs,
+    const Vec3Soa& products
+) const {
+    QUARTZ_ASSERT(rhs.size() == lhs.size() && products.size() == lhs.size(), "All inputs and outputs must be the same size");
+    getTable(m_instructionSet)->cross(lhs, rhs, products);
+}
+
+void
+TransformKernels::rotate(
+    const ConstQuaternionSoa& rotations,
+    const ConstVec3Soa& vectors,
+    const Vec3Soa& rotatedVectors
+) const {
+    QUARTZ_ASSERT(rotations.size() == vectors.size() && rotatedVectors.size() == vectors.size(), "All inputs and outputs must be the same size");
+    getTable(m_instructionSet)->rotate(rotations, vectors, rotatedVectors);
+}
+
+void
+TransformKernels::composeTrs(
+    const ConstVec3Soa& translations,
+    const ConstQuaternionSoa& rotations,
+    const ConstVec3Soa& scales,
+    std::span<Matrix4> matrices
+) const {
+    QUARTZ_ASSERT(rotations.size() == translations.size() && scales.size() == translations.size() && matrices.size() == translations.size(), "All inputs and outputs must be the same size");
+    getTable(m_instructionSet)->composeTrs(translations, rotations, scales, matrices);
+}
+
+void
+TransformKernels::composeInverseTrs(
+    const ConstVec3Soa& translations,
+    const ConstQuaternionSoa& rotations,
+    const ConstVec3Soa& scales,
+    std::span<Matrix4> matrices
+) const {
+    QUARTZ_ASSERT(rotations.size() == translations.size() && scales.size() == translations.size() && matrices.size() == translations.size(), "All inputs and outputs must be the same size");
+    getTable(m_instructionSet)->composeInverseTrs(translations, rotations, scales, matrices);
+}
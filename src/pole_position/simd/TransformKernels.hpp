@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+/**
+ * @brief Views of vectors and quaternions stored as structure of arrays, one span per component. All spans of a
+ * view must be the same size
+ */
+struct Vec3Soa {
+    std::size_t size() const { return x.size(); }
+
+    std::span<double> x;
+    std::span<double> y;
+    std::span<double> z;
+};
+
+struct ConstVec3Soa {
+    ConstVec3Soa(std::span<const double> x_, std::span<const double> y_, std::span<const double> z_) : x(x_), y(y_), z(z_) {}
+    ConstVec3Soa(const Vec3Soa& vec3Soa) : x(vec3Soa.x), y(vec3Soa.y), z(vec3Soa.z) {}
+
+    std::size_t size() const { return x.size(); }
+
+    std::span<const double> x;
+    std::span<const double> y;
+    std::span<const double> z;
+};
+
+struct ConstQuaternionSoa {
+    std::size_t size() const { return w.size(); }
+
+    std::span<const double> w;
+    std::span<const double> x;
+    std::span<const double> y;
+    std::span<const double> z;
+};
+
+/**
+ * @brief Column major, the layout the renderer uploads
+ */
+struct Matrix4 {
+    std::array<double, 16> elements;
+};
+
+/**
+ * @brief Batched transform math over structure of arrays data, for the places that do the same math::Vec3 and
+ * math::Quaternion operations for every doodad. Each kernel is built for SSE2 and AVX2 as well as plain scalar
+ * code, and the best one the CPU supports is picked at runtime. The vector kernels give results that are within a
+ * few epsilon of the scalar math::Vec3 operations, but not always bit for bit equal to them, since the compiler
+ * is free to fuse multiplies and adds in the wider kernels.
+ *
+ * Outputs may alias inputs of the same kind, so normalize(v, v) normalizes in place. Rotations must be unit
+ * quaternions and scales must not have a zero component when inverting
+ */
+class TransformKernels {
+public: // classes and enums
+    enum class InstructionSet {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+public: // member functions
+    /**
+     * @brief Uses the widest instruction set the CPU supports, or the given one if it is supported
+     */
+    TransformKernels();
+    explicit TransformKernels(const InstructionSet instructionSet);
+
+    InstructionSet getInstructionSet() const { return m_instructionSet; }
+
+    /**
+     * @brief Zero length vectors are left as they are
+     */
+    void normalize(const ConstVec3Soa& vectors, const Vec3Soa& normalizedVectors) const;
+    void cross(const ConstVec3Soa& lhs, const ConstVec3Soa& rhs, const Vec3Soa& products) const;
+    void rotate(const ConstQuaternionSoa& rotations, const ConstVec3Soa& vectors, const Vec3Soa& rotatedVectors) const;
+
+    /**
+     * @brief The matrix that scales, then rotates, then translates, and its inverse
+     */
+    void composeTrs(const ConstVec3Soa& translations, const ConstQuaternionSoa& rotations, const ConstVec3Soa& scales, std::span<Matrix4> matrices) const;
+    void composeInverseTrs(const ConstVec3Soa& translations, const ConstQuaternionSoa& rotations, const ConstVec3Soa& scales, std::span<Matrix4> matrices) const;
+
+    static bool isSupported(const InstructionSet instructionSet);
+    static const char* getInstructionSetName(const InstructionSet instructionSet);
+
+private: // member variables
+    InstructionSet m_instructionSet;
+};
@@ -0,0 +1,44 @@
+#include "pole_position/simd/TransformKernelTable.hpp"
+
+// Only this file is compiled with AVX2 enabled, and its kernels are only called once the CPU has been checked
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+#include "pole_position/simd/TransformKernelsImpl.hpp"
+
+namespace {
+
+struct Avx2Lanes {
+    using Register = __m256d;
+    static constexpr std::size_t width = 4;
+
+    static Register load(const double* const p_values) { return _mm256_loadu_pd(p_values); }
+    static void store(double* const p_values, const Register value) { _mm256_storeu_pd(p_values, value); }
+    static Register broadcast(const double value) { return _mm256_set1_pd(value); }
+    static Register add(const Register lhs, const Register rhs) { return _mm256_add_pd(lhs, rhs); }
+    static Register subtract(const Register lhs, const Register rhs) { return _mm256_sub_pd(lhs, rhs); }
+    static Register multiply(const Register lhs, const Register rhs) { return _mm256_mul_pd(lhs, rhs); }
+    static Register divide(const Register lhs, const Register rhs) { return _mm256_div_pd(lhs, rhs); }
+    static Register squareRoot(const Register value) { return _mm256_sqrt_pd(value); }
+
+    static Register selectPositive(const Register condition, const Register ifPositive, const Register otherwise) {
+        return _mm256_blendv_pd(otherwise, ifPositive, _mm256_cmp_pd(condition, _mm256_setzero_pd(), _CMP_GT_OQ));
+    }
+};
+
+} // namespace
+
+const TransformKernelTable*
+getAvx2TransformKernelTable() {
+    return getTransformKernelTable<Avx2Lanes>();
+}
+
+#else
+
+const TransformKernelTable*
+getAvx2TransformKernelTable() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+#include "pole_position/simd/TransformKernelTable.hpp"
+#include "pole_position/simd/TransformKernels.hpp"
+
+/**
+ * @brief The kernels, written once against a Lanes type that says how many doubles go in a register and how to
+ * do arithmetic on them. Included only by the TransformKernels*.cpp files, each of which instantiates them for its
+ * own instruction set. Everything here has internal linkage, so that the AVX2 file's copies, which are compiled
+ * for AVX2, can never be picked by the linker for a caller in another file
+ */
+namespace {
+
+struct ScalarLanes {
+    using Register = double;
+    static constexpr std::size_t width = 1;
+
+    static Register load(const double* const p_values) { return *p_values; }
+    static void store(double* const p_values, const Register value) { *p_values = value; }
+    static Register broadcast(const double value) { return value; }
+    static Register add(const Register lhs, const Register rhs) { return lhs + rhs; }
+    static Register subtract(const Register lhs, const Register rhs) { return lhs - rhs; }
+    static Register multiply(const Register lhs, const Register rhs) { return lhs * rhs; }
+    static Register divide(const Register lhs, const Register rhs) { return lhs / rhs; }
+    static Register squareRoot(const Register value) { return std::sqrt(value); }
+
+    /**
+     * @brief ifPositive where condition is greater than zero, otherwise where it is not
+     */
+    static Register selectPositive(const Register condition, const Register ifPositive, const Register otherwise) { return condition > 0.0 ? ifPositive : otherwise; }
+};
+
+/**
+ * @brief Runs kernel<Lanes>(i) for every batch of Lanes::width elements starting at i, and kernel<ScalarLanes>(i)
+ * for each of the elements left over
+ */
+template<typename Lanes, typename Kernel>
+void
+forEachBatch(
+    const std::size_t count,
+    const Kernel& kernel
+) {
+    std::size_t i = 0;
+    for (; i + Lanes::width <= count; i += Lanes::width) {
+        kernel.template operator()<Lanes>(i);
+    }
+    for (; i < count; ++i) {
+        kernel.template operator()<ScalarLanes>(i);
+    }
+}
+
+template<typename Lanes>
+struct Vec3Registers {
+    typename Lanes::Register x;
+    typename Lanes::Register y;
+    typename Lanes::Register z;
+
+    static Vec3Registers load(const ConstVec3Soa& vectors, const std::size_t i) {
+        return {Lanes::load(&vectors.x[i]), Lanes::load(&vectors.y[i]), Lanes::load(&vectors.z[i])};
+    }
+
+    void store(const Vec3Soa& vectors, const std::size_t i) const {
+        Lanes::store(&vectors.x[i], x);
+        Lanes::store(&vectors.y[i], y);
+        Lanes::store(&vectors.z[i], z);
+    }
+
+    Vec3Registers cross(const Vec3Registers& rhs) const {
+        return {
+            Lanes::subtract(Lanes::multiply(y, rhs.z), Lanes::multiply(z, rhs.y)),
+            Lanes::subtract(Lanes::multiply(z, rhs.x), Lanes::multiply(x, rhs.z)),
+            Lanes::subtract(Lanes::multiply(x, rhs.y), Lanes::multiply(y, rhs.x))
+        };
+    }
+};
+
+/**
+ * @brief Plain arrays rather than std::array, since vector registers lose their alignment attributes as template
+ * arguments
+ */
+template<typename Lanes>
+struct RotationMatrixRegisters {
+    // Rows then columns
+    typename Lanes::Register elements[3][3];
+};
+
+template<typename Lanes>
+struct AffineMatrixRegisters {
+    // The upper three rows, the bottom row of every matrix being 0 0 0 1
+    typename Lanes::Register elements[3][4];
+};
+
+/**
+ * @brief The rotation matrix of a batch of unit quaternions
+ */
+template<typename Lanes>
+RotationMatrixRegisters<Lanes>
+loadRotationMatrix(
+    const ConstQuaternionSoa& rotations,
+    const std::size_t i
+) {
+    using L = Lanes;
+
+    const typename L::Register w = L::load(&rotations.w[i]);
+    const typename L::Register x = L::load(&rotations.x[i]);
+    const typename L::Register y = L::load(&rotations.y[i]);
+    const typename L::Register z = L::load(&rotations.z[i]);
+    const typename L::Register one = L::broadcast(1.0);
+    const typename L::Register two = L::broadcast(2.0);
+
+    const typename L::Register xx = L::multiply(x, x);
+    const typename L::Register yy = L::multiply(y, y);
+    const typename L::Register zz = L::multiply(z, z);
+    const typename L::Register xy = L::multiply(x, y);
+    const typename L::Register xz = L::multiply(x, z);
+    const typename L::Register yz = L::multiply(y, z);
+    const typename L::Register wx = L::multiply(w, x);
+    const typename L::Register wy = L::multiply(w, y);
+    const typename L::Register wz = L::multiply(w, z);
+
+    return {{
+        {L::subtract(one, L::multiply(two, L::add(yy, zz))), L::multiply(two, L::subtract(xy, wz)), L::multiply(two, L::add(xz, wy))},
+        {L::multiply(two, L::add(xy, wz)), L::subtract(one, L::multiply(two, L::add(xx, zz))), L::multiply(two, L::subtract(yz, wx))},
+        {L::multiply(two, L::subtract(xz, wy)), L::multiply(two, L::add(yz, wx)), L::subtract(one, L::multiply(two, L::add(xx, yy)))}
+    }};
+}
+
+template<typename Lanes>
+void
+storeAffineMatrices(
+    const AffineMatrixRegisters<Lanes>& matrixRegisters,
+    std::span<Matrix4> matrices,
+    const std::size_t i
+) {
+    std::array<std::array<std::array<double, Lanes::width>, 4>, 3> values;
+    for (std::size_t row = 0; row < 3; ++row) {
+        for (std::size_t column = 0; column < 4; ++column) {
+            Lanes::store(values[row][column].data(), matrixRegisters.elements[row][column]);
+        }
+    }
+
+    for (std::size_t lane = 0; lane < Lanes::width; ++lane) {
+        std::array<double, 16>& elements = matrices[i + lane].elements;
+        for (std::size_t column = 0; column < 4; ++column) {
+            elements[column * 4 + 0] = values[0][column][lane];
+            elements[column * 4 + 1] = values[1][column][lane];
+            elements[column * 4 + 2] = values[2][column][lane];
+            elements[column * 4 + 3] = column == 3 ? 1.0 : 0.0;
+        }
+    }
+}
+
+template<typename Lanes>
+void
+normalizeKernel(
+    const ConstVec3Soa& vectors,
+    const Vec3Soa& normalizedVectors
+) {
+    forEachBatch<Lanes>(vectors.size(), [&] <typename L> (const std::size_t i) {
+        const Vec3Registers<L> vector = Vec3Registers<L>::load(vectors, i);
+        const typename L::Register magnitude = L::squareRoot(L::add(L::add(L::multiply(vector.x, vector.x), L::multiply(vector.y, vector.y)), L::multiply(vector.z, vector.z)));
+        const Vec3Registers<L> normalizedVector {
+            L::selectPositive(magnitude, L::divide(vector.x, magnitude), vector.x),
+            L::selectPositive(magnitude, L::divide(vector.y, magnitude), vector.y),
+            L::selectPositive(magnitude, L::divide(vector.z, magnitude), vector.z)
+        };
+        normalizedVector.store(normalizedVectors, i);
+    });
+}
+
+template<typename Lanes>
+void
+crossKernel(
+    const ConstVec3Soa& lhs,
+    const ConstVec3Soa& rhs,
+    const Vec3Soa& products
+) {
+    forEachBatch<Lanes>(lhs.size(), [&] <typename L> (const std::size_t i) {
+        Vec3Registers<L>::load(lhs, i).cross(Vec3Registers<L>::load(rhs, i)).store(products, i);
+    });
+}
+
+template<typename Lanes>
+void
+rotateKernel(
+    const ConstQuaternionSoa& rotations,
+    const ConstVec3Soa& vectors,
+    const Vec3Soa& rotatedVectors
+) {
+    // v + w t + q x t with t = 2 (q x v), where q is the quaternion's vector part. Cheaper than building the matrix
+    // when every vector has its own rotation
+    forEachBatch<Lanes>(vectors.size(), [&] <typename L> (const std::size_t i) {
+        const Vec3Registers<L> vector = Vec3Registers<L>::load(vectors, i);
+        const Vec3Registers<L> axis {L::load(&rotations.x[i]), L::load(&rotations.y[i]), L::load(&rotations.z[i])};
+        const typename L::Register w = L::load(&rotations.w[i]);
+        const typename L::Register two = L::broadcast(2.0);
+
+        const Vec3Registers<L> axisCrossVector = axis.cross(vector);
+        const Vec3Registers<L> t {L::multiply(two, axisCrossVector.x), L::multiply(two, axisCrossVector.y), L::multiply(two, axisCrossVector.z)};
+        const Vec3Registers<L> axisCrossT = axis.cross(t);
+
+        const Vec3Registers<L> rotatedVector {
+            L::add(L::add(vector.x, L::multiply(w, t.x)), axisCrossT.x),
+            L::add(L::add(vector.y, L::multiply(w, t.y)), axisCrossT.y),
+            L::add(L::add(vector.z, L::multiply(w, t.z)), axisCrossT.z)
+        };
+        rotatedVector.store(rotatedVectors, i);
+    });
+}
+
+template<typename Lanes>
+void
+composeTrsKernel(
+    const ConstVec3Soa& translations,
+    const ConstQuaternionSoa& rotations,
+    const ConstVec3Soa& scales,
+    std::span<Matrix4> matrices
+) {
+    // R S in the upper left, so column j is column j of R scaled by the jth scale
+    forEachBatch<Lanes>(translations.size(), [&] <typename L> (const std::size_t i) {
+        const RotationMatrixRegisters<L> rotation = loadRotationMatrix<L>(rotations, i);
+        const Vec3Registers<L> scale = Vec3Registers<L>::load(scales, i);
+        const Vec3Registers<L> translation = Vec3Registers<L>::load(translations, i);
+
+        const typename L::Register translationComponents[3] = {translation.x, translation.y, translation.z};
+
+        AffineMatrixRegisters<L> matrixRegisters;
+        for (std::size_t row = 0; row < 3; ++row) {
+            matrixRegisters.elements[row][0] = L::multiply(rotation.elements[row][0], scale.x);
+            matrixRegisters.elements[row][1] = L::multiply(rotation.elements[row][1], scale.y);
+            matrixRegisters.elements[row][2] = L::multiply(rotation.elements[row][2], scale.z);
+            matrixRegisters.elements[row][3] = translationComponents[row];
+        }
+
+        storeAffineMatrices<L>(matrixRegisters, matrices, i);
+    });
+}
+
+template<typename Lanes>
+void
+composeInverseTrsKernel(
+    const ConstVec3Soa& translations,
+    const ConstQuaternionSoa& rotations,
+    const ConstVec3Soa& scales,
+    std::span<Matrix4> matrices
+) {
+    // The inverse of T R S is S^-1 R^T T^-1, so row i of the upper left is column i of R divided by the ith scale,
+    // and the translation is that applied to -t
+    forEachBatch<Lanes>(translations.size(), [&] <typename L> (const std::size_t i) {
+        const RotationMatrixRegisters<L> rotation = loadRotationMatrix<L>(rotations, i);
+        const Vec3Registers<L> scale = Vec3Registers<L>::load(scales, i);
+        const Vec3Registers<L> translation = Vec3Registers<L>::load(translations, i);
+        const typename L::Register one = L::broadcast(1.0);
+        const typename L::Register inverseScales[3] = {L::divide(one, scale.x), L::divide(one, scale.y), L::divide(one, scale.z)};
+
+        AffineMatrixRegisters<L> matrixRegisters;
+        for (std::size_t row = 0; row < 3; ++row) {
+            const typename L::Register column0 = L::multiply(rotation.elements[0][row], inverseScales[row]);
+            const typename L::Register column1 = L::multiply(rotation.elements[1][row], inverseScales[row]);
+            const typename L::Register column2 = L::multiply(rotation.elements[2][row], inverseScales[row]);
+            const typename L::Register rotatedTranslation = L::add(L::add(L::multiply(column0, translation.x), L::multiply(column1, translation.y)), L::multiply(column2, translation.z));
+            matrixRegisters.elements[row][0] = column0;
+            matrixRegisters.elements[row][1] = column1;
+            matrixRegisters.elements[row][2] = column2;
+            matrixRegisters.elements[row][3] = L::subtract(L::broadcast(0.0), rotatedTranslation);
+        }
+
+        storeAffineMatrices<L>(matrixRegisters, matrices, i);
+    });
+}
+
+template<typename Lanes>
+const TransformKernelTable*
+getTransformKernelTable() {
+    static const TransformKernelTable transformKernelTable {
+        &normalizeKernel<Lanes>,
+        &crossKernel<Lanes>,
+        &rotateKernel<Lanes>,
+        &composeTrsKernel<Lanes>,
+        &composeInverseTrsKernel<Lanes>
+    };
+    return &transformKernelTable;
+}
+
+} // namespace
@@ -0,0 +1,44 @@
+#include "pole_position/simd/TransformKernelTable.hpp"
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#include "pole_position/simd/TransformKernelsImpl.hpp"
+
+namespace {
+
+struct Sse2Lanes {
+    using Register = __m128d;
+    static constexpr std::size_t width = 2;
+
+    static Register load(const double* const p_values) { return _mm_loadu_pd(p_values); }
+    static void store(double* const p_values, const Register value) { _mm_storeu_pd(p_values, value); }
+    static Register broadcast(const double value) { return _mm_set1_pd(value); }
+    static Register add(const Register lhs, const Register rhs) { return _mm_add_pd(lhs, rhs); }
+    static Register subtract(const Register lhs, const Register rhs) { return _mm_sub_pd(lhs, rhs); }
+    static Register multiply(const Register lhs, const Register rhs) { return _mm_mul_pd(lhs, rhs); }
+    static Register divide(const Register lhs, const Register rhs) { return _mm_div_pd(lhs, rhs); }
+    static Register squareRoot(const Register value) { return _mm_sqrt_pd(value); }
+
+    static Register selectPositive(const Register condition, const Register ifPositive, const Register otherwise) {
+        const Register mask = _mm_cmpgt_pd(condition, _mm_setzero_pd());
+        return _mm_or_pd(_mm_and_pd(mask, ifPositive), _mm_andnot_pd(mask, otherwise));
+    }
+};
+
+} // namespace
+
+const TransformKernelTable*
+getSse2TransformKernelTable() {
+    return getTransformKernelTable<Sse2Lanes>();
+}
+
+#else
+
+const TransformKernelTable*
+getSse2TransformKernelTable() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cmath>
+
+#include "math/transform/Quaternion.hpp"
+
+/**
+ * @brief Interpolation between two recorded states of a doodad, shared by everything that presents doodads
+ * between ticks or between the frames of a trajectory
+ */
+
+/**
+ * @brief Normalized lerp, through whichever of to and -to is closer. Across a tick or so the angle is small enough
+ * that the difference from a slerp is not visible
+ */
+inline math::Quaternion
+interpolateRotation(
+    const math::Quaternion& from,
+    const math::Quaternion& to,
+    const double factor
+) {
+    const double dot = from.w * to.w + from.x * to.x + from.y * to.y + from.z * to.z;
+    const double toSign = dot < 0.0 ? -1.0 : 1.0;
+
+    const double w = from.w + (toSign * to.w - from.w) * factor;
+    const double x = from.x + (toSign * to.x - from.x) * factor;
+    const double y = from.y + (toSign * to.y - from.y) * factor;
+    const double z = from.z + (toSign * to.z - from.z) * factor;
+    const double magnitude = std::sqrt(w * w + x * x + y * y + z * z);
+
+    return magnitude > 0.0 ? math::Quaternion(w / magnitude, x / magnitude, y / magnitude, z / magnitude) : to;
+}
@@ -0,0 +1,103 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/asset_loading/MappedFile.hpp"
+#include "pole_position/snapshot/WorldSnapshot.hpp"
+#include "pole_position/snapshot/WorldSnapshotFormat.hpp"
+
+WorldSnapshot::WorldSnapshot() :
+    m_words(),
+    m_layout()
+{}
+
+WorldSnapshot
+WorldSnapshot::readFromFile(
+    const std::string& filepath
+) {
+    const MappedFile mappedFile(filepath);
+    const std::string_view contents = mappedFile.getContents();
+
+    world_snapshot_format::Header header {};
+    if (contents.size() < sizeof(header)) {
+        LOG_CRITICALthis("{} is too small to be a world snapshot ( {} bytes )", filepath, contents.size());
+        throw std::runtime_error("Invalid world snapshot");
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+
+    if (header.magic != world_snapshot_format::magic || header.version != world_snapshot_format::version) {
+        LOG_CRITICALthis("{} is not a version {} world snapshot", filepath, world_snapshot_format::version);
+        throw std::runtime_error("Invalid world snapshot");
+    }
+
+    const world_snapshot_format::Layout layout = world_snapshot_format::computeLayout(header);
+    if (header.byteCount != layout.byteCount || contents.size() != layout.byteCount) {
+        LOG_CRITICALthis("{} is {} bytes, but its header describes {} bytes", filepath, contents.size(), layout.byteCount);
+        throw std::runtime_error("Invalid world snapshot");
+    }
+
+    WorldSnapshot snapshot;
+    snapshot.reset(header);
+    std::memcpy(snapshot.m_words.data(), contents.data(), contents.size());
+
+    LOG_INFOthis("Read the snapshot of tick {} with {} doodads from {}, {} bytes", header.tickCount, header.doodadCount, filepath, contents.size());
+
+    return snapshot;
+}
+
+void
+WorldSnapshot::writeToFile(
+    const std::string& filepath
+) const {
+    const int fileDescriptor = open(filepath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor < 0) {
+        LOG_CRITICALthis("Failed to open {} for writing: {}", filepath, std::strerror(errno));
+        throw std::runtime_error("Failed to open world snapshot for writing");
+    }
+
+    const std::size_t byteCount = this->getByteCount();
+    if (ftruncate(fileDescriptor, static_cast<off_t>(byteCount)) != 0) {
+        LOG_CRITICALthis("Failed to size {} to {} bytes: {}", filepath, byteCount, std::strerror(errno));
+        close(fileDescriptor);
+        throw std::runtime_error("Failed to size world snapshot file");
+    }
+
+    // mmap refuses empty mappings, and an empty snapshot is an empty file
+    if (byteCount > 0) {
+        void* const p_data = mmap(nullptr, byteCount, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+        if (p_data == MAP_FAILED) {
+            LOG_CRITICALthis("Failed to map {}: {}", filepath, std::strerror(errno));
+            close(fileDescriptor);
+            throw std::runtime_error("Failed to map world snapshot file");
+        }
+
+        // The kernel writes the pages back on its own time, the copy is all that is paid for here
+        std::memcpy(p_data, m_words.data(), byteCount);
+        munmap(p_data, byteCount);
+    }
+
+    close(fileDescriptor);
+
+    LOG_INFOthis("Wrote the snapshot of tick {} to {}, {} bytes", this->isEmpty() ? 0 : this->getTickCount(), filepath, byteCount);
+}
+
+void
+WorldSnapshot::reset(
+    const world_snapshot_format::Header& header
+) {
+    m_layout = world_snapshot_format::computeLayout(header);
+    m_words.resize(m_layout.byteCount / sizeof(uint64_t));
+
+    world_snapshot_format::Header& writtenHeader = *reinterpret_cast<world_snapshot_format::Header*>(m_words.data());
+    writtenHeader = header;
+    writtenHeader.byteCount = m_layout.byteCount;
+}
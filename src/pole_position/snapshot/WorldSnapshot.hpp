@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/snapshot/WorldSnapshotFormat.hpp"
+
+/**
+ * @brief The whole state of a simulation at the end of a tick as one contiguous buffer, laid out as
+ * world_snapshot_format describes. HeadlessSimulation::captureSnapshot fills it and restoreSnapshot puts the
+ * simulation back to it.
+ *
+ * The buffer is kept as 8 byte words, which every section is a whole number of. A snapshot that is captured into
+ * over and over keeps its buffer, so only the first capture allocates
+ */
+class WorldSnapshot {
+public: // member functions
+    WorldSnapshot();
+
+    /**
+     * @brief Throws if the file cannot be mapped or does not hold a snapshot
+     */
+    static WorldSnapshot readFromFile(const std::string& filepath);
+
+    /**
+     * @brief Writes the buffer through a shared mapping of the file, which is created or truncated to fit. Throws if
+     * the file cannot be created or mapped
+     */
+    void writeToFile(const std::string& filepath) const;
+
+    /**
+     * @brief Sizes the buffer for the header's counts and writes the header into it. Everything after the header is
+     * left as whatever the buffer held before
+     */
+    void reset(const world_snapshot_format::Header& header);
+
+    bool isEmpty() const { return m_words.empty(); }
+    std::size_t getByteCount() const { return m_words.size() * sizeof(uint64_t); }
+    const world_snapshot_format::Header& getHeader() const { return *reinterpret_cast<const world_snapshot_format::Header*>(m_words.data()); }
+    const world_snapshot_format::Layout& getLayout() const { return m_layout; }
+    uint64_t getTickCount() const { return this->getHeader().tickCount; }
+
+    std::span<uint64_t> getWords() { return m_words; }
+    std::span<const uint64_t> getWords() const { return m_words; }
+
+    template <typename T>
+    std::span<T> getSection(const std::size_t byteOffset, const std::size_t count) { return {reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(m_words.data()) + byteOffset), count}; }
+
+    template <typename T>
+    std::span<const T> getSection(const std::size_t byteOffset, const std::size_t count) const { return {reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(m_words.data()) + byteOffset), count}; }
+
+    USE_LOGGER(SNAPSHOT);
+
+private: // member variables
+    std::vector<uint64_t> m_words;
+    world_snapshot_format::Layout m_layout;
+};
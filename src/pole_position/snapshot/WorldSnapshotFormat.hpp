@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The layout of a world snapshot, everything a HeadlessSimulation needs to carry on from a tick, as one
+ * buffer of fixed size sections:
+ *
+ *   Header | DoodadTransform[doodadCount] | uint64_t lastActiveTickIndex[doodadCount] | BodyState[movableDoodadCount]
+ *          | VehicleControls[doodadCount, only with vehicles] | VehicleState[vehicleCount] | WheelState[wheelCount]
+ *          | PlayerControllerState[only with a player]
+ *
+ * Every section is a whole number of 8 byte words, so that two snapshots of the same simulation can be compared and
+ * diffed word by word. Everything is stored as doubles whatever the types it came from, so a snapshot file does not
+ * depend on how the math or physics types of the build that wrote it were laid out
+ */
+namespace world_snapshot_format {
+
+constexpr std::array<char, 4> magic = {'P', 'P', 'W', 'S'};
+constexpr uint16_t version = 1;
+
+enum Flags : uint16_t {
+    HasPlayerController = 0b0000000000000001
+};
+
+struct Header {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t doodadCount;
+    uint32_t movableDoodadCount;
+    uint32_t vehicleCount;
+    uint32_t wheelCount;
+    uint64_t tickCount;
+    std::array<double, 3> gravity_mps2;
+    uint64_t byteCount;
+};
+static_assert(sizeof(Header) == 64);
+
+struct DoodadTransform {
+    std::array<double, 3> position;
+    std::array<double, 4> rotation; // w, x, y, z
+};
+static_assert(sizeof(DoodadTransform) == 56);
+
+/**
+ * @brief A movable doodad's rigid body, which can differ from its doodad's transform while it sleeps
+ */
+struct BodyState {
+    std::array<double, 3> position;
+    std::array<double, 4> orientation; // w, x, y, z
+    std::array<double, 3> linearVelocity_mps;
+    std::array<double, 3> angularVelocity_radps;
+    uint64_t isSleeping;
+};
+static_assert(sizeof(BodyState) == 112);
+
+struct VehicleControls {
+    double throttle;
+    double brake;
+    double steering;
+};
+static_assert(sizeof(VehicleControls) == 24);
+
+struct VehicleState {
+    uint64_t gearIndex;
+    double engineSpeed_rpm;
+};
+static_assert(sizeof(VehicleState) == 16);
+
+/**
+ * @brief A wheel's spin and what its ray last touched, a negative hit distance meaning nothing
+ */
+struct WheelState {
+    double angularSpeed_radps;
+    double hitDistance_m;
+    std::array<double, 3> hitPoint;
+    std::array<double, 3> hitNormal;
+};
+static_assert(sizeof(WheelState) == 64);
+
+struct PlayerControllerState {
+    std::array<double, 3> cameraEulerAngles_deg; // yaw, pitch, roll
+    std::array<double, 3> cameraPosition;
+    double cameraDistance;
+    double horizontalMovementSpeed_mps;
+};
+static_assert(sizeof(PlayerControllerState) == 64);
+
+/**
+ * @brief Where each section starts, all of which follow from the header's counts
+ */
+struct Layout {
+    std::size_t doodadTransformsOffset;
+    std::size_t lastActiveTickIndicesOffset;
+    std::size_t bodyStatesOffset;
+    std::size_t vehicleControlsOffset;
+    std::size_t vehicleStatesOffset;
+    std::size_t wheelStatesOffset;
+    std::size_t playerControllerStateOffset;
+    std::size_t byteCount;
+};
+
+constexpr Layout
+computeLayout(
+    const Header& header
+) {
+    Layout layout {};
+    layout.doodadTransformsOffset = sizeof(Header);
+    layout.lastActiveTickIndicesOffset = layout.doodadTransformsOffset + header.doodadCount * sizeof(DoodadTransform);
+    layout.bodyStatesOffset = layout.lastActiveTickIndicesOffset + header.doodadCount * sizeof(uint64_t);
+    layout.vehicleControlsOffset = layout.bodyStatesOffset + header.movableDoodadCount * sizeof(BodyState);
+    layout.vehicleStatesOffset = layout.vehicleControlsOffset + (header.vehicleCount > 0 ? header.doodadCount * sizeof(VehicleControls) : 0);
+    layout.wheelStatesOffset = layout.vehicleStatesOffset + header.vehicleCount * sizeof(VehicleState);
+    layout.playerControllerStateOffset = layout.wheelStatesOffset + header.wheelCount * sizeof(WheelState);
+    layout.byteCount = layout.playerControllerStateOffset + ((header.flags & HasPlayerController) ? sizeof(PlayerControllerState) : 0);
+    return layout;
+}
+
+} // namespace world_snapshot_format
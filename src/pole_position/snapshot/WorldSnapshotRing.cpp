@@ -0,0 +1,138 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/snapshot/WorldSnapshot.hpp"
+#include "pole_position/snapshot/WorldSnapshotRing.hpp"
+
+WorldSnapshotRing::WorldSnapshotRing(
+    const std::size_t capacity
+) :
+    m_newestSnapshot(),
+    m_deltas(),
+    m_oldestDeltaIndex(0),
+    m_deltaCount(0),
+    m_deltaWordCount(0)
+{
+    if (capacity == 0) {
+        LOG_CRITICALthis("A snapshot ring has to hold at least one snapshot");
+        throw std::runtime_error("Invalid snapshot ring capacity");
+    }
+
+    m_deltas.resize(capacity - 1);
+}
+
+void
+WorldSnapshotRing::encodeDelta(
+    std::span<const uint64_t> fromWords,
+    std::span<const uint64_t> toWords,
+    std::vector<uint64_t>& delta
+) {
+    constexpr std::size_t maxRunLength = 0xFFFFFFFF;
+
+    delta.clear();
+
+    std::size_t i = 0;
+    while (i < toWords.size()) {
+        const std::size_t unchangedStart = i;
+        while (i < toWords.size() && fromWords[i] == toWords[i] && i - unchangedStart < maxRunLength) {
+            ++i;
+        }
+        if (i == toWords.size()) {
+            break;
+        }
+
+        const std::size_t changedStart = i;
+        while (i < toWords.size() && fromWords[i] != toWords[i] && i - changedStart < maxRunLength) {
+            ++i;
+        }
+
+        delta.push_back((static_cast<uint64_t>(changedStart - unchangedStart) << 32) | static_cast<uint64_t>(i - changedStart));
+        for (std::size_t j = changedStart; j < i; ++j) {
+            delta.push_back(fromWords[j] ^ toWords[j]);
+        }
+    }
+}
+
+void
+WorldSnapshotRing::applyDelta(
+    std::span<const uint64_t> delta,
+    std::span<uint64_t> words
+) {
+    std::size_t wordIndex = 0;
+    std::size_t deltaIndex = 0;
+    while (deltaIndex < delta.size()) {
+        const uint64_t run = delta[deltaIndex++];
+        wordIndex += static_cast<std::size_t>(run >> 32);
+
+        const std::size_t changedCount = static_cast<std::size_t>(run & 0xFFFFFFFF);
+        for (std::size_t i = 0; i < changedCount; ++i) {
+            words[wordIndex++] ^= delta[deltaIndex++];
+        }
+    }
+}
+
+void
+WorldSnapshotRing::push(
+    const WorldSnapshot& snapshot
+) {
+    PROFILE_SCOPE("World snapshot ring push");
+
+    if (!m_newestSnapshot.isEmpty() && m_newestSnapshot.getByteCount() != snapshot.getByteCount()) {
+        LOG_INFOthis("Snapshot of tick {} is {} bytes instead of {}, starting the ring over", snapshot.getTickCount(), snapshot.getByteCount(), m_newestSnapshot.getByteCount());
+        this->clear();
+    }
+
+    if (!m_newestSnapshot.isEmpty() && !m_deltas.empty()) {
+        // Once full, the newest delta takes the oldest one's slot
+        if (m_deltaCount == m_deltas.size()) {
+            m_deltaWordCount -= m_deltas[m_oldestDeltaIndex].size();
+            m_oldestDeltaIndex = (m_oldestDeltaIndex + 1) % m_deltas.size();
+            --m_deltaCount;
+        }
+
+        std::vector<uint64_t>& delta = m_deltas[(m_oldestDeltaIndex + m_deltaCount) % m_deltas.size()];
+        WorldSnapshotRing::encodeDelta(snapshot.getWords(), m_newestSnapshot.getWords(), delta);
+        m_deltaWordCount += delta.size();
+        ++m_deltaCount;
+    }
+
+    m_newestSnapshot = snapshot;
+}
+
+bool
+WorldSnapshotRing::rewind(
+    const std::size_t stepCount,
+    WorldSnapshot& snapshot
+) {
+    PROFILE_SCOPE("World snapshot ring rewind");
+
+    if (stepCount >= this->getSnapshotCount()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < stepCount; ++i) {
+        const std::size_t newestDeltaIndex = (m_oldestDeltaIndex + m_deltaCount - 1) % m_deltas.size();
+        const std::vector<uint64_t>& delta = m_deltas[newestDeltaIndex];
+        WorldSnapshotRing::applyDelta(delta, m_newestSnapshot.getWords());
+        m_deltaWordCount -= delta.size();
+        --m_deltaCount;
+    }
+
+    snapshot = m_newestSnapshot;
+
+    return true;
+}
+
+void
+WorldSnapshotRing::clear() {
+    m_newestSnapshot = WorldSnapshot();
+    m_oldestDeltaIndex = 0;
+    m_deltaCount = 0;
+    m_deltaWordCount = 0;
+}
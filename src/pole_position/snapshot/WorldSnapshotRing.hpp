@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/snapshot/WorldSnapshot.hpp"
+
+/**
+ * @brief The last few snapshots of a simulation for rolling it back, held as the newest snapshot in full and a
+ * delta per snapshot before it.
+ *
+ * A delta is the XOR of a snapshot's words with the next one's, with the runs of words that did not change left
+ * out. Between two ticks only the doodads that moved change, so a delta is usually far smaller than a snapshot, and
+ * the same delta that turns a snapshot into the next one turns the next one back. Rewinding applies the newest
+ * deltas to the newest snapshot one after the other, and the oldest delta is dropped once the ring is full, so
+ * nothing ever needs the snapshots in between to be kept whole.
+ *
+ * Each slot's delta buffer is kept when it is reused, so a ring that has gone round once does not allocate
+ */
+class WorldSnapshotRing {
+public: // member functions
+    /**
+     * @brief Holds up to capacity snapshots, the newest and capacity - 1 deltas before it
+     */
+    explicit WorldSnapshotRing(const std::size_t capacity);
+
+    /**
+     * @brief A snapshot of another size than the ones before it, which is one of another simulation, starts the
+     * ring over
+     */
+    void push(const WorldSnapshot& snapshot);
+
+    /**
+     * @brief Drops the stepCount newest snapshots and copies the one that is then the newest into snapshot, which
+     * is stepCount snapshots before the newest one. Returns false and leaves the ring as it was if it does not hold
+     * that many
+     */
+    bool rewind(const std::size_t stepCount, WorldSnapshot& snapshot);
+
+    void clear();
+
+    std::size_t getCapacity() const { return m_deltas.size() + 1; }
+    std::size_t getSnapshotCount() const { return m_newestSnapshot.isEmpty() ? 0 : m_deltaCount + 1; }
+
+    /**
+     * @brief What the held snapshot and deltas take up, not counting what the buffers have reserved past that
+     */
+    std::size_t getByteCount() const { return m_newestSnapshot.getByteCount() + m_deltaWordCount * sizeof(uint64_t); }
+
+    USE_LOGGER(SNAPSHOT);
+
+private: // helpers
+    /**
+     * @brief Runs of the XOR of from and to, each a word holding the number of unchanged words before it in its high
+     * half and the number of changed words in its low half, followed by the changed words
+     */
+    static void encodeDelta(std::span<const uint64_t> fromWords, std::span<const uint64_t> toWords, std::vector<uint64_t>& delta);
+    static void applyDelta(std::span<const uint64_t> delta, std::span<uint64_t> words);
+
+private: // member variables
+    WorldSnapshot m_newestSnapshot;
+
+    // From the oldest, the deltas are a ring over the slots
+    std::vector<std::vector<uint64_t>> m_deltas;
+    std::size_t m_oldestDeltaIndex;
+    std::size_t m_deltaCount;
+    std::size_t m_deltaWordCount;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+
+#include "math/transform/Vec3.hpp"
+
+/**
+ * @brief An axis aligned bounding box
+ */
+struct Aabb {
+public: // member functions
+    static Aabb fromSphere(const math::Vec3& center, const double radius) {
+        return {
+            math::Vec3(center.x - radius, center.y - radius, center.z - radius),
+            math::Vec3(center.x + radius, center.y + radius, center.z + radius)
+        };
+    }
+
+    Aabb merge(const Aabb& other) const {
+        return {
+            math::Vec3(std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z)),
+            math::Vec3(std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z))
+        };
+    }
+
+    Aabb expand(const double margin) const {
+        return {
+            math::Vec3(min.x - margin, min.y - margin, min.z - margin),
+            math::Vec3(max.x + margin, max.y + margin, max.z + margin)
+        };
+    }
+
+    bool contains(const Aabb& other) const {
+        return
+            min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+            other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+    }
+
+    bool overlaps(const Aabb& other) const {
+        return
+            min.x <= other.max.x && other.min.x <= max.x &&
+            min.y <= other.max.y && other.min.y <= max.y &&
+            min.z <= other.max.z && other.min.z <= max.z;
+    }
+
+    /**
+     * @brief What the tree minimizes when it picks where to insert. Any measure that grows with the box works,
+     * the surface area is the usual one
+     */
+    double getSurfaceArea() const {
+        const double width = static_cast<double>(max.x - min.x);
+        const double height = static_cast<double>(max.y - min.y);
+        const double depth = static_cast<double>(max.z - min.z);
+        return 2.0 * (width * height + height * depth + depth * width);
+    }
+
+    double getDistanceSquaredTo(const math::Vec3& point) const {
+        const double dx = std::max({static_cast<double>(min.x - point.x), 0.0, static_cast<double>(point.x - max.x)});
+        const double dy = std::max({static_cast<double>(min.y - point.y), 0.0, static_cast<double>(point.y - max.y)});
+        const double dz = std::max({static_cast<double>(min.z - point.z), 0.0, static_cast<double>(point.z - max.z)});
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    /**
+     * @brief The distance along the ray at which it enters the box, if it does before maxDistance. Takes the
+     * inverse of the ray's direction, which is worth working out once per ray rather than once per box
+     */
+    std::optional<double> raycast(
+        const math::Vec3& origin,
+        const math::Vec3& inverseDirection,
+        const double maxDistance
+    ) const {
+        double entryDistance = 0.0;
+        double exitDistance = maxDistance;
+
+        const double origins[3] = {origin.x, origin.y, origin.z};
+        const double inverseDirections[3] = {inverseDirection.x, inverseDirection.y, inverseDirection.z};
+        const double mins[3] = {min.x, min.y, min.z};
+        const double maxs[3] = {max.x, max.y, max.z};
+        for (int axis = 0; axis < 3; ++axis) {
+            double nearDistance = (mins[axis] - origins[axis]) * inverseDirections[axis];
+            double farDistance = (maxs[axis] - origins[axis]) * inverseDirections[axis];
+            if (nearDistance > farDistance) {
+                std::swap(nearDistance, farDistance);
+            }
+
+            // A ray parallel to a slab it starts inside of gives nan here, which the comparisons let through
+            entryDistance = nearDistance > entryDistance ? nearDistance : entryDistance;
+            exitDistance = farDistance < exitDistance ? farDistance : exitDistance;
+            if (entryDistance > exitDistance) {
+                return std::nullopt;
+            }
+        }
+
+        return entryDistance;
+    }
+
+public: // member variables
+    math::Vec3 min;
+    math::Vec3 max;
+};
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/memory/FrameArena.hpp"
+#include "pole_position/spatial/Aabb.hpp"
+#include "pole_position/spatial/DynamicAabbTree.hpp"
+
+DynamicAabbTree::DynamicAabbTree() :
+    m_nodes(),
+    m_rootIndex(s_nullIndex),
+    m_freeListIndex(s_nullIndex),
+    m_proxyCount(0)
+{}
+
+int32_t
+DynamicAabbTree::allocateNode() {
+    if (m_freeListIndex == s_nullIndex) {
+        m_nodes.push_back({});
+        m_freeListIndex = static_cast<int32_t>(m_nodes.size() - 1);
+        m_nodes.back().parentIndex = s_nullIndex;
+    }
+
+    const int32_t nodeIndex = m_freeListIndex;
+    Node& node = m_nodes[nodeIndex];
+    m_freeListIndex = node.parentIndex;
+
+    node.parentIndex = s_nullIndex;
+    node.firstChildIndex = s_nullIndex;
+    node.secondChildIndex = s_nullIndex;
+    node.categoryBitMask = 0;
+    node.doodadIndex = 0;
+    node.height = 0;
+
+    return nodeIndex;
+}
+
+void
+DynamicAabbTree::freeNode(
+    const int32_t nodeIndex
+) {
+    Node& node = m_nodes[nodeIndex];
+    node.parentIndex = m_freeListIndex;
+    node.height = -1;
+    m_freeListIndex = nodeIndex;
+}
+
+int32_t
+DynamicAabbTree::createProxy(
+    const Aabb& aabb,
+    const uint16_t categoryBitMask,
+    const std::size_t doodadIndex
+) {
+    const int32_t proxyId = this->allocateNode();
+
+    Node& node = m_nodes[proxyId];
+    node.aabb = aabb.expand(s_aabbMargin);
+    node.tightAabb = aabb;
+    node.categoryBitMask = categoryBitMask;
+    node.doodadIndex = doodadIndex;
+
+    this->insertLeaf(proxyId);
+    ++m_proxyCount;
+
+    return proxyId;
+}
+
+void
+DynamicAabbTree::destroyProxy(
+    const int32_t proxyId
+) {
+    this->removeLeaf(proxyId);
+    this->freeNode(proxyId);
+    --m_proxyCount;
+}
+
+bool
+DynamicAabbTree::moveProxy(
+    const int32_t proxyId,
+    const Aabb& aabb
+) {
+    Node& node = m_nodes[proxyId];
+    node.tightAabb = aabb;
+    if (node.aabb.contains(aabb)) {
+        return false;
+    }
+
+    this->removeLeaf(proxyId);
+    m_nodes[proxyId].aabb = aabb.expand(s_aabbMargin);
+    this->insertLeaf(proxyId);
+
+    return true;
+}
+
+void
+DynamicAabbTree::insertLeaf(
+    const int32_t leafIndex
+) {
+    if (m_rootIndex == s_nullIndex) {
+        m_rootIndex = leafIndex;
+        m_nodes[leafIndex].parentIndex = s_nullIndex;
+        return;
+    }
+
+    // Walk down to the sibling that makes the tree's total surface area grow the least
+    const Aabb leafAabb = m_nodes[leafIndex].aabb;
+    int32_t siblingIndex = m_rootIndex;
+    while (!m_nodes[siblingIndex].isLeaf()) {
+        const Node& node = m_nodes[siblingIndex];
+
+        const double area = node.aabb.getSurfaceArea();
+        const double combinedArea = node.aabb.merge(leafAabb).getSurfaceArea();
+
+        // Pairing with this node makes a new parent, and descending further grows this node regardless
+        const double cost = 2.0 * combinedArea;
+        const double inheritedCost = 2.0 * (combinedArea - area);
+
+        const auto getDescendCost = [this, &leafAabb, inheritedCost] (const int32_t childIndex) {
+            const Node& child = m_nodes[childIndex];
+            const double mergedArea = child.aabb.merge(leafAabb).getSurfaceArea();
+            return (child.isLeaf() ? mergedArea : mergedArea - child.aabb.getSurfaceArea()) + inheritedCost;
+        };
+        const double firstChildCost = getDescendCost(node.firstChildIndex);
+        const double secondChildCost = getDescendCost(node.secondChildIndex);
+
+        if (cost < firstChildCost && cost < secondChildCost) {
+            break;
+        }
+
+        siblingIndex = firstChildCost < secondChildCost ? node.firstChildIndex : node.secondChildIndex;
+    }
+
+    const int32_t oldParentIndex = m_nodes[siblingIndex].parentIndex;
+    const int32_t newParentIndex = this->allocateNode();
+
+    Node& newParent = m_nodes[newParentIndex];
+    newParent.parentIndex = oldParentIndex;
+    newParent.aabb = leafAabb.merge(m_nodes[siblingIndex].aabb);
+    newParent.categoryBitMask = m_nodes[leafIndex].categoryBitMask | m_nodes[siblingIndex].categoryBitMask;
+    newParent.height = m_nodes[siblingIndex].height + 1;
+    newParent.firstChildIndex = siblingIndex;
+    newParent.secondChildIndex = leafIndex;
+
+    if (oldParentIndex == s_nullIndex) {
+        m_rootIndex = newParentIndex;
+    } else if (m_nodes[oldParentIndex].firstChildIndex == siblingIndex) {
+        m_nodes[oldParentIndex].firstChildIndex = newParentIndex;
+    } else {
+        m_nodes[oldParentIndex].secondChildIndex = newParentIndex;
+    }
+    m_nodes[siblingIndex].parentIndex = newParentIndex;
+    m_nodes[leafIndex].parentIndex = newParentIndex;
+
+    this->refitAncestors(oldParentIndex);
+}
+
+void
+DynamicAabbTree::removeLeaf(
+    const int32_t leafIndex
+) {
+    if (leafIndex == m_rootIndex) {
+        m_rootIndex = s_nullIndex;
+        return;
+    }
+
+    // The leaf's parent goes away and the leaf's sibling takes its place
+    const int32_t parentIndex = m_nodes[leafIndex].parentIndex;
+    const int32_t grandparentIndex = m_nodes[parentIndex].parentIndex;
+    const int32_t siblingIndex = m_nodes[parentIndex].firstChildIndex == leafIndex ?
+        m_nodes[parentIndex].secondChildIndex :
+        m_nodes[parentIndex].firstChildIndex;
+
+    if (grandparentIndex == s_nullIndex) {
+        m_rootIndex = siblingIndex;
+    } else if (m_nodes[grandparentIndex].firstChildIndex == parentIndex) {
+        m_nodes[grandparentIndex].firstChildIndex = siblingIndex;
+    } else {
+        m_nodes[grandparentIndex].secondChildIndex = siblingIndex;
+    }
+    m_nodes[siblingIndex].parentIndex = grandparentIndex;
+    this->freeNode(parentIndex);
+
+    this->refitAncestors(grandparentIndex);
+}
+
+void
+DynamicAabbTree::refitAncestors(
+    int32_t nodeIndex
+) {
+    while (nodeIndex != s_nullIndex) {
+        nodeIndex = this->balance(nodeIndex);
+
+        Node& node = m_nodes[nodeIndex];
+        const Node& firstChild = m_nodes[node.firstChildIndex];
+        const Node& secondChild = m_nodes[node.secondChildIndex];
+        node.aabb = firstChild.aabb.merge(secondChild.aabb);
+        node.categoryBitMask = firstChild.categoryBitMask | secondChild.categoryBitMask;
+        node.height = 1 + std::max(firstChild.height, secondChild.height);
+
+        nodeIndex = node.parentIndex;
+    }
+}
+
+int32_t
+DynamicAabbTree::balance(
+    const int32_t nodeIndex
+) {
+    Node& node = m_nodes[nodeIndex];
+    if (node.isLeaf() || node.height < 2) {
+        return nodeIndex;
+    }
+
+    const int32_t firstChildIndex = node.firstChildIndex;
+    const int32_t secondChildIndex = node.secondChildIndex;
+    const int32_t heightDifference = m_nodes[secondChildIndex].height - m_nodes[firstChildIndex].height;
+    if (heightDifference >= -1 && heightDifference <= 1) {
+        return nodeIndex;
+    }
+
+    // Rotate the taller child up into the node's place. The node keeps its shorter child and takes the taller
+    // child's shorter child, and the taller child keeps its own taller child
+    const bool rotateSecondChild = heightDifference > 1;
+    const int32_t risingIndex = rotateSecondChild ? secondChildIndex : firstChildIndex;
+    const int32_t keptChildIndex = rotateSecondChild ? firstChildIndex : secondChildIndex;
+    Node& rising = m_nodes[risingIndex];
+
+    const int32_t risingFirstChildIndex = rising.firstChildIndex;
+    const int32_t risingSecondChildIndex = rising.secondChildIndex;
+    const bool firstIsTaller = m_nodes[risingFirstChildIndex].height > m_nodes[risingSecondChildIndex].height;
+    const int32_t tallerIndex = firstIsTaller ? risingFirstChildIndex : risingSecondChildIndex;
+    const int32_t shorterIndex = firstIsTaller ? risingSecondChildIndex : risingFirstChildIndex;
+
+    rising.parentIndex = node.parentIndex;
+    if (rising.parentIndex == s_nullIndex) {
+        m_rootIndex = risingIndex;
+    } else if (m_nodes[rising.parentIndex].firstChildIndex == nodeIndex) {
+        m_nodes[rising.parentIndex].firstChildIndex = risingIndex;
+    } else {
+        m_nodes[rising.parentIndex].secondChildIndex = risingIndex;
+    }
+
+    rising.firstChildIndex = nodeIndex;
+    rising.secondChildIndex = tallerIndex;
+    node.parentIndex = risingIndex;
+
+    if (rotateSecondChild) {
+        node.secondChildIndex = shorterIndex;
+    } else {
+        node.firstChildIndex = shorterIndex;
+    }
+    m_nodes[shorterIndex].parentIndex = nodeIndex;
+
+    const Node& keptChild = m_nodes[keptChildIndex];
+    const Node& shorter = m_nodes[shorterIndex];
+    node.aabb = keptChild.aabb.merge(shorter.aabb);
+    node.categoryBitMask = keptChild.categoryBitMask | shorter.categoryBitMask;
+    node.height = 1 + std::max(keptChild.height, shorter.height);
+
+    const Node& taller = m_nodes[tallerIndex];
+    rising.aabb = node.aabb.merge(taller.aabb);
+    rising.categoryBitMask = node.categoryBitMask | taller.categoryBitMask;
+    rising.height = 1 + std::max(node.height, taller.height);
+
+    return risingIndex;
+}
+
+std::optional<DynamicAabbTree::RayHit>
+DynamicAabbTree::raycast(
+    const math::Vec3& origin,
+    const math::Vec3& direction,
+    const double maxDistance,
+    const uint16_t categoryBitMask
+) const {
+    if (m_rootIndex == s_nullIndex) {
+        return std::nullopt;
+    }
+
+    // Dividing by a zero component gives an infinity, which the slab test handles
+    const math::Vec3 inverseDirection(1.0 / direction.x, 1.0 / direction.y, 1.0 / direction.z);
+
+    std::optional<RayHit> o_closestHit;
+    double closestDistance = maxDistance;
+
+    QueryStack stack;
+    std::size_t stackSize = 0;
+    DynamicAabbTree::push(stack, stackSize, m_rootIndex);
+
+    while (stackSize > 0) {
+        const Node& node = m_nodes[stack[--stackSize]];
+        if (!(node.categoryBitMask & categoryBitMask) || !node.aabb.raycast(origin, inverseDirection, closestDistance)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            const std::optional<double> o_distance = node.tightAabb.raycast(origin, inverseDirection, closestDistance);
+            if (o_distance && (!o_closestHit || *o_distance < closestDistance)) {
+                o_closestHit = RayHit{node.doodadIndex, *o_distance};
+                closestDistance = *o_distance;
+            }
+            continue;
+        }
+
+        // The nearer child goes on top so that it is visited first and shortens the ray for the other one
+        const std::optional<double> o_firstDistance = m_nodes[node.firstChildIndex].aabb.raycast(origin, inverseDirection, closestDistance);
+        const std::optional<double> o_secondDistance = m_nodes[node.secondChildIndex].aabb.raycast(origin, inverseDirection, closestDistance);
+        const bool firstIsNearer = o_firstDistance && (!o_secondDistance || *o_firstDistance <= *o_secondDistance);
+        if (firstIsNearer) {
+            if (o_secondDistance) {
+                DynamicAabbTree::push(stack, stackSize, node.secondChildIndex);
+            }
+            DynamicAabbTree::push(stack, stackSize, node.firstChildIndex);
+        } else {
+            if (o_firstDistance) {
+                DynamicAabbTree::push(stack, stackSize, node.firstChildIndex);
+            }
+            if (o_secondDistance) {
+                DynamicAabbTree::push(stack, stackSize, node.secondChildIndex);
+            }
+        }
+    }
+
+    return o_closestHit;
+}
+
+void
+DynamicAabbTree::queryNearest(
+    const math::Vec3& point,
+    const std::size_t count,
+    const uint16_t categoryBitMask,
+    std::vector<std::size_t>& doodadIndices,
+    FrameArena* const p_frameArena
+) const {
+    if (m_rootIndex == s_nullIndex || count == 0 || !(m_nodes[m_rootIndex].categoryBitMask & categoryBitMask)) {
+        return;
+    }
+
+    // Best first: nodes come off of the queue nearest first, and once the nearest remaining node is further away
+    // than the furthest of the count closest leaves so far, nothing left can get into them
+    using Candidate = std::pair<double, int32_t>;
+    FrameVector<Candidate> nodeQueueStorage(p_frameArena);
+    nodeQueueStorage.reserve(2 * count + 2);
+    std::priority_queue<Candidate, FrameVector<Candidate>, std::greater<Candidate>> nodeQueue(std::greater<Candidate>(), std::move(nodeQueueStorage));
+    FrameVector<std::pair<double, std::size_t>> closestLeaves(p_frameArena);
+    closestLeaves.reserve(count + 1);
+
+    nodeQueue.push({m_nodes[m_rootIndex].aabb.getDistanceSquaredTo(point), m_rootIndex});
+    while (!nodeQueue.empty()) {
+        const auto [distanceSquared, nodeIndex] = nodeQueue.top();
+        nodeQueue.pop();
+        if (closestLeaves.size() == count && distanceSquared > closestLeaves.front().first) {
+            break;
+        }
+
+        const Node& node = m_nodes[nodeIndex];
+        if (node.isLeaf()) {
+            closestLeaves.push_back({node.tightAabb.getDistanceSquaredTo(point), node.doodadIndex});
+            std::push_heap(closestLeaves.begin(), closestLeaves.end());
+            if (closestLeaves.size() > count) {
+                std::pop_heap(closestLeaves.begin(), closestLeaves.end());
+                closestLeaves.pop_back();
+            }
+            continue;
+        }
+
+        for (const int32_t childIndex : {node.firstChildIndex, node.secondChildIndex}) {
+            const Node& child = m_nodes[childIndex];
+            if (!(child.categoryBitMask & categoryBitMask)) {
+                continue;
+            }
+
+            const double childDistanceSquared = child.aabb.getDistanceSquaredTo(point);
+            if (closestLeaves.size() < count || childDistanceSquared <= closestLeaves.front().first) {
+                nodeQueue.push({childDistanceSquared, childIndex});
+            }
+        }
+    }
+
+    std::sort_heap(closestLeaves.begin(), closestLeaves.end());
+    for (const std::pair<double, std::size_t>& closestLeaf : closestLeaves) {
+        doodadIndices.push_back(closestLeaf.second);
+    }
+}
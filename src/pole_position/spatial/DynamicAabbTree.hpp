@@ -0,0 +1,210 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/memory/FrameArena.hpp"
+#include "pole_position/spatial/Aabb.hpp"
+
+/**
+ * @brief A bounding volume hierarchy that is updated in place as things move, in the style of Box2D's dynamic tree.
+ * Leaves hold a fattened copy of their box, so something that moves a little stays where it is in the tree and
+ * only things that leave their fat box are taken out and reinserted. Insertion picks the sibling that grows the
+ * tree's surface area the least and rotations keep the tree balanced, so every query is logarithmic in the number
+ * of leaves for small query volumes.
+ *
+ * Every node also holds the union of the collision categories below it, so queries for some categories skip
+ * whole subtrees that hold none of them.
+ */
+class DynamicAabbTree {
+public: // classes and enums
+    struct RayHit {
+        std::size_t doodadIndex;
+        double distance;
+    };
+
+public: // member functions
+    DynamicAabbTree();
+
+    int32_t createProxy(const Aabb& aabb, const uint16_t categoryBitMask, const std::size_t doodadIndex);
+    void destroyProxy(const int32_t proxyId);
+
+    /**
+     * @brief Returns whether the proxy had to be reinserted, which is only when it left its fat box
+     */
+    bool moveProxy(const int32_t proxyId, const Aabb& aabb);
+
+    std::size_t getProxyCount() const { return m_proxyCount; }
+    int32_t getHeight() const { return m_rootIndex == s_nullIndex ? 0 : m_nodes[m_rootIndex].height; }
+
+    /**
+     * @brief Calls visitor(doodadIndex) for every proxy in one of the categories whose box overlaps the box
+     */
+    template<typename Visitor>
+    void queryAabb(const Aabb& aabb, const uint16_t categoryBitMask, Visitor&& visitor) const;
+
+    /**
+     * @brief Calls visitor(doodadIndex) for every proxy in one of the categories whose box is within radius of
+     * the center
+     */
+    template<typename Visitor>
+    void querySphere(const math::Vec3& center, const double radius, const uint16_t categoryBitMask, Visitor&& visitor) const;
+
+    /**
+     * @brief The proxy in one of the categories whose box the ray enters first. The direction must be normalized
+     */
+    std::optional<RayHit> raycast(
+        const math::Vec3& origin,
+        const math::Vec3& direction,
+        const double maxDistance,
+        const uint16_t categoryBitMask
+    ) const;
+
+    /**
+     * @brief Appends the doodad indices of the count proxies in one of the categories whose boxes are closest to
+     * the point, nearest first. The search's own bookkeeping comes from the frame arena if there is one, and from
+     * the heap otherwise
+     */
+    void queryNearest(
+        const math::Vec3& point,
+        const std::size_t count,
+        const uint16_t categoryBitMask,
+        std::vector<std::size_t>& doodadIndices,
+        FrameArena* const p_frameArena
+    ) const;
+
+private: // classes and enums
+    struct Node {
+        bool isLeaf() const { return firstChildIndex == s_nullIndex; }
+
+        /**
+         * @brief Fattened for leaves, the union of the children's boxes otherwise
+         */
+        Aabb aabb;
+        Aabb tightAabb;
+        uint16_t categoryBitMask;
+        std::size_t doodadIndex;
+
+        /**
+         * @brief The next free node for nodes on the free list
+         */
+        int32_t parentIndex;
+        int32_t firstChildIndex;
+        int32_t secondChildIndex;
+
+        /**
+         * @brief Leaves are 0, free nodes are -1
+         */
+        int32_t height;
+    };
+
+    /**
+     * @brief Enough for any tree the balancing lets exist, which is about 1.44 log2 of the number of leaves
+     */
+    using QueryStack = std::array<int32_t, 256>;
+
+private: // helpers
+    static void push(QueryStack& stack, std::size_t& stackSize, const int32_t nodeIndex) {
+        if (stackSize == stack.size()) {
+            throw std::runtime_error("Dynamic AABB tree is too deep to query");
+        }
+        stack[stackSize++] = nodeIndex;
+    }
+
+private: // member functions
+    int32_t allocateNode();
+    void freeNode(const int32_t nodeIndex);
+    void insertLeaf(const int32_t leafIndex);
+    void removeLeaf(const int32_t leafIndex);
+    void refitAncestors(int32_t nodeIndex);
+    int32_t balance(const int32_t nodeIndex);
+
+private: // static variables
+    static constexpr int32_t s_nullIndex = -1;
+
+    /**
+     * @brief How far a leaf's box is fattened on each side, in meters
+     */
+    static constexpr double s_aabbMargin = 0.25;
+
+private: // member variables
+    std::vector<Node> m_nodes;
+    int32_t m_rootIndex;
+    int32_t m_freeListIndex;
+    std::size_t m_proxyCount;
+};
+
+template<typename Visitor>
+void
+DynamicAabbTree::queryAabb(
+    const Aabb& aabb,
+    const uint16_t categoryBitMask,
+    Visitor&& visitor
+) const {
+    if (m_rootIndex == s_nullIndex) {
+        return;
+    }
+
+    QueryStack stack;
+    std::size_t stackSize = 0;
+    DynamicAabbTree::push(stack, stackSize, m_rootIndex);
+
+    while (stackSize > 0) {
+        const Node& node = m_nodes[stack[--stackSize]];
+        if (!(node.categoryBitMask & categoryBitMask) || !node.aabb.overlaps(aabb)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            if (node.tightAabb.overlaps(aabb)) {
+                visitor(node.doodadIndex);
+            }
+            continue;
+        }
+
+        DynamicAabbTree::push(stack, stackSize, node.firstChildIndex);
+        DynamicAabbTree::push(stack, stackSize, node.secondChildIndex);
+    }
+}
+
+template<typename Visitor>
+void
+DynamicAabbTree::querySphere(
+    const math::Vec3& center,
+    const double radius,
+    const uint16_t categoryBitMask,
+    Visitor&& visitor
+) const {
+    if (m_rootIndex == s_nullIndex) {
+        return;
+    }
+
+    const double radiusSquared = radius * radius;
+
+    QueryStack stack;
+    std::size_t stackSize = 0;
+    DynamicAabbTree::push(stack, stackSize, m_rootIndex);
+
+    while (stackSize > 0) {
+        const Node& node = m_nodes[stack[--stackSize]];
+        if (!(node.categoryBitMask & categoryBitMask) || node.aabb.getDistanceSquaredTo(center) > radiusSquared) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            if (node.tightAabb.getDistanceSquaredTo(center) <= radiusSquared) {
+                visitor(node.doodadIndex);
+            }
+            continue;
+        }
+
+        DynamicAabbTree::push(stack, stackSize, node.firstChildIndex);
+        DynamicAabbTree::push(stack, stackSize, node.secondChildIndex);
+    }
+}
@@ -0,0 +1,112 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "pole_position/memory/FrameArena.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/spatial/Aabb.hpp"
+#include "pole_position/spatial/DynamicAabbTree.hpp"
+#include "pole_position/spatial/SpatialIndex.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+SpatialIndex::SpatialIndex(
+    const DoodadStore& doodadStore
+) :
+    m_tree(),
+    m_proxyIds(doodadStore.size(), -1)
+{
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Spatial);
+
+    for (std::size_t doodadIndex = 0; doodadIndex < doodadStore.size(); ++doodadIndex) {
+        if (!doodadStore.rigidBodies[doodadIndex]) {
+            continue;
+        }
+
+        m_proxyIds[doodadIndex] = m_tree.createProxy(
+            Aabb::fromSphere(doodadStore.positions[doodadIndex], doodadStore.boundingRadii[doodadIndex]),
+            doodadStore.collisionCategoryBitMasks[doodadIndex],
+            doodadIndex
+        );
+    }
+}
+
+std::size_t
+SpatialIndex::update(
+    const DoodadStore& doodadStore
+) {
+    PROFILE_SCOPE("Spatial index update");
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Spatial);
+
+    std::size_t reinsertedCount = 0;
+    for (const std::size_t doodadIndex : doodadStore.activeDoodadIndices) {
+        const Aabb aabb = Aabb::fromSphere(doodadStore.positions[doodadIndex], doodadStore.boundingRadii[doodadIndex]);
+        if (m_tree.moveProxy(m_proxyIds[doodadIndex], aabb)) {
+            ++reinsertedCount;
+        }
+    }
+
+    return reinsertedCount;
+}
+
+void
+SpatialIndex::querySpheres(
+    std::span<const SphereQuery> queries,
+    BatchResults& results
+) const {
+    results.doodadIndices.clear();
+    results.offsets.assign(1, 0);
+
+    for (const SphereQuery& query : queries) {
+        m_tree.querySphere(query.center, query.radius, query.categoryBitMask, [&results] (const std::size_t doodadIndex) {
+            results.doodadIndices.push_back(doodadIndex);
+        });
+        results.offsets.push_back(results.doodadIndices.size());
+    }
+}
+
+void
+SpatialIndex::queryAabbs(
+    std::span<const AabbQuery> queries,
+    BatchResults& results
+) const {
+    results.doodadIndices.clear();
+    results.offsets.assign(1, 0);
+
+    for (const AabbQuery& query : queries) {
+        m_tree.queryAabb(query.aabb, query.categoryBitMask, [&results] (const std::size_t doodadIndex) {
+            results.doodadIndices.push_back(doodadIndex);
+        });
+        results.offsets.push_back(results.doodadIndices.size());
+    }
+}
+
+void
+SpatialIndex::queryNearest(
+    std::span<const NearestQuery> queries,
+    BatchResults& results,
+    FrameArena* const p_frameArena
+) const {
+    results.doodadIndices.clear();
+    results.offsets.assign(1, 0);
+
+    for (const NearestQuery& query : queries) {
+        m_tree.queryNearest(query.point, query.count, query.categoryBitMask, results.doodadIndices, p_frameArena);
+        results.offsets.push_back(results.doodadIndices.size());
+    }
+}
+
+void
+SpatialIndex::raycast(
+    std::span<const RayQuery> queries,
+    std::vector<std::optional<DynamicAabbTree::RayHit>>& hits
+) const {
+    hits.clear();
+    hits.reserve(queries.size());
+
+    for (const RayQuery& query : queries) {
+        hits.push_back(m_tree.raycast(query.origin, query.direction, query.maxDistance, query.categoryBitMask));
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/memory/FrameArena.hpp"
+#include "pole_position/spatial/Aabb.hpp"
+#include "pole_position/spatial/DynamicAabbTree.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+/**
+ * @brief A DynamicAabbTree over every doodad with a collider, each one bounded by the sphere around its position
+ * that holds its collider whichever way it is rotated, so only moving keeps the index busy and rotating is free.
+ * Queries are filtered by CollisionCategories bits and come in batches, each query's doodads landing in one shared
+ * result buffer.
+ */
+class SpatialIndex {
+public: // classes and enums
+    struct SphereQuery {
+        math::Vec3 center;
+        double radius;
+        uint16_t categoryBitMask;
+    };
+
+    struct AabbQuery {
+        Aabb aabb;
+        uint16_t categoryBitMask;
+    };
+
+    /**
+     * @brief The direction must be normalized
+     */
+    struct RayQuery {
+        math::Vec3 origin;
+        math::Vec3 direction;
+        double maxDistance;
+        uint16_t categoryBitMask;
+    };
+
+    struct NearestQuery {
+        math::Vec3 point;
+        std::size_t count;
+        uint16_t categoryBitMask;
+    };
+
+    /**
+     * @brief The doodads of query i are doodadIndices[offsets[i], offsets[i + 1])
+     */
+    struct BatchResults {
+        std::span<const std::size_t> get(const std::size_t queryIndex) const {
+            return std::span<const std::size_t>(doodadIndices).subspan(offsets[queryIndex], offsets[queryIndex + 1] - offsets[queryIndex]);
+        }
+
+        std::vector<std::size_t> doodadIndices;
+        std::vector<std::size_t> offsets;
+    };
+
+public: // member functions
+    explicit SpatialIndex(const DoodadStore& doodadStore);
+
+    /**
+     * @brief Moves the active doodads' proxies to their current positions. Returns how many of them had left
+     * their fat box and were reinserted
+     */
+    std::size_t update(const DoodadStore& doodadStore);
+
+    std::size_t getDoodadCount() const { return m_tree.getProxyCount(); }
+    int32_t getHeight() const { return m_tree.getHeight(); }
+
+    void querySpheres(std::span<const SphereQuery> queries, BatchResults& results) const;
+    void queryAabbs(std::span<const AabbQuery> queries, BatchResults& results) const;
+    void queryNearest(std::span<const NearestQuery> queries, BatchResults& results, FrameArena* const p_frameArena = nullptr) const;
+    void raycast(std::span<const RayQuery> queries, std::vector<std::optional<DynamicAabbTree::RayHit>>& hits) const;
+
+private: // member variables
+    DynamicAabbTree m_tree;
+
+    /**
+     * @brief Indexed by doodad index, -1 for doodads without a collider
+     */
+    std::vector<int32_t> m_proxyIds;
+};
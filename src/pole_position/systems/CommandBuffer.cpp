@@ -0,0 +1,71 @@
+#include <cstddef>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/physics/Conversions.hpp"
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/vehicle/VehicleControls.hpp"
+
+void
+CommandBuffer::setRotation(
+    const std::size_t doodadIndex,
+    const math::Quaternion& rotation
+) {
+    m_commands.push_back({CommandKind::SetRotation, doodadIndex, math::Vec3(), rotation});
+}
+
+void
+CommandBuffer::setLinearVelocity(
+    const std::size_t doodadIndex,
+    const math::Vec3& linearVelocity_mps
+) {
+    m_commands.push_back({CommandKind::SetLinearVelocity, doodadIndex, linearVelocity_mps, math::Quaternion()});
+}
+
+void
+CommandBuffer::applyForce(
+    const std::size_t doodadIndex,
+    const math::Vec3& force_N
+) {
+    m_commands.push_back({CommandKind::ApplyForce, doodadIndex, force_N, math::Quaternion()});
+}
+
+void
+CommandBuffer::setVehicleControls(
+    const std::size_t doodadIndex,
+    const VehicleControls& controls
+) {
+    m_commands.push_back({CommandKind::SetVehicleControls, doodadIndex, math::Vec3(controls.throttle, controls.brake, controls.steering), math::Quaternion()});
+}
+
+void
+CommandBuffer::apply(
+    DoodadStore& doodadStore
+) const {
+    for (const Command& command : m_commands) {
+        reactphysics3d::RigidBody* const p_rigidBody = doodadStore.rigidBodies[command.doodadIndex];
+
+        switch (command.kind) {
+            case CommandKind::SetRotation: {
+                reactphysics3d::Transform bodyTransform = p_rigidBody->getTransform();
+                bodyTransform.setOrientation(toReactPhysics3d(command.rotation));
+                p_rigidBody->setTransform(bodyTransform);
+                doodadStore.rotations[command.doodadIndex] = command.rotation;
+                break;
+            }
+            case CommandKind::SetLinearVelocity:
+                p_rigidBody->setLinearVelocity(toReactPhysics3d(command.vector));
+                break;
+            case CommandKind::ApplyForce:
+                p_rigidBody->applyWorldForceAtCenterOfMass(toReactPhysics3d(command.vector));
+                break;
+            case CommandKind::SetVehicleControls:
+                doodadStore.vehicleControls[command.doodadIndex] = {command.vector.x, command.vector.y, command.vector.z};
+                break;
+        }
+    }
+}
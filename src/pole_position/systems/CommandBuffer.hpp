@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/vehicle/VehicleControls.hpp"
+
+/**
+ * @brief The writes a system's fixed update wants to make to the doodads' rigid bodies, held back until every
+ * system has read the doodad store. Buffers are applied one after another in a fixed order, so the outcome does
+ * not depend on which thread filled which buffer or when
+ */
+class CommandBuffer {
+public: // member functions
+    CommandBuffer() = default;
+
+    void setRotation(const std::size_t doodadIndex, const math::Quaternion& rotation);
+    void setLinearVelocity(const std::size_t doodadIndex, const math::Vec3& linearVelocity_mps);
+    void applyForce(const std::size_t doodadIndex, const math::Vec3& force_N);
+    void setVehicleControls(const std::size_t doodadIndex, const VehicleControls& controls);
+
+    std::size_t size() const { return m_commands.size(); }
+    void clear() { m_commands.clear(); }
+
+    /**
+     * @brief Applies the commands in the order they were recorded
+     */
+    void apply(DoodadStore& doodadStore) const;
+
+private: // classes and enums
+    enum class CommandKind : uint8_t {
+        SetRotation,
+        SetLinearVelocity,
+        ApplyForce,
+        SetVehicleControls
+    };
+
+    /**
+     * @brief Vehicle controls travel in the vector as (throttle, brake, steering), rather than making every
+     * command bigger for them
+     */
+    struct Command {
+        CommandKind kind;
+        std::size_t doodadIndex;
+        math::Vec3 vector;
+        math::Quaternion rotation;
+    };
+
+private: // member variables
+    std::vector<Command> m_commands;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/vehicle/VehicleControls.hpp"
+
+/**
+ * @brief The doodads of a simulation as structure of arrays, indexed by the doodad's position in the scene
+ * parameters. Systems walk only the columns they need, and only for the doodads they were registered for
+ */
+struct DoodadStore {
+public: // member functions
+    std::size_t size() const { return positions.size(); }
+
+public: // member variables
+    std::vector<math::Vec3> positions;
+    std::vector<math::Quaternion> rotations;
+    std::vector<math::Vec3> scales;
+    std::vector<reactphysics3d::RigidBody*> rigidBodies; // null for doodads without a rigid body
+
+    /**
+     * @brief The radius of the sphere around the doodad's position that holds its collider however it is rotated,
+     * and its collider's categories. Both are 0 for doodads without a rigid body
+     */
+    std::vector<double> boundingRadii;
+    std::vector<uint16_t> collisionCategoryBitMasks;
+
+    /**
+     * @brief The doodads whose bodies the physics step can move, which are the only ones that need their
+     * transforms synced back after it
+     */
+    std::vector<std::size_t> movableDoodadIndices;
+
+    /**
+     * @brief The movable doodads whose transforms the last tick could have changed, because their bodies were awake
+     * for it or fell asleep during it. Sleeping bodies stay where they are until something wakes them, so everything
+     * downstream of the physics step only has to look at these
+     */
+    std::vector<std::size_t> activeDoodadIndices;
+
+    /**
+     * @brief The last tick each doodad was active in, only meaningful for movable doodads. Lets code that skipped
+     * some ticks find out which doodads moved since it last looked
+     */
+    std::vector<uint64_t> lastActiveTickIndices;
+
+    /**
+     * @brief The doodads without rigid bodies that a GhostPlayback moves along recorded trajectories. They are not
+     * movable, since the physics step never moves them, but their lastActiveTickIndices are kept like the movable
+     * doodads', so whatever copies or interpolates the doodads that moved has to look at these as well
+     */
+    std::vector<std::size_t> ghostDoodadIndices;
+
+    /**
+     * @brief What each vehicle's driver asked for, read by the VehicleFleet before each physics substep. Empty until
+     * the simulation has vehicles, then one per doodad, which is idle for the doodads that are not vehicles
+     */
+    std::vector<VehicleControls> vehicleControls;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "util/macros.hpp"
+
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/memory/FrameArena.hpp"
+#include "pole_position/spatial/SpatialIndex.hpp"
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+
+/**
+ * @brief What a system gets to work with. The doodad indices are only the doodads the system was registered for,
+ * or in a fixed update, the slice of them that this call is responsible for. The spatial index matches the
+ * doodad store, and is null when the update runs against a copy of the store, like an interpolated one on
+ * another thread.
+ *
+ * Temporaries that only live for the call go in the frame arena, which is this call's own and is reset before the
+ * next one, so nothing allocated from it may be kept
+ */
+struct SystemContext {
+    const DoodadStore& doodadStore;
+    const SpatialIndex* p_spatialIndex;
+    std::span<const std::size_t> doodadIndices;
+    const InputState& inputState;
+    double ticksPerSecond;
+    FrameArena& frameArena;
+};
+
+/**
+ * @brief A behaviour that runs once per tick over every doodad it was registered for, instead of once per doodad
+ * through a callback. Doodads that no system was registered for are never visited
+ */
+class DoodadSystem {
+public: // member functions
+    virtual ~DoodadSystem() = default;
+
+    /**
+     * @brief Used as the profiler scope of the system, so it has to outlive the system
+     */
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Runs on the simulation's thread before any system's fixedUpdate, for the work that is done once per
+     * tick rather than once per doodad
+     */
+    virtual void prepareFixedUpdate(UNUSED const InputState& inputState, UNUSED const double ticksPerSecond) {}
+
+    /**
+     * @brief Runs before the physics step. The doodad store holds the transforms from the end of the previous
+     * step and must only be read, every write goes through the command buffer. With a job system, several slices
+     * of the system's doodads run at the same time, so anything else the system touches here must be read only
+     */
+    virtual void fixedUpdate(UNUSED const SystemContext& context, UNUSED CommandBuffer& commandBuffer) const {}
+
+    /**
+     * @brief Runs on the simulation's thread after the physics step, once the doodads' transforms have been synced
+     */
+    virtual void update(UNUSED const SystemContext& context) {}
+};
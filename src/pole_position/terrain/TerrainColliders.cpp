@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/physics/ContactEventBuffer.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/scene/SceneParameters.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/terrain/TerrainColliders.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+
+TerrainColliders::TerrainColliders(
+    reactphysics3d::PhysicsCommon& physicsCommon,
+    reactphysics3d::PhysicsWorld* const p_physicsWorld,
+    const TerrainFile& terrainFile,
+    const double margin
+) :
+    m_physicsCommon(physicsCommon),
+    mp_physicsWorld(p_physicsWorld),
+    m_terrainFile(terrainFile),
+    m_margin(margin),
+    m_doodadChunkRanges(),
+    m_chunkColliders(terrainFile.getChunkCount(), {nullptr, nullptr, 0, 0}),
+    m_colliderChunkIndices(),
+    m_maxColliderCount(0),
+    m_createdColliderCount(0),
+    m_destroyedColliderCount(0)
+{}
+
+TerrainColliders::~TerrainColliders() {
+    for (const uint32_t chunkIndex : m_colliderChunkIndices) {
+        this->destroyCollider(chunkIndex);
+    }
+}
+
+void
+TerrainColliders::update(
+    const DoodadStore& doodadStore,
+    std::span<const std::size_t> doodadIndices,
+    const uint64_t tickIndex
+) {
+    PROFILE_SCOPE("Terrain colliders update");
+
+    if (m_doodadChunkRanges.size() < doodadStore.size()) {
+        m_doodadChunkRanges.resize(doodadStore.size(), s_emptyChunkRange);
+    }
+
+    for (const std::size_t doodadIndex : doodadIndices) {
+        const ChunkRange chunkRange = this->getChunkRange(doodadStore, doodadIndex);
+        ChunkRange& previousChunkRange = m_doodadChunkRanges[doodadIndex];
+        if (chunkRange == previousChunkRange) {
+            continue;
+        }
+
+        // Referencing the new chunks first keeps the ones in both ranges from dropping to 0 in between
+        this->addReferences(chunkRange, 1, tickIndex);
+        this->addReferences(previousChunkRange, -1, tickIndex);
+        previousChunkRange = chunkRange;
+    }
+
+    for (std::size_t i = 0; i < m_colliderChunkIndices.size();) {
+        const uint32_t chunkIndex = m_colliderChunkIndices[i];
+        const ChunkCollider& chunkCollider = m_chunkColliders[chunkIndex];
+        if (chunkCollider.referenceCount > 0 || tickIndex - chunkCollider.lastReferencedTickIndex < s_lingerTickCount) {
+            ++i;
+            continue;
+        }
+
+        this->destroyCollider(chunkIndex);
+        m_colliderChunkIndices[i] = m_colliderChunkIndices.back();
+        m_colliderChunkIndices.pop_back();
+    }
+}
+
+TerrainColliders::Statistics
+TerrainColliders::getStatistics() const {
+    return {
+        m_colliderChunkIndices.size(),
+        m_maxColliderCount,
+        m_createdColliderCount,
+        m_destroyedColliderCount
+    };
+}
+
+TerrainColliders::ChunkRange
+TerrainColliders::getChunkRange(
+    const DoodadStore& doodadStore,
+    const std::size_t doodadIndex
+) const {
+    const math::Vec3& position = doodadStore.positions[doodadIndex];
+    const double reach = doodadStore.boundingRadii[doodadIndex] + m_margin;
+
+    const ChunkRange chunkRange {
+        std::max<int64_t>(m_terrainFile.getChunkX(static_cast<double>(position.x) - reach), 0),
+        std::max<int64_t>(m_terrainFile.getChunkZ(static_cast<double>(position.z) - reach), 0),
+        std::min<int64_t>(m_terrainFile.getChunkX(static_cast<double>(position.x) + reach), static_cast<int64_t>(m_terrainFile.getChunkCountX()) - 1),
+        std::min<int64_t>(m_terrainFile.getChunkZ(static_cast<double>(position.z) + reach), static_cast<int64_t>(m_terrainFile.getChunkCountZ()) - 1)
+    };
+
+    return chunkRange.firstChunkX <= chunkRange.lastChunkX && chunkRange.firstChunkZ <= chunkRange.lastChunkZ ? chunkRange : s_emptyChunkRange;
+}
+
+void
+TerrainColliders::addReferences(
+    const ChunkRange& chunkRange,
+    const int32_t referenceCountDelta,
+    const uint64_t tickIndex
+) {
+    for (int64_t chunkZ = chunkRange.firstChunkZ; chunkZ <= chunkRange.lastChunkZ; ++chunkZ) {
+        for (int64_t chunkX = chunkRange.firstChunkX; chunkX <= chunkRange.lastChunkX; ++chunkX) {
+            const uint32_t chunkIndex = static_cast<uint32_t>(chunkZ) * m_terrainFile.getChunkCountX() + static_cast<uint32_t>(chunkX);
+            ChunkCollider& chunkCollider = m_chunkColliders[chunkIndex];
+            chunkCollider.referenceCount += referenceCountDelta;
+            chunkCollider.lastReferencedTickIndex = tickIndex;
+
+            if (chunkCollider.referenceCount > 0 && !chunkCollider.p_body) {
+                this->createCollider(chunkIndex);
+                m_colliderChunkIndices.push_back(chunkIndex);
+                m_maxColliderCount = std::max(m_maxColliderCount, m_colliderChunkIndices.size());
+            }
+        }
+    }
+}
+
+void
+TerrainColliders::createCollider(
+    const uint32_t chunkIndex
+) {
+    const TerrainFile::ChunkLod chunkLod = m_terrainFile.getChunkLod(chunkIndex, 0);
+    const terrain_file_format::ChunkEntry& chunkEntry = m_terrainFile.getChunkEntry(chunkIndex);
+    const double chunkSize = m_terrainFile.getChunkSize();
+    const double sampleSpacing = chunkSize / (chunkLod.samplesPerSide - 1);
+
+    // Nothing is copied, the shape reads the heights out of the mapping for as long as it lives
+    ChunkCollider& chunkCollider = m_chunkColliders[chunkIndex];
+    chunkCollider.p_shape = m_physicsCommon.createHeightFieldShape(
+        static_cast<int>(chunkLod.samplesPerSide),
+        static_cast<int>(chunkLod.samplesPerSide),
+        static_cast<reactphysics3d::decimal>(chunkEntry.minHeight),
+        static_cast<reactphysics3d::decimal>(chunkEntry.maxHeight),
+        chunkLod.p_heights,
+        reactphysics3d::HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE,
+        1,
+        1,
+        reactphysics3d::Vector3(static_cast<reactphysics3d::decimal>(sampleSpacing), 1, static_cast<reactphysics3d::decimal>(sampleSpacing))
+    );
+
+    // The shape is centered on its body, halfway between its lowest and highest point
+    const uint32_t chunkX = chunkIndex % m_terrainFile.getChunkCountX();
+    const uint32_t chunkZ = chunkIndex / m_terrainFile.getChunkCountX();
+    chunkCollider.p_body = mp_physicsWorld->createRigidBody({
+        reactphysics3d::Vector3(
+            static_cast<reactphysics3d::decimal>(m_terrainFile.getChunkMinX(chunkX) + 0.5 * chunkSize),
+            static_cast<reactphysics3d::decimal>(0.5 * (chunkEntry.minHeight + chunkEntry.maxHeight)),
+            static_cast<reactphysics3d::decimal>(m_terrainFile.getChunkMinZ(chunkZ) + 0.5 * chunkSize)
+        ),
+        reactphysics3d::Quaternion::identity()
+    });
+    chunkCollider.p_body->setType(reactphysics3d::BodyType::STATIC);
+    chunkCollider.p_body->setUserData(reinterpret_cast<void*>(static_cast<uintptr_t>(ContactEventBuffer::noDoodadIndex)));
+
+    reactphysics3d::Collider* const p_collider = chunkCollider.p_body->addCollider(chunkCollider.p_shape, reactphysics3d::Transform::identity());
+    p_collider->setCollisionCategoryBits(static_cast<uint16_t>(CollisionCategories::Terrain));
+    p_collider->setCollideWithMaskBits(0xFFFF ^ static_cast<uint16_t>(CollisionCategories::Terrain));
+
+    ++m_createdColliderCount;
+}
+
+void
+TerrainColliders::destroyCollider(
+    const uint32_t chunkIndex
+) {
+    ChunkCollider& chunkCollider = m_chunkColliders[chunkIndex];
+    mp_physicsWorld->destroyRigidBody(chunkCollider.p_body);
+    m_physicsCommon.destroyHeightFieldShape(chunkCollider.p_shape);
+    chunkCollider.p_body = nullptr;
+    chunkCollider.p_shape = nullptr;
+
+    ++m_destroyedColliderCount;
+}
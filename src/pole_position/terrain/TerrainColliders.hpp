@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+
+/**
+ * @brief Gives the terrain chunks near movable doodads a static heightfield body in the physics world, and takes it
+ * away again once no movable doodad has been near the chunk for a while. The heightfields read their heights
+ * straight out of the terrain file's mapping at full detail.
+ *
+ * Each movable doodad holds a reference on the chunks within its bounding radius plus a margin of its position.
+ * Sleeping bodies do not move, so only the active doodads' references are updated each tick, and a chunk under a
+ * sleeping body keeps its collider for as long as the body sleeps on it.
+ *
+ * The chunks' bodies are not doodads, their user data is ContactEventBuffer::noDoodadIndex
+ */
+class TerrainColliders {
+public: // classes and enums
+    struct Statistics {
+        std::size_t colliderCount;
+        std::size_t maxColliderCount;
+        uint64_t createdColliderCount;
+        uint64_t destroyedColliderCount;
+    };
+
+public: // member functions
+    TerrainColliders(
+        reactphysics3d::PhysicsCommon& physicsCommon,
+        reactphysics3d::PhysicsWorld* const p_physicsWorld,
+        const TerrainFile& terrainFile,
+        const double margin
+    );
+    TerrainColliders(const TerrainColliders& other) = delete;
+    TerrainColliders& operator=(const TerrainColliders& other) = delete;
+    ~TerrainColliders();
+
+    /**
+     * @brief Moves the given doodads' references to the chunks around where they are now, then destroys the
+     * colliders of chunks that have gone unreferenced for long enough
+     */
+    void update(const DoodadStore& doodadStore, std::span<const std::size_t> doodadIndices, const uint64_t tickIndex);
+
+    Statistics getStatistics() const;
+
+    USE_LOGGER(TERRAIN);
+
+private: // classes and enums
+    /**
+     * @brief Inclusive, and empty when the doodad is not over the terrain
+     */
+    struct ChunkRange {
+        int64_t firstChunkX;
+        int64_t firstChunkZ;
+        int64_t lastChunkX;
+        int64_t lastChunkZ;
+
+        bool operator==(const ChunkRange& other) const = default;
+    };
+
+    struct ChunkCollider {
+        reactphysics3d::HeightFieldShape* p_shape;
+        reactphysics3d::RigidBody* p_body;
+        uint32_t referenceCount;
+        uint64_t lastReferencedTickIndex;
+    };
+
+private: // member functions
+    ChunkRange getChunkRange(const DoodadStore& doodadStore, const std::size_t doodadIndex) const;
+    void addReferences(const ChunkRange& chunkRange, const int32_t referenceCountDelta, const uint64_t tickIndex);
+    void createCollider(const uint32_t chunkIndex);
+    void destroyCollider(const uint32_t chunkIndex);
+
+private: // static variables
+    static constexpr ChunkRange s_emptyChunkRange = {0, 0, -1, -1};
+
+    /**
+     * @brief How long an unreferenced chunk keeps its collider, so a doodad moving back and forth over a chunk
+     * boundary does not rebuild the same collider every tick
+     */
+    static constexpr uint64_t s_lingerTickCount = 60;
+
+private: // member variables
+    reactphysics3d::PhysicsCommon& m_physicsCommon;
+    reactphysics3d::PhysicsWorld* mp_physicsWorld;
+    const TerrainFile& m_terrainFile;
+    double m_margin;
+
+    std::vector<ChunkRange> m_doodadChunkRanges;
+    std::vector<ChunkCollider> m_chunkColliders;
+    std::vector<uint32_t> m_colliderChunkIndices;
+
+    std::size_t m_maxColliderCount;
+    uint64_t m_createdColliderCount;
+    uint64_t m_destroyedColliderCount;
+};
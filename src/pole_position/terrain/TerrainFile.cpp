@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/asset_loading/MappedFile.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+#include "pole_position/terrain/TerrainFileFormat.hpp"
+
+namespace {
+
+/**
+ * @brief A pseudo random value in [-1, 1] for a lattice point
+ */
+double
+getLatticeValue(
+    const int64_t x,
+    const int64_t z,
+    const uint32_t seed
+) {
+    uint64_t hash = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(z) * 0xC2B2AE3D27D4EB4Full ^ seed;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return static_cast<double>(hash >> 11) / static_cast<double>(1ull << 53) * 2.0 - 1.0;
+}
+
+double
+getValueNoise(
+    const double x,
+    const double z,
+    const uint32_t seed
+) {
+    const double floorX = std::floor(x);
+    const double floorZ = std::floor(z);
+    const int64_t latticeX = static_cast<int64_t>(floorX);
+    const int64_t latticeZ = static_cast<int64_t>(floorZ);
+
+    // Smoothstepped so the surface has no creases along the lattice
+    const double tX = (x - floorX) * (x - floorX) * (3.0 - 2.0 * (x - floorX));
+    const double tZ = (z - floorZ) * (z - floorZ) * (3.0 - 2.0 * (z - floorZ));
+
+    const double value00 = getLatticeValue(latticeX, latticeZ, seed);
+    const double value10 = getLatticeValue(latticeX + 1, latticeZ, seed);
+    const double value01 = getLatticeValue(latticeX, latticeZ + 1, seed);
+    const double value11 = getLatticeValue(latticeX + 1, latticeZ + 1, seed);
+
+    const double value0 = value00 + (value10 - value00) * tX;
+    const double value1 = value01 + (value11 - value01) * tX;
+    return value0 + (value1 - value0) * tZ;
+}
+
+/**
+ * @brief Six octaves of value noise, the coarsest with hills about a kilometre across
+ */
+double
+getTerrainHeight(
+    const double x,
+    const double z,
+    const double amplitude,
+    const uint32_t seed
+) {
+    double height = 0.0;
+    double octaveAmplitude = 1.0;
+    double frequency = 1.0 / 1000.0;
+    for (uint32_t octave = 0; octave < 6; ++octave) {
+        height += getValueNoise(x * frequency, z * frequency, seed + octave) * octaveAmplitude;
+        octaveAmplitude *= 0.5;
+        frequency *= 2.0;
+    }
+
+    // Flat where the demo level's ground is, rising into the hills over the next few hundred metres
+    const double distance = std::sqrt(x * x + z * z);
+    const double t = std::clamp((distance - 150.0) / 300.0, 0.0, 1.0);
+    return height * amplitude * t * t * (3.0 - 2.0 * t);
+}
+
+template <typename T>
+void
+writeValues(
+    std::ofstream& outputStream,
+    const T* p_values,
+    const std::size_t count
+) {
+    outputStream.write(reinterpret_cast<const char*>(p_values), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+void
+TerrainFile::generate(
+    const std::string& filepath,
+    const GenerationParameters& parameters
+) {
+    LOG_FUNCTION_SCOPE_INFOthis("{} ( {}x{} chunks of {} m )", filepath, parameters.chunkCountX, parameters.chunkCountZ, parameters.chunkSize);
+
+    const uint32_t cellsPerSide = parameters.samplesPerSide - 1;
+    if (parameters.samplesPerSide < 2 || !std::has_single_bit(cellsPerSide)) {
+        throw std::runtime_error("Terrain chunks need a power of 2 plus 1 samples per side");
+    }
+    if (parameters.lodCount == 0 || (cellsPerSide >> (parameters.lodCount - 1)) == 0) {
+        throw std::runtime_error("Terrain chunks are too small for that many levels of detail");
+    }
+
+    std::ofstream outputStream(filepath, std::ios::binary | std::ios::trunc);
+    if (!outputStream) {
+        throw std::runtime_error("Failed to open " + filepath + " for writing");
+    }
+
+    const uint32_t chunkCount = parameters.chunkCountX * parameters.chunkCountZ;
+    const uint64_t chunkByteCount = TerrainFile::getLodOffset(parameters.samplesPerSide, parameters.lodCount, 0) + terrain_file_format::getLodByteCount(parameters.samplesPerSide, 0);
+    const uint64_t firstChunkOffset = terrain_file_format::alignUp(sizeof(terrain_file_format::Header) + chunkCount * sizeof(terrain_file_format::ChunkEntry));
+    const uint64_t chunkStride = terrain_file_format::alignUp(chunkByteCount);
+
+    // Centered on the world's origin
+    const double originX = -0.5 * parameters.chunkCountX * parameters.chunkSize;
+    const double originZ = -0.5 * parameters.chunkCountZ * parameters.chunkSize;
+    const double sampleSpacing = parameters.chunkSize / cellsPerSide;
+
+    // The table is only known once every chunk is written, so it is written last over this
+    std::vector<terrain_file_format::ChunkEntry> chunkEntries(chunkCount);
+    outputStream.seekp(static_cast<std::streamoff>(firstChunkOffset));
+
+    std::vector<float> heights(static_cast<std::size_t>(parameters.samplesPerSide) * parameters.samplesPerSide);
+    std::vector<float> lodHeights;
+    std::vector<char> chunkBytes(chunkStride);
+    float minHeight = std::numeric_limits<float>::max();
+    float maxHeight = std::numeric_limits<float>::lowest();
+    for (uint32_t chunkZ = 0; chunkZ < parameters.chunkCountZ; ++chunkZ) {
+        for (uint32_t chunkX = 0; chunkX < parameters.chunkCountX; ++chunkX) {
+            const uint32_t chunkIndex = chunkZ * parameters.chunkCountX + chunkX;
+            const double chunkMinX = originX + chunkX * parameters.chunkSize;
+            const double chunkMinZ = originZ + chunkZ * parameters.chunkSize;
+
+            float chunkMinHeight = std::numeric_limits<float>::max();
+            float chunkMaxHeight = std::numeric_limits<float>::lowest();
+            for (uint32_t sampleZ = 0; sampleZ < parameters.samplesPerSide; ++sampleZ) {
+                for (uint32_t sampleX = 0; sampleX < parameters.samplesPerSide; ++sampleX) {
+                    const float height = static_cast<float>(getTerrainHeight(chunkMinX + sampleX * sampleSpacing, chunkMinZ + sampleZ * sampleSpacing, parameters.heightAmplitude, parameters.seed));
+                    heights[sampleZ * parameters.samplesPerSide + sampleX] = height;
+                    chunkMinHeight = std::min(chunkMinHeight, height);
+                    chunkMaxHeight = std::max(chunkMaxHeight, height);
+                }
+            }
+
+            // Coarser levels are every 2^lod-th sample of the full one, so they match their neighbours' edges too
+            std::fill(chunkBytes.begin(), chunkBytes.end(), 0);
+            for (uint32_t lod = 0; lod < parameters.lodCount; ++lod) {
+                const uint32_t lodSamplesPerSide = terrain_file_format::getLodSamplesPerSide(parameters.samplesPerSide, lod);
+                lodHeights.resize(static_cast<std::size_t>(lodSamplesPerSide) * lodSamplesPerSide);
+                for (uint32_t sampleZ = 0; sampleZ < lodSamplesPerSide; ++sampleZ) {
+                    for (uint32_t sampleX = 0; sampleX < lodSamplesPerSide; ++sampleX) {
+                        lodHeights[sampleZ * lodSamplesPerSide + sampleX] = heights[(sampleZ << lod) * parameters.samplesPerSide + (sampleX << lod)];
+                    }
+                }
+                std::memcpy(chunkBytes.data() + TerrainFile::getLodOffset(parameters.samplesPerSide, parameters.lodCount, lod), lodHeights.data(), lodHeights.size() * sizeof(float));
+            }
+            writeValues(outputStream, chunkBytes.data(), chunkBytes.size());
+
+            chunkEntries[chunkIndex] = {firstChunkOffset + chunkIndex * chunkStride, chunkMinHeight, chunkMaxHeight};
+            minHeight = std::min(minHeight, chunkMinHeight);
+            maxHeight = std::max(maxHeight, chunkMaxHeight);
+        }
+    }
+
+    const terrain_file_format::Header header {
+        terrain_file_format::magic,
+        terrain_file_format::version,
+        static_cast<uint16_t>(parameters.lodCount),
+        parameters.chunkCountX,
+        parameters.chunkCountZ,
+        parameters.samplesPerSide,
+        static_cast<float>(parameters.chunkSize),
+        static_cast<float>(originX),
+        static_cast<float>(originZ),
+        minHeight,
+        maxHeight
+    };
+    outputStream.seekp(0);
+    writeValues(outputStream, &header, 1);
+    writeValues(outputStream, chunkEntries.data(), chunkEntries.size());
+
+    if (!outputStream) {
+        throw std::runtime_error("Failed to write " + filepath);
+    }
+
+    LOG_INFOthis("Wrote {} chunks ( {:.1f} km2, heights {:.1f} m to {:.1f} m ) to {}", chunkCount, parameters.chunkCountX * parameters.chunkSize * parameters.chunkCountZ * parameters.chunkSize / 1.0e6, minHeight, maxHeight, filepath);
+}
+
+TerrainFile::TerrainFile(
+    const std::string& filepath
+) :
+    m_mappedFile(filepath),
+    mp_header(nullptr),
+    mp_chunkEntries(nullptr)
+{
+    const std::string_view contents = m_mappedFile.getContents();
+    if (contents.size() < sizeof(terrain_file_format::Header)) {
+        throw std::runtime_error(filepath + " is not a terrain file");
+    }
+
+    // The mapping starts on a page, and the header and table are laid out so their members are aligned
+    mp_header = reinterpret_cast<const terrain_file_format::Header*>(contents.data());
+    if (mp_header->magic != terrain_file_format::magic || mp_header->version != terrain_file_format::version) {
+        throw std::runtime_error(filepath + " is not a terrain file of version " + std::to_string(terrain_file_format::version));
+    }
+
+    const uint32_t cellsPerSide = mp_header->samplesPerSide - 1;
+    if (mp_header->samplesPerSide < 2 || !std::has_single_bit(cellsPerSide) || mp_header->lodCount == 0 || (cellsPerSide >> (mp_header->lodCount - 1)) == 0 || !(mp_header->chunkSize > 0.0f)) {
+        throw std::runtime_error(filepath + " has malformed chunks");
+    }
+
+    const uint64_t chunkTableEnd = sizeof(terrain_file_format::Header) + static_cast<uint64_t>(this->getChunkCount()) * sizeof(terrain_file_format::ChunkEntry);
+    if (chunkTableEnd > contents.size()) {
+        throw std::runtime_error(filepath + " is truncated");
+    }
+    mp_chunkEntries = reinterpret_cast<const terrain_file_format::ChunkEntry*>(contents.data() + sizeof(terrain_file_format::Header));
+
+    const uint64_t chunkByteCount = TerrainFile::getLodOffset(mp_header->samplesPerSide, mp_header->lodCount, 0) + terrain_file_format::getLodByteCount(mp_header->samplesPerSide, 0);
+    for (uint32_t chunkIndex = 0; chunkIndex < this->getChunkCount(); ++chunkIndex) {
+        const terrain_file_format::ChunkEntry& chunkEntry = mp_chunkEntries[chunkIndex];
+        if (chunkEntry.dataOffset % terrain_file_format::chunkAlignment != 0 || chunkEntry.dataOffset < chunkTableEnd || chunkEntry.dataOffset + chunkByteCount > contents.size()) {
+            throw std::runtime_error(fmt::format("{} has chunk {} out of bounds", filepath, chunkIndex));
+        }
+    }
+
+    LOG_INFOthis("Mapped {}x{} terrain chunks of {} m with {} levels of detail from {}", mp_header->chunkCountX, mp_header->chunkCountZ, mp_header->chunkSize, mp_header->lodCount, filepath);
+}
+
+int64_t
+TerrainFile::getChunkX(
+    const double x
+) const {
+    return static_cast<int64_t>(std::floor((x - mp_header->originX) / this->getChunkSize()));
+}
+
+int64_t
+TerrainFile::getChunkZ(
+    const double z
+) const {
+    return static_cast<int64_t>(std::floor((z - mp_header->originZ) / this->getChunkSize()));
+}
+
+TerrainFile::ChunkLod
+TerrainFile::getChunkLod(
+    const uint32_t chunkIndex,
+    const uint32_t lod
+) const {
+    const uint64_t offset = mp_chunkEntries[chunkIndex].dataOffset + TerrainFile::getLodOffset(mp_header->samplesPerSide, mp_header->lodCount, lod);
+    return {
+        reinterpret_cast<const float*>(m_mappedFile.getContents().data() + offset),
+        terrain_file_format::getLodSamplesPerSide(mp_header->samplesPerSide, lod)
+    };
+}
+
+void
+TerrainFile::prefetchChunk(
+    const uint32_t chunkIndex,
+    const uint32_t lod
+) const {
+    const uint64_t lodEnd = TerrainFile::getLodOffset(mp_header->samplesPerSide, mp_header->lodCount, lod) + terrain_file_format::getLodByteCount(mp_header->samplesPerSide, lod);
+    m_mappedFile.prefetch(mp_chunkEntries[chunkIndex].dataOffset, lodEnd);
+}
+
+void
+TerrainFile::evictChunk(
+    const uint32_t chunkIndex,
+    const std::optional<uint32_t> o_keptLod
+) const {
+    // Chunks are padded out to the next one's page, so the padding is the chunk's to drop
+    const uint64_t chunkByteCount = terrain_file_format::alignUp(TerrainFile::getLodOffset(mp_header->samplesPerSide, mp_header->lodCount, 0) + terrain_file_format::getLodByteCount(mp_header->samplesPerSide, 0));
+    const uint64_t keptByteCount = o_keptLod ? TerrainFile::getLodOffset(mp_header->samplesPerSide, mp_header->lodCount, *o_keptLod) + terrain_file_format::getLodByteCount(mp_header->samplesPerSide, *o_keptLod) : 0;
+    m_mappedFile.evict(mp_chunkEntries[chunkIndex].dataOffset + keptByteCount, chunkByteCount - keptByteCount);
+}
+
+uint64_t
+TerrainFile::getLodOffset(
+    const uint32_t samplesPerSide,
+    const uint32_t lodCount,
+    const uint32_t lod
+) {
+    // Coarsest first, so everything coarser than the level comes before it
+    uint64_t offset = 0;
+    for (uint32_t coarserLod = lod + 1; coarserLod < lodCount; ++coarserLod) {
+        offset += terrain_file_format::getLodByteCount(samplesPerSide, coarserLod);
+    }
+
+    return offset;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/asset_loading/MappedFile.hpp"
+#include "pole_position/terrain/TerrainFileFormat.hpp"
+
+/**
+ * @brief A heightfield terrain cut into square chunks, mapped straight out of a terrain file. Nothing is parsed or
+ * copied, the heights are used where they lie in the mapping, so paging a chunk in costs the reads of its pages and
+ * nothing else. The chunks' coordinates run along x and z from the terrain's origin, and their index is
+ * chunkZ * chunkCountX + chunkX
+ */
+class TerrainFile {
+public: // classes and enums
+    struct GenerationParameters {
+        uint32_t chunkCountX;
+        uint32_t chunkCountZ;
+        uint32_t samplesPerSide; // must be a power of 2 plus 1
+        uint32_t lodCount;
+        double chunkSize;
+        double heightAmplitude;
+        uint32_t seed;
+    };
+
+    /**
+     * @brief The heights of one chunk at one level of detail, samplesPerSide by samplesPerSide row by row along z
+     */
+    struct ChunkLod {
+        const float* p_heights;
+        uint32_t samplesPerSide;
+    };
+
+public: // member functions
+    /**
+     * @brief Writes a terrain of rolling fractal noise, flattened around the world's origin where the demo level's
+     * doodads are
+     */
+    static void generate(const std::string& filepath, const GenerationParameters& parameters);
+
+    /**
+     * @brief Throws if the file cannot be mapped or is not a terrain file
+     */
+    explicit TerrainFile(const std::string& filepath);
+    TerrainFile(const TerrainFile& other) = delete;
+    TerrainFile& operator=(const TerrainFile& other) = delete;
+
+    uint32_t getChunkCountX() const { return mp_header->chunkCountX; }
+    uint32_t getChunkCountZ() const { return mp_header->chunkCountZ; }
+    uint32_t getChunkCount() const { return mp_header->chunkCountX * mp_header->chunkCountZ; }
+    uint32_t getSamplesPerSide() const { return mp_header->samplesPerSide; }
+    uint32_t getLodCount() const { return mp_header->lodCount; }
+    double getChunkSize() const { return mp_header->chunkSize; }
+    double getMinHeight() const { return mp_header->minHeight; }
+    double getMaxHeight() const { return mp_header->maxHeight; }
+
+    /**
+     * @brief The chunk coordinate a world coordinate falls in, which is outside of the terrain for coordinates
+     * that are
+     */
+    int64_t getChunkX(const double x) const;
+    int64_t getChunkZ(const double z) const;
+    double getChunkMinX(const uint32_t chunkX) const { return mp_header->originX + chunkX * this->getChunkSize(); }
+    double getChunkMinZ(const uint32_t chunkZ) const { return mp_header->originZ + chunkZ * this->getChunkSize(); }
+
+    const terrain_file_format::ChunkEntry& getChunkEntry(const uint32_t chunkIndex) const { return mp_chunkEntries[chunkIndex]; }
+    ChunkLod getChunkLod(const uint32_t chunkIndex, const uint32_t lod) const;
+
+    /**
+     * @brief Ask the kernel to start paging in what the chunk at the level of detail reads, which for coarse
+     * levels is only the chunk's first page
+     */
+    void prefetchChunk(const uint32_t chunkIndex, const uint32_t lod) const;
+
+    /**
+     * @brief Let the kernel drop the chunk's pages that the level of detail does not read, or all of them without
+     * one. Dropping pages someone still reads is safe, they are read from the file again
+     */
+    void evictChunk(const uint32_t chunkIndex, const std::optional<uint32_t> o_keptLod) const;
+
+    USE_LOGGER(TERRAIN);
+
+private: // helpers
+    /**
+     * @brief Where the level of detail starts within its chunk's data
+     */
+    static uint64_t getLodOffset(const uint32_t samplesPerSide, const uint32_t lodCount, const uint32_t lod);
+
+private: // member variables
+    MappedFile m_mappedFile;
+    const terrain_file_format::Header* mp_header;
+    const terrain_file_format::ChunkEntry* mp_chunkEntries;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief The layout of a terrain file.
+ *
+ * A terrain file is a header, a table with an entry per chunk and then each chunk's heights. Chunks are laid out
+ * row by row along z, and each chunk's heights start on a page boundary so that a chunk can be paged in and out of
+ * the mapping without touching its neighbours:
+ *
+ *   Header | ChunkEntry[chunkCountX * chunkCountZ] | chunk 0 | chunk 1 | ...
+ *
+ * A chunk holds its levels of detail coarsest first, so the coarse levels share the chunk's first pages and only a
+ * chunk drawn at full detail needs the rest of them. Level l has ((samplesPerSide - 1) >> l) + 1 samples per side,
+ * as 32 bit floats row by row along z. Neighbouring chunks share the samples along their common edge, so there are
+ * no seams at any level
+ */
+namespace terrain_file_format {
+
+constexpr std::array<char, 4> magic = {'P', 'P', 'T', 'R'};
+constexpr uint16_t version = 1;
+
+constexpr uint64_t chunkAlignment = 4096;
+
+struct Header {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint16_t lodCount;
+    uint32_t chunkCountX;
+    uint32_t chunkCountZ;
+    uint32_t samplesPerSide;
+    float chunkSize;
+    float originX;
+    float originZ;
+    float minHeight;
+    float maxHeight;
+};
+static_assert(sizeof(Header) == 40);
+
+struct ChunkEntry {
+    uint64_t dataOffset;
+    float minHeight;
+    float maxHeight;
+};
+static_assert(sizeof(ChunkEntry) == 16);
+
+constexpr uint32_t
+getLodSamplesPerSide(
+    const uint32_t samplesPerSide,
+    const uint32_t lod
+) {
+    return ((samplesPerSide - 1) >> lod) + 1;
+}
+
+constexpr uint64_t
+getLodByteCount(
+    const uint32_t samplesPerSide,
+    const uint32_t lod
+) {
+    const uint64_t lodSamplesPerSide = getLodSamplesPerSide(samplesPerSide, lod);
+    return lodSamplesPerSide * lodSamplesPerSide * sizeof(float);
+}
+
+constexpr uint64_t
+alignUp(
+    const uint64_t offset
+) {
+    return (offset + chunkAlignment - 1) & ~(chunkAlignment - 1);
+}
+
+} // namespace terrain_file_format
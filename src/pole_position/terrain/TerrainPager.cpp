@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+#include "pole_position/terrain/TerrainPager.hpp"
+
+TerrainPager::TerrainPager(
+    const TerrainFile& terrainFile,
+    const Parameters& parameters
+) :
+    m_terrainFile(terrainFile),
+    m_parameters(parameters),
+    m_chunkLods(terrainFile.getChunkCount(), s_notResident),
+    m_chunkVisitedUpdateIndices(terrainFile.getChunkCount(), 0),
+    m_residentChunks(),
+    m_nextResidentChunks(),
+    m_updateCount(0),
+    m_totalResidentChunkCount(0),
+    m_maxResidentChunkCount(0),
+    m_pagedInChunkCount(0),
+    m_pagedOutChunkCount(0),
+    m_lodChangeCount(0),
+    m_totalUpdateMicroseconds(0.0),
+    m_maxUpdateMicroseconds(0.0),
+    m_totalChunkCountsByLod(terrainFile.getLodCount(), 0)
+{
+    // Enough for every chunk the load radius can reach, so updates never allocate
+    const std::size_t maxChunksPerSide = static_cast<std::size_t>(std::ceil(2.0 * m_parameters.loadRadius / terrainFile.getChunkSize())) + 1;
+    m_residentChunks.reserve(maxChunksPerSide * maxChunksPerSide);
+    m_nextResidentChunks.reserve(maxChunksPerSide * maxChunksPerSide);
+}
+
+void
+TerrainPager::update(
+    const math::Vec3& cameraPosition
+) {
+    PROFILE_SCOPE("Terrain paging");
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point startTime = Clock::now();
+
+    const double cameraX = static_cast<double>(cameraPosition.x);
+    const double cameraZ = static_cast<double>(cameraPosition.z);
+    const double chunkSize = m_terrainFile.getChunkSize();
+
+    const int64_t firstChunkX = std::max<int64_t>(m_terrainFile.getChunkX(cameraX - m_parameters.loadRadius), 0);
+    const int64_t lastChunkX = std::min<int64_t>(m_terrainFile.getChunkX(cameraX + m_parameters.loadRadius), static_cast<int64_t>(m_terrainFile.getChunkCountX()) - 1);
+    const int64_t firstChunkZ = std::max<int64_t>(m_terrainFile.getChunkZ(cameraZ - m_parameters.loadRadius), 0);
+    const int64_t lastChunkZ = std::min<int64_t>(m_terrainFile.getChunkZ(cameraZ + m_parameters.loadRadius), static_cast<int64_t>(m_terrainFile.getChunkCountZ()) - 1);
+
+    m_nextResidentChunks.clear();
+    for (int64_t chunkZ = firstChunkZ; chunkZ <= lastChunkZ; ++chunkZ) {
+        for (int64_t chunkX = firstChunkX; chunkX <= lastChunkX; ++chunkX) {
+            // Distance along the ground to the nearest point of the chunk, which is 0 for the chunk the camera is over
+            const double chunkMinX = m_terrainFile.getChunkMinX(static_cast<uint32_t>(chunkX));
+            const double chunkMinZ = m_terrainFile.getChunkMinZ(static_cast<uint32_t>(chunkZ));
+            const double deltaX = std::max({chunkMinX - cameraX, 0.0, cameraX - (chunkMinX + chunkSize)});
+            const double deltaZ = std::max({chunkMinZ - cameraZ, 0.0, cameraZ - (chunkMinZ + chunkSize)});
+            const double distance = std::sqrt(deltaX * deltaX + deltaZ * deltaZ);
+            if (distance > m_parameters.loadRadius) {
+                continue;
+            }
+
+            const uint32_t chunkIndex = static_cast<uint32_t>(chunkZ) * m_terrainFile.getChunkCountX() + static_cast<uint32_t>(chunkX);
+            const uint32_t lod = this->getLod(distance);
+            const uint8_t previousLod = m_chunkLods[chunkIndex];
+            if (previousLod == s_notResident) {
+                m_terrainFile.prefetchChunk(chunkIndex, lod);
+                ++m_pagedInChunkCount;
+            } else if (lod < previousLod) {
+                m_terrainFile.prefetchChunk(chunkIndex, lod);
+                ++m_lodChangeCount;
+            } else if (lod > previousLod) {
+                m_terrainFile.evictChunk(chunkIndex, lod);
+                ++m_lodChangeCount;
+            }
+
+            m_chunkLods[chunkIndex] = static_cast<uint8_t>(lod);
+            m_chunkVisitedUpdateIndices[chunkIndex] = m_updateCount;
+            m_nextResidentChunks.push_back({chunkIndex, lod});
+            ++m_totalChunkCountsByLod[lod];
+        }
+    }
+
+    // Whatever was resident and was not visited this time has left the load radius
+    for (const ResidentChunk& residentChunk : m_residentChunks) {
+        if (m_chunkVisitedUpdateIndices[residentChunk.chunkIndex] != m_updateCount) {
+            m_terrainFile.evictChunk(residentChunk.chunkIndex, std::nullopt);
+            m_chunkLods[residentChunk.chunkIndex] = s_notResident;
+            ++m_pagedOutChunkCount;
+        }
+    }
+    m_residentChunks.swap(m_nextResidentChunks);
+
+    const double updateMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - startTime).count();
+    ++m_updateCount;
+    m_totalResidentChunkCount += m_residentChunks.size();
+    m_maxResidentChunkCount = std::max(m_maxResidentChunkCount, m_residentChunks.size());
+    m_totalUpdateMicroseconds += updateMicroseconds;
+    m_maxUpdateMicroseconds = std::max(m_maxUpdateMicroseconds, updateMicroseconds);
+}
+
+TerrainPager::Statistics
+TerrainPager::getStatistics() const {
+    std::vector<double> meanChunkCountsByLod(m_totalChunkCountsByLod.size(), 0.0);
+    for (std::size_t lod = 0; lod < m_totalChunkCountsByLod.size(); ++lod) {
+        meanChunkCountsByLod[lod] = m_updateCount > 0 ? static_cast<double>(m_totalChunkCountsByLod[lod]) / m_updateCount : 0.0;
+    }
+
+    return {
+        m_updateCount,
+        m_updateCount > 0 ? static_cast<double>(m_totalResidentChunkCount) / m_updateCount : 0.0,
+        m_maxResidentChunkCount,
+        m_pagedInChunkCount,
+        m_pagedOutChunkCount,
+        m_lodChangeCount,
+        m_updateCount > 0 ? m_totalUpdateMicroseconds / m_updateCount : 0.0,
+        m_maxUpdateMicroseconds,
+        std::move(meanChunkCountsByLod)
+    };
+}
+
+void
+TerrainPager::logStatistics() const {
+    const Statistics statistics = this->getStatistics();
+
+    LOG_INFOthis("Paged terrain for {} frames, mean {:.1f} and max {} resident chunks", statistics.updateCount, statistics.meanResidentChunkCount, statistics.maxResidentChunkCount);
+    LOG_INFOthis("  {} chunks paged in, {} paged out, {} level of detail changes, update mean {:.2f} us, max {:.2f} us", statistics.pagedInChunkCount, statistics.pagedOutChunkCount, statistics.lodChangeCount, statistics.meanUpdateMicroseconds, statistics.maxUpdateMicroseconds);
+    for (std::size_t lod = 0; lod < statistics.meanChunkCountsByLod.size(); ++lod) {
+        LOG_INFOthis("  level of detail {}: mean {:.1f} chunks", lod, statistics.meanChunkCountsByLod[lod]);
+    }
+}
+
+uint32_t
+TerrainPager::getLod(
+    const double distance
+) const {
+    for (std::size_t lod = 0; lod < m_parameters.lodDistances.size() && lod + 1 < m_terrainFile.getLodCount(); ++lod) {
+        if (distance < m_parameters.lodDistances[lod]) {
+            return static_cast<uint32_t>(lod);
+        }
+    }
+
+    return m_terrainFile.getLodCount() - 1;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+
+/**
+ * @brief Keeps the terrain chunks around a camera paged in, each at a level of detail picked by its distance from
+ * the camera, standing in for the streaming in front of terrain mesh submission. A chunk that comes into range or
+ * needs a finer level has its pages prefetched, one that leaves range or needs a coarser level has the pages it no
+ * longer reads dropped, so what stays resident is what the camera can see at the detail it is drawn with
+ */
+class TerrainPager {
+public: // classes and enums
+    struct Parameters {
+        double loadRadius;
+
+        /**
+         * @brief A chunk closer than lodDistances[lod] is drawn at that level of detail, the finest that applies.
+         * Chunks further than all of them are drawn at the coarsest level
+         */
+        std::vector<double> lodDistances;
+    };
+
+    struct ResidentChunk {
+        uint32_t chunkIndex;
+        uint32_t lod;
+    };
+
+    struct Statistics {
+        uint64_t updateCount;
+        double meanResidentChunkCount;
+        std::size_t maxResidentChunkCount;
+        uint64_t pagedInChunkCount;
+        uint64_t pagedOutChunkCount;
+        uint64_t lodChangeCount;
+        double meanUpdateMicroseconds;
+        double maxUpdateMicroseconds;
+        std::vector<double> meanChunkCountsByLod;
+    };
+
+public: // member functions
+    TerrainPager(const TerrainFile& terrainFile, const Parameters& parameters);
+    TerrainPager(const TerrainPager& other) = delete;
+    TerrainPager& operator=(const TerrainPager& other) = delete;
+
+    void update(const math::Vec3& cameraPosition);
+
+    std::span<const ResidentChunk> getResidentChunks() const { return m_residentChunks; }
+    Statistics getStatistics() const;
+    void logStatistics() const;
+
+    USE_LOGGER(TERRAIN);
+
+private: // member functions
+    uint32_t getLod(const double distance) const;
+
+private: // static variables
+    static constexpr uint8_t s_notResident = 0xFF;
+
+private: // member variables
+    const TerrainFile& m_terrainFile;
+    Parameters m_parameters;
+
+    /**
+     * @brief Each chunk's level of detail, s_notResident for chunks that are not paged in
+     */
+    std::vector<uint8_t> m_chunkLods;
+    std::vector<uint64_t> m_chunkVisitedUpdateIndices;
+    std::vector<ResidentChunk> m_residentChunks;
+    std::vector<ResidentChunk> m_nextResidentChunks;
+
+    uint64_t m_updateCount;
+    uint64_t m_totalResidentChunkCount;
+    std::size_t m_maxResidentChunkCount;
+    uint64_t m_pagedInChunkCount;
+    uint64_t m_pagedOutChunkCount;
+    uint64_t m_lodChangeCount;
+    double m_totalUpdateMicroseconds;
+    double m_maxUpdateMicroseconds;
+    std::vector<uint64_t> m_totalChunkCountsByLod;
+};
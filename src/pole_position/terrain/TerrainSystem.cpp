@@ -0,0 +1,25 @@
+#include "util/macros.hpp"
+
+#include "quartz/scene/camera/Camera.hpp"
+
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+#include "pole_position/terrain/TerrainPager.hpp"
+#include "pole_position/terrain/TerrainSystem.hpp"
+#include "pole_position/third_person_controller/ThirdPersonController.hpp"
+
+TerrainSystem::TerrainSystem(
+    const ThirdPersonController& playerController,
+    const TerrainFile& terrainFile,
+    const TerrainPager::Parameters& pagerParameters
+) :
+    m_playerController(playerController),
+    m_terrainPager(terrainFile, pagerParameters)
+{}
+
+void
+TerrainSystem::update(
+    UNUSED const SystemContext& context
+) {
+    m_terrainPager.update(m_playerController.getCamera().getPosition());
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/terrain/TerrainFile.hpp"
+#include "pole_position/terrain/TerrainPager.hpp"
+#include "pole_position/third_person_controller/ThirdPersonController.hpp"
+
+/**
+ * @brief Pages the terrain in around the player's camera once per frame. Like the CullingSystem it has to be added
+ * after the player's controller so it sees the camera the frame is drawn with, and is registered over no doodads
+ */
+class TerrainSystem : public DoodadSystem {
+public: // member functions
+    TerrainSystem(
+        const ThirdPersonController& playerController,
+        const TerrainFile& terrainFile,
+        const TerrainPager::Parameters& pagerParameters
+    );
+
+    const char* getName() const override { return "Terrain system"; }
+    void update(const SystemContext& context) override;
+
+    const TerrainPager& getTerrainPager() const { return m_terrainPager; }
+
+private: // member variables
+    const ThirdPersonController& m_playerController;
+    TerrainPager m_terrainPager;
+};
@@ -10,6 +10,11 @@
 #include "quartz/scene/doodad/Doodad.hpp"
 #include "quartz/scene/scene/Scene.hpp"
 
+#include "pole_position/input/InputRecorder.hpp"
+#include "pole_position/input/InputReplayer.hpp"
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/logging/AsyncLogger.hpp"
+#include "pole_position/profiling/Profiler.hpp"
 #include "pole_position/third_person_controller/ThirdPersonController.hpp"
 
 math::Vec3
@@ -46,7 +51,10 @@ ThirdPersonController::ThirdPersonController() :
     m_cameraDistanceMax(200.0),
     m_cameraDistanceCurrent(10.0),
     m_maxHorizontalMovementSpeed(15.0),
-    m_currentHorizontalMovementSpeed(0.0)
+    m_currentHorizontalMovementSpeed(0.0),
+    mp_inputRecorder(nullptr),
+    mp_inputReplayer(nullptr),
+    m_replayedInputState(InputState::idle())
 {}
 
 void
@@ -61,44 +69,93 @@ void
 ThirdPersonController::fixedUpdateCallback(
     quartz::scene::Doodad::FixedUpdateCallbackParameters parameters
 ) {
-    this->movementFixedUpdate(parameters.inputManager, parameters.p_doodad, parameters.ticksPerSecond);
+    PROFILE_SCOPE("Player fixed update");
+    this->movementFixedUpdate(this->getFixedUpdateInputState(parameters.inputManager, parameters.ticksPerSecond), parameters.p_doodad, parameters.ticksPerSecond);
 }
 
 void
 ThirdPersonController::updateCallback(
     quartz::scene::Doodad::UpdateCallbackParameters parameters
 ) {
-    this->cameraUpdate(parameters.inputManager, parameters.p_doodad);
+    PROFILE_SCOPE("Player update");
+    this->cameraUpdate(this->getUpdateInputState(parameters.inputManager), parameters.p_doodad);
 }
 
-void
-ThirdPersonController::movementFixedUpdate(
+InputState
+ThirdPersonController::getFixedUpdateInputState(
     const quartz::managers::InputManager& inputManager,
-    quartz::scene::Doodad* const p_doodad,
-    UNUSED const double ticksPerSecond
+    const double ticksPerSecond
 ) {
-    const math::Vec3 forwardDirection = m_camera.getLookDirection().getProjectionOntoPlane(math::Vec3::Up).normalize();
+    if (mp_inputReplayer) {
+        // Several ticks can run before the next update, which has to see all of their camera movement, not only the
+        // last tick's
+        const InputState tickInputState = mp_inputReplayer->readNextTick().value_or(InputState::idle());
+        m_replayedInputState.keyDown_w = tickInputState.keyDown_w;
+        m_replayedInputState.keyDown_a = tickInputState.keyDown_a;
+        m_replayedInputState.keyDown_s = tickInputState.keyDown_s;
+        m_replayedInputState.keyDown_d = tickInputState.keyDown_d;
+        m_replayedInputState.mousePositionOffset_x += tickInputState.mousePositionOffset_x;
+        m_replayedInputState.mousePositionOffset_y += tickInputState.mousePositionOffset_y;
+        m_replayedInputState.scrollOffset_y += tickInputState.scrollOffset_y;
+        return tickInputState;
+    }
 
-    const math::Quaternion doodadRotation = math::Quaternion::fromEulerAngles(-1 * m_camera.getEulerAngles().yawDegrees, 0, 0);
-    p_doodad->setRotation(doodadRotation);
+    const InputState inputState = InputState::fromInputManager(inputManager);
+    if (mp_inputRecorder) {
+        mp_inputRecorder->recordFixedUpdate(inputState, ticksPerSecond);
+    }
 
+    return inputState;
+}
+
+InputState
+ThirdPersonController::getUpdateInputState(
+    const quartz::managers::InputManager& inputManager
+) {
+    if (mp_inputReplayer) {
+        // A replayed tick's camera movement is applied once, by the first update that follows it
+        const InputState inputState = m_replayedInputState;
+        m_replayedInputState.mousePositionOffset_x = 0.0;
+        m_replayedInputState.mousePositionOffset_y = 0.0;
+        m_replayedInputState.scrollOffset_y = 0.0;
+        return inputState;
+    }
+
+    const InputState inputState = InputState::fromInputManager(inputManager);
+    if (mp_inputRecorder) {
+        mp_inputRecorder->recordUpdate(inputState);
+    }
+
+    return inputState;
+}
+
+math::Quaternion
+ThirdPersonController::calculateDoodadRotation() const {
+    return math::Quaternion::fromEulerAngles(-1 * m_camera.getEulerAngles().yawDegrees, 0, 0);
+}
+
+math::Vec3
+ThirdPersonController::calculateMovementVelocity(
+    const InputState& inputState
+) {
+    const math::Vec3 forwardDirection = m_camera.getLookDirection().getProjectionOntoPlane(math::Vec3::Up).normalize();
     const math::Vec3 rightDirection = forwardDirection.cross(math::Vec3::Up).normalize();
 
     math::Vec3 horizontalMovementDirection(0, 0, 0);
 
     // Front and back
-    if (inputManager.getKeyDown_w()) {
+    if (inputState.keyDown_w) {
         horizontalMovementDirection += forwardDirection;
     }
-    if (inputManager.getKeyDown_s()) {
+    if (inputState.keyDown_s) {
         horizontalMovementDirection -= forwardDirection;
     }
 
     // Left and right
-    if (inputManager.getKeyDown_a()) {
+    if (inputState.keyDown_a) {
         horizontalMovementDirection -= rightDirection;
     }
-    if (inputManager.getKeyDown_d()) {
+    if (inputState.keyDown_d) {
         horizontalMovementDirection += rightDirection;
     }
 
@@ -106,32 +163,32 @@ ThirdPersonController::movementFixedUpdate(
     horizontalMovementDirection.normalize();
     const math::Vec3 currentHorizontalMovementVelocity = horizontalMovementDirection * m_maxHorizontalMovementSpeed;
 
-    quartz::physics::RigidBody& rigidBody = p_doodad->getRigidBodyOptionalReference().value();
-    rigidBody.setLinearVelocity_mps(currentHorizontalMovementVelocity);
-
     m_currentHorizontalMovementSpeed = currentHorizontalMovementVelocity.magnitude();
+    ASYNC_LOG_TRACE(PLAYER, "Horizontal movement speed {:.3f}", m_currentHorizontalMovementSpeed);
+
+    return currentHorizontalMovementVelocity;
 }
- 
+
 void
-ThirdPersonController::cameraUpdate(
-    const quartz::managers::InputManager& inputManager,
-    quartz::scene::Doodad* const p_doodad
+ThirdPersonController::updateCamera(
+    const InputState& inputState,
+    const math::Vec3& doodadPosition
 ) {
     // Rotate camera according to mouse input
     const quartz::scene::Camera::EulerAngles previousEulerAngles = m_camera.getEulerAngles();
-    const double calibratedMousePositionOffset_x = inputManager.getMousePositionOffset_x() * m_cameraSensitivity;
-    const double calibratedMousePositionOffset_y = inputManager.getMousePositionOffset_y() * m_cameraSensitivity;
+    const double calibratedMousePositionOffset_x = inputState.mousePositionOffset_x * m_cameraSensitivity;
+    const double calibratedMousePositionOffset_y = inputState.mousePositionOffset_y * m_cameraSensitivity;
     const double updatedPitch = std::clamp(previousEulerAngles.pitchDegrees + calibratedMousePositionOffset_y, -89.5, 89.5);
     const double updatedYaw = glm::mod(previousEulerAngles.yawDegrees - calibratedMousePositionOffset_x, 360.0);
     m_camera.setEulerAngles({updatedYaw, updatedPitch, previousEulerAngles.rollDegrees});
 
     // Update the camera distance according to mouse input
-    const double calibratedMouseDistanceOffset = inputManager.getScrollOffset_y() * m_cameraDistanceSensitivity * -1.0;
+    const double calibratedMouseDistanceOffset = inputState.scrollOffset_y * m_cameraDistanceSensitivity * -1.0;
     m_cameraDistanceCurrent += calibratedMouseDistanceOffset;
     m_cameraDistanceCurrent = std::clamp(m_cameraDistanceCurrent, m_cameraDistanceMin, m_cameraDistanceMax);
 
     // Move camera based on doodad's position and camera's direction
-    const math::Vec3 cameraInitialPosition = p_doodad->getTransform().position - m_camera.getLookDirection() * m_cameraDistanceCurrent;
+    const math::Vec3 cameraInitialPosition = doodadPosition - m_camera.getLookDirection() * m_cameraDistanceCurrent;
     const math::Vec3 cameraPositionOffset = ThirdPersonController::calculateCameraOffset(
         m_camera.getLookDirection(),
         m_cameraFocalPointHorizontalOffset,
@@ -141,6 +198,46 @@ ThirdPersonController::cameraUpdate(
     m_camera.setPosition(cameraPosition);
 }
 
+ThirdPersonController::State
+ThirdPersonController::getState() const {
+    return {
+        m_camera.getEulerAngles(),
+        m_camera.getPosition(),
+        m_cameraDistanceCurrent,
+        m_currentHorizontalMovementSpeed
+    };
+}
+
+void
+ThirdPersonController::setState(
+    const State& state
+) {
+    m_camera.setEulerAngles(state.cameraEulerAngles);
+    m_camera.setPosition(state.cameraPosition);
+    m_cameraDistanceCurrent = state.cameraDistance;
+    m_currentHorizontalMovementSpeed = state.horizontalMovementSpeed;
+}
+
+void
+ThirdPersonController::movementFixedUpdate(
+    const InputState& inputState,
+    quartz::scene::Doodad* const p_doodad,
+    UNUSED const double ticksPerSecond
+) {
+    p_doodad->setRotation(this->calculateDoodadRotation());
+
+    quartz::physics::RigidBody& rigidBody = p_doodad->getRigidBodyOptionalReference().value();
+    rigidBody.setLinearVelocity_mps(this->calculateMovementVelocity(inputState));
+}
+ 
+void
+ThirdPersonController::cameraUpdate(
+    const InputState& inputState,
+    quartz::scene::Doodad* const p_doodad
+) {
+    this->updateCamera(inputState, p_doodad->getTransform().position);
+}
+
 void
 ThirdPersonController::collisionStartCallback(
     UNUSED quartz::physics::Collider::CollisionCallbackParameters parameters
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
 #include "util/logger/Logger.hpp"
 
 #include "quartz/managers/input_manager/InputManager.hpp"
@@ -7,9 +10,21 @@
 #include "quartz/scene/doodad/Doodad.hpp"
 
 #include "pole_position/Loggers.hpp"
+#include "pole_position/input/InputRecorder.hpp"
+#include "pole_position/input/InputReplayer.hpp"
+#include "pole_position/input/InputState.hpp"
 
 class ThirdPersonController {
 public: // classes and enums
+    /**
+     * @brief What driving the controller changes, which is what a world snapshot needs to put it back
+     */
+    struct State {
+        quartz::scene::Camera::EulerAngles cameraEulerAngles;
+        math::Vec3 cameraPosition;
+        double cameraDistance;
+        double horizontalMovementSpeed;
+    };
 
 public: // member functions
     ThirdPersonController();
@@ -22,6 +37,26 @@ public: // member functions
     void collisionStayCallback(quartz::physics::Collider::CollisionCallbackParameters parameters);
     void collisionEndCallback(quartz::physics::Collider::CollisionCallbackParameters parameters);
 
+    /**
+     * @brief When set, the input read in the fixed update and update callbacks is written to the recorder, or is
+     * taken from the replayer instead of from the input manager
+     */
+    void setInputRecorder(InputRecorder* const p_inputRecorder) { mp_inputRecorder = p_inputRecorder; }
+    void setInputReplayer(InputReplayer* const p_inputReplayer) { mp_inputReplayer = p_inputReplayer; }
+
+    /**
+     * @brief The pieces of the fixed update and update callbacks that do not need a quartz::scene::Doodad,
+     * so the controller can also be driven by the headless simulation
+     */
+    math::Quaternion calculateDoodadRotation() const;
+    math::Vec3 calculateMovementVelocity(const InputState& inputState);
+    void updateCamera(const InputState& inputState, const math::Vec3& doodadPosition);
+
+    const quartz::scene::Camera& getCamera() const { return m_camera; }
+
+    State getState() const;
+    void setState(const State& state);
+
     USE_LOGGER(PLAYER);
 
 private: // helpers
@@ -32,14 +67,23 @@ private: // helpers
     );
 
 private: // member functions
-    void movementFixedUpdate(
+    InputState getFixedUpdateInputState(
         const quartz::managers::InputManager& inputManager,
+        const double ticksPerSecond
+    );
+
+    InputState getUpdateInputState(
+        const quartz::managers::InputManager& inputManager
+    );
+
+    void movementFixedUpdate(
+        const InputState& inputState,
         quartz::scene::Doodad* const p_doodad,
         const double ticksPerSecond
     );
 
     void cameraUpdate(
-        const quartz::managers::InputManager& inputManager,
+        const InputState& inputState,
         quartz::scene::Doodad* const p_doodad
     );
 
@@ -55,5 +99,9 @@ private: // member variables
 
     double m_maxHorizontalMovementSpeed;
     double m_currentHorizontalMovementSpeed;
+
+    InputRecorder* mp_inputRecorder;
+    InputReplayer* mp_inputReplayer;
+    InputState m_replayedInputState;
 };
 
@@ -0,0 +1,47 @@
+#include <cstddef>
+
+#include "util/macros.hpp"
+
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/third_person_controller/ThirdPersonController.hpp"
+#include "pole_position/third_person_controller/ThirdPersonControllerSystem.hpp"
+
+ThirdPersonControllerSystem::ThirdPersonControllerSystem(
+    ThirdPersonController& controller
+) :
+    m_controller(controller),
+    m_doodadRotation(),
+    m_movementVelocity()
+{}
+
+void
+ThirdPersonControllerSystem::prepareFixedUpdate(
+    const InputState& inputState,
+    UNUSED const double ticksPerSecond
+) {
+    m_doodadRotation = m_controller.calculateDoodadRotation();
+    m_movementVelocity = m_controller.calculateMovementVelocity(inputState);
+}
+
+void
+ThirdPersonControllerSystem::fixedUpdate(
+    const SystemContext& context,
+    CommandBuffer& commandBuffer
+) const {
+    for (const std::size_t doodadIndex : context.doodadIndices) {
+        commandBuffer.setRotation(doodadIndex, m_doodadRotation);
+        commandBuffer.setLinearVelocity(doodadIndex, m_movementVelocity);
+    }
+}
+
+void
+ThirdPersonControllerSystem::update(
+    const SystemContext& context
+) {
+    // There is only one camera, so it follows the first of the controller's doodads
+    if (!context.doodadIndices.empty()) {
+        m_controller.updateCamera(context.inputState, context.doodadStore.positions[context.doodadIndices.front()]);
+    }
+}
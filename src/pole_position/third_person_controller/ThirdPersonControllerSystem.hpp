@@ -0,0 +1,30 @@
+#pragma once
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/input/InputState.hpp"
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/third_person_controller/ThirdPersonController.hpp"
+
+/**
+ * @brief Drives the doodads of a ThirdPersonController through the system path: the same work as its
+ * fixedUpdateCallback and updateCallback, done on the doodad store instead of a quartz::scene::Doodad
+ */
+class ThirdPersonControllerSystem : public DoodadSystem {
+public: // member functions
+    explicit ThirdPersonControllerSystem(ThirdPersonController& controller);
+
+    const char* getName() const override { return "Third person controller system"; }
+    void prepareFixedUpdate(const InputState& inputState, const double ticksPerSecond) override;
+    void fixedUpdate(const SystemContext& context, CommandBuffer& commandBuffer) const override;
+    void update(const SystemContext& context) override;
+
+private: // member variables
+    ThirdPersonController& m_controller;
+
+    // The controller's rotation and velocity do not depend on the doodad, so they are worked out once per tick
+    math::Quaternion m_doodadRotation;
+    math::Vec3 m_movementVelocity;
+};
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/physics/Conversions.hpp"
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+#include "pole_position/vehicle/VehicleAiSystem.hpp"
+#include "pole_position/vehicle/VehicleControls.hpp"
+
+VehicleAiSystem::VehicleAiSystem(
+    const Parameters& parameters
+) :
+    m_parameters(parameters)
+{}
+
+void
+VehicleAiSystem::fixedUpdate(
+    const SystemContext& context,
+    CommandBuffer& commandBuffer
+) const {
+    for (const std::size_t doodadIndex : context.doodadIndices) {
+        const math::Vec3& position = context.doodadStore.positions[doodadIndex];
+        const math::Quaternion& rotation = context.doodadStore.rotations[doodadIndex];
+        const math::Vec3 forwardDirection = rotation.rotate(math::Vec3(0.0, 0.0, 1.0));
+        const math::Vec3 sideDirection = rotation.rotate(math::Vec3(1.0, 0.0, 0.0));
+
+        math::Vec3 radialOffset = position - m_parameters.trackCenter;
+        radialOffset.y = 0.0;
+        const double radius_m = radialOffset.magnitude();
+        if (radius_m < 1.0) {
+            // Sitting on the track's center there is no lane to pick, so get off it
+            commandBuffer.setVehicleControls(doodadIndex, {0.5, 0.0, 0.0});
+            continue;
+        }
+
+        const double laneIndex = std::clamp(std::round((radius_m - m_parameters.innermostLaneRadius_m) / m_parameters.laneWidth_m), 0.0, static_cast<double>(m_parameters.laneCount - 1));
+        const double laneRadius_m = m_parameters.innermostLaneRadius_m + laneIndex * m_parameters.laneWidth_m;
+
+        const math::Vec3 radialDirection = radialOffset * (1.0 / radius_m);
+        math::Vec3 tangentDirection = math::Vec3::Up.cross(radialDirection);
+        if (tangentDirection.dot(forwardDirection) < 0.0) {
+            tangentDirection = tangentDirection * -1.0;
+        }
+
+        const double lookAheadAngle_rad = m_parameters.lookAheadDistance_m / laneRadius_m;
+        const math::Vec3 targetPosition = m_parameters.trackCenter + (radialDirection * std::cos(lookAheadAngle_rad) + tangentDirection * std::sin(lookAheadAngle_rad)) * laneRadius_m;
+        const math::Vec3 toTarget = targetPosition - position;
+        const double headingError_rad = std::atan2(toTarget.dot(sideDirection), toTarget.dot(forwardDirection));
+
+        const double laneSpeed_mps = m_parameters.innermostLaneSpeed_mps * laneRadius_m / m_parameters.innermostLaneRadius_m;
+        const double speed_mps = toMath(context.doodadStore.rigidBodies[doodadIndex]->getLinearVelocity()).dot(forwardDirection);
+
+        commandBuffer.setVehicleControls(doodadIndex, {
+            std::clamp((laneSpeed_mps - speed_mps) * s_throttleGain, 0.0, 1.0),
+            std::clamp((speed_mps - laneSpeed_mps) * s_brakeGain, 0.0, 1.0),
+            std::clamp(headingError_rad * s_steeringGain, -1.0, 1.0)
+        });
+    }
+}
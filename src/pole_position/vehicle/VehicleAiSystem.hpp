@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+#include "math/transform/Vec3.hpp"
+
+#include "pole_position/systems/CommandBuffer.hpp"
+#include "pole_position/systems/DoodadSystem.hpp"
+
+/**
+ * @brief Drives its vehicles around a circular track of concentric lanes. Each vehicle keeps to the lane it is
+ * nearest and goes whichever way round it is facing, steering for a point a little further along its lane. Outer
+ * lanes go proportionally faster, so every lane laps in the same time and cars keep their spacing
+ */
+class VehicleAiSystem : public DoodadSystem {
+public: // classes and enums
+    struct Parameters {
+        math::Vec3 trackCenter;
+        double innermostLaneRadius_m;
+        double laneWidth_m;
+        std::size_t laneCount;
+        double innermostLaneSpeed_mps;
+        double lookAheadDistance_m;
+    };
+
+public: // member functions
+    explicit VehicleAiSystem(const Parameters& parameters);
+
+    const char* getName() const override { return "Vehicle AI system"; }
+    void fixedUpdate(const SystemContext& context, CommandBuffer& commandBuffer) const override;
+
+private: // static variables
+    /**
+     * @brief Steering per radian of heading error, and throttle and brake per metre per second off the lane's speed
+     */
+    static constexpr double s_steeringGain = 2.0;
+    static constexpr double s_throttleGain = 0.5;
+    static constexpr double s_brakeGain = 0.2;
+
+private: // member variables
+    Parameters m_parameters;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * @brief What a driver asks of a vehicle for the next tick. Throttle and brake go from 0 to 1, steering from -1
+ * to 1 where positive turns toward the chassis' +x side
+ */
+struct VehicleControls {
+public: // member functions
+    static VehicleControls idle() { return {0.0, 0.0, 0.0}; }
+
+public: // member variables
+    double throttle;
+    double brake;
+    double steering;
+};
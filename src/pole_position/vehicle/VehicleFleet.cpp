@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "math/transform/Quaternion.hpp"
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/memory/MemoryTracker.hpp"
+#include "pole_position/physics/Conversions.hpp"
+#include "pole_position/profiling/Profiler.hpp"
+#include "pole_position/snapshot/WorldSnapshotFormat.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/vehicle/VehicleControls.hpp"
+#include "pole_position/vehicle/VehicleFleet.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+reactphysics3d::decimal
+VehicleFleet::WheelRaycastCallback::notifyRaycastHit(
+    const reactphysics3d::RaycastInfo& raycastInfo
+) {
+    // -1 skips the collider, returning the hit's fraction shortens the ray to it so only closer hits follow
+    if (raycastInfo.body == mp_chassisBody || raycastInfo.collider->getIsTrigger()) {
+        return -1.0f;
+    }
+
+    isHit = true;
+    hitFraction = raycastInfo.hitFraction;
+    hitPoint = raycastInfo.worldPoint;
+    hitNormal = raycastInfo.worldNormal;
+
+    return raycastInfo.hitFraction;
+}
+
+double
+VehicleFleet::getEngineTorqueFraction(
+    const VehicleParameters& vehicleParameters,
+    const double engineSpeed_rpm
+) {
+    // Flat up to three quarters of the rev limit, then falling away to nothing at it
+    const double peakEndSpeed_rpm = 0.75 * vehicleParameters.maxEngineSpeed_rpm;
+    if (engineSpeed_rpm <= peakEndSpeed_rpm) {
+        return 1.0;
+    }
+
+    return std::clamp((vehicleParameters.maxEngineSpeed_rpm - engineSpeed_rpm) / (vehicleParameters.maxEngineSpeed_rpm - peakEndSpeed_rpm), 0.0, 1.0);
+}
+
+VehicleFleet::VehicleFleet(
+    reactphysics3d::PhysicsWorld* const p_physicsWorld
+) :
+    mp_physicsWorld(p_physicsWorld),
+    m_vehicleParameters(),
+    m_vehicleDoodadIndices(),
+    m_chassisBodies(),
+    m_parameterIndices(),
+    m_firstWheelIndices(),
+    m_gearIndices(),
+    m_engineSpeeds_rpm(),
+    m_wheelVehicleIndices(),
+    m_steeringAngles_rad(),
+    m_rayOrigins(),
+    m_rayDirections(),
+    m_steeredForwards(),
+    m_hitDistances(),
+    m_hitPoints(),
+    m_hitNormals(),
+    m_driveTorques_Nm(),
+    m_brakeTorques_Nm(),
+    m_wheelAngularSpeeds_radps(),
+    m_wheelForces_N()
+{}
+
+void
+VehicleFleet::addVehicles(
+    const DoodadStore& doodadStore,
+    const std::vector<std::size_t>& doodadIndices,
+    const VehicleParameters& vehicleParameters
+) {
+    const MemoryTracker::ScopedTag scopedTag(MemoryTag::Physics);
+
+    const bool hasDrivenWheel = std::any_of(vehicleParameters.wheelParameters.begin(), vehicleParameters.wheelParameters.end(), [] (const WheelParameters& wheelParameters) { return wheelParameters.isDriven; });
+    if (!hasDrivenWheel || vehicleParameters.gearRatios.empty()) {
+        LOG_CRITICALthis("Vehicles need at least one driven wheel and one gear ({} wheels, {} gears)", vehicleParameters.wheelParameters.size(), vehicleParameters.gearRatios.size());
+        throw std::runtime_error("Invalid vehicle parameters");
+    }
+
+    for (const std::size_t doodadIndex : doodadIndices) {
+        const reactphysics3d::RigidBody* const p_rigidBody = doodadIndex < doodadStore.size() ? doodadStore.rigidBodies[doodadIndex] : nullptr;
+        if (!p_rigidBody || p_rigidBody->getType() != reactphysics3d::BodyType::DYNAMIC) {
+            LOG_CRITICALthis("Doodad {} does not have a dynamic rigid body to use as a vehicle's chassis", doodadIndex);
+            throw std::runtime_error("Invalid doodad for vehicle");
+        }
+    }
+
+    const std::size_t parameterIndex = m_vehicleParameters.size();
+    m_vehicleParameters.push_back(vehicleParameters);
+
+    // A solid box, which is close enough for a car's body
+    const math::Vec3& halfExtents_m = vehicleParameters.chassisHalfExtents_m;
+    const double mass_kg = vehicleParameters.chassisMass_kg;
+    const math::Vec3 inertiaTensor_kgm2(
+        mass_kg / 3.0 * (halfExtents_m.y * halfExtents_m.y + halfExtents_m.z * halfExtents_m.z),
+        mass_kg / 3.0 * (halfExtents_m.x * halfExtents_m.x + halfExtents_m.z * halfExtents_m.z),
+        mass_kg / 3.0 * (halfExtents_m.x * halfExtents_m.x + halfExtents_m.y * halfExtents_m.y)
+    );
+
+    const std::size_t wheelCount = doodadIndices.size() * vehicleParameters.wheelParameters.size();
+    const std::size_t totalWheelCount = m_wheelVehicleIndices.size() + wheelCount;
+    m_wheelVehicleIndices.reserve(totalWheelCount);
+
+    for (const std::size_t doodadIndex : doodadIndices) {
+        reactphysics3d::RigidBody* const p_rigidBody = doodadStore.rigidBodies[doodadIndex];
+        p_rigidBody->setMass(static_cast<reactphysics3d::decimal>(mass_kg));
+        p_rigidBody->setLocalInertiaTensor(toReactPhysics3d(inertiaTensor_kgm2));
+        p_rigidBody->setLocalCenterOfMass(toReactPhysics3d(vehicleParameters.centerOfMassOffset_m));
+
+        const std::size_t vehicleIndex = m_vehicleDoodadIndices.size();
+        m_vehicleDoodadIndices.push_back(doodadIndex);
+        m_chassisBodies.push_back(p_rigidBody);
+        m_parameterIndices.push_back(parameterIndex);
+        m_firstWheelIndices.push_back(m_wheelVehicleIndices.size());
+        m_gearIndices.push_back(0);
+        m_engineSpeeds_rpm.push_back(vehicleParameters.idleEngineSpeed_rpm);
+
+        m_wheelVehicleIndices.insert(m_wheelVehicleIndices.end(), vehicleParameters.wheelParameters.size(), vehicleIndex);
+    }
+
+    m_steeringAngles_rad.resize(totalWheelCount, 0.0);
+    m_rayOrigins.resize(totalWheelCount);
+    m_rayDirections.resize(totalWheelCount);
+    m_steeredForwards.resize(totalWheelCount);
+    m_hitDistances.resize(totalWheelCount, -1.0);
+    m_hitPoints.resize(totalWheelCount);
+    m_hitNormals.resize(totalWheelCount);
+    m_driveTorques_Nm.resize(totalWheelCount, 0.0);
+    m_brakeTorques_Nm.resize(totalWheelCount, 0.0);
+    m_wheelAngularSpeeds_radps.resize(totalWheelCount, 0.0);
+    m_wheelForces_N.resize(totalWheelCount);
+
+    LOG_INFOthis("Added {} vehicles with {} wheels each, {} vehicles and {} wheels in total", doodadIndices.size(), vehicleParameters.wheelParameters.size(), m_vehicleDoodadIndices.size(), m_wheelVehicleIndices.size());
+}
+
+void
+VehicleFleet::updateDrivetrains(
+    const DoodadStore& doodadStore
+) {
+    for (std::size_t vehicleIndex = 0; vehicleIndex < m_vehicleDoodadIndices.size(); ++vehicleIndex) {
+        const VehicleParameters& vehicleParameters = m_vehicleParameters[m_parameterIndices[vehicleIndex]];
+        const VehicleControls& controls = doodadStore.vehicleControls[m_vehicleDoodadIndices[vehicleIndex]];
+        const std::size_t firstWheelIndex = m_firstWheelIndices[vehicleIndex];
+        const std::size_t wheelCount = vehicleParameters.wheelParameters.size();
+
+        // The clutch never slips, so the engine turns with the driven wheels, but never below idle
+        double drivenWheelSpeedSum_radps = 0.0;
+        std::size_t drivenWheelCount = 0;
+        for (std::size_t i = 0; i < wheelCount; ++i) {
+            if (vehicleParameters.wheelParameters[i].isDriven) {
+                drivenWheelSpeedSum_radps += std::abs(m_wheelAngularSpeeds_radps[firstWheelIndex + i]);
+                ++drivenWheelCount;
+            }
+        }
+
+        std::size_t& gearIndex = m_gearIndices[vehicleIndex];
+        const double wheelToEngineSpeed_rpm = 60.0 / (2.0 * std::numbers::pi) * vehicleParameters.finalDriveRatio;
+        double engineSpeed_rpm = drivenWheelSpeedSum_radps / drivenWheelCount * vehicleParameters.gearRatios[gearIndex] * wheelToEngineSpeed_rpm;
+        if (engineSpeed_rpm > vehicleParameters.upshiftEngineSpeed_rpm && gearIndex + 1 < vehicleParameters.gearRatios.size()) {
+            engineSpeed_rpm *= vehicleParameters.gearRatios[gearIndex + 1] / vehicleParameters.gearRatios[gearIndex];
+            ++gearIndex;
+        } else if (engineSpeed_rpm < vehicleParameters.downshiftEngineSpeed_rpm && gearIndex > 0) {
+            engineSpeed_rpm *= vehicleParameters.gearRatios[gearIndex - 1] / vehicleParameters.gearRatios[gearIndex];
+            --gearIndex;
+        }
+        engineSpeed_rpm = std::max(engineSpeed_rpm, vehicleParameters.idleEngineSpeed_rpm);
+        m_engineSpeeds_rpm[vehicleIndex] = engineSpeed_rpm;
+
+        const double engineTorque_Nm = std::clamp(controls.throttle, 0.0, 1.0) * vehicleParameters.maxEngineTorque_Nm * VehicleFleet::getEngineTorqueFraction(vehicleParameters, engineSpeed_rpm);
+        const double wheelDriveTorque_Nm = engineTorque_Nm * vehicleParameters.gearRatios[gearIndex] * vehicleParameters.finalDriveRatio / drivenWheelCount;
+        const double brakeTorque_Nm = std::clamp(controls.brake, 0.0, 1.0) * vehicleParameters.maxBrakeTorque_Nm;
+        const double steeringAngle_rad = std::clamp(controls.steering, -1.0, 1.0) * vehicleParameters.maxSteeringAngle_rad;
+
+        for (std::size_t i = 0; i < wheelCount; ++i) {
+            const WheelParameters& wheelParameters = vehicleParameters.wheelParameters[i];
+            m_driveTorques_Nm[firstWheelIndex + i] = wheelParameters.isDriven ? wheelDriveTorque_Nm : 0.0;
+            m_brakeTorques_Nm[firstWheelIndex + i] = brakeTorque_Nm;
+            m_steeringAngles_rad[firstWheelIndex + i] = wheelParameters.isSteered ? steeringAngle_rad : 0.0;
+        }
+    }
+}
+
+void
+VehicleFleet::castWheelRays() {
+    PROFILE_SCOPE("Vehicle wheel raycasts");
+
+    // Lay out every wheel's ray from its chassis' transform at the start of the substep
+    for (std::size_t vehicleIndex = 0; vehicleIndex < m_vehicleDoodadIndices.size(); ++vehicleIndex) {
+        const VehicleParameters& vehicleParameters = m_vehicleParameters[m_parameterIndices[vehicleIndex]];
+        const reactphysics3d::Transform& chassisTransform = m_chassisBodies[vehicleIndex]->getTransform();
+        const math::Vec3 chassisPosition = toMath(chassisTransform.getPosition());
+        const math::Quaternion chassisRotation = toMath(chassisTransform.getOrientation());
+        const math::Vec3 downDirection = chassisRotation.rotate(math::Vec3(0.0, -1.0, 0.0));
+        const math::Vec3 forwardDirection = chassisRotation.rotate(math::Vec3(0.0, 0.0, 1.0));
+        const math::Vec3 sideDirection = chassisRotation.rotate(math::Vec3(1.0, 0.0, 0.0));
+
+        const std::size_t firstWheelIndex = m_firstWheelIndices[vehicleIndex];
+        for (std::size_t i = 0; i < vehicleParameters.wheelParameters.size(); ++i) {
+            const std::size_t wheelIndex = firstWheelIndex + i;
+            const double steeringAngle_rad = m_steeringAngles_rad[wheelIndex];
+            m_rayOrigins[wheelIndex] = chassisPosition + chassisRotation.rotate(vehicleParameters.wheelParameters[i].attachmentPosition_m);
+            m_rayDirections[wheelIndex] = downDirection;
+            m_steeredForwards[wheelIndex] = forwardDirection * std::cos(steeringAngle_rad) + sideDirection * std::sin(steeringAngle_rad);
+        }
+    }
+
+    // Then cast them all
+    for (std::size_t wheelIndex = 0; wheelIndex < m_wheelVehicleIndices.size(); ++wheelIndex) {
+        const std::size_t vehicleIndex = m_wheelVehicleIndices[wheelIndex];
+        const VehicleParameters& vehicleParameters = m_vehicleParameters[m_parameterIndices[vehicleIndex]];
+        const double rayLength_m = vehicleParameters.suspensionRestLength_m + vehicleParameters.wheelRadius_m;
+
+        WheelRaycastCallback raycastCallback(m_chassisBodies[vehicleIndex]);
+        const reactphysics3d::Ray ray(
+            toReactPhysics3d(m_rayOrigins[wheelIndex]),
+            toReactPhysics3d(m_rayOrigins[wheelIndex] + m_rayDirections[wheelIndex] * rayLength_m)
+        );
+        mp_physicsWorld->raycast(ray, &raycastCallback, vehicleParameters.wheelCollideWithMaskBits);
+
+        if (!raycastCallback.isHit) {
+            m_hitDistances[wheelIndex] = -1.0;
+            continue;
+        }
+
+        m_hitDistances[wheelIndex] = raycastCallback.hitFraction * rayLength_m;
+        m_hitPoints[wheelIndex] = toMath(raycastCallback.hitPoint);
+        m_hitNormals[wheelIndex] = toMath(raycastCallback.hitNormal);
+    }
+}
+
+uint32_t
+VehicleFleet::solveWheels(
+    const double substepSeconds
+) {
+    PROFILE_SCOPE("Vehicle wheel solve");
+
+    uint32_t groundedWheelCount = 0;
+    for (std::size_t wheelIndex = 0; wheelIndex < m_wheelVehicleIndices.size(); ++wheelIndex) {
+        const std::size_t vehicleIndex = m_wheelVehicleIndices[wheelIndex];
+        const VehicleParameters& vehicleParameters = m_vehicleParameters[m_parameterIndices[vehicleIndex]];
+        const double wheelRadius_m = vehicleParameters.wheelRadius_m;
+        const double wheelInertia_kgm2 = vehicleParameters.wheelInertia_kgm2;
+        double& wheelAngularSpeed_radps = m_wheelAngularSpeeds_radps[wheelIndex];
+
+        // Brakes only ever slow the wheel down, so they act after everything else and stop at standing still
+        const auto applyBrake = [&] () {
+            const double brakeSpeedChange_radps = m_brakeTorques_Nm[wheelIndex] * substepSeconds / wheelInertia_kgm2;
+            wheelAngularSpeed_radps = std::abs(wheelAngularSpeed_radps) <= brakeSpeedChange_radps ?
+                0.0 :
+                wheelAngularSpeed_radps - std::copysign(brakeSpeedChange_radps, wheelAngularSpeed_radps);
+        };
+
+        const double hitDistance_m = m_hitDistances[wheelIndex];
+        if (hitDistance_m < 0.0) {
+            wheelAngularSpeed_radps += m_driveTorques_Nm[wheelIndex] * substepSeconds / wheelInertia_kgm2;
+            applyBrake();
+            m_wheelForces_N[wheelIndex] = math::Vec3(0.0, 0.0, 0.0);
+            continue;
+        }
+        ++groundedWheelCount;
+
+        // Suspension, a spring and damper along the chassis' up axis
+        const math::Vec3 upDirection = m_rayDirections[wheelIndex] * -1.0;
+        const math::Vec3& hitPoint = m_hitPoints[wheelIndex];
+        const math::Vec3 contactVelocity_mps = toMath(m_chassisBodies[vehicleIndex]->getLinearVelocityAtWorldPoint(toReactPhysics3d(hitPoint)));
+        const double compression_m = std::clamp(vehicleParameters.suspensionRestLength_m - (hitDistance_m - wheelRadius_m), 0.0, vehicleParameters.suspensionRestLength_m);
+        const double compressionSpeed_mps = -contactVelocity_mps.dot(upDirection);
+        const double load_N = std::clamp(
+            vehicleParameters.suspensionStiffness_Npm * compression_m + vehicleParameters.suspensionDamping_Nspm * compressionSpeed_mps,
+            0.0,
+            vehicleParameters.maxSuspensionForce_N
+        );
+
+        // The tire's axes, on the plane of what it is touching
+        const math::Vec3& hitNormal = m_hitNormals[wheelIndex];
+        const math::Vec3& steeredForward = m_steeredForwards[wheelIndex];
+        math::Vec3 forwardDirection = steeredForward - hitNormal * steeredForward.dot(hitNormal);
+        forwardDirection.normalize();
+        const math::Vec3 sideDirection = hitNormal.cross(forwardDirection);
+        const double longitudinalSpeed_mps = contactVelocity_mps.dot(forwardDirection);
+        const double lateralSpeed_mps = contactVelocity_mps.dot(sideDirection);
+        const double slipSpeed_mps = std::max(std::abs(longitudinalSpeed_mps), s_minimumSlipSpeed_mps);
+        const double maxTireForce_N = vehicleParameters.tireFrictionCoefficient * load_N;
+
+        // Longitudinal, solved implicitly together with the wheel's spin. The tire's force is stiff against the
+        // wheel's small inertia, stepping the two one after the other blows up at anything but walking pace
+        const double wheelAngularSpeedBefore_radps = wheelAngularSpeed_radps;
+        const double slipStiffness_Nspm = vehicleParameters.tireLongitudinalStiffness * load_N / slipSpeed_mps;
+        const double substepPerInertia = substepSeconds / wheelInertia_kgm2;
+        wheelAngularSpeed_radps =
+            (wheelAngularSpeedBefore_radps + substepPerInertia * (m_driveTorques_Nm[wheelIndex] + wheelRadius_m * slipStiffness_Nspm * longitudinalSpeed_mps)) /
+            (1.0 + substepPerInertia * wheelRadius_m * wheelRadius_m * slipStiffness_Nspm);
+        double longitudinalForce_N = slipStiffness_Nspm * (wheelAngularSpeed_radps * wheelRadius_m - longitudinalSpeed_mps);
+        if (std::abs(longitudinalForce_N) > maxTireForce_N) {
+            // Past the limit of grip the force stops depending on the slip, and the wheel spins up or locks freely
+            longitudinalForce_N = std::copysign(maxTireForce_N, longitudinalForce_N);
+            wheelAngularSpeed_radps = wheelAngularSpeedBefore_radps + substepPerInertia * (m_driveTorques_Nm[wheelIndex] - wheelRadius_m * longitudinalForce_N);
+        }
+        applyBrake();
+
+        // Lateral, never more than it takes to stop this wheel's share of the chassis sliding within the substep
+        const double wheelMass_kg = vehicleParameters.chassisMass_kg / vehicleParameters.wheelParameters.size();
+        const double slipAngle_rad = std::atan2(lateralSpeed_mps, slipSpeed_mps);
+        const double maxLateralForce_N = std::abs(lateralSpeed_mps) * wheelMass_kg / substepSeconds;
+        double lateralForce_N = std::clamp(-vehicleParameters.tireLateralStiffness_perRadian * load_N * slipAngle_rad, -maxLateralForce_N, maxLateralForce_N);
+
+        // Both directions share one budget of grip
+        const double tireForce_N = std::sqrt(longitudinalForce_N * longitudinalForce_N + lateralForce_N * lateralForce_N);
+        if (tireForce_N > maxTireForce_N) {
+            const double scale = maxTireForce_N / tireForce_N;
+            longitudinalForce_N *= scale;
+            lateralForce_N *= scale;
+        }
+
+        m_wheelForces_N[wheelIndex] = upDirection * load_N + forwardDirection * longitudinalForce_N + sideDirection * lateralForce_N;
+    }
+
+    return groundedWheelCount;
+}
+
+void
+VehicleFleet::applyWheelForces() {
+    for (std::size_t wheelIndex = 0; wheelIndex < m_wheelVehicleIndices.size(); ++wheelIndex) {
+        if (m_hitDistances[wheelIndex] < 0.0) {
+            continue;
+        }
+
+        m_chassisBodies[m_wheelVehicleIndices[wheelIndex]]->applyWorldForceAtWorldPosition(
+            toReactPhysics3d(m_wheelForces_N[wheelIndex]),
+            toReactPhysics3d(m_hitPoints[wheelIndex])
+        );
+    }
+}
+
+VehicleFleet::SubstepTimings
+VehicleFleet::substep(
+    const DoodadStore& doodadStore,
+    const double substepSeconds
+) {
+    PROFILE_SCOPE("Vehicle substep");
+
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point startTime = Clock::now();
+    this->updateDrivetrains(doodadStore);
+    this->castWheelRays();
+    const Clock::time_point raycastEndTime = Clock::now();
+
+    const uint32_t groundedWheelCount = this->solveWheels(substepSeconds);
+    this->applyWheelForces();
+
+    return {
+        std::chrono::duration<double, std::micro>(raycastEndTime - startTime).count(),
+        std::chrono::duration<double, std::micro>(Clock::now() - raycastEndTime).count(),
+        groundedWheelCount
+    };
+}
+
+void
+VehicleFleet::writeState(
+    std::span<world_snapshot_format::VehicleState> vehicleStates,
+    std::span<world_snapshot_format::WheelState> wheelStates
+) const {
+    for (std::size_t vehicleIndex = 0; vehicleIndex < vehicleStates.size(); ++vehicleIndex) {
+        vehicleStates[vehicleIndex] = {
+            static_cast<uint64_t>(m_gearIndices[vehicleIndex]),
+            m_engineSpeeds_rpm[vehicleIndex]
+        };
+    }
+
+    for (std::size_t wheelIndex = 0; wheelIndex < wheelStates.size(); ++wheelIndex) {
+        const math::Vec3& hitPoint = m_hitPoints[wheelIndex];
+        const math::Vec3& hitNormal = m_hitNormals[wheelIndex];
+        wheelStates[wheelIndex] = {
+            m_wheelAngularSpeeds_radps[wheelIndex],
+            m_hitDistances[wheelIndex],
+            {hitPoint.x, hitPoint.y, hitPoint.z},
+            {hitNormal.x, hitNormal.y, hitNormal.z}
+        };
+    }
+}
+
+void
+VehicleFleet::checkState(
+    std::span<const world_snapshot_format::VehicleState> vehicleStates
+) const {
+    for (std::size_t vehicleIndex = 0; vehicleIndex < vehicleStates.size(); ++vehicleIndex) {
+        const VehicleParameters& vehicleParameters = m_vehicleParameters[m_parameterIndices[vehicleIndex]];
+        if (vehicleStates[vehicleIndex].gearIndex >= vehicleParameters.gearRatios.size()) {
+            LOG_CRITICALthis("Vehicle {} is in gear {} but only has {} gears", vehicleIndex, vehicleStates[vehicleIndex].gearIndex, vehicleParameters.gearRatios.size());
+            throw std::runtime_error("Invalid vehicle state in world snapshot");
+        }
+    }
+}
+
+void
+VehicleFleet::readState(
+    std::span<const world_snapshot_format::VehicleState> vehicleStates,
+    std::span<const world_snapshot_format::WheelState> wheelStates
+) {
+    for (std::size_t vehicleIndex = 0; vehicleIndex < vehicleStates.size(); ++vehicleIndex) {
+        m_gearIndices[vehicleIndex] = static_cast<std::size_t>(vehicleStates[vehicleIndex].gearIndex);
+        m_engineSpeeds_rpm[vehicleIndex] = vehicleStates[vehicleIndex].engineSpeed_rpm;
+    }
+
+    for (std::size_t wheelIndex = 0; wheelIndex < wheelStates.size(); ++wheelIndex) {
+        const world_snapshot_format::WheelState& wheelState = wheelStates[wheelIndex];
+        m_wheelAngularSpeeds_radps[wheelIndex] = wheelState.angularSpeed_radps;
+        m_hitDistances[wheelIndex] = wheelState.hitDistance_m;
+        m_hitPoints[wheelIndex] = math::Vec3(wheelState.hitPoint[0], wheelState.hitPoint[1], wheelState.hitPoint[2]);
+        m_hitNormals[wheelIndex] = math::Vec3(wheelState.hitNormal[0], wheelState.hitNormal[1], wheelState.hitNormal[2]);
+    }
+}
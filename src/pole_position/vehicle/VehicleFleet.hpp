@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "math/transform/Vec3.hpp"
+
+#include "util/logger/Logger.hpp"
+
+#include "pole_position/Loggers.hpp"
+#include "pole_position/snapshot/WorldSnapshotFormat.hpp"
+#include "pole_position/systems/DoodadStore.hpp"
+#include "pole_position/vehicle/VehicleParameters.hpp"
+
+/**
+ * @brief Drives doodads' rigid bodies as raycast cars: each wheel is a ray cast down from the chassis, whose hit
+ * compresses a spring and damper pushing the chassis up, and whose load lets the tire push the chassis along and
+ * sideways. The engine's torque reaches the driven wheels through an automatic gearbox, and each wheel's spin is
+ * its own state, so the tires' slip comes out of the torques rather than being made up.
+ *
+ * The whole fleet is solved together once per physics substep. Every wheel's ray is laid out first, then they are
+ * all cast, then every wheel is solved over flat arrays, and only then are the forces handed to the chassis. The
+ * wheels of 200 cars cost about what their raycasts cost, instead of 200 trips through a per-car callback. The
+ * raycasts stay on the calling thread, reactphysics3d's broad phase allocates from pools that are not thread safe.
+ *
+ * Each vehicle's controls are read from the doodad store's vehicleControls, written through
+ * CommandBuffer::setVehicleControls
+ */
+class VehicleFleet {
+public: // classes and enums
+    struct SubstepTimings {
+        double raycastMicroseconds;
+        double solveMicroseconds;
+        uint32_t groundedWheelCount;
+    };
+
+public: // member functions
+    explicit VehicleFleet(reactphysics3d::PhysicsWorld* const p_physicsWorld);
+    VehicleFleet(const VehicleFleet& other) = delete;
+    VehicleFleet& operator=(const VehicleFleet& other) = delete;
+
+    /**
+     * @brief Gives the doodads' bodies the chassis' mass and inertia and starts driving them. The bodies must be
+     * dynamic and must outlive the fleet
+     */
+    void addVehicles(const DoodadStore& doodadStore, const std::vector<std::size_t>& doodadIndices, const VehicleParameters& vehicleParameters);
+
+    /**
+     * @brief Casts every wheel's ray and applies every wheel's forces for a physics step of substepSeconds, which
+     * must come right after
+     */
+    SubstepTimings substep(const DoodadStore& doodadStore, const double substepSeconds);
+
+    /**
+     * @brief The gearboxes, engines and wheel spins that carry over from one substep to the next, and what each
+     * wheel's ray touched in the last one. One entry per vehicle and per wheel, in the order they were added
+     */
+    void writeState(std::span<world_snapshot_format::VehicleState> vehicleStates, std::span<world_snapshot_format::WheelState> wheelStates) const;
+    void readState(std::span<const world_snapshot_format::VehicleState> vehicleStates, std::span<const world_snapshot_format::WheelState> wheelStates);
+
+    /**
+     * @brief Throws if a vehicle state could not have been written by these vehicles, like a gear they do not have.
+     * Snapshots can come from a file, so this runs before anything is restored from one
+     */
+    void checkState(std::span<const world_snapshot_format::VehicleState> vehicleStates) const;
+
+    std::size_t getVehicleCount() const { return m_vehicleDoodadIndices.size(); }
+    std::size_t getWheelCount() const { return m_wheelVehicleIndices.size(); }
+    const std::vector<std::size_t>& getVehicleDoodadIndices() const { return m_vehicleDoodadIndices; }
+    std::size_t getGearIndex(const std::size_t vehicleIndex) const { return m_gearIndices[vehicleIndex]; }
+    double getEngineSpeed_rpm(const std::size_t vehicleIndex) const { return m_engineSpeeds_rpm[vehicleIndex]; }
+
+    USE_LOGGER(VEHICLE);
+
+private: // classes and enums
+    /**
+     * @brief Keeps the closest hit along the ray that is not the wheel's own chassis or a trigger
+     */
+    class WheelRaycastCallback : public reactphysics3d::RaycastCallback {
+    public:
+        explicit WheelRaycastCallback(const reactphysics3d::CollisionBody* const p_chassisBody) : mp_chassisBody(p_chassisBody), isHit(false), hitFraction(1.0f), hitPoint(), hitNormal() {}
+        reactphysics3d::decimal notifyRaycastHit(const reactphysics3d::RaycastInfo& raycastInfo) override;
+
+    private:
+        const reactphysics3d::CollisionBody* mp_chassisBody;
+
+    public:
+        bool isHit;
+        reactphysics3d::decimal hitFraction;
+        reactphysics3d::Vector3 hitPoint;
+        reactphysics3d::Vector3 hitNormal;
+    };
+
+private: // helpers
+    static double getEngineTorqueFraction(const VehicleParameters& vehicleParameters, const double engineSpeed_rpm);
+
+private: // member functions
+    void updateDrivetrains(const DoodadStore& doodadStore);
+    void castWheelRays();
+    uint32_t solveWheels(const double substepSeconds);
+    void applyWheelForces();
+
+private: // static variables
+    /**
+     * @brief The slowest a tire's slip is measured against, so a car pulling away or coming to rest does not
+     * divide by nothing
+     */
+    static constexpr double s_minimumSlipSpeed_mps = 1.0;
+
+private: // member variables
+    reactphysics3d::PhysicsWorld* mp_physicsWorld;
+    std::vector<VehicleParameters> m_vehicleParameters;
+
+    // Per vehicle
+    std::vector<std::size_t> m_vehicleDoodadIndices;
+    std::vector<reactphysics3d::RigidBody*> m_chassisBodies;
+    std::vector<std::size_t> m_parameterIndices;
+    std::vector<std::size_t> m_firstWheelIndices;
+    std::vector<std::size_t> m_gearIndices;
+    std::vector<double> m_engineSpeeds_rpm;
+
+    // Per wheel, over every vehicle's wheels back to back
+    std::vector<std::size_t> m_wheelVehicleIndices;
+    std::vector<double> m_steeringAngles_rad;
+    std::vector<math::Vec3> m_rayOrigins;
+    std::vector<math::Vec3> m_rayDirections;
+    std::vector<math::Vec3> m_steeredForwards;
+    std::vector<double> m_hitDistances; // negative when the ray hit nothing
+    std::vector<math::Vec3> m_hitPoints;
+    std::vector<math::Vec3> m_hitNormals;
+    std::vector<double> m_driveTorques_Nm;
+    std::vector<double> m_brakeTorques_Nm;
+    std::vector<double> m_wheelAngularSpeeds_radps;
+    std::vector<math::Vec3> m_wheelForces_N;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/transform/Vec3.hpp"
+
+/**
+ * @brief Where a wheel hangs off the chassis, in the chassis' space with +y up and +z forward. The attachment is
+ * the top of the suspension's travel, the wheel's ray is cast straight down the chassis' -y from it
+ */
+struct WheelParameters {
+    math::Vec3 attachmentPosition_m;
+    bool isSteered;
+    bool isDriven;
+};
+
+/**
+ * @brief Everything a VehicleFleet needs to drive a doodad's rigid body as a car. The chassis' mass and inertia
+ * replace whatever the body had, its collider is left as it is
+ */
+struct VehicleParameters {
+    // Chassis
+    double chassisMass_kg;
+    math::Vec3 chassisHalfExtents_m;
+    math::Vec3 centerOfMassOffset_m;
+
+    // Wheels and suspension
+    std::vector<WheelParameters> wheelParameters;
+    double wheelRadius_m;
+    double wheelInertia_kgm2;
+    double suspensionRestLength_m;
+    double suspensionStiffness_Npm;
+    double suspensionDamping_Nspm;
+    double maxSuspensionForce_N;
+    uint16_t wheelCollideWithMaskBits;
+
+    // Tires, the stiffnesses are per newton of load on the tire
+    double tireFrictionCoefficient;
+    double tireLongitudinalStiffness;
+    double tireLateralStiffness_perRadian;
+    double maxSteeringAngle_rad;
+
+    // Drivetrain, geared through an automatic gearbox to the driven wheels
+    double maxEngineTorque_Nm;
+    double idleEngineSpeed_rpm;
+    double maxEngineSpeed_rpm;
+    double upshiftEngineSpeed_rpm;
+    double downshiftEngineSpeed_rpm;
+    std::vector<double> gearRatios;
+    double finalDriveRatio;
+    double maxBrakeTorque_Nm;
+};